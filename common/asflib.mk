@@ -110,8 +110,8 @@ PART_REV  = e
 # directories we pull files from, otherwise it'd be hard to clean them up.
 #
 # ASF_FILES:    The specific file locations for what we want in the library.
-#                For the Arduino Due, the Non-Volatile Memory, ADC, PIO, PMC, sleep,
-#                SPI, TWI, UART, USART, and Watchdog Timer drivers are selected,
+#                For the Arduino Due, the Non-Volatile Memory, ADC, DMAC, PIO, PMC,
+#                sleep, SPI, TWI, UART, USART, and Watchdog Timer drivers are selected,
 #                along with a clock, serial, and SPI service.
 #                The standard SAM interrupt vectors, as well as the MCU-specific
 #                startup files are also included.
@@ -143,12 +143,15 @@ ASF_FILES = \
        common/drivers/nvm/sam                              \
        common/services/clock/$(PART_BASE)                  \
        common/services/serial                              \
+       common/services/sleepmgr/sam                        \
        common/services/spi/sam_spi                         \
        common/utils/interrupt                              \
        common/utils/stdio                                  \
        sam/boards/$(ASF_FOLDER)                            \
        sam/drivers/adc                                     \
+       sam/drivers/dmac                                    \
        sam/drivers/efc                                     \
+       sam/drivers/pdc                                     \
        sam/drivers/pio                                     \
        sam/drivers/pmc                                     \
        sam/drivers/spi                                     \
@@ -157,6 +160,7 @@ ASF_FILES = \
        sam/drivers/uart                                    \
        sam/drivers/usart                                   \
        sam/drivers/wdt                                     \
+       sam/services/flash_efc                              \
        sam/utils/cmsis/$(PART_BASE)/source/templates       \
        sam/utils/cmsis/$(PART_BASE)/source/templates/gcc
 
@@ -199,7 +203,9 @@ ASF_INCLUDE = \
        sam/boards/$(ASF_FOLDER)                            \
        sam/boards/$(ASF_FOLDER)/board_config               \
        sam/drivers/adc                                     \
+       sam/drivers/dmac                                    \
        sam/drivers/efc                                     \
+       sam/drivers/pdc                                     \
        sam/drivers/pio                                     \
        sam/drivers/pmc                                     \
        sam/drivers/spi                                     \
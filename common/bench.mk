@@ -0,0 +1,45 @@
+# Kernel Benchmark Makefile
+# Mini-disclaimer: This file was not developed or endorsed by Atmel.
+
+# List of phony commands
+.PHONY: bench host-bench
+
+#-----------------------------------------------------------------------------------
+# 'make bench' runs the kernel benchmarks in lib/Services/rtos_bench.cpp on the
+# board and saves their results; 'make host-bench' does the same with the host
+# build (see common/host.mk). The project must run the benchmarks itself, as
+# projects/ex08_frt_bench_cpp does. Include this after common.mk and host.mk:
+#     include common/common.mk
+#     include common/host.mk
+#     include common/bench.mk
+#
+# The results are saved, one comma separated line each, to $(TARGET)_bench.csv or
+# $(TARGET)_host_bench.csv by tools/bench_capture.py, which needs pyserial to read
+# the board. Keep a copy of a file and give it as BENCH_BASELINE to have the next
+# run compared with it, which fails if any result got more than BENCH_THRESHOLD
+# percent slower:
+#     make bench BENCH_BASELINE=v8.0.1_bench.csv
+#-----------------------------------------------------------------------------------
+
+# BENCH_PORT:      The board's serial port, as for 'make putty'.
+# BENCH_BASELINE:  An earlier results file to compare with, or empty.
+# BENCH_THRESHOLD: The slowdown, in percent, counted as a regression.
+#
+BENCH_PORT ?= /dev/ttyACM0
+BENCH_BASELINE ?=
+BENCH_THRESHOLD ?= 10
+
+bench_flags = $(if $(BENCH_BASELINE), --compare $(BENCH_BASELINE)) \
+       --threshold $(BENCH_THRESHOLD)
+
+#-----------------------------------------------------------------------------------
+# 'make bench', 'make host-bench'
+#-----------------------------------------------------------------------------------
+# Uploading resets the board, and the benchmarks start a second later, so the
+# console is opened straight after bossac is done.
+#
+bench: install
+	python3 tools/bench_capture.py --port $(BENCH_PORT) -o $(TARGET)_bench.csv $(bench_flags)
+
+host-bench: host
+	./$(HOST_TARGET) | python3 tools/bench_capture.py -o $(TARGET)_host_bench.csv $(bench_flags)
@@ -1,7 +1,75 @@
 # Common ARM Makefile
 
 # List of phony commands
-.PHONY: all library clean install putty
+.PHONY: all library clean install putty FORCE
+
+#-----------------------------------------------------------------------------------
+# Build Directories
+#-----------------------------------------------------------------------------------
+# Every object, dependency and library file, and the .elf and .bin files, are
+# built out of the source tree, under a directory for the project and its
+# configuration, so several projects and configurations can share one tree:
+#
+# BUILD_ROOT:   The directory that holds every project's build directory.
+# BUILD_CONFIG: A name for the configuration being built; the BUILD_PROFILE below
+#                unless it's given. Set it on the command line to keep builds with
+#                different settings apart, e.g.
+#                    make BUILD_CONFIG=heap4 HEAP_NUMBER=4
+#                builds in $(BUILD_ROOT)/$(TARGET)-heap4. Changing the settings
+#                without changing BUILD_CONFIG works too; everything in the build
+#                directory is rebuilt, as the compiler flags have changed.
+#
+BUILD_ROOT ?= build
+BUILD_CONFIG ?= $(BUILD_PROFILE)
+BUILD_DIR = $(BUILD_ROOT)/$(TARGET)$(if $(strip $(BUILD_CONFIG)),-$(BUILD_CONFIG))
+
+# The file recording the flags the build directory's contents were built with
+BUILD_FLAGS = $(BUILD_DIR)/build.flags
+
+# The object file in $(BUILD_DIR) for each source file given
+build_objs = $(addprefix $(BUILD_DIR)/,$(patsubst ./%,%,$(1)))
+
+#-----------------------------------------------------------------------------------
+# Build Profiles
+#-----------------------------------------------------------------------------------
+# BUILD_PROFILE: How the whole image, ASF and FreeRTOS as well as the project, is
+#                optimized. Leave it empty for the project's OPTIMIZATION, or set it
+#                on the command line to one of:
+#                    lto   the project's OPTIMIZATION, with link-time optimization
+#                    size  -Os, with link-time optimization, for the smallest image
+#                e.g. 'make BUILD_PROFILE=size', which builds in
+#                $(BUILD_ROOT)/$(TARGET)-size.
+#
+# LTO_EXCLUDE:   Sources which are compiled without link-time optimization. The
+#                FreeRTOS port is reached from its own inline assembly, where LTO
+#                can't see it, and the syscalls only from newlib, which is linked
+#                after LTO has decided what's unused. Heap 5 wraps _sbrk() for
+#                newlib, and --wrap doesn't reach into LTO's objects.
+#
+BUILD_PROFILE ?=
+
+ifneq ($(filter-out lto size,$(BUILD_PROFILE)),)
+$(error Unknown BUILD_PROFILE '$(BUILD_PROFILE)'; it can be lto, size or empty)
+endif
+
+ifeq ($(BUILD_PROFILE),size)
+OPTIMIZATION = -Os
+endif
+
+# The objects keep their own code as well (-ffat-lto-objects), so that the size
+# report below can tell which module the optimized code came from
+ifneq ($(BUILD_PROFILE),)
+LTO_FLAGS = -flto -ffat-lto-objects
+endif
+
+LTO_EXCLUDE = $(FRT_PORT) $(filter %/heap_5.c,$(FRT_HEAP)) \
+              $(foreach A_DIR, $(SYSCALL_DIRS), $(wildcard $(A_DIR)/*.c))
+
+# The link-time optimization flags for the file being built. This goes by $@ in
+# the recipes, rather than being a target-specific variable, so that build.flags
+# doesn't change with whichever object happens to be built first.
+lto_flags = $(if $(LTO_FLAGS),$(if $(filter $@,$(call build_objs, \
+              $(patsubst %.c,%.o,$(LTO_EXCLUDE)))),-fno-lto,$(LTO_FLAGS)))
 
 #-----------------------------------------------------------------------------------
 # Compiler Object/Flag Setup
@@ -10,10 +78,11 @@
 # This is the name of the library file which will hold object code which has been
 # compiled from all the source files in the library subdirectories
 #
-LIB_NAME = syslib.a
+LIB_NAME = $(BUILD_DIR)/syslib.a
 LIB_INCLUDE = $(FRT_INCLUDE) \
               $(addprefix $(ASF_PATH)/,$(ASF_INCLUDE)) \
-              $(SYSCALL_INCLUDE)
+              $(SYSCALL_INCLUDE) \
+              $(SERVICE_INCLUDE)
 CMSIS_LIB = $(addprefix $(ASF_PATH)/$(LIB_PATH)/,$(CMSIS_LIBS))
 
 # Populate the C compiler flags with includes for all relevant directories
@@ -44,13 +113,17 @@ PROJ_SRCS =  \
            
 PROJ_SRC  = $(filter-out lib/ASF/sam/applications/getting-started/main_sam4l.c,$(PROJ_SRCS))
 
-PROJ_SRC += $(FRT_HEAP) $(FRT_PORT)
+PROJ_SRC += $(FRT_HEAP) $(FRT_PORT) $(SERVICE_SRC)
 
-PROJ_OBJS = \
+PROJ_OBJS = $(call build_objs, \
            $(patsubst %.cpp, %.o, $(filter %.cpp, $(PROJ_SRC))) \
            $(patsubst %.cc, %.o, $(filter %.cc, $(PROJ_SRC))) \
            $(patsubst %.c, %.o, $(filter %.c, $(PROJ_SRC))) \
-           $(PROJ_ASRC:.S=.o)
+           $(PROJ_ASRC:.S=.o))
+
+# The objects which go into the library: FreeRTOS (if it's used) and ASF
+#
+LIB_OBJS = $(call build_objs, $(FRT_OBJS) $(ASF_LIB_OBJS))
 
 #FRT_DIRS += $(FRT_HEAP_DIR) $(FRT_PORT_DIR)
            
@@ -68,6 +141,12 @@ OBJDUMP         := $(CROSS)objdump
 SIZE            := $(CROSS)size
 GDB             := $(CROSS)gdb
 
+# With link-time optimization, the library needs the symbol index which only the
+# archiver with GCC's plugin can make
+ifneq ($(LTO_FLAGS),)
+AR              := $(CROSS)gcc-ar
+endif
+
 # This section is mostly just taken from the massive default SAM makefile 
 # provided by Atmel in their software framework at /sam/utils/make/Makefile.sam.in
 # This bit takes all the previously defined flags and stuffs them into
@@ -90,7 +169,7 @@ flashflags-gnu-y        :=
 #ldflags-gnu-y   += -pipe
 
 ##########NEWSTUFF
-target          = $(TARGET_FLASH)
+target          = $(BUILD_DIR)/$(TARGET_FLASH)
 linker_script   = $(ASF_PATH)/$(LINKER_SCRIPT_FLASH)
 debug_script    = $(ASF_PATH)/$(DEBUG_SCRIPT_FLASH)
 target_type     = elf
@@ -98,12 +177,12 @@ target_type     = elf
 
 # Create object files list from source files list.
 obj-y    = $(PROJ_OBJS)
-# Create dependency files list from source files list.
-dep-files  = $(wildcard $(foreach f,$(obj-y),$(basename $(f)).d))
+# Create dependency files list from source files list, for the library too.
+dep-files  = $(wildcard $(foreach f,$(obj-y) $(LIB_OBJS),$(basename $(f)).d))
 
 ####################
 
-optflags-gnu-y  = $(OPTIMIZATION)
+optflags-gnu-y  = $(OPTIMIZATION) $(lto_flags)
 
 # Archiver flags
 # NOTE: This is changed slightly from the default SAM Makefile to give the library a
@@ -129,8 +208,22 @@ depflags        = -MD -MP -MQ $@
 asflags-gnu-y   += -x assembler-with-cpp
 # Compile C files using the GNU99 standard.
 cflags-gnu-y    += -std=gnu99
-# Compile C++ files using the GNU++98 standard.
-cxxflags-gnu-y  += -std=gnu++98
+# Compile C++ files using the standard the project gives as CXX_STANDARD, or the
+# GNU++98 standard if it doesn't give one.
+CXX_STANDARD ?= gnu++98
+cxxflags-gnu-y  += -std=$(CXX_STANDARD)
+# C++ exceptions and run-time type information are compiled in unless the project
+# sets CXX_EXCEPTIONS or CXX_RTTI to 0. Nothing in lib needs either, and without
+# them the image loses its unwinding tables and the typeinfo of every class with
+# virtual functions.
+CXX_EXCEPTIONS ?= 1
+CXX_RTTI ?= 1
+ifeq ($(CXX_EXCEPTIONS),0)
+cxxflags-gnu-y  += -fno-exceptions
+endif
+ifeq ($(CXX_RTTI),0)
+cxxflags-gnu-y  += -fno-rtti
+endif
 
 # Don't use strict aliasing (very common in embedded applications).
 cflags-gnu-y    += -fno-strict-aliasing
@@ -167,8 +260,15 @@ cppflags-gnu-y += --param max-inline-insns-single=500
 # To reduce application size use only integer printf function.
 cppflags-gnu-y += -Dprintf=iprintf
 
-# Garbage collect unreferred sections when linking.
+# Garbage collect unreferred sections when linking. With link-time optimization
+# the code is compiled again here, so it needs the section flags as well.
 ldflags-gnu-y   += -Wl,--gc-sections
+ifneq ($(LTO_FLAGS),)
+ldflags-gnu-y   += -ffunction-sections -fdata-sections
+endif
+
+# Write a map of where everything went, for the size report.
+ldflags-gnu-y   += -Wl,-Map=$(target).map
 
 # Use the linker script if provided by the project.
 ifneq ($(strip $(linker_script)),)
@@ -203,23 +303,33 @@ ar_flags = $(arflags-gnu-y)
 # Inference Rules 
 #  Show how to process each kind of file
 #-----------------------------------------------------------------------------------
+# Each object goes into $(BUILD_DIR), under the same path as its source file. Each
+# also depends on $(BUILD_FLAGS), so that changing the flags rebuilds everything,
+# and the dependency files the compiler writes beside the objects are included
+# below, so that changing a header rebuilds whatever includes it. Every rule makes
+# its own directory, so they can all run at once under 'make -j'.
+#
 # How to compile a .c file into a .o file
-.c.o:
+$(BUILD_DIR)/%.o: %.c $(BUILD_FLAGS)
+	@mkdir -p $(@D)
 	@echo $<
 	@$(CC) -x c $(c_flags) $< -o $@
 
 # How to compile a .cc file into a .o file
-.cc.o:
+$(BUILD_DIR)/%.o: %.cc $(BUILD_FLAGS)
+	@mkdir -p $(@D)
 	@echo $<
 	@$(CXX) -x none $(cxx_flags) $< -o $@
 
 # How to compile a .cpp file into a .o file
-.cpp.o:
+$(BUILD_DIR)/%.o: %.cpp $(BUILD_FLAGS)
+	@mkdir -p $(@D)
 	@echo $<
 	@$(CPP) -x c++ $(cxx_flags) $< -o $@
 
 # How to compile an .S file into a .o file
-.S.o:
+$(BUILD_DIR)/%.o: %.S $(BUILD_FLAGS)
+	@mkdir -p $(@D)
 	@echo $<
 	@$(CC) $(a_flags) -c $< -o $@
 
@@ -230,7 +340,7 @@ ar_flags = $(arflags-gnu-y)
 # Make the main target of this project.  This target is invoked when the user types 
 # 'make' as opposed to 'make <target>'  This must be the first target in Makefile.
 #
-all: library $(target).elf $(target).bin
+all: $(target).elf $(target).bin
 
 #$(target).elf: $(linker_script) $(obj-y)
 #	@echo $(linker_script)
@@ -240,7 +350,7 @@ all: library $(target).elf $(target).bin
 #	$(SIZE) -Ax $@
 #	$(SIZE) -Bx $@
 	
-$(target).elf:  $(PROJ_OBJS)
+$(target).elf:  $(PROJ_OBJS) $(LIB_NAME)
 	$(LD) $(startgroup-gnu-y) $(resetgroup-gnu-y) $(l_flags) $(PROJ_OBJS) $(LIB_NAME) $(libflags-gnu-y) $(endgroup-gnu-y) -g -o $@
 	@echo size
 	@$(SIZE) -Bx $@
@@ -249,20 +359,110 @@ $(target).elf:  $(PROJ_OBJS)
 #	@$(LD) $(l_flags) $(PROJ_OBJS) $(LIB_NAME) $(libflags-gnu-y) -o $@
 
 # Create binary image from ELF output file.
-$(target).bin:
+$(target).bin: $(target).elf
 	@echo Making bin
-	$(OBJCOPY) -O binary $(target).elf $@
+	$(OBJCOPY) -O binary $< $@
+
+#-----------------------------------------------------------------------------------
+# Size Report
+#-----------------------------------------------------------------------------------
+# After linking, tools/size_report.py can print the flash and RAM the image uses,
+# by module, from the linker's map file, and save the table in $(target).size.
+# Only the objects are listed here; everything else is the toolchain's or the
+# linker's.
+#
+# SIZE_REPORT: Set to 1 to run the report after every link, e.g.
+#               'make SIZE_REPORT=1'. It is on by default for the lto and size
+#               profiles, and whenever SIZE_BUDGET is set, since that can't be
+#               checked without it; otherwise 'make' only prints the totals.
+#
+# SIZE_BUDGET: Limits on the sizes, which fail the build when they're exceeded, or
+#               empty. Each is <memory>=<bytes>, or <module>.<memory>=<bytes> for
+#               one module, where <memory> is flash or ram and the bytes may end in
+#               K, e.g. in the project Makefile:
+#                   SIZE_BUDGET = flash=256K ram=64K freertos.ram=40K
+#               The build fails until the image fits, or the budget is raised; the
+#               .elf and .bin are left as they are, but aren't installed.
+#
+SIZE_BUDGET ?=
+SIZE_STAMP = $(BUILD_DIR)/size.budget
+
+ifneq ($(BUILD_PROFILE)$(strip $(SIZE_BUDGET)),)
+SIZE_REPORT ?= 1
+endif
+SIZE_REPORT ?= 0
+
+ifeq ($(SIZE_REPORT),1)
+all: $(target).size
+endif
+
+size_freertos = $(call build_objs, $(FRT_OBJS) $(patsubst %.c,%.o,$(FRT_HEAP) $(FRT_PORT)))
+size_syscalls = $(call build_objs, \
+              $(patsubst %.c,%.o,$(foreach A_DIR, $(SYSCALL_DIRS), $(wildcard $(A_DIR)/*.c))))
+size_services = $(call build_objs, \
+              $(patsubst %.c,%.o,$(patsubst %.cpp,%.o,$(SERVICE_SRC))))
+size_asf      = $(call build_objs, $(ASF_LIB_OBJS))
+size_app      = $(filter-out $(size_freertos) $(size_syscalls) $(size_services) \
+              $(size_asf), $(PROJ_OBJS))
+
+size_flags = --library $(LIB_NAME) \
+             --module app $(size_app) \
+             --module services $(size_services) \
+             --module freertos $(size_freertos) \
+             --module syscalls $(size_syscalls) \
+             --module asf $(size_asf) \
+             $(addprefix --budget ,$(SIZE_BUDGET))
+
+$(target).size: $(target).elf $(SIZE_STAMP)
+	@python3 tools/size_report.py $< $(size_flags) -o $@
+
+$(SIZE_STAMP): FORCE
+	$(call update_file,$(SIZE_BUDGET))
 
 #-----------------------------------------------------------------------------------
 # 'make library' 
 #-----------------------------------------------------------------------------------
 # Builds the library file, using an automatically generated list of
 # all the C, C++, and assembly source files in the library files 
-# listed in $(ASF_FILES) and $(FRT_FILES)
+# listed in $(ASF_FILES) and $(FRT_FILES). The library is made afresh whenever
+# one of its objects changes, or the list of them does, so that objects which are
+# no longer built (another heap, say) don't linger in it.
 #
-library:  $(FRT_OBJS) $(ASF_LIB_OBJS)
-	$(AR) r $(ar_flags) $(FRT_OBJS) $(ASF_LIB_OBJS)
-	
+LIB_STAMP = $(BUILD_DIR)/syslib.objs
+
+library: $(LIB_NAME)
+
+$(LIB_NAME): $(LIB_OBJS) $(LIB_STAMP)
+	@rm -f $@
+	$(AR) rcs $(ar_flags) $(LIB_OBJS)
+
+$(LIB_STAMP): FORCE
+	$(call update_file,$(LIB_OBJS))
+
+#-----------------------------------------------------------------------------------
+# Compiler Flags
+#-----------------------------------------------------------------------------------
+# $(BUILD_FLAGS) holds the tools and flags everything in $(BUILD_DIR) was built
+# with. It is checked on every run, but only written when they have changed, so
+# that it only makes the objects out of date when they really are.
+#
+# Recipe which writes the text given to the target, unless the target holds it
+define update_file
+	@mkdir -p $(@D)
+	@echo '$(subst ','\'',$(1))' > $@.new
+	@if cmp -s $@.new $@; then rm -f $@.new; else mv -f $@.new $@; fi
+endef
+
+build_flags = $(CC) $(c_flags) $(CXX) $(cxx_flags) $(a_flags) $(LD) $(l_flags) \
+              $(libflags-gnu-y) $(AR) $(ar_flags)
+
+$(BUILD_FLAGS): FORCE
+	$(call update_file,$(build_flags))
+
+FORCE:
+
+-include $(dep-files)
+
 #-----------------------------------------------------------------------------------
 # 'make install' 
 #-----------------------------------------------------------------------------------
@@ -282,50 +482,12 @@ install:  all
 # 'make clean' 
 #-----------------------------------------------------------------------------------
 # Erases the compiled files so you can restart the building process
-# from a clean slate. It's also useful before committing files to a CVS or SVN 
-# or Git repository.
+# from a clean slate. Only this project's build directory, for the configuration
+# given by BUILD_CONFIG, is removed; other projects' builds are left alone.
 #
 clean:
-@echo -n Cleaning up the Project build files...
-	@for subdir in $(PROJ_DIRS); do \
-		rm -f $$subdir/*.o; \
-		rm -f $$subdir/*.d; \
-		rm -f $$subdir/*.lst; \
-		rm -f $$subdir/*~; \
-	done
-	@echo done.
-	
-	@echo -n Cleaning up the ASF library build files...
-	@rm -f $(ASF_LIB_NAME) *.o *.d *.hex *.lst *.elf *.bin *~
-	@for subdir in $(ASF_CLEAN); do \
-		rm -f $$subdir/*.o; \
-		rm -f $$subdir/*.d; \
-		rm -f $$subdir/*.lst; \
-		rm -f $$subdir/*~; \
-	done
-	@echo done.
-	
-	@echo -n Cleaning up the FreeRTOS library build files...
-	@rm -f $(FRT_LIB_NAME) *.d *.o *.hex *.lst *.elf *.bin *~
-	@for subdir in $(FRT_DIRS); do \
-		rm -f $$subdir/*.o; \
-		rm -f $$subdir/*.d; \
-		rm -f $$subdir/*.lst; \
-		rm -f $$subdir/*~; \
-	done
-	@echo done.
-	
-	@echo -n Cleaning up syscall build files...
-	@for subdir in $(SYSCALL_DIRS); do \
-		rm -f $$subdir/*.o; \
-		rm -f $$subdir/*.d; \
-		rm -f $$subdir/*.lst; \
-		rm -f $$subdir/*~; \
-	done
-	@echo done.
-	
-	@echo -n Removing the system library...
-	@rm -f $(LIB_NAME)
+	@echo -n Cleaning up the build files in $(BUILD_DIR)...
+	@rm -rf $(BUILD_DIR)
 	@echo done.
 	
 #-----------------------------------------------------------------------------------
@@ -33,10 +33,38 @@ FRT_CONF_PATH = lib/FreeRTOS_Config
 #                $(ASF_PATH)/common/boards/$(ASF_FOLDER) -
 #                see below for information on $(ASF_FOLDER)
 #
+# HEAP_NUMBER:  Which FreeRTOS heap implementation to link in, 1 to 5, normally set
+#                in the project Makefile; 2 if it isn't. Heaps 1 to 4 come from
+#                $(FRT_PATH)/Source/portable/MemMang. Heap 5 comes from
+#                $(FRT_HEAP5_PATH) and spreads the heap over both SRAM banks;
+#                newlib's _sbrk() is then wrapped so that its malloc() can't grow
+#                into them (see heap_5.c).
+#                lib/FreeRTOS_Config/FreeRTOSHeap.h describes each heap. The
+#                number is also passed to the compiler as configHEAP_NUMBER, so
+#                changing it rebuilds everything (see BUILD_CONFIG in common.mk).
+#
+# TICKLESS_IDLE: Set to 1 in the project Makefile to let the idle task stop the
+#                tick and sleep (see FreeRTOSConfig.h); 0 if it isn't set. It is
+#                passed to the compiler as configUSE_TICKLESS_IDLE.
+#
+# RUN_TIME_STATS: Set to 1 in the project Makefile to charge CPU cycles to tasks
+#                from the kernel's trace hooks (see FreeRTOSStats.h); 0 if it isn't
+#                set. The hooks run on every tick and context switch, so leave it
+#                off unless the project prints the statistics. It is passed to the
+#                compiler as configGENERATE_RUN_TIME_STATS.
+#
 PORTABLE = ARM_CM3
-HEAP_NUMBER = 2
+HEAP_NUMBER ?= 2
+TICKLESS_IDLE ?= 0
+RUN_TIME_STATS ?= 0
 FRT_HEAP_DIR = $(FRT_PATH)/Source/portable/MemMang
+FRT_HEAP5_PATH = lib/FreeRTOS_Heap
+ifeq ($(HEAP_NUMBER),5)
+FRT_HEAP = $(FRT_HEAP5_PATH)/heap_5.c
+LDFLAGS += -Wl,--wrap=_sbrk
+else
 FRT_HEAP = $(FRT_HEAP_DIR)/heap_$(HEAP_NUMBER).c
+endif
 FRT_PORT_DIR = $(FRT_PATH)/Source/portable/GCC/$(PORTABLE)
 FRT_PORT = $(FRT_PORT_DIR)/port.c
 
@@ -147,6 +175,13 @@ FRT_LIB_NAME = freertoslib.a
 #
 CFLAGS += $(patsubst %,-I%,$(FRT_INCLUDE))
 
+# Tell the heap telemetry in $(FRT_CONF_PATH) which heap it's looking at, and the
+# kernel whether to idle tickless and whether to gather run time statistics
+#
+CPPFLAGS += -D configHEAP_NUMBER=$(HEAP_NUMBER)
+CPPFLAGS += -D configUSE_TICKLESS_IDLE=$(TICKLESS_IDLE)
+CPPFLAGS += -D configGENERATE_RUN_TIME_STATS=$(RUN_TIME_STATS)
+
 # This section makes a list of object files from the source files in subdirectories
 # in the FRT_OBJS list, separating the C++, C, and assembly source files
 #
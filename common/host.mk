@@ -0,0 +1,243 @@
+# Host Simulation Makefile
+# Mini-disclaimer: This file was not developed or endorsed by Atmel.
+
+# List of phony commands
+.PHONY: host host-run host-test host-clean
+
+#-----------------------------------------------------------------------------------
+# 'make host' builds the project as a program for the PC it's run on, so that it
+# can be run, profiled with perf, checked with valgrind or built with sanitizers
+# without a board. The project's own sources, the FreeRTOS configuration files and
+# the services are compiled unchanged. FreeRTOS is the POSIX port, which runs each
+# task as a thread, and ASF is replaced by the stand-ins in lib/Host (see
+# lib/Host/asf_host.h), which model just enough of the UART, ADC, SPI, DMA and
+# I2C controllers for the services that drive them to run. Only FreeRTOS projects
+# can be built this way.
+#
+# Include this after common.mk in the project Makefile, so that 'make' on its own
+# still builds for the board:
+#     include common/common.mk
+#     include common/host.mk
+#
+# Then, from the project root:
+#     make host                                   builds build/<target>/host/<target>_host
+#     make host-run                               builds and runs it
+#     make host-test                              builds and runs the tests in tests/host
+#     make host HOST_SANITIZE=address,undefined   builds with sanitizers
+#     valgrind ./build/<target>/host/<target>_host
+#     perf record -g ./build/<target>/host/<target>_host
+# The program runs until it's stopped with Ctrl-C, or for HOST_RUN_MS milliseconds
+# if that is set in the environment, which suits profilers and leak checkers best.
+# HOST_TRACE_PINS in the environment prints each change to an output pin.
+#-----------------------------------------------------------------------------------
+
+#-----------------------------------------------------------------------------------
+# FreeRTOS Location
+#-----------------------------------------------------------------------------------
+# FRT_HOST_PATH: The FreeRTOS kernel to build for the host. The kernel in
+#            lib/FreeRTOS (V8.0.1) has no POSIX port, so this must be a separate
+#            copy of a later one which has portable/ThirdParty/GCC/Posix, such as
+#            a FreeRTOS-Kernel V10.4 release (V11 changed the static allocation
+#            hooks in FreeRTOSHooks.c). Put it in lib/FreeRTOS_Host, or point this
+#            at it on the command line. With a later kernel, task notifications
+#            are available, so FRT_TASK_NOTIFICATIONS is 1 in the host build.
+#
+FRT_HOST_PATH ?= lib/FreeRTOS_Host
+FRT_HOST_PORT = $(FRT_HOST_PATH)/portable/ThirdParty/GCC/Posix
+
+#-----------------------------------------------------------------------------------
+# Host Compiler Setup
+#-----------------------------------------------------------------------------------
+# HOST_CC, HOST_CXX: The host's C and C++ compilers.
+# HOST_OPT:      Optimization and debugging flags.
+# HOST_ARCH:     Extra flags for the target architecture. Pointers and longs are 64
+#                bits on most PCs but 32 on the board; set this to -m32 (which
+#                needs the compiler's multilib support) to match the board.
+# HOST_SANITIZE: Sanitizers to build with, as given to -fsanitize=, or empty.
+#
+HOST_CC ?= gcc
+HOST_CXX ?= g++
+HOST_AR ?= ar
+HOST_OPT ?= -O1 -g
+HOST_ARCH ?=
+HOST_SANITIZE ?=
+
+HOST_BUILD_DIR = $(BUILD_DIR)/host
+HOST_TARGET = $(HOST_BUILD_DIR)/$(TARGET)_host
+HOST_PATH = lib/Host
+
+# The file recording the flags the host objects were built with
+HOST_FLAGS = $(HOST_BUILD_DIR)/host.flags
+
+# The heap the program is built with, and the one the tests are built with
+HOST_HEAP = 3
+HOST_TEST_HEAP = 4
+
+# The tests, and where they are built
+HOST_TEST_PATH = tests/host
+HOST_TEST_DIR = $(HOST_BUILD_DIR)/test
+HOST_TEST_FLAGS = $(HOST_TEST_DIR)/test.flags
+
+#-----------------------------------------------------------------------------------
+# Host Source Files
+# You REALLY Shouldn't Need to Change Anything Below Here
+#-----------------------------------------------------------------------------------
+# The project sources, without the newlib syscalls; the FreeRTOS configuration
+# files; the services; the kernel and its POSIX port; and the ASF and CMSIS-DSP
+# stand-ins. heap_3 passes allocations on to the C library's malloc(), where
+# valgrind and the sanitizers can see them.
+#
+HOST_PROJ_SRC = \
+       $(foreach A_DIR, $(filter-out $(SYSCALL_DIRS), $(PROJ_DIRS)), \
+              $(wildcard $(A_DIR)/*.cpp) $(wildcard $(A_DIR)/*.c))
+
+HOST_SERVICE_SRC = $(SERVICE_SRC)
+
+HOST_FRT_SRC = \
+       $(wildcard $(FRT_HOST_PATH)/*.c) \
+       $(FRT_HOST_PORT)/port.c \
+       $(FRT_HOST_PORT)/utils/wait_for_event.c \
+       $(wildcard $(FRT_CONF_PATH)/*.c)
+
+HOST_SRC = $(HOST_PROJ_SRC) $(HOST_SERVICE_SRC) $(HOST_FRT_SRC) \
+       $(FRT_HOST_PATH)/portable/MemMang/heap_$(HOST_HEAP).c \
+       $(HOST_PATH)/asf_host.c $(HOST_PATH)/arm_math_host.c
+
+HOST_OBJS = $(addprefix $(HOST_BUILD_DIR)/, $(patsubst ./%,%, \
+       $(patsubst %.cpp, %.o, $(filter %.cpp, $(HOST_SRC))) \
+       $(patsubst %.c, %.o, $(filter %.c, $(HOST_SRC)))))
+
+#-----------------------------------------------------------------------------------
+# Host Compiler Flags
+#-----------------------------------------------------------------------------------
+# lib/Host comes first, so that its FreeRTOSConfig.h and the ASF stand-ins in
+# lib/Host/asf are found before anything else. The project's own -D options are
+# passed on, apart from the heap number. printf() and puts() are renamed, as
+# iprintf() is on the board, to the host versions which keep tasks from being
+# switched out while they hold the C library's lock on stdout; fortified stdio
+# would bypass the renaming, so it is turned off.
+#
+HOST_INCLUDE = \
+       $(HOST_PATH) \
+       $(HOST_PATH)/asf \
+       $(FRT_HOST_PATH)/include \
+       $(FRT_HOST_PORT) \
+       $(FRT_CONF_PATH) \
+       $(ASF_CONFIG) \
+       $(SERVICE_INCLUDE) \
+       .
+
+HOST_DEFINES = \
+       -D _HOST_BUILD_ -D _USE_FREERTOS_ -D configHEAP_NUMBER=$(HOST_HEAP) \
+       -U_FORTIFY_SOURCE -Dprintf=host_printf -Dputs=host_puts \
+       $(filter-out -DconfigHEAP_NUMBER=%, $(filter -D%, $(subst -D ,-D,$(CPPFLAGS))))
+
+ifneq ($(strip $(HOST_SANITIZE)),)
+HOST_SANFLAGS = -fsanitize=$(HOST_SANITIZE) -fno-omit-frame-pointer
+endif
+
+host_flags = $(HOST_OPT) $(HOST_ARCH) $(HOST_SANFLAGS) $(HOST_DEFINES) \
+       $(patsubst %,-I%,$(HOST_INCLUDE)) -Wall -fno-strict-aliasing -MD -MP
+host_c_flags = $(host_flags) $(filter -std=%, $(cflags-gnu-y))
+host_cxx_flags = $(host_flags) $(filter -std=%, $(cxxflags-gnu-y))
+host_l_flags = $(HOST_ARCH) $(HOST_SANFLAGS) -pthread -lm
+
+# Check for the kernel before anything is built, rather than failing on its headers
+ifneq ($(filter host host-run host-test, $(MAKECMDGOALS)),)
+ifeq ($(wildcard $(FRT_HOST_PORT)/port.c),)
+$(error No FreeRTOS kernel with the POSIX port in FRT_HOST_PATH ($(FRT_HOST_PATH)); see common/host.mk)
+endif
+endif
+
+#-----------------------------------------------------------------------------------
+# Host Rules
+#-----------------------------------------------------------------------------------
+# Objects go under $(HOST_BUILD_DIR), inside the board's build directory but apart
+# from the board's own objects. As there, each depends on $(HOST_FLAGS), so that
+# changing the host compiler or its flags rebuilds them all.
+#
+$(HOST_BUILD_DIR)/%.o: %.c $(HOST_FLAGS)
+	@mkdir -p $(@D)
+	@echo $<
+	@$(HOST_CC) -c -x c $(host_c_flags) $< -o $@
+
+$(HOST_BUILD_DIR)/%.o: %.cpp $(HOST_FLAGS)
+	@mkdir -p $(@D)
+	@echo $<
+	@$(HOST_CXX) -c -x c++ $(host_cxx_flags) $< -o $@
+
+$(HOST_FLAGS): FORCE
+	$(call update_file,$(HOST_CC) $(host_c_flags) $(HOST_CXX) $(host_cxx_flags) $(host_l_flags))
+
+-include $(HOST_OBJS:.o=.d)
+
+#-----------------------------------------------------------------------------------
+# Host Tests
+#-----------------------------------------------------------------------------------
+# Each *_test.c or *_test.cpp in $(HOST_TEST_PATH) is a program of its own, which
+# exits with 0 if everything it checks holds. The tests don't use the project's
+# sources. They're linked with an archive of every service, the kernel and the
+# stand-ins, from which the linker takes only what a test calls, so the services
+# a project leaves out of SERVICES can't get in the way. pool_new is left out, as
+# it would take over operator new in any test that used new. They are built with
+# heap_4, which counts its free bytes, and in a directory of their own, so the
+# different heap doesn't touch the program's objects.
+#
+HOST_TEST_SRC = $(wildcard $(HOST_TEST_PATH)/*_test.c $(HOST_TEST_PATH)/*_test.cpp)
+HOST_TESTS = $(addprefix $(HOST_TEST_DIR)/, $(basename $(notdir $(HOST_TEST_SRC))))
+HOST_TEST_OBJS = $(addprefix $(HOST_TEST_DIR)/, $(addsuffix .o, $(basename $(HOST_TEST_SRC))))
+
+HOST_TEST_LIB = $(HOST_TEST_DIR)/libhost_test.a
+HOST_TEST_LIB_SRC = \
+       $(filter-out %/pool_new.cpp, $(wildcard $(SERVICE_PATH)/*.c $(SERVICE_PATH)/*.cpp)) \
+       $(HOST_FRT_SRC) \
+       $(FRT_HOST_PATH)/portable/MemMang/heap_$(HOST_TEST_HEAP).c \
+       $(HOST_PATH)/asf_host.c $(HOST_PATH)/arm_math_host.c
+
+HOST_TEST_LIB_OBJS = $(addprefix $(HOST_TEST_DIR)/, $(patsubst ./%,%, \
+       $(patsubst %.cpp, %.o, $(filter %.cpp, $(HOST_TEST_LIB_SRC))) \
+       $(patsubst %.c, %.o, $(filter %.c, $(HOST_TEST_LIB_SRC)))))
+
+$(HOST_TEST_DIR)/%: HOST_HEAP = $(HOST_TEST_HEAP)
+
+$(HOST_TEST_DIR)/%.o: %.c $(HOST_TEST_FLAGS)
+	@mkdir -p $(@D)
+	@echo $<
+	@$(HOST_CC) -c -x c $(host_c_flags) $< -o $@
+
+$(HOST_TEST_DIR)/%.o: %.cpp $(HOST_TEST_FLAGS)
+	@mkdir -p $(@D)
+	@echo $<
+	@$(HOST_CXX) -c -x c++ $(host_cxx_flags) $< -o $@
+
+$(HOST_TEST_FLAGS): FORCE
+	$(call update_file,$(HOST_CC) $(host_c_flags) $(HOST_CXX) $(host_cxx_flags) $(host_l_flags))
+
+$(HOST_TEST_LIB): $(HOST_TEST_LIB_OBJS)
+	@rm -f $@
+	@$(HOST_AR) rcs $@ $^
+
+$(HOST_TESTS): $(HOST_TEST_DIR)/%: $(HOST_TEST_DIR)/$(HOST_TEST_PATH)/%.o $(HOST_TEST_LIB)
+	$(HOST_CXX) $^ $(host_l_flags) -o $@
+
+-include $(HOST_TEST_LIB_OBJS:.o=.d) $(HOST_TEST_OBJS:.o=.d)
+
+#-----------------------------------------------------------------------------------
+# 'make host', 'make host-run', 'make host-test', 'make host-clean'
+#-----------------------------------------------------------------------------------
+host: $(HOST_TARGET)
+
+$(HOST_TARGET): $(HOST_OBJS)
+	$(HOST_CXX) $(HOST_OBJS) $(host_l_flags) -o $@
+
+host-run: host
+	./$(HOST_TARGET)
+
+# Runs each test in turn, stopping at the first to fail
+host-test: $(HOST_TESTS)
+	@for test in $(HOST_TESTS); do echo ./$$test; ./$$test || exit 1; done
+
+host-clean:
+	@echo -n Cleaning up the host build files...
+	@rm -rf $(HOST_BUILD_DIR)
+	@echo done.
@@ -0,0 +1,49 @@
+# Services Makefile
+# Mini-disclaimer: This file was not developed or endorsed by Atmel.
+
+# List of phony commands
+.PHONY: all library clean
+
+#-----------------------------------------------------------------------------------
+# Services Location
+#-----------------------------------------------------------------------------------
+# SERVICE_PATH: Path to the directory holding the Altrino Due services (drivers and
+#            utilities built on top of ASF) relative to this project directory.
+#            Unless you mess around with the directories, because this is located
+#            in the $(PROJECT_ROOT)/common directory, the path here should be left 
+#            as:    lib/Services
+#
+SERVICE_PATH = lib/Services
+
+#-----------------------------------------------------------------------------------
+# Service File Locations
+#-----------------------------------------------------------------------------------
+# SERVICES:     The services a project wants built, set in the project Makefile
+#                before this file is included. Each name is the base name of a
+#                source file in $(SERVICE_PATH), so, for example, 
+#                    SERVICES = console
+#                builds $(SERVICE_PATH)/console.c into the project. A service
+#                written in C++ is a .cpp file instead. Services are
+#                opt-in because several of them install interrupt handlers or
+#                replace newlib hooks, which a project may not want.
+#                Header-only helpers in $(SERVICE_PATH) don't need to be listed.
+#
+# SERVICE_INCLUDE: The directories containing files that need to be included for
+#                compiling the services and the projects that use them.
+#
+SERVICE_SRC = $(foreach A_SRV, $(SERVICES), $(wildcard $(SERVICE_PATH)/$(A_SRV).c)) \
+              $(foreach A_SRV, $(SERVICES), $(wildcard $(SERVICE_PATH)/$(A_SRV).cpp))
+
+SERVICE_DIRS = \
+       $(SERVICE_PATH)
+
+SERVICE_INCLUDE = \
+       $(SERVICE_PATH)
+
+#-----------------------------------------------------------------------------------
+# Compiler Object/Flag Setup
+# You REALLY Shouldn't Need to Change Anything Below Here
+#-----------------------------------------------------------------------------------
+# Populate the C compiler flags with includes for all relevant directories
+#
+CFLAGS += $(patsubst %,-I%,$(SERVICE_INCLUDE))
@@ -75,12 +75,18 @@
 #include <pmc.h>
 #include <sleep.h>
 
+// From module: PDC - Peripheral DMA Controller
+#include <pdc.h>
+
 // From module: Part identification macros
 #include <parts.h>
 
 // From module: SAM3X startup code
 #include <exceptions.h>
 
+// From module: Sleep manager - SAM implementation
+#include <sleepmgr.h>
+
 // From module: Standard serial I/O (stdio) - SAM implementation
 #include <stdio_serial.h>
 
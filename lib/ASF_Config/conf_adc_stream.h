@@ -0,0 +1,37 @@
+/**
+ * \file
+ *
+ * \brief ADC streaming configuration.
+ *
+ * Settings for the streaming ADC service in lib/Services/adc_stream.c.
+ */
+
+#ifndef CONF_ADC_STREAM_H
+#define CONF_ADC_STREAM_H
+
+/** The timer counter channel whose TIOA output triggers each sequence. The ADC
+ *  can only be triggered by the three channels of TC0, and the examples use TC0
+ *  channel 0 for their 4 Hz tick, so the stream takes channel 1. The ID and
+ *  trigger must match the channel. */
+#define ADC_STREAM_TC				TC0
+#define ADC_STREAM_TC_CHANNEL		1
+#define ADC_STREAM_TC_ID			ID_TC1
+#define ADC_STREAM_TRIGGER			ADC_TRIG_TIO_CH_1
+
+/** Samples in each block handed to the callback. It is rounded down to a whole
+ *  number of sequences. Each sample takes 2 bytes. */
+#define ADC_STREAM_BLOCK_SAMPLES	512
+
+/** Number of block buffers, at least 3. Two are always loaded into the PDC; the
+ *  rest are waiting for, or being used by, the callback. */
+#define ADC_STREAM_BLOCKS			4
+
+/** NVIC priority of the ADC interrupt. If it's no more urgent than
+ *  configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY, the handler can wake the
+ *  stream's task. */
+#define ADC_STREAM_IRQ_PRIORITY		10
+
+/** Stack depth of the task that runs the callback, in words */
+#define ADC_STREAM_TASK_STACK_SIZE	(configMINIMAL_STACK_SIZE * 2)
+
+#endif /* CONF_ADC_STREAM_H */
@@ -0,0 +1,22 @@
+/**
+ * \file
+ *
+ * \brief Deferred binary logging configuration.
+ *
+ * Settings for the binary log service in lib/Services/binlog.c.
+ */
+
+#ifndef CONF_BINLOG_H
+#define CONF_BINLOG_H
+
+/** Size of the log record buffer, in 32-bit words. Must be a power of two. A record
+ *  takes three words plus one per argument. */
+#define BINLOG_BUFFER_WORDS			512
+
+/** How often the log task sends buffered records to the console, in milliseconds */
+#define BINLOG_DRAIN_PERIOD_MS		10
+
+/** Stack depth of the log task, in words */
+#define BINLOG_TASK_STACK_SIZE		configMINIMAL_STACK_SIZE
+
+#endif /* CONF_BINLOG_H */
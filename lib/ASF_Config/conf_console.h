@@ -0,0 +1,35 @@
+/**
+ * \file
+ *
+ * \brief Console service configuration.
+ *
+ * Settings for the interrupt-driven console in lib/Services/console.c. The UART
+ * itself (baud rate, framing) is still configured in conf_uart_serial.h.
+ */
+
+#ifndef CONF_CONSOLE_H
+#define CONF_CONSOLE_H
+
+/** Size of the RAM transmit ring, in bytes. Must be a power of two. At 115200
+ *  baud, 1024 bytes takes about 89 ms to drain. */
+#define CONSOLE_TX_BUFFER_SIZE		1024
+
+/** Largest number of bytes handed to the PDC in one transfer. Each transfer costs
+ *  one copy out of the ring and one ENDTX interrupt. */
+#define CONSOLE_DMA_CHUNK			64
+
+/** What console_write() does when the ring is full; one of CONSOLE_FULL_DROP,
+ *  CONSOLE_FULL_BLOCK or CONSOLE_FULL_OVERWRITE. Can be changed at run time with
+ *  console_set_policy(). */
+#define CONSOLE_FULL_POLICY_DEFAULT	CONSOLE_FULL_DROP
+
+/** NVIC priority of the console UART interrupt. Under FreeRTOS the handler wakes
+ *  blocked writers, so it must be no more urgent than
+ *  configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY; the lowest keeps it out of the way
+ *  of everything else. */
+#define CONSOLE_IRQ_PRIORITY		15
+
+/** Interrupt handler serving the console UART (CONF_UART). */
+#define CONSOLE_UART_Handler		UART_Handler
+
+#endif /* CONF_CONSOLE_H */
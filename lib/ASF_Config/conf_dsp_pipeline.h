@@ -0,0 +1,16 @@
+/**
+ * \file
+ *
+ * \brief DSP pipeline configuration.
+ *
+ * Settings for the signal processing pipeline in lib/Services/dsp_pipeline.c.
+ */
+
+#ifndef CONF_DSP_PIPELINE_H
+#define CONF_DSP_PIPELINE_H
+
+/** Stack depth of each pipeline task, in words. The stages keep their state in
+ *  buffers of their own, so the tasks need little more than printf() does. */
+#define DSP_PIPELINE_TASK_STACK_SIZE	(configMINIMAL_STACK_SIZE * 2)
+
+#endif /* CONF_DSP_PIPELINE_H */
@@ -0,0 +1,30 @@
+/**
+ * \file
+ *
+ * \brief Fault handler configuration.
+ *
+ * Settings for the crash dump service in lib/Services/fault.c.
+ */
+
+#ifndef CONF_FAULT_H
+#define CONF_FAULT_H
+
+/** Number of likely return addresses kept from the faulting stack */
+#define FAULT_BACKTRACE_DEPTH		8
+
+/** How many words of the faulting stack to search for return addresses */
+#define FAULT_STACK_SCAN_WORDS		128
+
+/** Set to 1 to also keep the last crash dump in flash, where it survives power
+ *  cycles. It takes the last page of flash bank 1, which the program must not
+ *  grow into. */
+#define FAULT_SAVE_TO_FLASH			0
+
+/** Flash address of the saved crash dump; must be the start of a page */
+#define FAULT_FLASH_ADDRESS			(IFLASH1_ADDR + IFLASH1_SIZE - IFLASH1_PAGE_SIZE)
+
+/** Set to 1 to reset once the dump has been saved, so that the board reboots and
+ *  reports it, or to 0 to stop and blink LED0 so that a debugger can be attached */
+#define FAULT_RESET_AFTER_DUMP		1
+
+#endif /* CONF_FAULT_H */
@@ -0,0 +1,25 @@
+/**
+ * \file
+ *
+ * \brief GPIO input service configuration.
+ *
+ * Settings for the edge-capturing input service in lib/Services/gpio_input.c.
+ */
+
+#ifndef CONF_GPIO_INPUT_H
+#define CONF_GPIO_INPUT_H
+
+/** Largest number of pins in the table given to gpio_input_init() */
+#define GPIO_INPUT_MAX_PINS			32
+
+/** Number of interrupts that can be queued before they are read. Must be a power
+ *  of two. Each takes 16 bytes and covers every pin that changed on its port. */
+#define GPIO_INPUT_QUEUE_SIZE		128
+
+/** NVIC priority of the PIO interrupts. All the ports' handlers must share one
+ *  priority, so that they can't interrupt each other. If it's no more urgent than
+ *  configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY, gpio_input_wait_events() can be
+ *  woken by the handlers. */
+#define GPIO_INPUT_IRQ_PRIORITY		10
+
+#endif /* CONF_GPIO_INPUT_H */
@@ -0,0 +1,27 @@
+/**
+ * \file
+ *
+ * \brief Pool allocator configuration.
+ *
+ * Settings for the fixed-block pool allocator in lib/Services/pool.c.
+ */
+
+#ifndef CONF_POOL_H
+#define CONF_POOL_H
+
+/** The size classes, smallest first, as POOL_CLASS(block size, block count). Block
+ *  sizes must be multiples of 8 so that every block is suitably aligned for any
+ *  type. A request is served from the smallest class its size fits in. The default
+ *  classes take 4.5 KB of RAM. */
+#define POOL_CLASSES				\
+	POOL_CLASS(16, 32)				\
+	POOL_CLASS(32, 32)				\
+	POOL_CLASS(64, 16)				\
+	POOL_CLASS(128, 8)				\
+	POOL_CLASS(256, 4)
+
+/** Set to 1 to serve a request from the next larger class when its own class is
+ *  used up, or to 0 to fail it instead */
+#define POOL_SPILL_TO_LARGER		1
+
+#endif /* CONF_POOL_H */
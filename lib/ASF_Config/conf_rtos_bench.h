@@ -0,0 +1,28 @@
+/**
+ * \file
+ *
+ * \brief Kernel benchmark configuration.
+ *
+ * Settings for the FreeRTOS micro-benchmarks in lib/Services/rtos_bench.cpp.
+ */
+
+#ifndef CONF_RTOS_BENCH_H
+#define CONF_RTOS_BENCH_H
+
+/** Measurements taken of each operation. Creating and deleting a task takes a
+ *  tick per sample, to let the idle task free the deleted one. */
+#define RTOS_BENCH_SAMPLES			1000
+
+/** A peripheral interrupt which nothing else uses, pended in software to time
+ *  the way from an interrupt to a task. The TRNG is left off on the Due. */
+#define RTOS_BENCH_IRQn				TRNG_IRQn
+#define RTOS_BENCH_Handler			TRNG_Handler
+
+/** NVIC priority of that interrupt. It wakes a task, so it must be no more
+ *  urgent than configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY. */
+#define RTOS_BENCH_IRQ_PRIORITY		10
+
+/** Stack depth of the benchmark task and of the tasks it measures, in words */
+#define RTOS_BENCH_TASK_STACK_SIZE	(configMINIMAL_STACK_SIZE * 2)
+
+#endif /* CONF_RTOS_BENCH_H */
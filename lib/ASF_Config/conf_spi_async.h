@@ -0,0 +1,29 @@
+/**
+ * \file
+ *
+ * \brief Asynchronous SPI configuration.
+ *
+ * Settings for the DMA-driven SPI master in lib/Services/spi_async.c.
+ */
+
+#ifndef CONF_SPI_ASYNC_H
+#define CONF_SPI_ASYNC_H
+
+/** The SPI controller and its peripheral ID. The Due brings out SPI0. */
+#define SPI_ASYNC_SPI				SPI0
+#define SPI_ASYNC_ID				ID_SPI0
+
+/** The DMAC channels used to feed the transmitter and drain the receiver, and the
+ *  DMAC hardware handshaking interfaces of SPI0's transmitter and receiver. The
+ *  receive channel's end interrupt marks the end of a transfer. */
+#define SPI_ASYNC_TX_CHANNEL		0
+#define SPI_ASYNC_RX_CHANNEL		1
+#define SPI_ASYNC_TX_INTERFACE		1
+#define SPI_ASYNC_RX_INTERFACE		2
+
+/** NVIC priority of the DMAC interrupt. Completion callbacks run in it, and may
+ *  call FreeRTOS ...FromISR() functions only if this is no more urgent than
+ *  configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY. */
+#define SPI_ASYNC_IRQ_PRIORITY		10
+
+#endif /* CONF_SPI_ASYNC_H */
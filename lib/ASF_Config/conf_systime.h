@@ -0,0 +1,21 @@
+/**
+ * \file
+ *
+ * \brief System time and delay configuration.
+ *
+ * Settings for the clock and delay service in lib/Services/systime.c.
+ */
+
+#ifndef CONF_SYSTIME_H
+#define CONF_SYSTIME_H
+
+/** SysTick rate in projects without FreeRTOS, whose SysTick_Handler calls
+ *  systime_tick(). Under FreeRTOS, configTICK_RATE_HZ is used instead. */
+#define SYSTIME_TICK_HZ				1000
+
+/** A delay that gives up the processor wakes up at least this long before it is
+ *  due and spins the rest of the way, so that the time taken to switch back to the
+ *  task doesn't make it late. In microseconds. */
+#define SYSTIME_WAKE_MARGIN_US		20
+
+#endif /* CONF_SYSTIME_H */
@@ -0,0 +1,33 @@
+/**
+ * \file
+ *
+ * \brief Timer wheel configuration.
+ *
+ * Settings for the microsecond timer wheel in lib/Services/timer_wheel.c.
+ */
+
+#ifndef CONF_TIMER_WHEEL_H
+#define CONF_TIMER_WHEEL_H
+
+/** The timer counter block and channel the wheel runs on. The examples use TC0
+ *  channel 0 for their 4 Hz tick, so the wheel takes TC1 channel 0 (peripheral
+ *  TC3). The ID and handler must match the block and channel. */
+#define TIMER_WHEEL_TC				TC1
+#define TIMER_WHEEL_CHANNEL			0
+#define TIMER_WHEEL_ID				ID_TC3
+#define TIMER_WHEEL_Handler			TC3_Handler
+
+/** NVIC priority of the timer interrupt. Callbacks that run in the interrupt may
+ *  call FreeRTOS ...FromISR() functions only if this is no more urgent (no lower
+ *  a number) than configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY. */
+#define TIMER_WHEEL_IRQ_PRIORITY	10
+
+/** Longest time the interrupt is left off, in microseconds. The 32-bit counter
+ *  wraps after about 102 seconds at MCK/2, and the wheel must read it more often
+ *  than that to keep track of time. */
+#define TIMER_WHEEL_MAX_SLEEP_US	(1UL << 25)
+
+/** Stack depth of the task that runs deferred callbacks, in words */
+#define TIMER_WHEEL_TASK_STACK_SIZE	(configMINIMAL_STACK_SIZE * 2)
+
+#endif /* CONF_TIMER_WHEEL_H */
@@ -0,0 +1,39 @@
+/**
+ * \file
+ *
+ * \brief Asynchronous TWI configuration.
+ *
+ * Settings for the interrupt-driven I2C manager in lib/Services/twi_async.c.
+ */
+
+#ifndef CONF_TWI_ASYNC_H
+#define CONF_TWI_ASYNC_H
+
+/** The TWI controller, its peripheral ID, interrupt and handler, and its pins.
+ *  The Due's SDA and SCL pins (20 and 21) are TWI1; SDA1 and SCL1 are TWI0. */
+#define TWI_ASYNC_TWI				TWI1
+#define TWI_ASYNC_ID				ID_TWI1
+#define TWI_ASYNC_IRQn				TWI1_IRQn
+#define TWI_ASYNC_Handler			TWI1_Handler
+#define TWI_ASYNC_DATA_GPIO			TWI1_DATA_GPIO
+#define TWI_ASYNC_DATA_FLAGS		TWI1_DATA_FLAGS
+#define TWI_ASYNC_CLK_GPIO			TWI1_CLK_GPIO
+#define TWI_ASYNC_CLK_FLAGS			TWI1_CLK_FLAGS
+
+/** Bus clock in Hz, up to 400 kHz */
+#define TWI_ASYNC_CLOCK_HZ			400000
+
+/** Times a request is tried again after a NACK or a lost arbitration before it
+ *  fails */
+#define TWI_ASYNC_RETRIES			3
+
+/** Most bytes read in one bus transaction by reads batched together. A read
+ *  longer than this on its own is still done, but not batched. */
+#define TWI_ASYNC_BATCH_MAX			64
+
+/** NVIC priority of the TWI interrupt. Completion callbacks run in it, and may
+ *  call FreeRTOS ...FromISR() functions only if this is no more urgent than
+ *  configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY. */
+#define TWI_ASYNC_IRQ_PRIORITY		10
+
+#endif /* CONF_TWI_ASYNC_H */
@@ -0,0 +1,221 @@
+//*************************************************************************************
+/** \file channel.h
+ *    This file contains a typed, fixed-capacity wrapper around FreeRTOS queues for
+ *    passing data between tasks, and between interrupts and tasks.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#ifndef _FRT_CHANNEL_H_
+#define _FRT_CHANNEL_H_
+
+#include <FreeRTOS.h>
+#include <queue.h>
+#include <FreeRTOSHooks.h>
+
+#if (__cplusplus >= 201103L)
+#include <type_traits>
+#endif
+
+/** \brief A typed FIFO of up to \c N items of type \c T.
+ *  \details A \c Channel is a FreeRTOS queue that only accepts and hands out \c T,
+ *  so the compiler checks what goes in and what comes out instead of everything
+ *  passing through \c void*. Items are copied in and out by value, so \c T should be
+ *  a plain data type (no pointers to itself, no user-defined copy constructor); to
+ *  pass something large without copying it, send a pointer to it instead. From
+ *  gnu++17 on, the compiler checks this.
+ * 
+ *  When static allocation is available (see \c FRT_STATIC_ALLOCATION), the item
+ *  storage and queue control block are members of the object, so a channel declared
+ *  at file scope takes no memory from the FreeRTOS heap. Otherwise, the queue is
+ *  created with \c xQueueCreate() as usual.
+ * 
+ *  Example usage:
+ *  \code
+ *  struct sample { uint16_t channel; uint16_t value; };
+ *  Channel<sample, 16> samples;           // At file scope, or shared via extern
+ *  ...
+ *  sample s = { 3, 1024 };
+ *  samples.send(s);                       // In the producing task
+ *  ...
+ *  sample batch[8];
+ *  UBaseType_t n = samples.receive_batch(batch, 8);   // In the consuming task
+ *  \endcode
+ */
+template <typename T, UBaseType_t N>
+class Channel {
+private:
+	#if (__cplusplus >= 201103L)
+	static_assert(N > 0, "A channel must hold at least one item");
+	#endif
+	#if (__cplusplus >= 201703L)
+	static_assert(std::is_trivially_copyable_v<T>,
+				  "A channel's items are copied byte by byte, so T must be trivially "
+				  "copyable");
+	#endif
+	
+	/** \brief The handle of the underlying FreeRTOS queue.
+	 */
+	QueueHandle_t queue;
+	
+	#if (FRT_STATIC_ALLOCATION == 1)
+	/** \brief Storage for the items in the queue.
+	 */
+	uint8_t storage[N * sizeof(T)];
+	
+	/** \brief The FreeRTOS queue control block.
+	 */
+	StaticQueue_t control;
+	#endif
+	
+	// Channels own a kernel object, so they can't be copied
+	Channel(const Channel&);
+	Channel& operator=(const Channel&);
+	
+public:
+	/** \brief Creates the underlying FreeRTOS queue.
+	 *  \details This may be run before the scheduler is started, so channels can be
+	 *  global objects.
+	 */
+	Channel(void)
+	{
+		#if (FRT_STATIC_ALLOCATION == 1)
+			queue = xQueueCreateStatic(N, sizeof(T), storage, &control);
+		#else
+			queue = xQueueCreate(N, sizeof(T));
+		#endif
+	}
+	
+	/** \brief Deletes the underlying FreeRTOS queue.
+	 *  \warning No task may be blocked on the channel when it is destroyed.
+	 */
+	~Channel(void)
+	{
+		vQueueDelete(queue);
+	}
+	
+	/** \brief Copies an item onto the back of the channel.
+	 *  @param item The item to send
+	 *  @param ticks How long to wait for space, in RTOS ticks; zero doesn't wait
+	 *  @return True if the item was sent, false if the channel stayed full
+	 */
+	bool send(const T& item, TickType_t ticks = portMAX_DELAY)
+	{
+		return xQueueSendToBack(queue, &item, ticks) == pdTRUE;
+	}
+	
+	/** \brief Copies an item onto the back of the channel from an ISR.
+	 *  @param item The item to send
+	 *  @param pxHigherPriorityTaskWoken Set to \c pdTRUE if a task of higher priority
+	 *         than the interrupted one was woken, in which case the ISR should end
+	 *         with \c portEND_SWITCHING_ISR(). May be null.
+	 *  @return True if the item was sent, false if the channel was full
+	 */
+	bool send_from_isr(const T& item, BaseType_t* pxHigherPriorityTaskWoken)
+	{
+		return xQueueSendToBackFromISR(queue, &item, pxHigherPriorityTaskWoken) 
+			   == pdTRUE;
+	}
+	
+	/** \brief Takes the item at the front of the channel.
+	 *  @param item Set to the received item
+	 *  @param ticks How long to wait for an item, in RTOS ticks
+	 *  @return True if an item was received, false if the wait timed out
+	 */
+	bool receive(T& item, TickType_t ticks = portMAX_DELAY)
+	{
+		return xQueueReceive(queue, &item, ticks) == pdTRUE;
+	}
+	
+	/** \brief Takes the item at the front of the channel from an ISR.
+	 *  @param item Set to the received item
+	 *  @param pxHigherPriorityTaskWoken See \c send_from_isr()
+	 *  @return True if an item was received, false if the channel was empty
+	 */
+	bool receive_from_isr(T& item, BaseType_t* pxHigherPriorityTaskWoken)
+	{
+		return xQueueReceiveFromISR(queue, &item, pxHigherPriorityTaskWoken) 
+			   == pdTRUE;
+	}
+	
+	/** \brief Waits for at least one item, then takes as many as are waiting.
+	 *  \details Only the first item is waited for; the rest are taken without
+	 *  blocking, so a burst of items costs the receiving task a single wake-up
+	 *  rather than one per item. This helps most when the receiving task runs at
+	 *  the same or a lower priority than the sender, so the items have a chance to
+	 *  pile up before it runs.
+	 *  @param items An array to copy the received items into
+	 *  @param maxItems The number of items \c items can hold
+	 *  @param ticks How long to wait for the first item, in RTOS ticks
+	 *  @return The number of items received, which is zero if the wait timed out
+	 */
+	UBaseType_t receive_batch(T* items, UBaseType_t maxItems, 
+							  TickType_t ticks = portMAX_DELAY)
+	{
+		UBaseType_t count = 0;
+		
+		if (maxItems == 0 || xQueueReceive(queue, &items[0], ticks) != pdTRUE)
+		{
+			return 0;
+		}
+		
+		for (count = 1; count < maxItems; count++)
+		{
+			if (xQueueReceive(queue, &items[count], 0) != pdTRUE)
+			{
+				break;
+			}
+		}
+		return count;
+	}
+	
+	/** \brief Returns the number of items waiting in the channel.
+	 */
+	UBaseType_t waiting(void) const
+	{
+		return uxQueueMessagesWaiting(queue);
+	}
+	
+	/** \brief Returns the number of items waiting in the channel, from an ISR.
+	 */
+	UBaseType_t waiting_from_isr(void) const
+	{
+		return uxQueueMessagesWaitingFromISR(queue);
+	}
+	
+	/** \brief Returns the number of free spaces in the channel.
+	 */
+	UBaseType_t spaces(void) const
+	{
+		return uxQueueSpacesAvailable(queue);
+	}
+	
+	/** \brief Returns the capacity of the channel.
+	 */
+	UBaseType_t capacity(void) const
+	{
+		return N;
+	}
+	
+	/** \brief Returns the FreeRTOS handle of the underlying queue, for use with the
+	 *  plain C API (for instance, to add it to a queue set).
+	 */
+	QueueHandle_t get_handle(void) const
+	{
+		return queue;
+	}
+};
+
+#endif // _FRT_CHANNEL_H_
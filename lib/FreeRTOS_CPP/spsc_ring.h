@@ -0,0 +1,200 @@
+//*************************************************************************************
+/** \file spsc_ring.h
+ *    This file contains a lock-free ring buffer for passing data from exactly one
+ *    producer to exactly one consumer, such as from an interrupt handler to a task.
+ *    It doesn't depend on FreeRTOS, so it can be used in bare-metal projects too.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#ifndef _SPSC_RING_H_
+#define _SPSC_RING_H_
+
+#include <stdint.h>
+
+/** \brief A wait-free single-producer, single-consumer ring buffer of \c N items.
+ *  \details The producer only ever writes \c head and the consumer only ever writes
+ *  \c tail, and on the Cortex-M3 an aligned 32-bit store can't be torn, so neither
+ *  side needs a critical section, a mutex or an LDREX/STREX retry loop. That makes
+ *  \c push() cheap enough to call from an ISR at any priority, including above
+ *  \c configMAX_SYSCALL_INTERRUPT_PRIORITY, where FreeRTOS calls aren't allowed.
+ * 
+ *  Both indices count up freely and are masked when used, so all \c N slots can be
+ *  filled; \c N must therefore be a power of two. A memory barrier between writing
+ *  an item and publishing the new index makes sure the other side never sees the
+ *  index move before the item it covers.
+ * 
+ *  Example, streaming ADC readings from an interrupt to a task:
+ *  \code
+ *  SpscRing<uint16_t, 64> samples;
+ * 
+ *  void ADC_Handler(void)
+ *  {
+ *		samples.push(adc_get_latest_value(ADC));   // Counted in overruns() if full
+ *  }
+ *  ...
+ *  uint16_t batch[16];
+ *  uint32_t n = samples.pop_batch(batch, 16);     // In the task
+ *  \endcode
+ *  \warning Only one context may push and only one may pop. Two ISRs pushing into
+ *  the same ring is only safe if they run at the same priority, so that neither can
+ *  interrupt the other.
+ */
+template <typename T, uint32_t N>
+class SpscRing {
+private:
+	// Fails to compile if N is not a power of two
+	typedef char n_must_be_a_power_of_two[((N != 0) && ((N & (N - 1)) == 0)) ? 1 : -1];
+	
+	/** \brief The items in the ring.
+	 */
+	T items[N];
+	
+	/** \brief Count of items ever pushed. Written only by the producer.
+	 */
+	volatile uint32_t head;
+	
+	/** \brief Count of items ever popped. Written only by the consumer.
+	 */
+	volatile uint32_t tail;
+	
+	/** \brief Count of pushes refused because the ring was full. Written only by 
+	 *  the producer.
+	 */
+	volatile uint32_t overrun_count;
+	
+public:
+	/** \brief Creates an empty ring.
+	 */
+	SpscRing(void)
+	{
+		head = 0;
+		tail = 0;
+		overrun_count = 0;
+	}
+	
+	/** \brief Copies an item into the ring. Producer only.
+	 *  @param item The item to add
+	 *  @return True if the item was added, false if the ring was full (in which case
+	 *          the overrun count goes up)
+	 */
+	bool push(const T& item)
+	{
+		uint32_t h = head;
+		
+		if (h - tail >= N)
+		{
+			overrun_count = overrun_count + 1;
+			return false;
+		}
+		items[h & (N - 1)] = item;
+		
+		// The item must be in place before the consumer can see the new head
+		__sync_synchronize();
+		head = h + 1;
+		return true;
+	}
+	
+	/** \brief Takes the oldest item out of the ring. Consumer only.
+	 *  @param item Set to the item taken
+	 *  @return True if an item was taken, false if the ring was empty
+	 */
+	bool pop(T& item)
+	{
+		uint32_t t = tail;
+		
+		if (head == t)
+		{
+			return false;
+		}
+		
+		// Don't read the item until the head that covers it has been seen
+		__sync_synchronize();
+		item = items[t & (N - 1)];
+		
+		// Finish reading the item before the producer can reuse its slot
+		__sync_synchronize();
+		tail = t + 1;
+		return true;
+	}
+	
+	/** \brief Takes up to \c maxItems of the oldest items out of the ring.
+	 *  Consumer only.
+	 *  \details This publishes the new tail once for the whole batch, rather than
+	 *  once per item.
+	 *  @param out An array to copy the items into
+	 *  @param maxItems The number of items \c out can hold
+	 *  @return The number of items taken
+	 */
+	uint32_t pop_batch(T* out, uint32_t maxItems)
+	{
+		uint32_t t = tail;
+		uint32_t count = head - t;
+		
+		if (count > maxItems)
+		{
+			count = maxItems;
+		}
+		
+		__sync_synchronize();
+		for (uint32_t i = 0; i < count; i++)
+		{
+			out[i] = items[(t + i) & (N - 1)];
+		}
+		
+		__sync_synchronize();
+		tail = t + count;
+		return count;
+	}
+	
+	/** \brief Returns the number of items in the ring.
+	 *  \details Exact when called by the consumer; from anywhere else it may be out
+	 *  of date as soon as it returns.
+	 */
+	uint32_t size(void) const
+	{
+		return head - tail;
+	}
+	
+	/** \brief Returns true if there is nothing to pop.
+	 */
+	bool empty(void) const
+	{
+		return head == tail;
+	}
+	
+	/** \brief Returns true if there is no room to push.
+	 */
+	bool full(void) const
+	{
+		return (head - tail) >= N;
+	}
+	
+	/** \brief Returns the number of items the ring can hold.
+	 */
+	uint32_t capacity(void) const
+	{
+		return N;
+	}
+	
+	/** \brief Returns the number of pushes refused because the ring was full.
+	 */
+	uint32_t overruns(void) const
+	{
+		return overrun_count;
+	}
+};
+
+#endif // _SPSC_RING_H_
@@ -28,6 +28,44 @@
 #include <FreeRTOS.h>
 #include <semphr.h>
 #include <task.h>
+#include <FreeRTOSHooks.h>
+#include <FreeRTOSStack.h>
+
+#if (__cplusplus >= 201103L)
+#include <type_traits>
+#include <utility>
+
+/** \brief A task's priority and stack depth, checked when the program is compiled.
+ *  \details Handing one of these to a task's constructor, in place of the priority
+ *  and stack depth, has the compiler refuse a priority that FreeRTOS doesn't have
+ *  or a stack smaller than \c configMINIMAL_STACK_SIZE, rather than the task going
+ *  wrong when it runs. It is an empty object, so it costs nothing at run time:
+ *  \code
+ *  class task_example : public TaskClass {
+ *  public:
+ *		task_example(const char* aName)
+ *			: TaskClass(aName, TaskConfig<2, configMINIMAL_STACK_SIZE + 50>()) {}
+ *		void run(void);
+ *  };
+ *  \endcode
+ *  \note This needs CXX_STANDARD set to gnu++11 or later in the project Makefile.
+ */
+template <UBaseType_t Priority, unsigned portSHORT StackDepth = configMINIMAL_STACK_SIZE>
+struct TaskConfig {
+	static_assert(Priority < configMAX_PRIORITIES,
+				  "A task's priority must be below configMAX_PRIORITIES");
+	static_assert(StackDepth >= configMINIMAL_STACK_SIZE,
+				  "A task's stack must be at least configMINIMAL_STACK_SIZE words deep");
+
+	/** \brief The priority at which the task will initially run
+	 */
+	static constexpr UBaseType_t priority = Priority;
+
+	/** \brief The size of the task's stack, in words
+	 */
+	static constexpr unsigned portSHORT stack_depth = StackDepth;
+};
+#endif // __cplusplus >= 201103L
 
 /** \brief The overarching FreeRTOS task wrapper class.
  *  \details It creates an object to for storing the handles for a FreeRTOS task also
@@ -38,7 +76,8 @@
  *  \note Using this wrapper and \c TaskClass for FreeRTOS tasks introduces a memory
  *  overhead of roughly 30000 bytes. If space becomes an issue that's terribly
  *  pressing, reverting to the standard C implementation of FreeRTOS tasks would be a
- *  viable option.
+ *  viable option, as would using \c StaticTaskClass, which keeps the stack and task
+ *  control block out of the FreeRTOS heap altogether.
  */
 
 class TaskWrap {
@@ -79,6 +118,101 @@ public:
 		#endif
 		return;
 	}
+	
+	/** \brief This method suggests that the RTOS lose focus of a task for a time
+	 */
+	void delayms (uint16_t interval)
+	{
+		vTaskDelay(configMS_TO_TICKS(interval));
+	}
+	
+	/** \brief This method forces the RTOS to perform a delay for a specified time
+	 */
+	void delay_from_for(portTickType& fromTicks, uint16_t interval)
+	{
+		vTaskDelayUntil (&fromTicks, configMS_TO_TICKS(interval));
+	}
+	
+	#if (FRT_TASK_NOTIFICATIONS == 1)
+	/** \brief Wakes this task up with a direct-to-task notification.
+	 *  \details This increments the task's notification value, much as giving a
+	 *  counting semaphore would, but without a separate kernel object: the
+	 *  notification lives in the task's control block. The task picks it up with
+	 *  \c wait_notify(). Must not be called from an ISR; use
+	 *  \c notify_from_isr() there. Example, with \c p_other pointing to another
+	 *  task object:
+	 *  \code
+	 *  p_other->notify();          // In this task
+	 *  ...
+	 *  wait_notify();              // In the other task's run()
+	 *  \endcode
+	 */
+	void notify(void)
+	{
+		xTaskNotifyGive(handle);
+	}
+	
+	/** \brief Wakes this task up from an interrupt service routine.
+	 *  @param pxHigherPriorityTaskWoken Set to \c pdTRUE if the notified task has a
+	 *         higher priority than the interrupted one, in which case the ISR should
+	 *         finish with \c portEND_SWITCHING_ISR(). May be null.
+	 */
+	void notify_from_isr(BaseType_t* pxHigherPriorityTaskWoken)
+	{
+		vTaskNotifyGiveFromISR(handle, pxHigherPriorityTaskWoken);
+	}
+	
+	/** \brief Blocks the calling task until it is sent a notification.
+	 *  \details This should only be called from within the task's own \c run(),
+	 *  as a task can only wait on its own notification value.
+	 *  @param ticks The longest time to wait, in RTOS ticks; \c portMAX_DELAY 
+	 *         waits forever
+	 *  @param clear If true, the notification count is cleared when it is taken
+	 *         (binary semaphore behavior); if false it is decremented (counting
+	 *         semaphore behavior)
+	 *  @return The notification count before it was cleared or decremented, which
+	 *          is zero if the wait timed out
+	 */
+	uint32_t wait_notify(TickType_t ticks = portMAX_DELAY, bool clear = true)
+	{
+		return ulTaskNotifyTake(clear ? pdTRUE : pdFALSE, ticks);
+	}
+	
+	/** \brief Sends this task a set of event bits.
+	 *  \details The bits are ORed into the task's notification value, so several
+	 *  events can be posted before the task gets around to looking at them with
+	 *  \c wait_bits(). This lets one notification stand in for an event group.
+	 *  @param bits The event bits to set
+	 */
+	void notify_bits(uint32_t bits)
+	{
+		xTaskNotify(handle, bits, eSetBits);
+	}
+	
+	/** \brief Sends this task a set of event bits from an ISR.
+	 *  @param bits The event bits to set
+	 *  @param pxHigherPriorityTaskWoken See \c notify_from_isr()
+	 */
+	void notify_bits_from_isr(uint32_t bits, BaseType_t* pxHigherPriorityTaskWoken)
+	{
+		xTaskNotifyFromISR(handle, bits, eSetBits, pxHigherPriorityTaskWoken);
+	}
+	
+	/** \brief Blocks the calling task until it is sent event bits.
+	 *  \details Like \c wait_notify(), this should only be called by the task
+	 *  itself.
+	 *  @param bits Set to the task's notification value when it was woken
+	 *  @param ticks The longest time to wait, in RTOS ticks
+	 *  @param clearOnExit The bits to clear once they have been read; by default,
+	 *         all of them
+	 *  @return True if a notification was received, false if the wait timed out
+	 */
+	bool wait_bits(uint32_t& bits, TickType_t ticks = portMAX_DELAY,
+				   uint32_t clearOnExit = 0xFFFFFFFFUL)
+	{
+		return xTaskNotifyWait(0, clearOnExit, &bits, ticks) == pdTRUE;
+	}
+	#endif // FRT_TASK_NOTIFICATIONS
 };
 
 /** \brief The task-specific FreeRTOS task-wrapping class.
@@ -109,7 +243,7 @@ public:
  *  public:
  *		// The constructor for the example class, which gives a pointer to the
  *		// task's name string, declares a numeric priority, and defines the stack
- *		// size for the task in bytes.
+ *		// size for the task in words (StackType_t, 4 bytes each on the SAM3X).
  *		task_example(const char* aName, unsigned portBASE_TYPE taskPriority, 
  *					 size_t stackSize, ...);
  * 
@@ -146,21 +280,46 @@ public:
 class TaskClass : public TaskWrap {
 private:
 	
+protected:
+	/** \brief Constructor for subclasses that register the task themselves.
+	 *  \details This leaves \c TaskWrap::handle empty rather than calling
+	 *  \c xTaskCreate(), so that a subclass such as \c StaticTaskClass can create
+	 *  the task with its own memory.
+	 */
+	TaskClass(void)
+	{
+		handle = 0;
+	}
+	
 public:
 	/** \brief The constructor for the base task class.
 	 *  \details It calls the FreeRTOS task creation function \c xTaskCreate() to
 	 *  associate the \c TaskWrap::handle with the actual code specified in an
 	 *  individual task's C++ and header files and register it in the FreeRTOS task
 	 *  list (and, as such, diagnostic information can be printed out about the task
-	 *  via the \c task_ui::printDiagTaskInfo() method.
+	 *  via the \c task_ui::printDiagTaskInfo() method. The task is also added to
+	 *  the stack monitor in FreeRTOSStack.h.
+	 *  @param stackDepth The size of the task's stack, in words
 	 */
 	TaskClass(char const*name, unsigned portBASE_TYPE priority,
 				unsigned portSHORT stackDepth=configMINIMAL_STACK_SIZE) 
 	{
+		handle = 0;
 		xTaskCreate((void(*)(void*))(&_user_run_function), 
 					(const char*)name, stackDepth, this, priority, &handle);
+		vStackMonitorRegister(handle, stackDepth);
 	}
 	
+	#if (__cplusplus >= 201103L)
+	/** \brief Creates the task with a priority and stack depth checked at compile
+	 *  time (see \c TaskConfig).
+	 *  @param name The name of the task, as shown in FreeRTOS diagnostics
+	 */
+	template <UBaseType_t Priority, unsigned portSHORT StackDepth>
+	TaskClass(char const* name, TaskConfig<Priority, StackDepth>)
+		: TaskClass(name, Priority, StackDepth) {}
+	#endif
+	
 	/** \brief Pure virtual run function for the TaskClass.
 	 *  \details \warning This pure virtual run function declaration makes it an 
 	 *  absolute requirement that any class that inherits \c TaskClass must supply 
@@ -209,21 +368,268 @@ public:
 			vTaskDelay (portMAX_DELAY);
 		}
 	}
+};
+
+/** \brief A task wrapper that binds the task's \c run() method at compile time.
+ *  \details This does the same job as \c TaskClass, but uses the "curiously
+ *  recurring template pattern": a task passes its own class as the template
+ *  parameter, so the trampoline handed to \c xTaskCreate() calls
+ *  \c Derived::run() directly. There is no vtable, no virtual call and no
+ *  function-pointer cast, and the compiler is free to inline \c run() into the
+ *  trampoline. Each task object is one pointer smaller as well.
+ * 
+ *  A task declares itself like this:
+ *  \code
+ *  class task_example : public Task<task_example> {
+ *  public:
+ *		task_example(const char* aName, unsigned portBASE_TYPE taskPriority, 
+ *					 size_t stackSize)
+ *			: Task<task_example>(aName, taskPriority, stackSize) {}
+ * 
+ *		// Must be public (or Task<task_example> must be a friend), and is not
+ *		// virtual
+ *		void run(void);
+ *  };
+ *  \endcode
+ *  and is created with \c new exactly as a \c TaskClass would be. Forgetting
+ *  \c run() is still caught, but by the compiler as a missing member rather than as
+ *  a pure virtual function.
+ *  \warning Because there is no virtual dispatch, a pointer to \c Task<Derived>
+ *  can't be used to treat different tasks alike; use \c TaskClass when that's needed.
+ */
+template <class Derived>
+class Task : public TaskWrap {
+public:
+	/** \brief Creates the task and registers it with FreeRTOS.
+	 *  @param name The name of the task, as shown in FreeRTOS diagnostics
+	 *  @param priority The priority at which this task will initially run
+	 *  @param stackDepth The size of the task's stack, in words
+	 */
+	Task(char const* name, unsigned portBASE_TYPE priority,
+		 unsigned portSHORT stackDepth=configMINIMAL_STACK_SIZE)
+	{
+		handle = 0;
+		xTaskCreate(&_user_run_function, (const char*)name, stackDepth,
+					static_cast<Derived*>(this), priority, &handle);
+		vStackMonitorRegister(handle, stackDepth);
+	}
 	
-	/** \brief This method suggests that the RTOS lose focus of a task for a time
+	#if (__cplusplus >= 201103L)
+	/** \brief Creates the task with a priority and stack depth checked at compile
+	 *  time (see \c TaskConfig).
+	 *  @param name The name of the task, as shown in FreeRTOS diagnostics
 	 */
-	void delayms (uint16_t interval)
+	template <UBaseType_t Priority, unsigned portSHORT StackDepth>
+	Task(char const* name, TaskConfig<Priority, StackDepth>)
+		: Task(name, Priority, StackDepth) {}
+	#endif
+	
+	/** \brief Runs \c Derived::run() for the task, then cleans up after it.
+	 *  \details \warning This method should never be called in a user's code!
+	 * 
+	 *  It has the exact signature FreeRTOS expects of a task function, so no cast
+	 *  is needed to pass it to \c xTaskCreate(). If \c run() returns, the task is
+	 *  deleted, just as with \c TaskClass::_user_run_function().
+	 *  @param pvParameters A pointer to the \c Derived task object
+	 */
+	static void _user_run_function(void* pvParameters)
 	{
-		vTaskDelay(configMS_TO_TICKS(interval));
+		Derived* pTask = static_cast<Derived*>(pvParameters);
+		
+		// Call the user's run() method; this is resolved at compile time
+		pTask->run();
+		
+		#if (INCLUDE_vTaskDelete == 1)
+			void* tempHandle = pTask->handle;
+			pTask->handle = 0;
+			vTaskDelete (tempHandle);
+		#else
+			pTask->handle = 0;
+		#endif
+
+		for (;;)
+		{
+			vTaskDelay (portMAX_DELAY);
+		}
 	}
+};
+
+#if (__cplusplus >= 201103L)
+/** \brief A task which runs a function object, such as a lambda, instead of a
+ *  \c run() method.
+ *  \details This saves writing a class for a task which is little more than its
+ *  loop. The function object is moved into the task object, so a lambda may capture
+ *  what it needs by value; anything captured by reference must outlive the task. The
+ *  function may take a \c TaskWrap& argument, which is the task itself, for
+ *  \c delayms() and the like. As with \c Task<Derived>, the function is called
+ *  directly, without a virtual call, and the task is deleted if it returns.
+ * 
+ *  Tasks are made with \c create_task(), which checks the priority and stack depth
+ *  at compile time:
+ *  \code
+ *  uint16_t period = 500;
+ *  create_task<2, configMINIMAL_STACK_SIZE + 100>("Blink", [period](TaskWrap& task)
+ *  {
+ *		for (;;)
+ *		{
+ *			ioport_toggle_pin_level(LED0_GPIO);
+ *			task.delayms(period);
+ *		}
+ *  });
+ *  \endcode
+ *  \note This needs CXX_STANDARD set to gnu++11 or later in the project Makefile.
+ */
+template <class Function>
+class FunctionTask : public TaskWrap {
+private:
+	/** \brief The function the task runs
+	 */
+	Function function;
 	
-	/** \brief This method forces the RTOS to perform a delay for a specified time
+	/** \brief Calls the function with the task, if it takes one...
 	 */
-	void delay_from_for(portTickType& fromTicks, uint16_t interval)
+	template <class F>
+	static auto invoke(F& f, TaskWrap& task, int) -> decltype(f(task), void())
 	{
-		vTaskDelayUntil (&fromTicks, configMS_TO_TICKS(interval));
+		f(task);
+	}
+	
+	/** \brief ...or with nothing, if it doesn't.
+	 */
+	template <class F>
+	static void invoke(F& f, TaskWrap&, long)
+	{
+		f();
+	}
+	
+public:
+	/** \brief Stores the function, then creates the task which runs it.
+	 *  \details The function is in place before the task is created, so this is
+	 *  safe while the scheduler is running, even if the new task's priority is
+	 *  higher than the creator's.
+	 *  @param name The name of the task, as shown in FreeRTOS diagnostics
+	 *  @param f The function to run
+	 */
+	template <UBaseType_t Priority, unsigned portSHORT StackDepth, class F>
+	FunctionTask(char const* name, TaskConfig<Priority, StackDepth>, F&& f)
+		: function(std::forward<F>(f))
+	{
+		handle = 0;
+		xTaskCreate(&_user_run_function, (const char*)name, StackDepth, this,
+					Priority, &handle);
+		vStackMonitorRegister(handle, StackDepth);
+	}
+	
+	/** \brief Runs the function for the task, then cleans up after it.
+	 *  \details \warning This method should never be called in a user's code!
+	 *  @param pvParameters A pointer to the \c FunctionTask object
+	 */
+	static void _user_run_function(void* pvParameters)
+	{
+		FunctionTask* pTask = static_cast<FunctionTask*>(pvParameters);
+		
+		invoke(pTask->function, *pTask, 0);
+		
+		#if (INCLUDE_vTaskDelete == 1)
+			void* tempHandle = pTask->handle;
+			pTask->handle = 0;
+			vTaskDelete (tempHandle);
+		#else
+			pTask->handle = 0;
+		#endif
+
+		for (;;)
+		{
+			vTaskDelay (portMAX_DELAY);
+		}
+	}
+};
+
+#if (__cplusplus >= 201703L)
+/** \brief Lets \c new \c FunctionTask(name, TaskConfig<...>(), lambda) work out
+ *  the lambda's type by itself.
+ */
+template <UBaseType_t Priority, unsigned portSHORT StackDepth, class F>
+FunctionTask(char const*, TaskConfig<Priority, StackDepth>, F&&)
+	-> FunctionTask<std::decay_t<F>>;
+#endif
+
+/** \brief Creates a task which runs a function object, such as a lambda.
+ *  \details The priority and stack depth are template parameters, so they are
+ *  checked at compile time by \c TaskConfig. See \c FunctionTask for an example.
+ *  @param name The name of the task, as shown in FreeRTOS diagnostics
+ *  @param function The function to run, which is moved or copied into the task
+ *  @return A pointer to the new task object
+ */
+template <UBaseType_t Priority, unsigned portSHORT StackDepth = configMINIMAL_STACK_SIZE,
+		  class Function>
+FunctionTask<typename std::decay<Function>::type>* create_task(char const* name,
+															  Function&& function)
+{
+	return new FunctionTask<typename std::decay<Function>::type>(name,
+		TaskConfig<Priority, StackDepth>(), std::forward<Function>(function));
+}
+#endif // __cplusplus >= 201103L
+
+#if (FRT_STATIC_ALLOCATION == 1)
+/** \brief A \c TaskClass whose stack and task control block live in the object.
+ *  \details Rather than having \c xTaskCreate() pull the stack and TCB out of the
+ *  \c configTOTAL_HEAP_SIZE heap, this class embeds both and hands them to
+ *  \c xTaskCreateStatic(). If the task object is a global or \c static variable,
+ *  its memory is fixed at link time, shows up in the \c .bss figure printed by
+ *  \c arm-none-eabi-size, and creating the task never touches the heap.
+ * 
+ *  The stack depth is given as a template parameter, in words (not bytes), just as
+ *  FreeRTOS counts it. A task only needs to change its parent class and drop the
+ *  stack size from its constructor:
+ *  \code
+ *  class task_example : public StaticTaskClass<configMINIMAL_STACK_SIZE + 50> {
+ *  public:
+ *		task_example(const char* aName, unsigned portBASE_TYPE taskPriority)
+ *			: StaticTaskClass<configMINIMAL_STACK_SIZE + 50>(aName, taskPriority) {}
+ *		void run(void);
+ *  };
+ *  ...
+ *  // Declared at file scope, so the stack is allocated by the linker
+ *  static task_example example_task("Example", 2);
+ *  \endcode
+ *  \warning The object must outlive the task. Don't create one of these on the
+ *  stack of a function that returns, and don't \c delete it while the task is still
+ *  running. Because FreeRTOS only starts tasks once the scheduler is running,
+ *  file-scope instances are safe to construct before \c vTaskStartScheduler().
+ *  \note This needs FreeRTOS V9.0.0 or later and \c configSUPPORT_STATIC_ALLOCATION
+ *  set to 1 in \c FreeRTOSConfig.h; it is left out otherwise.
+ */
+template <unsigned portSHORT StackDepth>
+class StaticTaskClass : public TaskClass {
+private:
+	#if (__cplusplus >= 201103L)
+	static_assert(StackDepth >= configMINIMAL_STACK_SIZE,
+				  "A task's stack must be at least configMINIMAL_STACK_SIZE words deep");
+	#endif
+	
+	/** \brief The task's stack, \c StackDepth words deep.
+	 */
+	StackType_t stack[StackDepth];
+	
+	/** \brief The FreeRTOS task control block for this task.
+	 */
+	StaticTask_t tcb;
+	
+public:
+	/** \brief Creates and registers the task using the memory in this object.
+	 *  @param name The name of the task, as shown in FreeRTOS diagnostics
+	 *  @param priority The priority at which this task will initially run
+	 */
+	StaticTaskClass(char const* name, unsigned portBASE_TYPE priority) : TaskClass()
+	{
+		handle = xTaskCreateStatic((void(*)(void*))(&_user_run_function), 
+								   (const char*)name, StackDepth, this, priority,
+								   stack, &tcb);
+		vStackMonitorRegister(handle, StackDepth);
 	}
 };
+#endif // FRT_STATIC_ALLOCATION
 
 /** \cond NO_DOXY <b>This function never needs to be called by user-written code.</b>
  *  This is the task function which is called by the RTOS scheduler. It needs to call
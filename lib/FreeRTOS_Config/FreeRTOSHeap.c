@@ -0,0 +1,105 @@
+/**
+ * \file
+ * \brief Heap telemetry for FreeRTOS
+ *
+ * Heap 5 supplies its own figures through vPortGetHeapFigures(). For the kernel's
+ * heaps the figures are pieced together from what they do expose: heaps 1, 2 and 4
+ * count their free bytes, and the traceMALLOC() hook set up in FreeRTOSConfig.h
+ * keeps the minimum after every allocation; heap 3 is newlib's, which reports its
+ * totals through mallinfo().
+ */
+#include <stdio.h>
+#include "FreeRTOSHeap.h"
+
+#if ( configHEAP_NUMBER == 3 )
+#include <malloc.h>
+#endif
+
+#if ( configHEAP_NUMBER == 1 ) || ( configHEAP_NUMBER == 2 ) || ( configHEAP_NUMBER == 4 )
+/** Fewest bytes ever free, kept by vHeapTraceMalloc() */
+static size_t xMinimumEverFree = configTOTAL_HEAP_SIZE;
+#endif
+
+//------------------------------------------------------------------------------
+void vHeapTraceMalloc( void )
+{
+#if ( configHEAP_NUMBER == 1 ) || ( configHEAP_NUMBER == 2 ) || ( configHEAP_NUMBER == 4 )
+	size_t xFree = xPortGetFreeHeapSize();
+
+	if( xFree < xMinimumEverFree )
+	{
+		xMinimumEverFree = xFree;
+	}
+#endif
+}
+
+void vHeapGetTelemetry( HeapTelemetry_t *pxTelemetry )
+{
+#if ( configHEAP_NUMBER == 5 )
+	vPortGetHeapFigures( pxTelemetry );
+#elif ( configHEAP_NUMBER == 3 )
+	struct mallinfo xInfo = mallinfo();
+
+	pxTelemetry->xTotalBytes = ( size_t ) xInfo.arena;
+	pxTelemetry->xFreeBytes = ( size_t ) xInfo.fordblks;
+	pxTelemetry->xMinimumEverFreeBytes = 0;
+	pxTelemetry->xLargestFreeBlock = 0;
+	pxTelemetry->xFreeBlocks = 0;
+#else
+	vTaskSuspendAll();
+	{
+		pxTelemetry->xTotalBytes = configTOTAL_HEAP_SIZE;
+		pxTelemetry->xFreeBytes = xPortGetFreeHeapSize();
+		pxTelemetry->xMinimumEverFreeBytes = xMinimumEverFree;
+	}
+	( void ) xTaskResumeAll();
+
+	#if ( configHEAP_NUMBER == 1 )
+		// Heap 1 hands out memory from the bottom up and never takes it back
+		pxTelemetry->xLargestFreeBlock = pxTelemetry->xFreeBytes;
+		pxTelemetry->xFreeBlocks = 1;
+	#else
+		pxTelemetry->xLargestFreeBlock = 0;
+		pxTelemetry->xFreeBlocks = 0;
+	#endif
+#endif
+
+	if( pxTelemetry->xFreeBytes == 0 )
+	{
+		pxTelemetry->ulFragmentation = 0;
+	}
+	else if( pxTelemetry->xLargestFreeBlock == 0 )
+	{
+		pxTelemetry->ulFragmentation = heapFRAGMENTATION_UNKNOWN;
+	}
+	else
+	{
+		pxTelemetry->ulFragmentation = ( uint32_t ) ( 1000ULL
+				- ( ( uint64_t ) pxTelemetry->xLargestFreeBlock * 1000ULL )
+				/ pxTelemetry->xFreeBytes );
+	}
+}
+
+void vHeapPrintReport( void )
+{
+	HeapTelemetry_t xHeap;
+
+	vHeapGetTelemetry( &xHeap );
+	printf( "Heap %d: %lu of %lu bytes free, min ever %lu, ", configHEAP_NUMBER,
+			( unsigned long ) xHeap.xFreeBytes, ( unsigned long ) xHeap.xTotalBytes,
+			( unsigned long ) xHeap.xMinimumEverFreeBytes );
+
+	// Without the free list there is nothing to say about the blocks
+	if( xHeap.ulFragmentation == heapFRAGMENTATION_UNKNOWN )
+	{
+		printf( "largest block n/a, fragmentation n/a\r\n" );
+	}
+	else
+	{
+		printf( "largest block %lu in %lu, fragmentation %lu.%lu%%\r\n",
+				( unsigned long ) xHeap.xLargestFreeBlock,
+				( unsigned long ) xHeap.xFreeBlocks,
+				( unsigned long ) ( xHeap.ulFragmentation / 10 ),
+				( unsigned long ) ( xHeap.ulFragmentation % 10 ) );
+	}
+}
@@ -0,0 +1,92 @@
+/**
+ * \file
+ * \brief Heap selection support and heap telemetry for FreeRTOS
+ *
+ * The heap implementation is chosen with HEAP_NUMBER in the project Makefile, which
+ * also passes it to the compiler as configHEAP_NUMBER:
+ *  - 1 never frees; allocation only.
+ *  - 2 frees, but never merges neighbouring free blocks, so it fragments when
+ *    blocks of different sizes are created and deleted.
+ *  - 3 wraps newlib's malloc() and free().
+ *  - 4 merges neighbouring free blocks, in one configTOTAL_HEAP_SIZE array.
+ *  - 5 merges like 4, but over several separate regions of RAM. The kernel's heaps
+ *    1 to 4 are used as they are; heap 5 is lib/FreeRTOS_Heap/heap_5.c, which
+ *    unless told otherwise takes all the RAM after the program's own data, apart
+ *    from configNEWLIB_HEAP_SIZE bytes kept for newlib, as two regions: the rest of
+ *    SRAM0 and the whole of SRAM1.
+ *
+ * vHeapGetTelemetry() reports how full and how fragmented the heap is. Heap 5 knows
+ * every figure. The kernel's heaps don't keep a list of their free blocks that can
+ * be read from outside, so for them the largest free block and the number of free
+ * blocks are reported as 0, meaning unknown, and the fragmentation as
+ * heapFRAGMENTATION_UNKNOWN, except for heap 1, where all the free memory is one
+ * block. vHeapPrintReport() prints "n/a" for figures it doesn't have.
+ */
+#ifndef _FREERTOSHEAP_H
+#define _FREERTOSHEAP_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Figures describing the state of the FreeRTOS heap */
+typedef struct xHEAP_TELEMETRY
+{
+	size_t xTotalBytes;				/**< Size of the heap, or 0 if unknown */
+	size_t xFreeBytes;				/**< Bytes free now */
+	size_t xMinimumEverFreeBytes;	/**< Fewest bytes that have ever been free */
+	size_t xLargestFreeBlock;		/**< Largest single free block, or 0 if unknown */
+	size_t xFreeBlocks;				/**< Number of free blocks, or 0 if unknown */
+	uint32_t ulFragmentation;		/**< Share of the free bytes that are not in the
+										 largest free block, in tenths of a percent,
+										 or heapFRAGMENTATION_UNKNOWN */
+} HeapTelemetry_t;
+
+/** ulFragmentation when the heap can't say how its free bytes are split up */
+#define heapFRAGMENTATION_UNKNOWN	( ( uint32_t ) 0xFFFFFFFFUL )
+
+/* Heap 5's region list. Kernels from V8.1.0 on declare it themselves. */
+#if !defined( tskKERNEL_VERSION_MAJOR ) || ( tskKERNEL_VERSION_MAJOR < 8 ) \
+	|| ( ( tskKERNEL_VERSION_MAJOR == 8 ) && ( tskKERNEL_VERSION_MINOR < 1 ) )
+
+/** One region of RAM for heap 5 */
+typedef struct HeapRegion
+{
+	uint8_t *pucStartAddress;		/**< First byte of the region */
+	size_t xSizeInBytes;			/**< Size of the region */
+} HeapRegion_t;
+
+/** Hands heap 5 the RAM it is to use, replacing the default regions. Must be called
+ *  before anything is allocated.
+ *  \param[in] pxHeapRegions The regions, in order of address, ending with one whose
+ *             start address is NULL
+ */
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions );
+
+#endif
+
+/** Heap 5's own figures, read by vHeapGetTelemetry(); leaves ulFragmentation alone.
+ *  \param[out] pxTelemetry Where to put them
+ */
+void vPortGetHeapFigures( HeapTelemetry_t *pxTelemetry );
+
+/** Trace hook: called by every heap after each allocation, with the scheduler
+ *  suspended, to keep track of the fewest bytes ever free. */
+void vHeapTraceMalloc( void );
+
+/** Fills in the heap figures.
+ *  \param[out] pxTelemetry Where to put them
+ */
+void vHeapGetTelemetry( HeapTelemetry_t *pxTelemetry );
+
+/** Prints the heap figures on one line. */
+void vHeapPrintReport( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _FREERTOSHEAP_H
@@ -3,6 +3,7 @@
  * \brief FreeRTOS for ARM
  */
 #include "FreeRTOSHooks.h"
+#include <sleepmgr.h>
 
 //------------------------------------------------------------------------------
 /** Blink error pattern
@@ -32,17 +33,17 @@ void hard_fault_isr(void)
 	
 }
 /** Hard fault - blink one short flash every two seconds */
-void HardFault_Handler(void) 	{errorBlink(1);}
+void __attribute__((weak)) HardFault_Handler(void) 	{errorBlink(1);}
 
 /** Bus fault - blink two short flashes every two seconds */
 void bus_fault_isr(void) {errorBlink(2);}
 /** Bus fault - blink two short flashes every two seconds */
-void BusFault_Handler(void) {errorBlink(2);}
+void __attribute__((weak)) BusFault_Handler(void) {errorBlink(2);}
 
 /** Usage fault - blink three short flashes every two seconds */
 void usage_fault_isr(void) {errorBlink(3);}
 /** Usage fault - blink three short flashes every two seconds */
-void UsageFault_Handler(void) {errorBlink(3);}
+void __attribute__((weak)) UsageFault_Handler(void) {errorBlink(3);}
 //------------------------------------------------------------------------------
 	/** vApplicationMallocFailedHook()
    Blink four short pulses if malloc fails.
@@ -57,7 +58,7 @@ void UsageFault_Handler(void) {errorBlink(3);}
 	FreeRTOSConfig.h, and the xPortGetFreeHeapSize() API function can be used
 	to query the size of free heap space that remains (although it does not
 	provide information on how the remaining heap might be fragmented). */
-void vApplicationMallocFailedHook(void) {
+void __attribute__((weak)) vApplicationMallocFailedHook(void) {
   errorBlink(4);
 }
 //------------------------------------------------------------------------------
@@ -72,8 +73,6 @@ void vApplicationMallocFailedHook(void) {
 	function, because it is the responsibility of the idle task to clean up
 	memory allocated by the kernel to any task that has since been deleted. */
 void  __attribute__((weak)) vApplicationIdleHook( void ) {
-  while(1)
-  {}
 }
 /*-----------------------------------------------------------*/
 	/**  Blink five short pulses if stack overflow is detected.
@@ -83,7 +82,7 @@ void  __attribute__((weak)) vApplicationIdleHook( void ) {
   \param[in] pxTask Task handle
   \param[in] pcTaskName Task name
   */
-void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+void __attribute__((weak)) vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
 	(void) pcTaskName;
 	(void) pxTask;
 	errorBlink(5);
@@ -97,10 +96,118 @@ void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
 void __attribute__((weak)) vApplicationTickHook(void) {
 }
 /*-----------------------------------------------------------*/
-/** Dummy time stats gathering functions need to be defined to keep the
-linker happy.  Could edit FreeRTOSConfig.h to remove these.*/
-void vMainConfigureTimerForRunTimeStats( void ) {}
-/** Dummy function
- *  \return zero
+/** CPU cycles spent asleep in the idle task, and the number of times it slept */
+static uint64_t ullSleepCycles = 0;
+static uint32_t ulSleepCount = 0;
+
+	/** Called by the port's tickless idle code, with interrupts disabled, once
+	SysTick has been set to wake the processor when the next task is due. This
+	does the sleeping itself, and then sets *pulExpectedIdleTime to zero so that
+	the port doesn't sleep again.
+
+	The processor is put in the SAM3X sleep mode (WFI), in which peripheral clocks
+	keep running. The deeper wait and backup modes would stop SysTick, so they are
+	not used even if the ASF sleep manager would allow them, but a driver holding a
+	SLEEPMGR_ACTIVE lock (sleepmgr_lock_mode()) keeps the processor awake.
+
+	The time asleep is measured on SysTick, which keeps counting in sleep mode. If
+	its interrupt became pending while asleep, the counter ran down to zero and
+	reloaded before the processor woke.
+  \param[in,out] pulExpectedIdleTime Ticks the kernel expects to be idle */
+void vPreSleepProcessing( uint32_t *pulExpectedIdleTime )
+{
+	uint32_t ulLoad;
+	uint32_t ulBefore;
+	uint32_t ulAfter;
+
+#ifdef CONFIG_SLEEPMGR_ENABLE
+	if( sleepmgr_locks[ SLEEPMGR_ACTIVE ] != 0 )
+	{
+		*pulExpectedIdleTime = 0;
+		return;
+	}
+#endif
+
+	SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+	ulLoad = SysTick->LOAD;
+	ulBefore = SysTick->VAL;
+
+	__DSB();
+	__WFI();
+	__ISB();
+
+	ulAfter = SysTick->VAL;
+	if( ( SCB->ICSR & SCB_ICSR_PENDSTSET_Msk ) != 0 )
+	{
+		ullSleepCycles += ulBefore + ( ulLoad - ulAfter );
+	}
+	else
+	{
+		ullSleepCycles += ulBefore - ulAfter;
+	}
+	ulSleepCount++;
+
+	*pulExpectedIdleTime = 0;
+}
+
+/** Total time the idle task has spent asleep.
+ *  \return CPU cycles spent asleep since the scheduler started
  */
-unsigned long ulMainGetRunTimeCounterValue(void) {return 0UL;}
\ No newline at end of file
+uint64_t ullSleepGetCycles( void )
+{
+	uint64_t ullCycles;
+
+	taskENTER_CRITICAL();
+	ullCycles = ullSleepCycles;
+	taskEXIT_CRITICAL();
+	return ullCycles;
+}
+
+/** Number of times the idle task has gone to sleep, which is also the number of
+ *  times something (a task becoming due, or any other interrupt) has woken it.
+ *  \return Sleeps since the scheduler started
+ */
+uint32_t ulSleepGetCount( void )
+{
+	return ulSleepCount;
+}
+/*-----------------------------------------------------------*/
+/* vMainConfigureTimerForRunTimeStats() and ulMainGetRunTimeCounterValue(), which
+the kernel uses to gather run time statistics, are in FreeRTOSStats.c. */
+/*-----------------------------------------------------------*/
+#if (FRT_STATIC_ALLOCATION == 1)
+/** Idle task memory. With static allocation enabled, the kernel asks the
+ *  application for the idle task's TCB and stack instead of taking them from the
+ *  heap, so they are placed in .bss here.
+ *  \param[out] ppxIdleTaskTCBBuffer Set to the idle task control block
+ *  \param[out] ppxIdleTaskStackBuffer Set to the idle task stack
+ *  \param[out] pulIdleTaskStackSize Set to the idle task stack depth, in words
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+		StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize)
+{
+	static StaticTask_t xIdleTaskTCB;
+	static StackType_t uxIdleTaskStack[configMINIMAL_STACK_SIZE];
+
+	*ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+	*ppxIdleTaskStackBuffer = uxIdleTaskStack;
+	*pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+/** Timer service task memory, placed in .bss for the same reason as the idle
+ *  task's.
+ *  \param[out] ppxTimerTaskTCBBuffer Set to the timer task control block
+ *  \param[out] ppxTimerTaskStackBuffer Set to the timer task stack
+ *  \param[out] pulTimerTaskStackSize Set to the timer task stack depth, in words
+ */
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+		StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize)
+{
+	static StaticTask_t xTimerTaskTCB;
+	static StackType_t uxTimerTaskStack[configTIMER_TASK_STACK_DEPTH];
+
+	*ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+	*ppxTimerTaskStackBuffer = uxTimerTaskStack;
+	*pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+#endif
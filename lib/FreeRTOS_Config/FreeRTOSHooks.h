@@ -14,6 +14,32 @@
 #include "semphr.h"
 #include "portmacro.h"
 
+/** Set to 1 when the kernel in lib/FreeRTOS can create tasks and kernel objects in
+ *  caller-supplied memory (FreeRTOS V9.0.0 and later, with
+ *  configSUPPORT_STATIC_ALLOCATION enabled in FreeRTOSConfig.h).
+ */
+#if defined(tskKERNEL_VERSION_MAJOR) && (tskKERNEL_VERSION_MAJOR >= 9) \
+	&& (configSUPPORT_STATIC_ALLOCATION == 1)
+	#define FRT_STATIC_ALLOCATION 1
+#else
+	#define FRT_STATIC_ALLOCATION 0
+#endif
+
+/** Set to 1 when the kernel supports direct-to-task notifications (FreeRTOS V8.2.0
+ *  and later, with configUSE_TASK_NOTIFICATIONS enabled in FreeRTOSConfig.h).
+ */
+#if defined(tskKERNEL_VERSION_MAJOR) && ((tskKERNEL_VERSION_MAJOR > 8) \
+	|| ((tskKERNEL_VERSION_MAJOR == 8) && (tskKERNEL_VERSION_MINOR >= 2))) \
+	&& (configUSE_TASK_NOTIFICATIONS == 1)
+	#define FRT_TASK_NOTIFICATIONS 1
+#else
+	#define FRT_TASK_NOTIFICATIONS 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void hard_fault_isr(void);
 /** Hard fault - blink one short flash every two seconds */
 void HardFault_Handler(void);
@@ -32,9 +58,20 @@ void vApplicationMallocFailedHook(void);
 
 void  __attribute__((weak)) vApplicationIdleHook( void );
 void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName);
+uint64_t ullSleepGetCycles( void );
+uint32_t ulSleepGetCount( void );
 void __attribute__((weak)) vApplicationTickHook(void);
-void vMainConfigureTimerForRunTimeStats( void );
-unsigned long ulMainGetRunTimeCounterValue(void);
+
+#if (FRT_STATIC_ALLOCATION == 1)
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+		StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize);
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+		StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
 
 //#endif  // __arm__
 #endif  // _FREERTOSHOOKS_H
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ * \file
+ * \brief Stack usage monitor for FreeRTOS tasks
+ *
+ * The table of monitored tasks is changed by tasks registering and by the kernel's
+ * traceTASK_DELETE() hook, so changes are made in critical sections. Sampling reads
+ * one task at a time with the scheduler suspended, which keeps the task from being
+ * deleted while its stack is being looked at without holding interrupts off for
+ * the whole scan.
+ */
+#include <stdio.h>
+#include "FreeRTOSStack.h"
+
+/** A monitored task, or a free slot if xTask is NULL */
+typedef struct xSTACK_SLOT
+{
+	TaskHandle_t xTask;
+	const char *pcName;
+	UBaseType_t uxDepth;
+	UBaseType_t uxPeakUsed;
+	BaseType_t xWarned;
+} StackSlot_t;
+
+static StackSlot_t xSlots[ configSTACK_MONITOR_MAX_TASKS ];
+
+/** Snapshot used by vStackMonitorPrintReport(), kept off the caller's stack */
+static StackUsage_t xReport[ configSTACK_MONITOR_MAX_TASKS ];
+
+/** Sampling period and report interval of the monitor task */
+static TickType_t xMonitorPeriod;
+static UBaseType_t uxMonitorReportEvery;
+
+//------------------------------------------------------------------------------
+/** Works out the stack depth to recommend for a task.
+ *  \param[in] uxPeakUsed The most of its stack the task has used, in words
+ *  \return The peak plus configSTACK_MONITOR_MARGIN percent, rounded up to a
+ *          multiple of 4 words
+ */
+static UBaseType_t prvRecommend( UBaseType_t uxPeakUsed )
+{
+	UBaseType_t uxWords = ( uxPeakUsed * ( 100 + configSTACK_MONITOR_MARGIN ) + 99 ) / 100;
+
+	return ( uxWords + 3 ) & ~( ( UBaseType_t ) 3 );
+}
+
+//------------------------------------------------------------------------------
+void vStackMonitorRegister( TaskHandle_t xTask, UBaseType_t uxDepth )
+{
+	UBaseType_t ux;
+
+	if( xTask == NULL )
+	{
+		return;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		for( ux = 0; ux < configSTACK_MONITOR_MAX_TASKS; ux++ )
+		{
+			if( xSlots[ ux ].xTask == NULL )
+			{
+				xSlots[ ux ].xTask = xTask;
+				xSlots[ ux ].pcName = pcTaskGetTaskName( xTask );
+				xSlots[ ux ].uxDepth = uxDepth;
+				xSlots[ ux ].uxPeakUsed = 0;
+				xSlots[ ux ].xWarned = pdFALSE;
+				break;
+			}
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+
+void vStackMonitorTaskDeleted( void *pxTask )
+{
+	UBaseType_t ux;
+
+	for( ux = 0; ux < configSTACK_MONITOR_MAX_TASKS; ux++ )
+	{
+		if( xSlots[ ux ].xTask == ( TaskHandle_t ) pxTask )
+		{
+			xSlots[ ux ].xTask = NULL;
+		}
+	}
+}
+
+void vStackMonitorSample( void )
+{
+	UBaseType_t ux;
+
+	for( ux = 0; ux < configSTACK_MONITOR_MAX_TASKS; ux++ )
+	{
+		StackSlot_t *pxSlot = &xSlots[ ux ];
+		BaseType_t xWarn = pdFALSE;
+		UBaseType_t uxLeft = 0;
+
+		vTaskSuspendAll();
+		{
+			if( pxSlot->xTask != NULL )
+			{
+				uxLeft = uxTaskGetStackHighWaterMark( pxSlot->xTask );
+				if( pxSlot->uxDepth - uxLeft > pxSlot->uxPeakUsed )
+				{
+					pxSlot->uxPeakUsed = pxSlot->uxDepth - uxLeft;
+				}
+				if( ( pxSlot->xWarned == pdFALSE )
+					&& ( uxLeft * 100 < pxSlot->uxDepth * configSTACK_MONITOR_MARGIN ) )
+				{
+					pxSlot->xWarned = pdTRUE;
+					xWarn = pdTRUE;
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		if( xWarn == pdTRUE )
+		{
+			printf( "Stack warning: %s has %lu of %lu words left\r\n", pxSlot->pcName,
+					( unsigned long ) uxLeft, ( unsigned long ) pxSlot->uxDepth );
+		}
+	}
+}
+
+UBaseType_t uxStackMonitorGetSnapshot( StackUsage_t *pxUsage, UBaseType_t uxMaxTasks )
+{
+	UBaseType_t ux;
+	UBaseType_t uxCount = 0;
+
+	taskENTER_CRITICAL();
+	{
+		for( ux = 0; ( ux < configSTACK_MONITOR_MAX_TASKS ) && ( uxCount < uxMaxTasks ); ux++ )
+		{
+			if( xSlots[ ux ].xTask != NULL )
+			{
+				pxUsage[ uxCount ].pcName = xSlots[ ux ].pcName;
+				pxUsage[ uxCount ].uxDepth = xSlots[ ux ].uxDepth;
+				pxUsage[ uxCount ].uxPeakUsed = xSlots[ ux ].uxPeakUsed;
+				pxUsage[ uxCount ].uxRecommended = prvRecommend( xSlots[ ux ].uxPeakUsed );
+				uxCount++;
+			}
+		}
+	}
+	taskEXIT_CRITICAL();
+	return uxCount;
+}
+
+void vStackMonitorPrintReport( void )
+{
+	UBaseType_t uxCount;
+	UBaseType_t ux;
+	long lSaved = 0;
+
+	vStackMonitorSample();
+	uxCount = uxStackMonitorGetSnapshot( xReport, configSTACK_MONITOR_MAX_TASKS );
+
+	printf( "\r\n%-*s %7s %7s %7s\r\n", configMAX_TASK_NAME_LEN, "Task", "Depth",
+			"Peak", "Advised" );
+	for( ux = 0; ux < uxCount; ux++ )
+	{
+		printf( "%-*s %7lu %7lu %7lu%s\r\n", configMAX_TASK_NAME_LEN, xReport[ ux ].pcName,
+				( unsigned long ) xReport[ ux ].uxDepth,
+				( unsigned long ) xReport[ ux ].uxPeakUsed,
+				( unsigned long ) xReport[ ux ].uxRecommended,
+				( xReport[ ux ].uxRecommended > xReport[ ux ].uxDepth ) ? "  too small" : "" );
+		lSaved += ( long ) xReport[ ux ].uxDepth - ( long ) xReport[ ux ].uxRecommended;
+	}
+	printf( "Stack words (x%u bytes) that the advised depths would free: %ld\r\n",
+			( unsigned ) sizeof( StackType_t ), lSaved );
+}
+
+/** The monitor task: samples every period and reports every few samples.
+ *  \param[in] pvParameters Not used
+ */
+static void prvStackMonitorTask( void *pvParameters )
+{
+	TickType_t xLastWake = xTaskGetTickCount();
+	UBaseType_t uxSamples = 0;
+
+	( void ) pvParameters;
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastWake, xMonitorPeriod );
+		if( ( uxMonitorReportEvery != 0 ) && ( ++uxSamples >= uxMonitorReportEvery ) )
+		{
+			uxSamples = 0;
+			vStackMonitorPrintReport();
+		}
+		else
+		{
+			vStackMonitorSample();
+		}
+	}
+}
+
+BaseType_t xStackMonitorStartTask( UBaseType_t uxPriority, TickType_t xPeriod,
+		UBaseType_t uxReportEvery )
+{
+	TaskHandle_t xTask = NULL;
+	BaseType_t xResult;
+
+	xMonitorPeriod = xPeriod;
+	uxMonitorReportEvery = uxReportEvery;
+	xResult = xTaskCreate( prvStackMonitorTask, "Stack", configMINIMAL_STACK_SIZE * 2,
+			NULL, uxPriority, &xTask );
+	vStackMonitorRegister( xTask, configMINIMAL_STACK_SIZE * 2 );
+	return xResult;
+}
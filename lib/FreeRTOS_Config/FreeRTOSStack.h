@@ -0,0 +1,80 @@
+/**
+ * \file
+ * \brief Stack usage monitor for FreeRTOS tasks
+ *
+ * Tasks created through the C++ wrappers in lib/FreeRTOS_CPP/task_wrap.h register
+ * themselves here with the depth of their stack; C tasks can be added with
+ * vStackMonitorRegister(). Every sample reads each task's high-water mark (the least
+ * stack it has ever had left, which FreeRTOS finds by looking for the fill pattern
+ * it painted the stack with) and keeps the deepest use seen. A warning is printed
+ * the first time a task's spare stack falls below configSTACK_MONITOR_MARGIN percent
+ * of its depth, and the report recommends, for each task, its deepest use plus that
+ * margin.
+ *
+ * Stack depths are in words (StackType_t, 4 bytes on the SAM3X), as FreeRTOS counts
+ * them. The high-water mark only shows what the task has done so far, so the
+ * recommendations are only as good as the run they came from: exercise every path,
+ * including the error paths, before shrinking a stack.
+ */
+#ifndef _FREERTOSSTACK_H
+#define _FREERTOSSTACK_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Stack figures for one task, in words */
+typedef struct xSTACK_USAGE
+{
+	const char *pcName;				/**< The task's name */
+	UBaseType_t uxDepth;			/**< Size of the stack */
+	UBaseType_t uxPeakUsed;			/**< Most of the stack ever used */
+	UBaseType_t uxRecommended;		/**< Suggested size: peak plus margin */
+} StackUsage_t;
+
+/** Starts monitoring a task.
+ *  \param[in] xTask The task's handle; NULL is ignored, so the result of a failed
+ *             task creation can be passed straight in
+ *  \param[in] uxDepth The depth its stack was created with, in words
+ */
+void vStackMonitorRegister( TaskHandle_t xTask, UBaseType_t uxDepth );
+
+/** Trace hook: a task is being deleted, so stop monitoring it.
+ *  \param[in] pxTask The task's handle
+ */
+void vStackMonitorTaskDeleted( void *pxTask );
+
+/** Reads the high-water mark of every monitored task, updating the peaks and
+ *  printing a warning for each task that has newly dropped below the margin. */
+void vStackMonitorSample( void );
+
+/** Copies the figures of every monitored task, as of the last sample.
+ *  \param[out] pxUsage Array to fill in
+ *  \param[in] uxMaxTasks Number of entries in \p pxUsage
+ *  \return Number of entries filled in
+ */
+UBaseType_t uxStackMonitorGetSnapshot( StackUsage_t *pxUsage, UBaseType_t uxMaxTasks );
+
+/** Takes a sample, then prints a table of each task's stack depth, deepest use and
+ *  recommended depth, and the words that would be saved by using the
+ *  recommendations. */
+void vStackMonitorPrintReport( void );
+
+/** Creates a task which samples every period and prints the report every
+ *  \p uxReportEvery samples.
+ *  \param[in] uxPriority Priority of the monitor task
+ *  \param[in] xPeriod Ticks between samples
+ *  \param[in] uxReportEvery Samples between reports; 0 for warnings only
+ *  \return pdPASS if the task was created
+ */
+BaseType_t xStackMonitorStartTask( UBaseType_t uxPriority, TickType_t xPeriod,
+		UBaseType_t uxReportEvery );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _FREERTOSSTACK_H
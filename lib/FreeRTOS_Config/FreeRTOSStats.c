@@ -0,0 +1,288 @@
+/**
+ * \file
+ * \brief Run time statistics for FreeRTOS, measured with the DWT cycle counter
+ *
+ * The kernel calls vStatsTaskSwitchedIn() from vTaskSwitchContext() and
+ * vStatsTick() from the tick interrupt, both with interrupts up to
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY masked, so the bookkeeping here only needs
+ * protecting when it's read from a task.
+ */
+#include <stdio.h>
+#include <compiler.h>
+#include <cycle_counter.h>
+#include "FreeRTOSStats.h"
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+/** A task being tracked, or a free slot if pvTask is NULL */
+typedef struct xSTATS_SLOT
+{
+	void *pvTask;
+	TaskStats_t xStats;
+} StatsSlot_t;
+
+static StatsSlot_t xSlots[configSTATS_MAX_TASKS];
+
+/** The slot of the task that is running, or NULL if it isn't tracked */
+static StatsSlot_t *pxRunning = NULL;
+
+/** The cycle counter extended to 64 bits, and the 32-bit reading it was last
+ *  brought up to date with */
+static uint64_t ullCycles = 0;
+static uint32_t ulLastCount = 0;
+
+/** When the running task was switched in, and when the figures were last reset */
+static uint64_t ullSliceStart = 0;
+static uint64_t ullWindowStart = 0;
+
+/** Snapshot used by vStatsPrintReport(), kept off the caller's stack */
+static TaskStats_t xReport[configSTATS_MAX_TASKS];
+
+//------------------------------------------------------------------------------
+/** Folds the cycles since the last call into the 64-bit count. This must run at
+ *  least once per counter wrap (51 s at 84 MHz), which the tick hook guarantees.
+ *  \return The 64-bit cycle count
+ */
+static uint64_t prvUpdateCycles( void )
+{
+	uint32_t ulNow = DWT->CYCCNT;
+
+	ullCycles += ( uint32_t ) ( ulNow - ulLastCount );
+	ulLastCount = ulNow;
+	return ullCycles;
+}
+
+/** Finds the slot for a task, claiming a free one the first time the task is seen.
+ *  \return The slot, or NULL if the table is full
+ */
+static StatsSlot_t *prvFindSlot( void *pvTask, const char *pcName )
+{
+	StatsSlot_t *pxFree = NULL;
+	UBaseType_t ux;
+
+	for( ux = 0; ux < configSTATS_MAX_TASKS; ux++ )
+	{
+		if( xSlots[ ux ].pvTask == pvTask )
+		{
+			return &xSlots[ ux ];
+		}
+		if( ( xSlots[ ux ].pvTask == NULL ) && ( pxFree == NULL ) )
+		{
+			pxFree = &xSlots[ ux ];
+		}
+	}
+	if( pxFree != NULL )
+	{
+		pxFree->pvTask = pvTask;
+		pxFree->xStats.pcName = pcName;
+		pxFree->xStats.ullCycles = 0;
+		pxFree->xStats.ulLongestSlice = 0;
+		pxFree->xStats.ulSwitches = 0;
+	}
+	return pxFree;
+}
+
+/** Charges the running task with the cycles since it was switched in.
+ *  \param[in] ullNow The current 64-bit cycle count
+ */
+static void prvCloseSlice( uint64_t ullNow )
+{
+	uint64_t ullSlice = ullNow - ullSliceStart;
+
+	if( pxRunning != NULL )
+	{
+		pxRunning->xStats.ullCycles += ullSlice;
+		if( ullSlice > pxRunning->xStats.ulLongestSlice )
+		{
+			pxRunning->xStats.ulLongestSlice =
+				( ullSlice > 0xFFFFFFFFULL ) ? 0xFFFFFFFFUL : ( uint32_t ) ullSlice;
+		}
+	}
+	ullSliceStart = ullNow;
+}
+
+//------------------------------------------------------------------------------
+/** Starts the cycle counter; called by the kernel as the scheduler starts. */
+void vMainConfigureTimerForRunTimeStats( void )
+{
+	cycle_counter_enable();
+
+	ulLastCount = DWT->CYCCNT;
+	ullCycles = 0;
+	ullSliceStart = 0;
+	ullWindowStart = 0;
+}
+
+/** Time base for the kernel's own run time counters.
+ *  \return The cycle count in units of 64 cycles, truncated to 32 bits
+ */
+unsigned long ulMainGetRunTimeCounterValue( void )
+{
+	UBaseType_t uxMask = portSET_INTERRUPT_MASK_FROM_ISR();
+	uint64_t ullNow = prvUpdateCycles();
+
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxMask );
+	return ( unsigned long ) ( ullNow >> 6 );
+}
+
+/** Trace hook: a task has been picked to run.
+ *  \param[in] pxTask The task's handle
+ *  \param[in] pcName The task's name
+ */
+void vStatsTaskSwitchedIn( void *pxTask, const char *pcName )
+{
+	uint64_t ullNow = prvUpdateCycles();
+
+	// vTaskSwitchContext() often picks the task that was already running
+	if( ( pxRunning != NULL ) && ( pxRunning->pvTask == pxTask ) )
+	{
+		return;
+	}
+	prvCloseSlice( ullNow );
+	pxRunning = prvFindSlot( pxTask, pcName );
+	if( pxRunning != NULL )
+	{
+		pxRunning->xStats.ulSwitches++;
+	}
+}
+
+/** Trace hook: a task is being deleted, so its slot can be reused.
+ *  \param[in] pxTask The task's handle
+ */
+void vStatsTaskDeleted( void *pxTask )
+{
+	UBaseType_t ux;
+
+	for( ux = 0; ux < configSTATS_MAX_TASKS; ux++ )
+	{
+		if( xSlots[ ux ].pvTask == pxTask )
+		{
+			if( pxRunning == &xSlots[ ux ] )
+			{
+				pxRunning = NULL;
+			}
+			xSlots[ ux ].pvTask = NULL;
+		}
+	}
+}
+
+/** Trace hook: called on every tick to keep the 64-bit count from missing a wrap
+ *  of the cycle counter. */
+void vStatsTick( void )
+{
+	( void ) prvUpdateCycles();
+}
+
+//------------------------------------------------------------------------------
+uint64_t ullStatsGetCycles( void )
+{
+	uint64_t ullNow;
+
+	taskENTER_CRITICAL();
+	ullNow = prvUpdateCycles();
+	taskEXIT_CRITICAL();
+	return ullNow;
+}
+
+UBaseType_t uxStatsGetSnapshot( TaskStats_t *pxStats, UBaseType_t uxMaxTasks,
+		uint64_t *pullWindow )
+{
+	UBaseType_t ux;
+	UBaseType_t uxCount = 0;
+
+	taskENTER_CRITICAL();
+	{
+		// Include the slice the calling task is in the middle of
+		prvCloseSlice( prvUpdateCycles() );
+
+		for( ux = 0; ( ux < configSTATS_MAX_TASKS ) && ( uxCount < uxMaxTasks ); ux++ )
+		{
+			if( xSlots[ ux ].pvTask != NULL )
+			{
+				pxStats[ uxCount++ ] = xSlots[ ux ].xStats;
+			}
+		}
+		if( pullWindow != NULL )
+		{
+			*pullWindow = ullCycles - ullWindowStart;
+		}
+	}
+	taskEXIT_CRITICAL();
+	return uxCount;
+}
+
+void vStatsReset( void )
+{
+	UBaseType_t ux;
+
+	taskENTER_CRITICAL();
+	{
+		ullWindowStart = prvUpdateCycles();
+		ullSliceStart = ullWindowStart;
+		for( ux = 0; ux < configSTATS_MAX_TASKS; ux++ )
+		{
+			xSlots[ ux ].xStats.ullCycles = 0;
+			xSlots[ ux ].xStats.ulLongestSlice = 0;
+			xSlots[ ux ].xStats.ulSwitches = 0;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+
+void vStatsPrintReport( BaseType_t xReset )
+{
+	uint64_t ullWindow;
+	uint32_t ulCyclesPerUs = SystemCoreClock / 1000000UL;
+	UBaseType_t uxCount = uxStatsGetSnapshot( xReport, configSTATS_MAX_TASKS,
+			&ullWindow );
+	UBaseType_t ux;
+
+	if( xReset == pdTRUE )
+	{
+		vStatsReset();
+	}
+	if( ullWindow == 0 )
+	{
+		return;
+	}
+
+	printf( "\r\n%-*s %7s %12s %9s\r\n", configMAX_TASK_NAME_LEN, "Task", "CPU",
+			"Longest(us)", "Switches" );
+	for( ux = 0; ux < uxCount; ux++ )
+	{
+		uint32_t ulPermille = ( uint32_t ) ( ( xReport[ ux ].ullCycles * 1000ULL )
+				/ ullWindow );
+
+		printf( "%-*s %4lu.%lu%% %12lu %9lu\r\n", configMAX_TASK_NAME_LEN,
+				xReport[ ux ].pcName, ( unsigned long ) ( ulPermille / 10 ),
+				( unsigned long ) ( ulPermille % 10 ),
+				( unsigned long ) ( xReport[ ux ].ulLongestSlice / ulCyclesPerUs ),
+				( unsigned long ) xReport[ ux ].ulSwitches );
+	}
+	printf( "Window: %lu ms\r\n",
+			( unsigned long ) ( ullWindow / ( ulCyclesPerUs * 1000UL ) ) );
+}
+
+/** The report task: prints and resets the statistics once per period.
+ *  \param[in] pvParameters The period, in ticks
+ */
+static void prvStatsReportTask( void *pvParameters )
+{
+	TickType_t xPeriod = ( TickType_t ) ( uintptr_t ) pvParameters;
+	TickType_t xLastWake = xTaskGetTickCount();
+
+	vStatsReset();
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastWake, xPeriod );
+		vStatsPrintReport( pdTRUE );
+	}
+}
+
+BaseType_t xStatsStartReportTask( UBaseType_t uxPriority, TickType_t xPeriod )
+{
+	return xTaskCreate( prvStatsReportTask, "Stats", configMINIMAL_STACK_SIZE * 2,
+			( void * ) ( uintptr_t ) xPeriod, uxPriority, NULL );
+}
+
+#endif // configGENERATE_RUN_TIME_STATS
@@ -0,0 +1,76 @@
+/**
+ * \file
+ * \brief Run time statistics for FreeRTOS, measured with the DWT cycle counter
+ *
+ * The trace hooks set up in FreeRTOSConfig.h charge every CPU cycle between two
+ * context switches to the task that was running, so for each task this keeps its
+ * total run time, its longest continuous run without being switched out, and how
+ * many times it has been switched in. Interrupt handlers are charged to whichever
+ * task they interrupted. The 32-bit cycle counter is extended to 64 bits on every
+ * tick and context switch, so totals don't wrap.
+ *
+ * The cycle counter doesn't count while the processor sleeps in tickless idle, so
+ * the figures only cover time spent awake; ullSleepGetCycles() in FreeRTOSHooks.h
+ * gives the time spent asleep.
+ *
+ * Figures cover the time since the scheduler started or since the last call to
+ * vStatsReset(). Up to configSTATS_MAX_TASKS tasks are tracked; slots are freed
+ * when tasks are deleted.
+ *
+ * The hooks cost time on every tick and context switch, so they are only built in,
+ * along with the functions here, when the project Makefile sets
+ * RUN_TIME_STATS = 1 (see common/freertoslib.mk).
+ */
+#ifndef _FREERTOSSTATS_H
+#define _FREERTOSSTATS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Statistics for one task */
+typedef struct xTASK_STATS
+{
+	const char *pcName;			/**< The task's name */
+	uint64_t ullCycles;			/**< CPU cycles spent running */
+	uint32_t ulLongestSlice;	/**< Longest single stretch of running, in cycles */
+	uint32_t ulSwitches;		/**< Number of times the task was switched in */
+} TaskStats_t;
+
+/** Returns the 64-bit cycle count since the scheduler started. */
+uint64_t ullStatsGetCycles( void );
+
+/** Copies the statistics of every tracked task.
+ *  \param[out] pxStats Array to fill in
+ *  \param[in] uxMaxTasks Number of entries in \p pxStats
+ *  \param[out] pullWindow Set to the cycles elapsed since the figures were last
+ *              reset; may be NULL
+ *  \return Number of entries filled in
+ */
+UBaseType_t uxStatsGetSnapshot( TaskStats_t *pxStats, UBaseType_t uxMaxTasks,
+		uint64_t *pullWindow );
+
+/** Clears every task's figures and starts a new measuring window. */
+void vStatsReset( void );
+
+/** Prints a table of each task's CPU share, longest slice and switch count.
+ *  \param[in] xReset pdTRUE to start a new measuring window after printing
+ */
+void vStatsPrintReport( BaseType_t xReset );
+
+/** Creates a task which prints the report and resets the figures every period, so
+ *  that each report covers the period just past.
+ *  \param[in] uxPriority Priority of the report task
+ *  \param[in] xPeriod Ticks between reports
+ *  \return pdPASS if the task was created
+ */
+BaseType_t xStatsStartReportTask( UBaseType_t uxPriority, TickType_t xPeriod );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _FREERTOSSTATS_H
@@ -0,0 +1,395 @@
+/**
+ * \file
+ * \brief FreeRTOS heap 5 for the SAM3X: a first-fit heap over several regions of RAM
+ *
+ * FreeRTOS V8.0.1 stops at heap 4, so this provides heap 5, with the same interface
+ * as the one later kernels ship (vPortDefineHeapRegions()). Free blocks are kept in
+ * one list in order of address, so a freed block is merged with its free neighbours
+ * on either side; blocks in different regions are never merged, because each region
+ * ends in a marker that is never free.
+ *
+ * If the program doesn't call vPortDefineHeapRegions() before the first allocation,
+ * the heap takes all the RAM that the linker script leaves after the program's data,
+ * .bss and main stack (from _end), keeping the first configNEWLIB_HEAP_SIZE bytes
+ * for newlib's malloc(). That is the rest of SRAM0, seen through its mirror at
+ * 0x20070000, and the whole of SRAM1 at 0x20080000, set up as two regions.
+ *
+ * Newlib doesn't know about the heap, and ASF's _sbrk() lets its malloc() grow
+ * right up to the end of RAM. So freertoslib.mk links heap 5 with --wrap=_sbrk,
+ * and newlib's calls come to __wrap__sbrk() below instead, which refuses to grow
+ * newlib's heap past configNEWLIB_HEAP_SIZE; malloc() then returns NULL rather
+ * than overwriting this heap.
+ */
+#include <stdlib.h>
+#include <errno.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "FreeRTOSHeap.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Blocks smaller than this are not split off the end of a larger one. */
+#define heapMINIMUM_BLOCK_SIZE	( ( size_t ) ( xHeapStructSize << 1 ) )
+
+/* The top bit of a block's size is set while the block belongs to the program. */
+#define heapBLOCK_ALLOCATED_BIT	( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * 8 ) - 1 ) )
+
+/* Where SRAM0's mirror ends and SRAM1 begins, and where SRAM1 ends. */
+#define heapSRAM1_START			( ( size_t ) 0x20080000UL )
+#define heapSRAM1_END			( ( size_t ) 0x20088000UL )
+
+/* The header at the start of every block, which links the free blocks together. */
+typedef struct A_BLOCK_LINK
+{
+	struct A_BLOCK_LINK *pxNextFreeBlock;	/*<< The next free block in the list. */
+	size_t xBlockSize;						/*<< The size of the block, header included. */
+} BlockLink_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Puts a block into the list of free blocks, in order of address, merging it with
+ * the blocks on either side if they are free and adjacent.
+ */
+static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
+
+/*
+ * Sets up the default regions described at the top of this file.
+ */
+static void prvDefineDefaultRegions( void );
+
+#if defined( __arm__ )
+/*
+ * Stands in for _sbrk() for newlib, keeping its heap out of the default regions.
+ */
+void *__wrap__sbrk( int iIncrement );
+void *__real__sbrk( int iIncrement );
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The size of the block header, rounded up to keep blocks aligned. */
+static const size_t xHeapStructSize	= ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The start of the free list, and the marker at the end of the last region. */
+static BlockLink_t xStart, *pxEnd = NULL;
+
+/* Figures for the telemetry. */
+static size_t xTotalHeapSize = 0U;
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
+void *pvReturn = NULL;
+
+	vTaskSuspendAll();
+	{
+		if( pxEnd == NULL )
+		{
+			prvDefineDefaultRegions();
+		}
+
+		/* Sizes with the top bit set can't be told apart from allocated blocks. */
+		if( ( xWantedSize > 0 ) && ( ( xWantedSize & heapBLOCK_ALLOCATED_BIT ) == 0 ) )
+		{
+			/* Make room for the header, and keep the next block aligned. */
+			xWantedSize += xHeapStructSize;
+			if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+			{
+				xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+			}
+
+			if( xWantedSize <= xFreeBytesRemaining )
+			{
+				/* Find the first free block, in order of address, that is big enough. */
+				pxPreviousBlock = &xStart;
+				pxBlock = xStart.pxNextFreeBlock;
+				while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
+				{
+					pxPreviousBlock = pxBlock;
+					pxBlock = pxBlock->pxNextFreeBlock;
+				}
+
+				/* Reaching the end marker means no block was big enough. */
+				if( pxBlock != pxEnd )
+				{
+					pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+					pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+					/* Give the rest of the block back if it's big enough to be useful. */
+					if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+					{
+						pxNewBlockLink = ( BlockLink_t * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+						pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+						pxBlock->xBlockSize = xWantedSize;
+						prvInsertBlockIntoFreeList( pxNewBlockLink );
+					}
+
+					xFreeBytesRemaining -= pxBlock->xBlockSize;
+					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+					{
+						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+					}
+
+					pxBlock->xBlockSize |= heapBLOCK_ALLOCATED_BIT;
+					pxBlock->pxNextFreeBlock = NULL;
+				}
+			}
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+	}
+	#endif
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+uint8_t *puc = ( uint8_t * ) pv;
+BlockLink_t *pxLink;
+
+	if( pv != NULL )
+	{
+		puc -= xHeapStructSize;
+		pxLink = ( BlockLink_t * ) puc;
+
+		/* Catch blocks that were never allocated, or have been freed already. */
+		configASSERT( ( pxLink->xBlockSize & heapBLOCK_ALLOCATED_BIT ) != 0 );
+		configASSERT( pxLink->pxNextFreeBlock == NULL );
+
+		if( ( ( pxLink->xBlockSize & heapBLOCK_ALLOCATED_BIT ) != 0 )
+			&& ( pxLink->pxNextFreeBlock == NULL ) )
+		{
+			pxLink->xBlockSize &= ~heapBLOCK_ALLOCATED_BIT;
+
+			vTaskSuspendAll();
+			{
+				xFreeBytesRemaining += pxLink->xBlockSize;
+				traceFREE( pv, pxLink->xBlockSize );
+				prvInsertBlockIntoFreeList( pxLink );
+			}
+			( void ) xTaskResumeAll();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapFigures( HeapTelemetry_t *pxTelemetry )
+{
+BlockLink_t *pxBlock;
+size_t xLargest = 0U, xBlocks = 0U;
+
+	vTaskSuspendAll();
+	{
+		if( pxEnd != NULL )
+		{
+			for( pxBlock = xStart.pxNextFreeBlock; pxBlock != pxEnd; pxBlock = pxBlock->pxNextFreeBlock )
+			{
+				xBlocks++;
+				if( pxBlock->xBlockSize > xLargest )
+				{
+					xLargest = pxBlock->xBlockSize;
+				}
+			}
+		}
+
+		pxTelemetry->xTotalBytes = xTotalHeapSize;
+		pxTelemetry->xFreeBytes = xFreeBytesRemaining;
+		pxTelemetry->xMinimumEverFreeBytes = xMinimumEverFreeBytesRemaining;
+		pxTelemetry->xLargestFreeBlock = xLargest;
+		pxTelemetry->xFreeBlocks = xBlocks;
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert )
+{
+BlockLink_t *pxIterator;
+uint8_t *puc;
+
+	/* Find the free block just below the one being inserted. */
+	for( pxIterator = &xStart; pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock )
+	{
+		/* Nothing to do here, just iterate to the right position. */
+	}
+
+	/* Merge with the block below if it ends where this one starts. */
+	puc = ( uint8_t * ) pxIterator;
+	if( ( puc + pxIterator->xBlockSize ) == ( uint8_t * ) pxBlockToInsert )
+	{
+		pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
+		pxBlockToInsert = pxIterator;
+	}
+
+	/* Merge with the block above if this one ends where it starts. The end marker
+	of a region is never in the list, so blocks in different regions never meet. */
+	puc = ( uint8_t * ) pxBlockToInsert;
+	if( ( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) pxIterator->pxNextFreeBlock )
+		&& ( pxIterator->pxNextFreeBlock != pxEnd ) )
+	{
+		pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
+		pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock->pxNextFreeBlock;
+	}
+	else
+	{
+		pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
+	}
+
+	/* If the block was merged with the one below, that block already links to it. */
+	if( pxIterator != pxBlockToInsert )
+	{
+		pxIterator->pxNextFreeBlock = pxBlockToInsert;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
+{
+BlockLink_t *pxFirstFreeBlockInRegion, *pxLastFreeBlock = NULL;
+const HeapRegion_t *pxHeapRegion;
+size_t xAddress, xEndAddress;
+
+	/* Can only be called once, before anything is allocated. */
+	configASSERT( pxEnd == NULL );
+
+	xStart.xBlockSize = 0U;
+	xStart.pxNextFreeBlock = NULL;
+	xTotalHeapSize = 0U;
+
+	for( pxHeapRegion = pxHeapRegions; pxHeapRegion->pucStartAddress != NULL; pxHeapRegion++ )
+	{
+		/* Trim both ends of the region to the alignment. */
+		xAddress = ( size_t ) pxHeapRegion->pucStartAddress;
+		xEndAddress = xAddress + pxHeapRegion->xSizeInBytes;
+		xAddress = ( xAddress + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		xEndAddress = ( xEndAddress - xHeapStructSize ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+		/* Regions must come in order of address and be big enough to hold a block. */
+		configASSERT( ( pxEnd == NULL ) || ( xAddress > ( size_t ) pxEnd ) );
+		if( ( xEndAddress <= xAddress ) || ( ( xEndAddress - xAddress ) < heapMINIMUM_BLOCK_SIZE ) )
+		{
+			continue;
+		}
+
+		/* The region is one free block followed by an end marker, which is never
+		free, so nothing after the region can be merged with the block. */
+		pxFirstFreeBlockInRegion = ( BlockLink_t * ) xAddress;
+		pxFirstFreeBlockInRegion->xBlockSize = xEndAddress - xAddress;
+
+		pxEnd = ( BlockLink_t * ) xEndAddress;
+		pxEnd->xBlockSize = 0U;
+		pxEnd->pxNextFreeBlock = NULL;
+		pxFirstFreeBlockInRegion->pxNextFreeBlock = pxEnd;
+
+		/* Link the region's block after the last region's, bypassing its marker. */
+		if( pxLastFreeBlock == NULL )
+		{
+			xStart.pxNextFreeBlock = pxFirstFreeBlockInRegion;
+		}
+		else
+		{
+			pxLastFreeBlock->pxNextFreeBlock = pxFirstFreeBlockInRegion;
+		}
+		pxLastFreeBlock = pxFirstFreeBlockInRegion;
+
+		xTotalHeapSize += pxFirstFreeBlockInRegion->xBlockSize;
+	}
+
+	/* At least one region must have been usable. */
+	configASSERT( pxEnd != NULL );
+
+	xFreeBytesRemaining = xTotalHeapSize;
+	xMinimumEverFreeBytesRemaining = xTotalHeapSize;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDefineDefaultRegions( void )
+{
+#if defined( __arm__ )
+extern uint32_t _end;
+HeapRegion_t xRegions[ 3 ];
+size_t xStartAddress = ( size_t ) &_end + configNEWLIB_HEAP_SIZE;
+
+	if( xStartAddress < heapSRAM1_START )
+	{
+		/* The rest of SRAM0, then SRAM1. */
+		xRegions[ 0 ].pucStartAddress = ( uint8_t * ) xStartAddress;
+		xRegions[ 0 ].xSizeInBytes = heapSRAM1_START - xStartAddress;
+		xRegions[ 1 ].pucStartAddress = ( uint8_t * ) heapSRAM1_START;
+		xRegions[ 1 ].xSizeInBytes = heapSRAM1_END - heapSRAM1_START;
+		xRegions[ 2 ].pucStartAddress = NULL;
+		xRegions[ 2 ].xSizeInBytes = 0U;
+	}
+	else
+	{
+		/* The program's data has spilled into SRAM1; use what's left of it. */
+		xRegions[ 0 ].pucStartAddress = ( uint8_t * ) xStartAddress;
+		xRegions[ 0 ].xSizeInBytes = heapSRAM1_END - xStartAddress;
+		xRegions[ 1 ].pucStartAddress = NULL;
+		xRegions[ 1 ].xSizeInBytes = 0U;
+	}
+
+	vPortDefineHeapRegions( xRegions );
+#else
+	/* Off the target there is no default RAM; call vPortDefineHeapRegions(). */
+	configASSERT( pxEnd != NULL );
+#endif
+}
+/*-----------------------------------------------------------*/
+
+#if defined( __arm__ )
+void *__wrap__sbrk( int iIncrement )
+{
+extern uint32_t _end;
+uint8_t *pucBreak = ( uint8_t * ) __real__sbrk( 0 );
+
+	if( ( iIncrement > 0 ) &&
+		( pucBreak + iIncrement > ( uint8_t * ) &_end + configNEWLIB_HEAP_SIZE ) )
+	{
+		errno = ENOMEM;
+		return ( void * ) -1;
+	}
+	return __real__sbrk( iIncrement );
+}
+#endif
@@ -0,0 +1,49 @@
+/*
+ * FreeRTOS configuration for the host build ('make host', see common/host.mk).
+ *
+ * It takes the board's configuration from lib/FreeRTOS_Config and changes only
+ * what the POSIX port needs, so that a program runs with the same priorities, tick
+ * rate, hooks and statistics as on the board.
+ */
+
+#ifndef HOST_FREERTOS_CONFIG_H
+#define HOST_FREERTOS_CONFIG_H
+
+#include "../FreeRTOS_Config/FreeRTOSConfig.h"
+
+/* Each task is a thread, and its stack must be big enough for the C library as
+well as the task; PTHREAD_STACK_MIN is 16 KB on Linux. Stacks are counted in
+words, which are 8 bytes on a 64-bit host. */
+#undef configMINIMAL_STACK_SIZE
+#define configMINIMAL_STACK_SIZE		( ( unsigned short ) 4096 )
+
+/* The program uses heap_3, which ignores this, but the tests in tests/host use
+heap_4, which takes every task's stack out of an array this size. */
+#undef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 2 * 1024 * 1024 ) )
+
+/* The POSIX port has no tickless idle; the host sleeps between ticks anyway. */
+#undef configUSE_TICKLESS_IDLE
+#define configUSE_TICKLESS_IDLE			0
+
+/* The tick also marks where SysTick starts counting down from; see asf_host.h. */
+void host_tick( void );
+
+#undef traceTASK_INCREMENT_TICK
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+#define traceTASK_INCREMENT_TICK( xTickCount )	do { vStatsTick(); host_tick(); } while( 0 )
+#else
+#define traceTASK_INCREMENT_TICK( xTickCount )	host_tick()
+#endif
+
+/* The interrupt task in asf_host.c needs to know which task is running. */
+#define INCLUDE_xTaskGetCurrentTaskHandle	1
+
+/* Report a failed assertion and abort, so a debugger or sanitizer can show where
+it was rather than the program hanging. */
+void host_assert_failed( const char *pcFile, int iLine );
+
+#undef configASSERT
+#define configASSERT( x ) if( ( x ) == 0 ) { host_assert_failed( __FILE__, __LINE__ ); }
+
+#endif /* HOST_FREERTOS_CONFIG_H */
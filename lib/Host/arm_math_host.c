@@ -0,0 +1,448 @@
+//*************************************************************************************
+/** \file arm_math_host.c
+ *    This file contains plain C versions of the CMSIS-DSP functions declared in
+ *    lib/Host/asf/arm_math.h, for the host build. They keep to the library's
+ *    formats, coefficient orders and state layouts, so the pipeline code which
+ *    calls them runs unchanged; they are written to be easy to check rather than
+ *    fast. The FFT is worked in double precision and then scaled down by its
+ *    length, as the library's fixed-point FFTs scale their results.
+ */
+//*************************************************************************************
+
+#include <math.h>
+#include <string.h>
+#include <arm_math.h>
+
+/// Longest FFT the radix-4 functions accept
+#define FFT_MAX                     1024
+
+static q15_t sat_q15(int64_t value)
+{
+	return (q15_t) ((value > INT16_MAX) ? INT16_MAX : (value < INT16_MIN) ? INT16_MIN : value);
+}
+
+static q31_t sat_q31(int64_t value)
+{
+	return (q31_t) ((value > INT32_MAX) ? INT32_MAX : (value < INT32_MIN) ? INT32_MIN : value);
+}
+
+/** \brief Rounds a fraction to a fixed-point value with a given number of fraction
+ *  bits. The caller saturates it to the format's range.
+ */
+static int64_t to_fixed(double value, int bits)
+{
+	return (int64_t) llround(ldexp(value, bits));
+}
+
+//------------------------------------------------------------------------------
+// FIR filters. The coefficients are in time-reversed order, and the state holds
+// the last numTaps - 1 samples of the previous block followed by the current one.
+
+arm_status arm_fir_init_q15(arm_fir_instance_q15 *S, uint16_t numTaps, q15_t *pCoeffs,
+		q15_t *pState, uint32_t blockSize)
+{
+	if ((numTaps < 4) || (numTaps & 1))
+	{
+		return ARM_MATH_ARGUMENT_ERROR;
+	}
+	S->numTaps = numTaps;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (numTaps + blockSize) * sizeof(q15_t));
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_fir_init_q31(arm_fir_instance_q31 *S, uint16_t numTaps, q31_t *pCoeffs,
+		q31_t *pState, uint32_t blockSize)
+{
+	S->numTaps = numTaps;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (numTaps + blockSize - 1) * sizeof(q31_t));
+}
+
+void arm_fir_q15(const arm_fir_instance_q15 *S, q15_t *pSrc, q15_t *pDst,
+		uint32_t blockSize)
+{
+	uint32_t history = S->numTaps - 1U;
+	uint32_t n;
+	uint32_t k;
+
+	memcpy(S->pState + history, pSrc, blockSize * sizeof(q15_t));
+	for (n = 0; n < blockSize; n++)
+	{
+		int64_t acc = 0;
+
+		for (k = 0; k < S->numTaps; k++)
+		{
+			acc += (int32_t) S->pCoeffs[k] * S->pState[n + k];
+		}
+		pDst[n] = sat_q15(acc >> 15);
+	}
+	memmove(S->pState, S->pState + blockSize, history * sizeof(q15_t));
+}
+
+void arm_fir_q31(const arm_fir_instance_q31 *S, q31_t *pSrc, q31_t *pDst,
+		uint32_t blockSize)
+{
+	uint32_t history = S->numTaps - 1U;
+	uint32_t n;
+	uint32_t k;
+
+	memcpy(S->pState + history, pSrc, blockSize * sizeof(q31_t));
+	for (n = 0; n < blockSize; n++)
+	{
+		int64_t acc = 0;
+
+		for (k = 0; k < S->numTaps; k++)
+		{
+			acc += (int64_t) S->pCoeffs[k] * S->pState[n + k];
+		}
+		pDst[n] = (q31_t) (acc >> 31);
+	}
+	memmove(S->pState, S->pState + blockSize, history * sizeof(q31_t));
+}
+
+//------------------------------------------------------------------------------
+// Biquad cascades, direct form I. Each stage's state is {x[n-1], x[n-2], y[n-1],
+// y[n-2]}.
+
+void arm_biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 *S, uint8_t numStages,
+		q15_t *pCoeffs, q15_t *pState, int8_t postShift)
+{
+	S->numStages = (int8_t) numStages;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	S->postShift = postShift;
+	memset(pState, 0, 4U * numStages * sizeof(q15_t));
+}
+
+void arm_biquad_cascade_df1_init_q31(arm_biquad_casd_df1_inst_q31 *S, uint8_t numStages,
+		q31_t *pCoeffs, q31_t *pState, int8_t postShift)
+{
+	S->numStages = numStages;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	S->postShift = (uint8_t) postShift;
+	memset(pState, 0, 4U * numStages * sizeof(q31_t));
+}
+
+void arm_biquad_cascade_df1_q15(const arm_biquad_casd_df1_inst_q15 *S, q15_t *pSrc,
+		q15_t *pDst, uint32_t blockSize)
+{
+	const q15_t *b = S->pCoeffs;
+	q15_t *state = S->pState;
+	q15_t *in = pSrc;
+	int stage;
+	uint32_t n;
+
+	// Coefficients per stage are {b0, 0, b1, b2, a1, a2}
+	for (stage = 0; stage < S->numStages; stage++, b += 6, state += 4, in = pDst)
+	{
+		for (n = 0; n < blockSize; n++)
+		{
+			q15_t x = in[n];
+			int64_t acc = (int32_t) b[0] * x + (int32_t) b[2] * state[0]
+					+ (int32_t) b[3] * state[1] + (int32_t) b[4] * state[2]
+					+ (int32_t) b[5] * state[3];
+			q15_t y = sat_q15(acc >> (15 - S->postShift));
+
+			state[1] = state[0];
+			state[0] = x;
+			state[3] = state[2];
+			state[2] = y;
+			pDst[n] = y;
+		}
+	}
+}
+
+void arm_biquad_cascade_df1_q31(const arm_biquad_casd_df1_inst_q31 *S, q31_t *pSrc,
+		q31_t *pDst, uint32_t blockSize)
+{
+	const q31_t *b = S->pCoeffs;
+	q31_t *state = S->pState;
+	q31_t *in = pSrc;
+	uint32_t stage;
+	uint32_t n;
+
+	// Coefficients per stage are {b0, b1, b2, a1, a2}
+	for (stage = 0; stage < S->numStages; stage++, b += 5, state += 4, in = pDst)
+	{
+		for (n = 0; n < blockSize; n++)
+		{
+			q31_t x = in[n];
+			int64_t acc = (int64_t) b[0] * x + (int64_t) b[1] * state[0]
+					+ (int64_t) b[2] * state[1] + (int64_t) b[3] * state[2]
+					+ (int64_t) b[4] * state[3];
+			q31_t y = (q31_t) (acc >> (31 - S->postShift));
+
+			state[1] = state[0];
+			state[0] = x;
+			state[3] = state[2];
+			state[2] = y;
+			pDst[n] = y;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// FIR decimators: the FIR filter, worked out only for the last of every M samples.
+
+arm_status arm_fir_decimate_init_q15(arm_fir_decimate_instance_q15 *S, uint16_t numTaps,
+		uint8_t M, q15_t *pCoeffs, q15_t *pState, uint32_t blockSize)
+{
+	if ((M == 0) || (blockSize % M != 0))
+	{
+		return ARM_MATH_LENGTH_ERROR;
+	}
+	S->M = M;
+	S->numTaps = numTaps;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (numTaps + blockSize - 1) * sizeof(q15_t));
+	return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_fir_decimate_init_q31(arm_fir_decimate_instance_q31 *S, uint16_t numTaps,
+		uint8_t M, q31_t *pCoeffs, q31_t *pState, uint32_t blockSize)
+{
+	if ((M == 0) || (blockSize % M != 0))
+	{
+		return ARM_MATH_LENGTH_ERROR;
+	}
+	S->M = M;
+	S->numTaps = numTaps;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (numTaps + blockSize - 1) * sizeof(q31_t));
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_fir_decimate_q15(const arm_fir_decimate_instance_q15 *S, q15_t *pSrc,
+		q15_t *pDst, uint32_t blockSize)
+{
+	uint32_t history = S->numTaps - 1U;
+	uint32_t i;
+	uint32_t k;
+
+	memcpy(S->pState + history, pSrc, blockSize * sizeof(q15_t));
+	for (i = 0; i < blockSize / S->M; i++)
+	{
+		const q15_t *window = S->pState + i * S->M + S->M - 1;
+		int64_t acc = 0;
+
+		for (k = 0; k < S->numTaps; k++)
+		{
+			acc += (int32_t) S->pCoeffs[k] * window[k];
+		}
+		pDst[i] = sat_q15(acc >> 15);
+	}
+	memmove(S->pState, S->pState + blockSize, history * sizeof(q15_t));
+}
+
+void arm_fir_decimate_q31(const arm_fir_decimate_instance_q31 *S, q31_t *pSrc,
+		q31_t *pDst, uint32_t blockSize)
+{
+	uint32_t history = S->numTaps - 1U;
+	uint32_t i;
+	uint32_t k;
+
+	memcpy(S->pState + history, pSrc, blockSize * sizeof(q31_t));
+	for (i = 0; i < blockSize / S->M; i++)
+	{
+		const q31_t *window = S->pState + i * S->M + S->M - 1;
+		int64_t acc = 0;
+
+		for (k = 0; k < S->numTaps; k++)
+		{
+			acc += (int64_t) S->pCoeffs[k] * window[k];
+		}
+		pDst[i] = (q31_t) (acc >> 31);
+	}
+	memmove(S->pState, S->pState + blockSize, history * sizeof(q31_t));
+}
+
+//------------------------------------------------------------------------------
+void arm_rms_q15(q15_t *pSrc, uint32_t blockSize, q15_t *pResult)
+{
+	double sum = 0.0;
+	uint32_t n;
+
+	for (n = 0; n < blockSize; n++)
+	{
+		sum += ldexp(pSrc[n], -15) * ldexp(pSrc[n], -15);
+	}
+	*pResult = (blockSize > 0) ? sat_q15(to_fixed(sqrt(sum / blockSize), 15)) : 0;
+}
+
+void arm_rms_q31(q31_t *pSrc, uint32_t blockSize, q31_t *pResult)
+{
+	double sum = 0.0;
+	uint32_t n;
+
+	for (n = 0; n < blockSize; n++)
+	{
+		sum += ldexp(pSrc[n], -31) * ldexp(pSrc[n], -31);
+	}
+	*pResult = (blockSize > 0) ? sat_q31(to_fixed(sqrt(sum / blockSize), 31)) : 0;
+}
+
+//------------------------------------------------------------------------------
+/** \brief Returns whether a length is one the radix-4 FFTs accept.
+ */
+static int fft_length_ok(uint16_t fftLen)
+{
+	return (fftLen == 16) || (fftLen == 64) || (fftLen == 256) || (fftLen == FFT_MAX);
+}
+
+/** \brief Transforms interleaved complex samples in place, in double precision,
+ *  and scales the results down by the length.
+ *  @param re The real parts
+ *  @param im The imaginary parts
+ *  @param length Number of points, a power of 2
+ *  @param inverse Whether to do the inverse transform
+ */
+static void fft_double(double *re, double *im, uint32_t length, int inverse)
+{
+	uint32_t i;
+	uint32_t j;
+	uint32_t span;
+
+	// Bit-reversed order in, natural order out
+	for (i = 1, j = 0; i < length; i++)
+	{
+		uint32_t bit = length >> 1;
+
+		for (; j & bit; bit >>= 1)
+		{
+			j ^= bit;
+		}
+		j |= bit;
+		if (i < j)
+		{
+			double t = re[i];
+
+			re[i] = re[j];
+			re[j] = t;
+			t = im[i];
+			im[i] = im[j];
+			im[j] = t;
+		}
+	}
+
+	for (span = 2; span <= length; span <<= 1)
+	{
+		double angle = (inverse ? 2.0 : -2.0) * M_PI / span;
+
+		for (i = 0; i < length; i += span)
+		{
+			for (j = 0; j < span / 2; j++)
+			{
+				double wr = cos(angle * j);
+				double wi = sin(angle * j);
+				uint32_t a = i + j;
+				uint32_t b = a + span / 2;
+				double tr = re[b] * wr - im[b] * wi;
+				double ti = re[b] * wi + im[b] * wr;
+
+				re[b] = re[a] - tr;
+				im[b] = im[a] - ti;
+				re[a] += tr;
+				im[a] += ti;
+			}
+		}
+	}
+
+	for (i = 0; i < length; i++)
+	{
+		re[i] /= length;
+		im[i] /= length;
+	}
+}
+
+arm_status arm_cfft_radix4_init_q15(arm_cfft_radix4_instance_q15 *S, uint16_t fftLen,
+		uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+	memset(S, 0, sizeof(*S));
+	S->fftLen = fftLen;
+	S->ifftFlag = ifftFlag;
+	S->bitReverseFlag = bitReverseFlag;
+	return fft_length_ok(fftLen) ? ARM_MATH_SUCCESS : ARM_MATH_ARGUMENT_ERROR;
+}
+
+arm_status arm_cfft_radix4_init_q31(arm_cfft_radix4_instance_q31 *S, uint16_t fftLen,
+		uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+	memset(S, 0, sizeof(*S));
+	S->fftLen = fftLen;
+	S->ifftFlag = ifftFlag;
+	S->bitReverseFlag = bitReverseFlag;
+	return fft_length_ok(fftLen) ? ARM_MATH_SUCCESS : ARM_MATH_ARGUMENT_ERROR;
+}
+
+void arm_cfft_radix4_q15(const arm_cfft_radix4_instance_q15 *S, q15_t *pSrc)
+{
+	double re[FFT_MAX];
+	double im[FFT_MAX];
+	uint32_t i;
+
+	for (i = 0; i < S->fftLen; i++)
+	{
+		re[i] = ldexp(pSrc[2 * i], -15);
+		im[i] = ldexp(pSrc[2 * i + 1], -15);
+	}
+	fft_double(re, im, S->fftLen, S->ifftFlag);
+	for (i = 0; i < S->fftLen; i++)
+	{
+		pSrc[2 * i] = sat_q15(to_fixed(re[i], 15));
+		pSrc[2 * i + 1] = sat_q15(to_fixed(im[i], 15));
+	}
+}
+
+void arm_cfft_radix4_q31(const arm_cfft_radix4_instance_q31 *S, q31_t *pSrc)
+{
+	double re[FFT_MAX];
+	double im[FFT_MAX];
+	uint32_t i;
+
+	for (i = 0; i < S->fftLen; i++)
+	{
+		re[i] = ldexp(pSrc[2 * i], -31);
+		im[i] = ldexp(pSrc[2 * i + 1], -31);
+	}
+	fft_double(re, im, S->fftLen, S->ifftFlag);
+	for (i = 0; i < S->fftLen; i++)
+	{
+		pSrc[2 * i] = sat_q31(to_fixed(re[i], 31));
+		pSrc[2 * i + 1] = sat_q31(to_fixed(im[i], 31));
+	}
+}
+
+//------------------------------------------------------------------------------
+// Magnitudes of complex samples, in 2.14 (q15) or 2.30 (q31) format
+
+void arm_cmplx_mag_q15(q15_t *pSrc, q15_t *pDst, uint32_t numSamples)
+{
+	uint32_t n;
+
+	for (n = 0; n < numSamples; n++)
+	{
+		double re = ldexp(pSrc[2 * n], -15);
+		double im = ldexp(pSrc[2 * n + 1], -15);
+
+		pDst[n] = sat_q15(to_fixed(sqrt(re * re + im * im), 14));
+	}
+}
+
+void arm_cmplx_mag_q31(q31_t *pSrc, q31_t *pDst, uint32_t numSamples)
+{
+	uint32_t n;
+
+	for (n = 0; n < numSamples; n++)
+	{
+		double re = ldexp(pSrc[2 * n], -31);
+		double im = ldexp(pSrc[2 * n + 1], -31);
+
+		pDst[n] = sat_q31(to_fixed(sqrt(re * re + im * im), 30));
+	}
+}
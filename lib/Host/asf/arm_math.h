@@ -0,0 +1,149 @@
+//*************************************************************************************
+/** \file arm_math.h
+ *    This file stands in for the CMSIS-DSP header in the host build. It declares
+ *    the types and the functions lib/Services/dsp_pipeline.c uses, which are
+ *    plain C reference versions in lib/Host/arm_math_host.c. They give the same
+ *    results as the library to within rounding, but none of its speed, so cycle
+ *    counts from a host run say nothing about the board.
+ */
+//*************************************************************************************
+
+#ifndef _ARM_MATH_H
+#define _ARM_MATH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int8_t q7_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+typedef float float32_t;
+
+typedef enum
+{
+	ARM_MATH_SUCCESS = 0,
+	ARM_MATH_ARGUMENT_ERROR = -1,
+	ARM_MATH_LENGTH_ERROR = -2,
+	ARM_MATH_SIZE_MISMATCH = -3,
+	ARM_MATH_NANINF = -4,
+	ARM_MATH_SINGULAR = -5,
+	ARM_MATH_TEST_FAILURE = -6
+} arm_status;
+
+typedef struct
+{
+	uint16_t numTaps;
+	q15_t *pState;
+	q15_t *pCoeffs;
+} arm_fir_instance_q15;
+
+typedef struct
+{
+	uint16_t numTaps;
+	q31_t *pState;
+	q31_t *pCoeffs;
+} arm_fir_instance_q31;
+
+typedef struct
+{
+	int8_t numStages;
+	q15_t *pState;
+	q15_t *pCoeffs;
+	int8_t postShift;
+} arm_biquad_casd_df1_inst_q15;
+
+typedef struct
+{
+	uint32_t numStages;
+	q31_t *pState;
+	q31_t *pCoeffs;
+	uint8_t postShift;
+} arm_biquad_casd_df1_inst_q31;
+
+typedef struct
+{
+	uint8_t M;
+	uint16_t numTaps;
+	q15_t *pCoeffs;
+	q15_t *pState;
+} arm_fir_decimate_instance_q15;
+
+typedef struct
+{
+	uint8_t M;
+	uint16_t numTaps;
+	q31_t *pCoeffs;
+	q31_t *pState;
+} arm_fir_decimate_instance_q31;
+
+typedef struct
+{
+	uint16_t fftLen;
+	uint8_t ifftFlag;
+	uint8_t bitReverseFlag;
+	q15_t *pTwiddle;
+	uint16_t *pBitRevTable;
+	uint16_t twidCoefModifier;
+	uint16_t bitRevFactor;
+} arm_cfft_radix4_instance_q15;
+
+typedef struct
+{
+	uint16_t fftLen;
+	uint8_t ifftFlag;
+	uint8_t bitReverseFlag;
+	q31_t *pTwiddle;
+	uint16_t *pBitRevTable;
+	uint16_t twidCoefModifier;
+	uint16_t bitRevFactor;
+} arm_cfft_radix4_instance_q31;
+
+arm_status arm_fir_init_q15(arm_fir_instance_q15 *S, uint16_t numTaps, q15_t *pCoeffs,
+		q15_t *pState, uint32_t blockSize);
+void arm_fir_init_q31(arm_fir_instance_q31 *S, uint16_t numTaps, q31_t *pCoeffs,
+		q31_t *pState, uint32_t blockSize);
+void arm_fir_q15(const arm_fir_instance_q15 *S, q15_t *pSrc, q15_t *pDst,
+		uint32_t blockSize);
+void arm_fir_q31(const arm_fir_instance_q31 *S, q31_t *pSrc, q31_t *pDst,
+		uint32_t blockSize);
+
+void arm_biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 *S, uint8_t numStages,
+		q15_t *pCoeffs, q15_t *pState, int8_t postShift);
+void arm_biquad_cascade_df1_init_q31(arm_biquad_casd_df1_inst_q31 *S, uint8_t numStages,
+		q31_t *pCoeffs, q31_t *pState, int8_t postShift);
+void arm_biquad_cascade_df1_q15(const arm_biquad_casd_df1_inst_q15 *S, q15_t *pSrc,
+		q15_t *pDst, uint32_t blockSize);
+void arm_biquad_cascade_df1_q31(const arm_biquad_casd_df1_inst_q31 *S, q31_t *pSrc,
+		q31_t *pDst, uint32_t blockSize);
+
+arm_status arm_fir_decimate_init_q15(arm_fir_decimate_instance_q15 *S, uint16_t numTaps,
+		uint8_t M, q15_t *pCoeffs, q15_t *pState, uint32_t blockSize);
+arm_status arm_fir_decimate_init_q31(arm_fir_decimate_instance_q31 *S, uint16_t numTaps,
+		uint8_t M, q31_t *pCoeffs, q31_t *pState, uint32_t blockSize);
+void arm_fir_decimate_q15(const arm_fir_decimate_instance_q15 *S, q15_t *pSrc,
+		q15_t *pDst, uint32_t blockSize);
+void arm_fir_decimate_q31(const arm_fir_decimate_instance_q31 *S, q31_t *pSrc,
+		q31_t *pDst, uint32_t blockSize);
+
+void arm_rms_q15(q15_t *pSrc, uint32_t blockSize, q15_t *pResult);
+void arm_rms_q31(q31_t *pSrc, uint32_t blockSize, q31_t *pResult);
+
+arm_status arm_cfft_radix4_init_q15(arm_cfft_radix4_instance_q15 *S, uint16_t fftLen,
+		uint8_t ifftFlag, uint8_t bitReverseFlag);
+arm_status arm_cfft_radix4_init_q31(arm_cfft_radix4_instance_q31 *S, uint16_t fftLen,
+		uint8_t ifftFlag, uint8_t bitReverseFlag);
+void arm_cfft_radix4_q15(const arm_cfft_radix4_instance_q15 *S, q15_t *pSrc);
+void arm_cfft_radix4_q31(const arm_cfft_radix4_instance_q31 *S, q31_t *pSrc);
+
+void arm_cmplx_mag_q15(q15_t *pSrc, q15_t *pDst, uint32_t numSamples);
+void arm_cmplx_mag_q31(q31_t *pSrc, q31_t *pDst, uint32_t numSamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _ARM_MATH_H
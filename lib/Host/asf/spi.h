@@ -0,0 +1,4 @@
+/** \file spi.h
+ *  Host stand-in for the ASF header of the same name; see lib/Host/asf_host.h.
+ */
+#include "../asf_host.h"
@@ -0,0 +1,5 @@
+/** \file stdio_serial.h
+ *  Host stand-in for the ASF header of the same name; see lib/Host/asf_host.h.
+ */
+#include "../asf_host.h"
+#include <conf_uart_serial.h>
@@ -0,0 +1,1609 @@
+//*************************************************************************************
+/** \file asf_host.c
+ *    This file contains the host stand-ins for ASF and CMSIS declared in
+ *    asf_host.h, and the host's console output.
+ *
+ *    The FreeRTOS POSIX port runs each task in a thread of its own and stops one
+ *    wherever it happens to be when another is to run. A task stopped inside
+ *    printf() would still hold the C library's lock on stdout, and the next task
+ *    to print would wait for it for ever. So 'make host' renames printf() and
+ *    puts() to host_printf() and host_puts() here, much as the board build
+ *    renames printf() to iprintf(), and they format into a buffer and write it
+ *    out in a critical section.
+ */
+//*************************************************************************************
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "asf_host.h"
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+/// Longest line host_printf() writes in one go; longer output is cut short
+#define HOST_PRINTF_MAX             512
+
+/// Most runs of one timer's handler at once, after the process has been held up
+#define HOST_TC_MAX_CATCH_UP        100
+
+/// Most PIO handlers which can be set up
+#define HOST_PIO_HANDLERS           32
+
+/// Timer counter channels: three blocks of three
+#define HOST_TC_CHANNELS            9
+
+/// The ADC's mid-scale reading, and how far the made-up signals swing either side
+#define HOST_ADC_MID                2048
+#define HOST_ADC_SWING              1000.0
+
+/// The bits of Pdc.HOST_END: a buffer count has reached zero since it was written
+#define HOST_PDC_ENDRX              (1UL << 0)
+#define HOST_PDC_ENDTX              (1UL << 1)
+
+uint32_t SystemCoreClock = HOST_CPU_HZ;
+CoreDebug_Type host_core_debug;
+SCB_Type host_scb;
+Pio host_pio[4];
+Tc host_tc[3] = { { 0 }, { 1 }, { 2 } };
+Uart host_uart;
+Adc host_adc;
+Spi host_spi;
+Dmac host_dmac;
+Twi host_twi[2];
+
+/// The linker script's start and end of the code, which nothing on the host is in
+uint32_t _sfixed;
+uint32_t _efixed;
+
+/// The PDC channels of the UART and the ADC
+static Pdc uart_pdc;
+static Pdc adc_pdc;
+
+/// Conversions of the ADC's whole sequence since it was set up
+static uint64_t adc_sequences;
+
+/// The cycle counter, the last value it was given, and how far it is behind the clock
+static DWT_Type host_dwt_regs;
+static uint32_t dwt_last;
+static uint32_t dwt_offset;
+
+/// SysTick, and the cycle count at the last FreeRTOS tick
+static SysTick_Type host_systick_regs;
+static uint32_t tick_cycles;
+
+/// When the process started, in nanoseconds on the monotonic clock
+static uint64_t start_ns;
+
+/** \brief The state of one timer counter channel.
+ */
+struct host_tc_channel
+{
+	uint32_t cmr;                   ///< Channel mode, as given to tc_init()
+	uint32_t ra;                    ///< RA compare value
+	uint32_t rc;                    ///< RC compare value
+	uint32_t imr;                   ///< Interrupts enabled
+	uint32_t sr;                    ///< Status bits not yet read
+	bool running;                   ///< Whether the clock is running
+	uint64_t start_ns;              ///< When the channel was started
+	uint32_t last_cv;               ///< Counter value at the last check
+	uint64_t last_periods;          ///< RC periods counted at the last check
+};
+
+static struct host_tc_channel tc_channels[HOST_TC_CHANNELS];
+
+/** \brief A handler set up with pio_handler_set().
+ */
+struct host_pio_handler
+{
+	uint32_t port;
+	uint32_t id;
+	uint32_t mask;
+	void (*handler)(uint32_t, uint32_t);
+};
+
+static struct host_pio_handler pio_handlers[HOST_PIO_HANDLERS];
+static uint32_t pio_handler_count;
+
+/** \brief The state of a DMAC channel, loaded from its descriptor.
+ */
+struct host_dmac_channel
+{
+	uint32_t cfg;                   ///< Channel configuration
+	uint32_t ctrlb;                 ///< Flow control and address modes
+	uint8_t *source;                ///< Where the next byte comes from
+	uint8_t *destination;           ///< Where it goes
+	uint32_t left;                  ///< Bytes still to move
+};
+
+static struct host_dmac_channel dmac_channels[HOST_DMAC_CHANNELS];
+
+/// Interrupts enabled in the NVIC, and waiting to run
+static volatile uint64_t irq_enabled;
+static volatile uint64_t irq_pending;
+
+/// Whether an interrupt handler is running
+static volatile bool irq_active;
+
+/// Depth of cpu_irq_save() calls, and whether an interrupt was made pending inside one
+static uint32_t irq_nesting;
+static bool irq_wake_deferred;
+
+/// The task which runs interrupt handlers, and what wakes it early
+static TaskHandle_t irq_task;
+static SemaphoreHandle_t irq_wake;
+
+/// Whether HOST_TRACE_PINS is set, worked out the first time a pin changes
+static int trace_pins = -1;
+
+// The peripheral handlers the stand-ins can run. Those the program doesn't define
+// are left null.
+#pragma weak UART_Handler
+#pragma weak TWI0_Handler
+#pragma weak TWI1_Handler
+#pragma weak SPI0_Handler
+#pragma weak ADC_Handler
+#pragma weak DMAC_Handler
+#pragma weak TRNG_Handler
+#pragma weak TC0_Handler
+#pragma weak TC1_Handler
+#pragma weak TC2_Handler
+#pragma weak TC3_Handler
+#pragma weak TC4_Handler
+#pragma weak TC5_Handler
+#pragma weak TC6_Handler
+#pragma weak TC7_Handler
+#pragma weak TC8_Handler
+
+/// The timer channels' handlers, in channel order
+static void (* const tc_handlers[HOST_TC_CHANNELS])(void) =
+{
+	TC0_Handler, TC1_Handler, TC2_Handler, TC3_Handler, TC4_Handler,
+	TC5_Handler, TC6_Handler, TC7_Handler, TC8_Handler
+};
+
+static void host_pio_dispatch(uint32_t port);
+static void host_irq_dispatch(void);
+static void host_adc_trigger(uint32_t channel, uint64_t count);
+
+//------------------------------------------------------------------------------
+/** \brief Returns the time since the process started, in nanoseconds.
+ */
+static uint64_t host_now_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	if (start_ns == 0)
+	{
+		start_ns = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec - 1;
+	}
+	return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec - start_ns;
+}
+
+/** \brief Converts a time to counts of a clock, without overflowing.
+ *  @param ns The time in nanoseconds
+ *  @param hz The clock's rate
+ */
+static uint64_t host_ns_to_counts(uint64_t ns, uint32_t hz)
+{
+	return (ns / 1000000000ULL) * hz + (ns % 1000000000ULL) * hz / 1000000000ULL;
+}
+
+/** \brief Runs the pending interrupts: in the interrupt task once the scheduler
+ *  is running, and straight away before then, as the board would.
+ */
+static void host_irq_wake(void)
+{
+	if ((irq_task != NULL) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+	{
+		xSemaphoreGive(irq_wake);
+	}
+	else
+	{
+		host_irq_dispatch();
+	}
+}
+
+/** \brief Makes an interrupt pending, and wakes the interrupt task for it. Inside
+ *  cpu_irq_save() that waits until cpu_irq_restore() has been called, and inside
+ *  a handler until the handler has returned.
+ */
+static void host_irq_raise(IRQn_Type irq)
+{
+	__atomic_or_fetch(&irq_pending, 1ULL << irq, __ATOMIC_SEQ_CST);
+	if (irq_active || !(irq_enabled & (1ULL << irq)))
+	{
+		return;
+	}
+	if (irq_nesting > 0)
+	{
+		irq_wake_deferred = true;
+	}
+	else
+	{
+		host_irq_wake();
+	}
+}
+
+/** \brief Returns the handler the program has for a peripheral interrupt, or null.
+ */
+static void (*host_irq_vector(IRQn_Type irq))(void)
+{
+	switch (irq)
+	{
+		case ID_UART: return UART_Handler;
+		case ID_TWI0: return TWI0_Handler;
+		case ID_TWI1: return TWI1_Handler;
+		case ID_SPI0: return SPI0_Handler;
+		case ID_ADC:  return ADC_Handler;
+		case ID_DMAC: return DMAC_Handler;
+		case ID_TRNG: return TRNG_Handler;
+		default:
+			if ((irq >= ID_TC0) && (irq <= ID_TC8))
+			{
+				return tc_handlers[irq - ID_TC0];
+			}
+			return NULL;
+	}
+}
+
+/** \brief Runs an interrupt's handler now if it is enabled and pending, for the
+ *  stand-ins which must let the program keep up part way through their work.
+ *  Only called from the interrupt handlers' context.
+ */
+static void host_irq_service(IRQn_Type irq)
+{
+	void (*handler)(void) = host_irq_vector(irq);
+
+	if ((irq_pending & irq_enabled & (1ULL << irq)) && (handler != NULL))
+	{
+		__atomic_and_fetch(&irq_pending, ~(1ULL << irq), __ATOMIC_SEQ_CST);
+		handler();
+	}
+}
+
+DWT_Type *host_dwt(void)
+{
+	uint32_t raw = (uint32_t) host_ns_to_counts(host_now_ns(), HOST_CPU_HZ);
+
+	// If the program has written the counter since it was last brought up to
+	// date, count on from what it wrote
+	if (host_dwt_regs.CYCCNT != dwt_last)
+	{
+		dwt_offset = raw - host_dwt_regs.CYCCNT;
+	}
+	host_dwt_regs.CYCCNT = dwt_last = raw - dwt_offset;
+	return &host_dwt_regs;
+}
+
+SysTick_Type *host_systick(void)
+{
+	uint32_t since = (uint32_t) host_ns_to_counts(host_now_ns(), HOST_CPU_HZ) - tick_cycles;
+
+	host_systick_regs.CTRL = SysTick_CTRL_ENABLE_Msk;
+	host_systick_regs.LOAD = HOST_CPU_HZ / configTICK_RATE_HZ - 1;
+	host_systick_regs.VAL = (since < host_systick_regs.LOAD) ? host_systick_regs.LOAD - since : 0;
+	return &host_systick_regs;
+}
+
+void host_tick(void)
+{
+	tick_cycles = (uint32_t) host_ns_to_counts(host_now_ns(), HOST_CPU_HZ);
+}
+
+uint32_t __get_IPSR(void)
+{
+	return irq_active ? 1 : 0;
+}
+
+uint32_t __get_PRIMASK(void)
+{
+	return 0;
+}
+
+uint32_t __get_BASEPRI(void)
+{
+	return (irq_nesting > 0) ? configMAX_SYSCALL_INTERRUPT_PRIORITY : 0;
+}
+
+//------------------------------------------------------------------------------
+/** \brief Works out the rate a timer channel counts at from its clock selection.
+ */
+static uint32_t host_tc_hz(const struct host_tc_channel *ch)
+{
+	switch (ch->cmr & TC_CMR_TCCLKS_Msk)
+	{
+		case TC_CMR_TCCLKS_TIMER_CLOCK1: return HOST_CPU_HZ / 2;
+		case TC_CMR_TCCLKS_TIMER_CLOCK2: return HOST_CPU_HZ / 8;
+		case TC_CMR_TCCLKS_TIMER_CLOCK3: return HOST_CPU_HZ / 32;
+		case TC_CMR_TCCLKS_TIMER_CLOCK4: return HOST_CPU_HZ / 128;
+		default:                         return HOST_SLCK_HZ;
+	}
+}
+
+/** \brief Returns whether a channel's counter goes back to zero on RC compare.
+ */
+static bool host_tc_resets_on_rc(const struct host_tc_channel *ch)
+{
+	return (((ch->cmr & TC_CMR_WAVE) && ((ch->cmr & TC_CMR_WAVSEL_Msk) == TC_CMR_WAVSEL_UP_RC))
+			|| (!(ch->cmr & TC_CMR_WAVE) && (ch->cmr & TC_CMR_CPCTRG))) && (ch->rc != 0);
+}
+
+/** \brief Returns the counts since a channel was started.
+ */
+static uint64_t host_tc_counts(const struct host_tc_channel *ch)
+{
+	return ch->running ? host_ns_to_counts(host_now_ns() - ch->start_ns, host_tc_hz(ch)) : 0;
+}
+
+static struct host_tc_channel *host_tc_channel(const Tc *tc, uint32_t channel)
+{
+	return &tc_channels[tc->index * 3 + channel];
+}
+
+/** \brief Runs a timer channel's handler once for each RC compare since it was
+ *  last checked.
+ *  @param index The channel, 0 to 8
+ */
+static void host_tc_check(uint32_t index)
+{
+	struct host_tc_channel *ch = &tc_channels[index];
+	uint64_t counts;
+	uint64_t due = 0;
+	uint32_t cv;
+
+	if (!ch->running)
+	{
+		return;
+	}
+	counts = host_tc_counts(ch);
+	if (host_tc_resets_on_rc(ch))
+	{
+		due = counts / ch->rc - ch->last_periods;
+		ch->last_periods += due;
+		host_adc_trigger(index, due);
+	}
+	else
+	{
+		cv = (uint32_t) counts;
+		if ((uint32_t) (ch->rc - ch->last_cv - 1) < (uint32_t) (cv - ch->last_cv))
+		{
+			due = 1;
+		}
+		ch->last_cv = cv;
+	}
+	if (due > HOST_TC_MAX_CATCH_UP)
+	{
+		due = HOST_TC_MAX_CATCH_UP;
+	}
+	for (; due > 0; due--)
+	{
+		ch->sr |= TC_SR_CPCS;
+		if ((ch->imr & TC_SR_CPCS) && (irq_enabled & (1ULL << (ID_TC0 + index)))
+				&& (tc_handlers[index] != NULL))
+		{
+			tc_handlers[index]();
+		}
+	}
+}
+
+/** \brief Runs every interrupt that is due or pending, lowest number first.
+ */
+static void host_irq_dispatch(void)
+{
+	uint32_t i;
+	uint64_t pending;
+	IRQn_Type irq;
+	void (*handler)(void);
+
+	if (irq_active)
+	{
+		return;
+	}
+	irq_active = true;
+	for (i = 0; i < HOST_TC_CHANNELS; i++)
+	{
+		host_tc_check(i);
+	}
+	while ((pending = irq_pending & irq_enabled) != 0)
+	{
+		irq = (IRQn_Type) __builtin_ctzll(pending);
+		__atomic_and_fetch(&irq_pending, ~(1ULL << irq), __ATOMIC_SEQ_CST);
+		handler = host_irq_vector(irq);
+		if ((irq >= ID_PIOA) && (irq <= ID_PIOD))
+		{
+			host_pio_dispatch((uint32_t) (irq - ID_PIOA));
+		}
+		else if (handler != NULL)
+		{
+			handler();
+		}
+	}
+	irq_active = false;
+}
+
+/** \brief The task which stands in for the NVIC. It checks for due interrupts
+ *  every tick, or sooner when one is made pending, and runs their handlers. If
+ *  HOST_RUN_MS is set in the environment, it ends the program after that many
+ *  milliseconds, so that profilers and leak checkers get a clean exit.
+ *  @param params Not used
+ */
+static void host_irq_task(void *params)
+{
+	const char *run_ms = getenv("HOST_RUN_MS");
+	uint64_t end_ns = (run_ms != NULL) ? strtoull(run_ms, NULL, 10) * 1000000ULL : 0;
+
+	(void) params;
+
+	for (;;)
+	{
+		xSemaphoreTake(irq_wake, 1);
+		host_irq_dispatch();
+		if ((end_ns != 0) && (host_now_ns() >= end_ns))
+		{
+			host_printf("\r\nHOST_RUN_MS reached, stopping\r\n");
+			exit(0);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+	__atomic_or_fetch(&irq_enabled, 1ULL << irq, __ATOMIC_SEQ_CST);
+	if (irq_pending & (1ULL << irq))
+	{
+		host_irq_raise(irq);
+	}
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+	__atomic_and_fetch(&irq_enabled, ~(1ULL << irq), __ATOMIC_SEQ_CST);
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type irq)
+{
+	host_irq_raise(irq);
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+	__atomic_and_fetch(&irq_pending, ~(1ULL << irq), __ATOMIC_SEQ_CST);
+}
+
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+	(void) irq;
+	(void) priority;
+}
+
+void NVIC_SystemReset(void)
+{
+	host_printf("\r\nSystem reset, stopping\r\n");
+	exit(1);
+}
+
+irqflags_t cpu_irq_save(void)
+{
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+	{
+		taskENTER_CRITICAL();
+	}
+	irq_nesting++;
+	return 0;
+}
+
+void cpu_irq_restore(irqflags_t flags)
+{
+	(void) flags;
+
+	irq_nesting--;
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+	{
+		taskEXIT_CRITICAL();
+	}
+	if ((irq_nesting == 0) && irq_wake_deferred)
+	{
+		irq_wake_deferred = false;
+		host_irq_wake();
+	}
+}
+
+void cpu_irq_enable(void)
+{
+	taskENABLE_INTERRUPTS();
+}
+
+void cpu_irq_disable(void)
+{
+	taskDISABLE_INTERRUPTS();
+}
+
+//------------------------------------------------------------------------------
+void sysclk_init(void)
+{
+	// Every example calls this first, so it sets up the interrupt task as well
+	if (irq_task == NULL)
+	{
+		host_now_ns();
+		irq_wake = xSemaphoreCreateBinary();
+		xTaskCreate(host_irq_task, "IRQ", configMINIMAL_STACK_SIZE * 2, NULL,
+				configMAX_PRIORITIES - 1, &irq_task);
+	}
+}
+
+uint32_t sysclk_get_main_hz(void)
+{
+	return HOST_CPU_HZ;
+}
+
+uint32_t sysclk_get_cpu_hz(void)
+{
+	return HOST_CPU_HZ;
+}
+
+uint32_t sysclk_get_peripheral_hz(void)
+{
+	return HOST_CPU_HZ;
+}
+
+void sysclk_enable_peripheral_clock(uint32_t id)
+{
+	(void) id;
+}
+
+void sysclk_disable_peripheral_clock(uint32_t id)
+{
+	(void) id;
+}
+
+uint32_t pmc_enable_periph_clk(uint32_t id)
+{
+	(void) id;
+	return 0;
+}
+
+uint32_t pmc_disable_periph_clk(uint32_t id)
+{
+	(void) id;
+	return 0;
+}
+
+void board_init(void)
+{
+	ioport_init();
+	ioport_set_pin_dir(LED0_GPIO, IOPORT_DIR_OUTPUT);
+	ioport_set_pin_dir(LED1_GPIO, IOPORT_DIR_OUTPUT);
+	ioport_set_pin_dir(LED2_GPIO, IOPORT_DIR_OUTPUT);
+}
+
+//------------------------------------------------------------------------------
+/** \brief Sets the levels of some of a port's pins, printing the change if
+ *  HOST_TRACE_PINS is set.
+ */
+static void host_pins_write(Pio *pio, uint32_t mask, bool level)
+{
+	uint32_t before = pio->PIO_ODSR;
+	uint32_t changed;
+	uint32_t bit;
+
+	if (level)
+	{
+		pio->PIO_ODSR |= mask;
+		pio->PIO_PDSR |= mask;
+	}
+	else
+	{
+		pio->PIO_ODSR &= ~mask;
+		pio->PIO_PDSR &= ~mask;
+	}
+
+	if (trace_pins < 0)
+	{
+		trace_pins = (getenv("HOST_TRACE_PINS") != NULL);
+	}
+	changed = (before ^ pio->PIO_ODSR) & mask;
+	for (bit = 0; trace_pins && (changed != 0); bit++, changed >>= 1)
+	{
+		if (changed & 1)
+		{
+			host_printf("[P%c%lu %s]", (char) ('A' + (pio - host_pio)),
+					(unsigned long) bit, level ? "high" : "low");
+		}
+	}
+}
+
+void ioport_init(void)
+{
+}
+
+void ioport_set_pin_dir(ioport_pin_t pin, enum ioport_direction dir)
+{
+	if (dir == IOPORT_DIR_OUTPUT)
+	{
+		host_pio[pin / 32].PIO_OSR |= 1UL << (pin % 32);
+	}
+	else
+	{
+		host_pio[pin / 32].PIO_OSR &= ~(1UL << (pin % 32));
+	}
+}
+
+void ioport_set_pin_mode(ioport_pin_t pin, ioport_port_mask_t mode)
+{
+	(void) pin;
+	(void) mode;
+}
+
+void ioport_set_pin_level(ioport_pin_t pin, bool level)
+{
+	host_pins_write(&host_pio[pin / 32], 1UL << (pin % 32), level);
+}
+
+void ioport_toggle_pin_level(ioport_pin_t pin)
+{
+	ioport_set_pin_level(pin, !ioport_get_pin_level(pin));
+}
+
+bool ioport_get_pin_level(ioport_pin_t pin)
+{
+	return (host_pio[pin / 32].PIO_PDSR & (1UL << (pin % 32))) != 0;
+}
+
+uint32_t gpio_configure_pin(uint32_t pin, uint32_t flags)
+{
+	uint32_t type = flags & PIO_TYPE_Msk;
+
+	if ((type == PIO_OUTPUT_0) || (type == PIO_OUTPUT_1))
+	{
+		ioport_set_pin_dir(pin, IOPORT_DIR_OUTPUT);
+		ioport_set_pin_level(pin, type == PIO_OUTPUT_1);
+	}
+	else if (type == PIO_INPUT)
+	{
+		ioport_set_pin_dir(pin, IOPORT_DIR_INPUT);
+	}
+	return 1;
+}
+
+void pio_set(Pio *pio, uint32_t mask)
+{
+	host_pins_write(pio, mask, true);
+}
+
+void pio_clear(Pio *pio, uint32_t mask)
+{
+	host_pins_write(pio, mask, false);
+}
+
+uint32_t pio_get(Pio *pio, uint32_t type, uint32_t mask)
+{
+	uint32_t levels = ((type == PIO_OUTPUT_0) || (type == PIO_OUTPUT_1))
+			? pio->PIO_ODSR : pio->PIO_PDSR;
+
+	return (levels & mask) ? 1 : 0;
+}
+
+void pio_set_output(Pio *pio, uint32_t mask, uint32_t default_level,
+		uint32_t multidrive_enable, uint32_t pull_up_enable)
+{
+	(void) multidrive_enable;
+	(void) pull_up_enable;
+
+	pio->PIO_OSR |= mask;
+	host_pins_write(pio, mask, default_level != 0);
+}
+
+void pio_set_input(Pio *pio, uint32_t mask, uint32_t attribute)
+{
+	(void) attribute;
+
+	pio->PIO_OSR &= ~mask;
+}
+
+uint32_t pio_configure(Pio *pio, uint32_t type, uint32_t mask, uint32_t attribute)
+{
+	if ((type == PIO_OUTPUT_0) || (type == PIO_OUTPUT_1))
+	{
+		pio_set_output(pio, mask, type == PIO_OUTPUT_1, 0, 0);
+	}
+	else if (type == PIO_INPUT)
+	{
+		pio_set_input(pio, mask, attribute);
+	}
+	return 1;
+}
+
+uint32_t pio_configure_pin(uint32_t pin, uint32_t flags)
+{
+	return gpio_configure_pin(pin, flags);
+}
+
+void pio_set_pin_high(uint32_t pin)
+{
+	ioport_set_pin_level(pin, true);
+}
+
+void pio_set_pin_low(uint32_t pin)
+{
+	ioport_set_pin_level(pin, false);
+}
+
+void pio_toggle_pin(uint32_t pin)
+{
+	ioport_toggle_pin_level(pin);
+}
+
+uint32_t pio_get_pin_value(uint32_t pin)
+{
+	return ioport_get_pin_level(pin) ? 1 : 0;
+}
+
+void pio_enable_interrupt(Pio *pio, uint32_t mask)
+{
+	pio->PIO_IMR |= mask;
+}
+
+void pio_disable_interrupt(Pio *pio, uint32_t mask)
+{
+	pio->PIO_IMR &= ~mask;
+}
+
+uint32_t pio_get_interrupt_status(Pio *pio)
+{
+	uint32_t status = pio->PIO_ISR;
+
+	pio->PIO_ISR = 0;
+	return status;
+}
+
+uint32_t pio_get_interrupt_mask(Pio *pio)
+{
+	return pio->PIO_IMR;
+}
+
+uint32_t pio_handler_set(Pio *pio, uint32_t id, uint32_t mask, uint32_t attr,
+		void (*handler)(uint32_t, uint32_t))
+{
+	(void) attr;
+
+	if (pio_handler_count == HOST_PIO_HANDLERS)
+	{
+		return 1;
+	}
+	pio_handlers[pio_handler_count].port = (uint32_t) (pio - host_pio);
+	pio_handlers[pio_handler_count].id = id;
+	pio_handlers[pio_handler_count].mask = mask;
+	pio_handlers[pio_handler_count].handler = handler;
+	pio_handler_count++;
+	return 0;
+}
+
+void pio_handler_set_priority(Pio *pio, IRQn_Type irq, uint32_t priority)
+{
+	(void) pio;
+	(void) priority;
+
+	NVIC_EnableIRQ(irq);
+}
+
+/** \brief Runs the handlers for a port's pins which have changed, as ASF's
+ *  pio_handler does from PIOx_Handler().
+ */
+static void host_pio_dispatch(uint32_t port)
+{
+	uint32_t status = pio_get_interrupt_status(&host_pio[port]) & host_pio[port].PIO_IMR;
+	uint32_t i;
+
+	for (i = 0; (i < pio_handler_count) && (status != 0); i++)
+	{
+		if ((pio_handlers[i].port == port) && (status & pio_handlers[i].mask))
+		{
+			pio_handlers[i].handler(pio_handlers[i].id, pio_handlers[i].mask);
+			status &= ~pio_handlers[i].mask;
+		}
+	}
+}
+
+void host_pin_set_input(ioport_pin_t pin, bool level)
+{
+	Pio *pio = &host_pio[pin / 32];
+	uint32_t mask = 1UL << (pin % 32);
+
+	if (((pio->PIO_PDSR & mask) != 0) == level)
+	{
+		return;
+	}
+	if (level)
+	{
+		pio->PIO_PDSR |= mask;
+	}
+	else
+	{
+		pio->PIO_PDSR &= ~mask;
+	}
+	pio->PIO_ISR |= mask;
+	if (pio->PIO_IMR & mask)
+	{
+		host_irq_raise((IRQn_Type) (ID_PIOA + pin / 32));
+	}
+}
+
+//------------------------------------------------------------------------------
+void tc_init(Tc *tc, uint32_t channel, uint32_t mode)
+{
+	struct host_tc_channel *ch = host_tc_channel(tc, channel);
+
+	memset(ch, 0, sizeof(*ch));
+	ch->cmr = mode;
+}
+
+void tc_start(Tc *tc, uint32_t channel)
+{
+	struct host_tc_channel *ch = host_tc_channel(tc, channel);
+
+	ch->start_ns = host_now_ns();
+	ch->last_cv = 0;
+	ch->last_periods = 0;
+	ch->running = true;
+}
+
+void tc_stop(Tc *tc, uint32_t channel)
+{
+	host_tc_channel(tc, channel)->running = false;
+}
+
+uint32_t tc_read_cv(Tc *tc, uint32_t channel)
+{
+	const struct host_tc_channel *ch = host_tc_channel(tc, channel);
+	uint64_t counts = host_tc_counts(ch);
+
+	return (uint32_t) (host_tc_resets_on_rc(ch) ? counts % ch->rc : counts);
+}
+
+uint32_t tc_read_ra(Tc *tc, uint32_t channel)
+{
+	return host_tc_channel(tc, channel)->ra;
+}
+
+uint32_t tc_read_rc(Tc *tc, uint32_t channel)
+{
+	return host_tc_channel(tc, channel)->rc;
+}
+
+void tc_write_ra(Tc *tc, uint32_t channel, uint32_t value)
+{
+	host_tc_channel(tc, channel)->ra = value;
+}
+
+void tc_write_rc(Tc *tc, uint32_t channel, uint32_t value)
+{
+	struct host_tc_channel *ch = host_tc_channel(tc, channel);
+	uint64_t counts = host_tc_counts(ch);
+
+	// Count compares from now on against the new value
+	ch->rc = value;
+	ch->last_cv = (uint32_t) counts;
+	ch->last_periods = (value != 0) ? counts / value : 0;
+}
+
+void tc_enable_interrupt(Tc *tc, uint32_t channel, uint32_t sources)
+{
+	host_tc_channel(tc, channel)->imr |= sources;
+}
+
+void tc_disable_interrupt(Tc *tc, uint32_t channel, uint32_t sources)
+{
+	host_tc_channel(tc, channel)->imr &= ~sources;
+}
+
+uint32_t tc_get_interrupt_mask(Tc *tc, uint32_t channel)
+{
+	return host_tc_channel(tc, channel)->imr;
+}
+
+uint32_t tc_get_status(Tc *tc, uint32_t channel)
+{
+	struct host_tc_channel *ch = host_tc_channel(tc, channel);
+	uint32_t status = ch->sr;
+
+	ch->sr = 0;
+	return status;
+}
+
+uint32_t tc_find_mck_divisor(uint32_t freq, uint32_t mck, uint32_t *divisor,
+		uint32_t *tcclks, uint32_t board_mck)
+{
+	static const uint32_t divisors[5] = { 2, 8, 32, 128, 0 };
+	uint32_t i;
+
+	(void) board_mck;
+
+	for (i = 0; i < 4; i++)
+	{
+		if ((freq >= (mck / divisors[i]) / 65536) && (freq <= mck / divisors[i]))
+		{
+			if (divisor != NULL)
+			{
+				*divisor = divisors[i];
+			}
+			if (tcclks != NULL)
+			{
+				*tcclks = i;
+			}
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+/** \brief Raises the UART interrupt if any of its enabled sources is set.
+ */
+static void host_uart_update(void)
+{
+	if (uart_get_status(UART) & host_uart.UART_IMR)
+	{
+		host_irq_raise(UART_IRQn);
+	}
+}
+
+/** \brief Raises the ADC interrupt if any of its enabled sources is set.
+ */
+static void host_adc_update(void)
+{
+	if (adc_get_status(ADC) & host_adc.ADC_IMR)
+	{
+		host_irq_raise(ADC_IRQn);
+	}
+}
+
+/** \brief Sends whatever the UART's PDC has been given straight to standard
+ *  output, so that it has always reached the end of its buffers.
+ */
+static void host_pdc_send(Pdc *pdc)
+{
+	if (!(pdc->PERIPH_PTSR & PERIPH_PTCR_TXTEN) || (pdc->PERIPH_TCR == 0))
+	{
+		return;
+	}
+	host_write((const char*) pdc->PERIPH_TPR, pdc->PERIPH_TCR);
+	if (pdc->PERIPH_TNCR != 0)
+	{
+		host_write((const char*) pdc->PERIPH_TNPR, pdc->PERIPH_TNCR);
+	}
+	pdc->PERIPH_TPR = pdc->PERIPH_TNPR + pdc->PERIPH_TNCR;
+	pdc->PERIPH_TCR = 0;
+	pdc->PERIPH_TNCR = 0;
+	pdc->HOST_END |= HOST_PDC_ENDTX;
+	host_uart_update();
+}
+
+void pdc_rx_init(Pdc *pdc, pdc_packet_t *packet, pdc_packet_t *next_packet)
+{
+	if (packet != NULL)
+	{
+		pdc->PERIPH_RPR = packet->ul_addr;
+		pdc->PERIPH_RCR = packet->ul_size;
+	}
+	if (next_packet != NULL)
+	{
+		pdc->PERIPH_RNPR = next_packet->ul_addr;
+		pdc->PERIPH_RNCR = next_packet->ul_size;
+	}
+	pdc->HOST_END &= ~HOST_PDC_ENDRX;
+}
+
+void pdc_tx_init(Pdc *pdc, pdc_packet_t *packet, pdc_packet_t *next_packet)
+{
+	if (packet != NULL)
+	{
+		pdc->PERIPH_TPR = packet->ul_addr;
+		pdc->PERIPH_TCR = packet->ul_size;
+	}
+	if (next_packet != NULL)
+	{
+		pdc->PERIPH_TNPR = next_packet->ul_addr;
+		pdc->PERIPH_TNCR = next_packet->ul_size;
+	}
+	pdc->HOST_END &= ~HOST_PDC_ENDTX;
+	host_pdc_send(pdc);
+}
+
+void pdc_enable_transfer(Pdc *pdc, uint32_t controls)
+{
+	pdc->PERIPH_PTSR |= controls & (PERIPH_PTCR_RXTEN | PERIPH_PTCR_TXTEN);
+	host_pdc_send(pdc);
+}
+
+void pdc_disable_transfer(Pdc *pdc, uint32_t controls)
+{
+	pdc->PERIPH_PTSR &= ~(((controls & PERIPH_PTCR_RXTDIS) ? PERIPH_PTCR_RXTEN : 0)
+			| ((controls & PERIPH_PTCR_TXTDIS) ? PERIPH_PTCR_TXTEN : 0));
+}
+
+uint32_t pdc_read_rx_counter(Pdc *pdc)
+{
+	return pdc->PERIPH_RCR;
+}
+
+uint32_t pdc_read_tx_counter(Pdc *pdc)
+{
+	return pdc->PERIPH_TCR;
+}
+
+//------------------------------------------------------------------------------
+Pdc *uart_get_pdc_base(Uart *uart)
+{
+	(void) uart;
+	return &uart_pdc;
+}
+
+void uart_enable_interrupt(Uart *uart, uint32_t sources)
+{
+	uart->UART_IMR |= sources;
+	host_uart_update();
+}
+
+void uart_disable_interrupt(Uart *uart, uint32_t sources)
+{
+	uart->UART_IMR &= ~sources;
+}
+
+uint32_t uart_get_interrupt_mask(Uart *uart)
+{
+	return uart->UART_IMR;
+}
+
+uint32_t uart_get_status(Uart *uart)
+{
+	uint32_t status = UART_SR_TXRDY | UART_SR_TXEMPTY;
+
+	(void) uart;
+
+	if (uart_pdc.HOST_END & HOST_PDC_ENDTX)
+	{
+		status |= UART_SR_ENDTX;
+	}
+	if ((uart_pdc.PERIPH_TCR == 0) && (uart_pdc.PERIPH_TNCR == 0))
+	{
+		status |= UART_SR_TXBUFE;
+	}
+	return status;
+}
+
+//------------------------------------------------------------------------------
+/** \brief Returns the reading of an ADC channel at a time, from a sine wave of
+ *  50 Hz on channel 0, 100 Hz on channel 1 and so on.
+ */
+static uint16_t host_adc_sample(uint32_t channel, double seconds)
+{
+	double wave = sin(2.0 * M_PI * 50.0 * (channel + 1) * seconds);
+
+	return (uint16_t) lround(HOST_ADC_MID + HOST_ADC_SWING * wave);
+}
+
+/** \brief Converts the ADC's sequence once per RC compare of the timer channel
+ *  which triggers it, and stores the readings through its PDC channel. When the
+ *  current buffer fills, the handler runs there and then, as it would on the
+ *  board long before the next conversion; readings with nowhere to go are lost.
+ *  @param channel The timer channel, 0 to 8
+ *  @param count RC compares since it was last checked
+ */
+static void host_adc_trigger(uint32_t channel, uint64_t count)
+{
+	const struct host_tc_channel *ch = &tc_channels[channel];
+	uint32_t trigger = (host_adc.ADC_MR & ADC_MR_TRGSEL_Msk) >> 1;
+	double seconds;
+	uint32_t slot;
+	uint32_t input;
+	uint16_t value;
+
+	if (!(host_adc.ADC_MR & ADC_MR_TRGEN) || (trigger < 1) || (trigger > 3)
+			|| (channel != trigger - 1))
+	{
+		return;
+	}
+	for (; count > 0; count--)
+	{
+		seconds = (double) adc_sequences++ * ch->rc / host_tc_hz(ch);
+		for (slot = 0; slot < 16; slot++)
+		{
+			if (!(host_adc.ADC_CHSR & (1UL << slot)))
+			{
+				continue;
+			}
+			input = (host_adc.ADC_MR & ADC_MR_USEQ)
+					? (host_adc.ADC_SEQR[slot / 8] >> (4 * (slot % 8))) & 0xF : slot;
+			value = host_adc_sample(input, seconds);
+			if (host_adc.ADC_EMR & ADC_EMR_TAG)
+			{
+				value |= (uint16_t) (input << 12);
+			}
+			if (!(adc_pdc.PERIPH_PTSR & PERIPH_PTCR_RXTEN) || (adc_pdc.PERIPH_RCR == 0))
+			{
+				continue;
+			}
+			*(uint16_t*) adc_pdc.PERIPH_RPR = value;
+			adc_pdc.PERIPH_RPR += sizeof(uint16_t);
+			if (--adc_pdc.PERIPH_RCR == 0)
+			{
+				if (adc_pdc.PERIPH_RNCR != 0)
+				{
+					adc_pdc.PERIPH_RPR = adc_pdc.PERIPH_RNPR;
+					adc_pdc.PERIPH_RCR = adc_pdc.PERIPH_RNCR;
+					adc_pdc.PERIPH_RNCR = 0;
+				}
+				adc_pdc.HOST_END |= HOST_PDC_ENDRX;
+				host_adc_update();
+				host_irq_service(ADC_IRQn);
+			}
+		}
+	}
+}
+
+uint32_t adc_init(Adc *adc, uint32_t mck, uint32_t adc_clock, enum adc_startup_time startup)
+{
+	(void) mck;
+	(void) adc_clock;
+	(void) startup;
+
+	memset((void*) adc, 0, sizeof(*adc));
+	memset(&adc_pdc, 0, sizeof(adc_pdc));
+	return 0;
+}
+
+void adc_configure_timing(Adc *adc, uint8_t tracking, enum adc_settling_time_t settling,
+		uint8_t transfer)
+{
+	(void) adc;
+	(void) tracking;
+	(void) settling;
+	(void) transfer;
+}
+
+void adc_configure_trigger(Adc *adc, enum adc_trigger_t trigger, uint8_t freerun)
+{
+	(void) freerun;
+
+	adc->ADC_MR = (adc->ADC_MR & ~(ADC_MR_TRGEN | ADC_MR_TRGSEL_Msk)) | (uint32_t) trigger;
+	adc_sequences = 0;
+}
+
+void adc_configure_sequence(Adc *adc, const enum adc_channel_num_t channels[],
+		uint8_t count)
+{
+	uint8_t i;
+
+	adc->ADC_SEQR[0] = 0;
+	adc->ADC_SEQR[1] = 0;
+	for (i = 0; (i < count) && (i < 16); i++)
+	{
+		adc->ADC_SEQR[i / 8] |= ((uint32_t) channels[i] & 0xF) << (4 * (i % 8));
+	}
+}
+
+void adc_start_sequencer(Adc *adc)
+{
+	adc->ADC_MR |= ADC_MR_USEQ;
+}
+
+void adc_stop_sequencer(Adc *adc)
+{
+	adc->ADC_MR &= ~ADC_MR_USEQ;
+}
+
+void adc_enable_tag(Adc *adc)
+{
+	adc->ADC_EMR |= ADC_EMR_TAG;
+}
+
+void adc_disable_tag(Adc *adc)
+{
+	adc->ADC_EMR &= ~ADC_EMR_TAG;
+}
+
+void adc_enable_channel(Adc *adc, enum adc_channel_num_t channel)
+{
+	adc->ADC_CHSR |= 1UL << channel;
+}
+
+void adc_disable_channel(Adc *adc, enum adc_channel_num_t channel)
+{
+	adc->ADC_CHSR &= ~(1UL << channel);
+}
+
+void adc_disable_all_channel(Adc *adc)
+{
+	adc->ADC_CHSR = 0;
+}
+
+uint32_t adc_get_status(Adc *adc)
+{
+	uint32_t status = 0;
+
+	(void) adc;
+
+	if (adc_pdc.HOST_END & HOST_PDC_ENDRX)
+	{
+		status |= ADC_ISR_ENDRX;
+	}
+	if ((adc_pdc.PERIPH_RCR == 0) && (adc_pdc.PERIPH_RNCR == 0))
+	{
+		status |= ADC_ISR_RXBUFF;
+	}
+	return status;
+}
+
+void adc_enable_interrupt(Adc *adc, uint32_t sources)
+{
+	adc->ADC_IMR |= sources;
+	host_adc_update();
+}
+
+void adc_disable_interrupt(Adc *adc, uint32_t sources)
+{
+	adc->ADC_IMR &= ~sources;
+}
+
+Pdc *adc_get_pdc_base(Adc *adc)
+{
+	(void) adc;
+	return &adc_pdc;
+}
+
+//------------------------------------------------------------------------------
+void spi_enable(Spi *spi)
+{
+	spi->SPI_SR = SPI_SR_SPIENS | SPI_SR_TDRE | SPI_SR_RDRF | SPI_SR_TXEMPTY;
+}
+
+void spi_disable(Spi *spi)
+{
+	spi->SPI_SR &= ~SPI_SR_SPIENS;
+}
+
+void spi_reset(Spi *spi)
+{
+	memset((void*) spi, 0, sizeof(*spi));
+}
+
+void spi_set_lastxfer(Spi *spi)
+{
+	(void) spi;
+}
+
+void spi_set_master_mode(Spi *spi)
+{
+	spi->SPI_MR |= SPI_MR_MSTR;
+}
+
+void spi_disable_mode_fault_detect(Spi *spi)
+{
+	spi->SPI_MR |= SPI_MR_MODFDIS;
+}
+
+void spi_disable_loopback(Spi *spi)
+{
+	spi->SPI_MR &= ~SPI_MR_LLB;
+}
+
+void spi_set_fixed_peripheral_select(Spi *spi)
+{
+	spi->SPI_MR &= ~SPI_MR_PS;
+}
+
+void spi_set_peripheral_chip_select_value(Spi *spi, uint32_t value)
+{
+	spi->SPI_MR = (spi->SPI_MR & ~SPI_MR_PCS_Msk) | ((value << SPI_MR_PCS_Pos) & SPI_MR_PCS_Msk);
+}
+
+void spi_set_clock_polarity(Spi *spi, uint32_t chip_select, uint32_t polarity)
+{
+	if (polarity)
+	{
+		spi->SPI_CSR[chip_select] |= SPI_CSR_CPOL;
+	}
+	else
+	{
+		spi->SPI_CSR[chip_select] &= ~SPI_CSR_CPOL;
+	}
+}
+
+void spi_set_clock_phase(Spi *spi, uint32_t chip_select, uint32_t phase)
+{
+	if (phase)
+	{
+		spi->SPI_CSR[chip_select] |= SPI_CSR_NCPHA;
+	}
+	else
+	{
+		spi->SPI_CSR[chip_select] &= ~SPI_CSR_NCPHA;
+	}
+}
+
+void spi_configure_cs_behavior(Spi *spi, uint32_t chip_select, uint32_t behavior)
+{
+	spi->SPI_CSR[chip_select] = (spi->SPI_CSR[chip_select]
+			& ~(SPI_CSR_CSAAT | SPI_CSR_CSNAAT)) | behavior;
+}
+
+void spi_set_bits_per_transfer(Spi *spi, uint32_t chip_select, uint32_t bits)
+{
+	spi->SPI_CSR[chip_select] = (spi->SPI_CSR[chip_select] & ~SPI_CSR_BITS_Msk) | bits;
+}
+
+int16_t spi_calc_baudrate_div(const uint32_t baudrate, uint32_t mck)
+{
+	uint32_t div = (mck + baudrate - 1) / baudrate;
+
+	return ((div < 1) || (div > 255)) ? -1 : (int16_t) div;
+}
+
+int16_t spi_set_baudrate_div(Spi *spi, uint32_t chip_select, uint8_t divider)
+{
+	if (divider == 0)
+	{
+		return -1;
+	}
+	spi->SPI_CSR[chip_select] = (spi->SPI_CSR[chip_select] & ~SPI_CSR_SCBR_Msk)
+			| ((uint32_t) divider << SPI_CSR_SCBR_Pos);
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+/** \brief Moves a byte for a channel, and says whether that was its last.
+ */
+static bool host_dmac_step(struct host_dmac_channel *chan)
+{
+	uint32_t source_incr = chan->ctrlb & DMAC_CTRLB_SRC_INCR_Msk;
+	uint32_t destination_incr = chan->ctrlb & DMAC_CTRLB_DST_INCR_Msk;
+
+	*chan->destination = *chan->source;
+	if (source_incr == DMAC_CTRLB_SRC_INCR_INCREMENTING)
+	{
+		chan->source++;
+	}
+	else if (source_incr == DMAC_CTRLB_SRC_INCR_DECREMENTING)
+	{
+		chan->source--;
+	}
+	if (destination_incr == DMAC_CTRLB_DST_INCR_INCREMENTING)
+	{
+		chan->destination++;
+	}
+	else if (destination_incr == DMAC_CTRLB_DST_INCR_DECREMENTING)
+	{
+		chan->destination--;
+	}
+	return --chan->left == 0;
+}
+
+/** \brief Runs a memory to peripheral channel to the end. After each byte it
+ *  writes, every enabled peripheral to memory channel reads one, which is what
+ *  the SPI's loopback gives back. Channels which finish raise their interrupt.
+ */
+static void host_dmac_run(uint32_t channel)
+{
+	struct host_dmac_channel *tx = &dmac_channels[channel];
+	uint32_t i;
+
+	while ((host_dmac.DMAC_CHSR & (1UL << channel)) && (tx->left > 0))
+	{
+		if (host_dmac_step(tx))
+		{
+			host_dmac.DMAC_CHSR &= ~(1UL << channel);
+			host_dmac.DMAC_EBCISR |= DMAC_EBCIER_BTC0 << channel;
+		}
+		for (i = 0; i < HOST_DMAC_CHANNELS; i++)
+		{
+			if ((host_dmac.DMAC_CHSR & (1UL << i)) && (dmac_channels[i].left > 0)
+					&& ((dmac_channels[i].ctrlb & DMAC_CTRLB_FC_Msk)
+					== DMAC_CTRLB_FC_PER2MEM_DMA_FC) && host_dmac_step(&dmac_channels[i]))
+			{
+				host_dmac.DMAC_CHSR &= ~(1UL << i);
+				host_dmac.DMAC_EBCISR |= DMAC_EBCIER_BTC0 << i;
+			}
+		}
+	}
+	if (host_dmac.DMAC_EBCISR & host_dmac.DMAC_EBCIMR)
+	{
+		host_irq_raise(DMAC_IRQn);
+	}
+}
+
+void dmac_init(Dmac *dmac)
+{
+	memset((void*) dmac, 0, sizeof(*dmac));
+	memset(dmac_channels, 0, sizeof(dmac_channels));
+}
+
+void dmac_enable(Dmac *dmac)
+{
+	dmac->DMAC_EN = 1;
+}
+
+void dmac_disable(Dmac *dmac)
+{
+	dmac->DMAC_EN = 0;
+}
+
+void dmac_set_priority_mode(Dmac *dmac, dmac_priority_mode_t mode)
+{
+	(void) dmac;
+	(void) mode;
+}
+
+void dmac_enable_interrupt(Dmac *dmac, uint32_t sources)
+{
+	dmac->DMAC_EBCIMR |= sources;
+}
+
+void dmac_disable_interrupt(Dmac *dmac, uint32_t sources)
+{
+	dmac->DMAC_EBCIMR &= ~sources;
+}
+
+uint32_t dmac_get_status(Dmac *dmac)
+{
+	uint32_t status = dmac->DMAC_EBCISR;
+
+	dmac->DMAC_EBCISR = 0;
+	return status;
+}
+
+void dmac_channel_set_configuration(Dmac *dmac, uint32_t channel, uint32_t config)
+{
+	(void) dmac;
+	dmac_channels[channel].cfg = config;
+}
+
+void dmac_channel_single_buf_transfer_init(Dmac *dmac, uint32_t channel,
+		dma_transfer_descriptor_t *desc)
+{
+	struct host_dmac_channel *chan = &dmac_channels[channel];
+
+	(void) dmac;
+
+	chan->ctrlb = desc->ul_ctrlB;
+	chan->source = (uint8_t*) desc->ul_source_addr;
+	chan->destination = (uint8_t*) desc->ul_destination_addr;
+	chan->left = desc->ul_ctrlA & 0xFFFFUL;
+}
+
+void dmac_channel_enable(Dmac *dmac, uint32_t channel)
+{
+	dmac->DMAC_CHSR |= 1UL << channel;
+	if (dmac->DMAC_EN && ((dmac_channels[channel].ctrlb & DMAC_CTRLB_FC_Msk)
+			== DMAC_CTRLB_FC_MEM2PER_DMA_FC))
+	{
+		host_dmac_run(channel);
+	}
+}
+
+void dmac_channel_disable(Dmac *dmac, uint32_t channel)
+{
+	dmac->DMAC_CHSR &= ~(1UL << channel);
+}
+
+//------------------------------------------------------------------------------
+/** \brief Raises a TWI's interrupt if any of its enabled sources is set.
+ */
+static void host_twi_update(Twi *twi)
+{
+	if (twi->TWI_SR & twi->TWI_IMR)
+	{
+		host_irq_raise((twi == TWI0) ? TWI0_IRQn : TWI1_IRQn);
+	}
+}
+
+uint32_t twi_master_init(Twi *twi, const twi_options_t *options)
+{
+	(void) options;
+
+	memset((void*) twi, 0, sizeof(*twi));
+	twi->TWI_SR = TWI_SR_TXCOMP | TWI_SR_TXRDY;
+	return TWI_SUCCESS;
+}
+
+void twi_enable_interrupt(Twi *twi, uint32_t sources)
+{
+	// A transaction has just been started, and nothing on the bus answers it
+	if (sources & TWI_SR_NACK)
+	{
+		twi->TWI_SR |= TWI_SR_NACK;
+	}
+	twi->TWI_IMR |= sources;
+	host_twi_update(twi);
+}
+
+void twi_disable_interrupt(Twi *twi, uint32_t sources)
+{
+	twi->TWI_IMR &= ~sources;
+}
+
+uint32_t twi_get_interrupt_status(Twi *twi)
+{
+	uint32_t status = twi->TWI_SR;
+
+	twi->TWI_SR &= ~(TWI_SR_NACK | TWI_SR_ARBLST);
+	return status;
+}
+
+uint32_t twi_get_interrupt_mask(Twi *twi)
+{
+	return twi->TWI_IMR;
+}
+
+//------------------------------------------------------------------------------
+/** \brief Writes bytes to standard output in one go, in a critical section once
+ *  the scheduler is running, so no other task can be stopped part way through.
+ *  @param data The bytes
+ *  @param length Number of bytes
+ */
+void host_write(const char *data, size_t length)
+{
+	bool running = (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+	ssize_t written;
+
+	if (running)
+	{
+		taskENTER_CRITICAL();
+	}
+	while (length > 0)
+	{
+		written = write(STDOUT_FILENO, data, length);
+		if (written <= 0)
+		{
+			break;
+		}
+		data += written;
+		length -= (size_t) written;
+	}
+	if (running)
+	{
+		taskEXIT_CRITICAL();
+	}
+}
+
+int host_printf(const char *format, ...)
+{
+	char line[HOST_PRINTF_MAX];
+	va_list args;
+	int length;
+
+	va_start(args, format);
+	length = vsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+	if (length > 0)
+	{
+		host_write(line, ((size_t) length < sizeof(line)) ? (size_t) length : sizeof(line) - 1);
+	}
+	return length;
+}
+
+int host_puts(const char *text)
+{
+	host_write(text, strlen(text));
+	host_write("\n", 1);
+	return 1;
+}
+
+void host_assert_failed(const char *file, int line)
+{
+	char message[128];
+	int length = snprintf(message, sizeof(message), "configASSERT failed at %s:%d\n",
+			file, line);
+
+	if (length > 0)
+	{
+		host_write(message, ((size_t) length < sizeof(message)) ? (size_t) length
+				: sizeof(message) - 1);
+	}
+	abort();
+}
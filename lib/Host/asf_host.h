@@ -0,0 +1,853 @@
+//*************************************************************************************
+/** \file asf_host.h
+ *    This file contains the stand-ins for the parts of ASF and CMSIS that the
+ *    examples and the portable services use, so that they can be built and run on
+ *    a PC by 'make host' (see common/host.mk).
+ *
+ *    The ASF headers the code includes (compiler.h, sysclk.h, tc.h and so on) are
+ *    replaced by one-line headers in lib/Host/asf which include this one. The
+ *    stand-ins work like this:
+ *      - Pins live in fake PIO registers. Setting an output changes the pin's
+ *        level as read back; HOST_TRACE_PINS in the environment prints each
+ *        change. host_pin_set_input() drives an input from test code, and runs
+ *        the pin's PIO interrupt handler if one is set up.
+ *      - The timer counters count from the host's monotonic clock, at the rate the
+ *        selected clock source would give on the board. Their RC compare
+ *        interrupts run the TCx_Handler() functions.
+ *      - Interrupt handlers are the program's own, such as TC0_Handler() and
+ *        UART_Handler(). Once the scheduler is running they run in a FreeRTOS task
+ *        at the highest priority, which checks for due interrupts every tick and
+ *        whenever one is made pending. So they pre-empt every task, as on the
+ *        board, but a timer interrupt can be up to a tick late, and several due in
+ *        one tick run back to back. Before the scheduler starts they run as soon
+ *        as they are made pending and not masked.
+ *      - cpu_irq_save() enters a FreeRTOS critical section, which keeps both the
+ *        tick and the interrupt task out.
+ *      - DWT->CYCCNT counts at the CPU clock rate from the host's monotonic clock.
+ *        Writes to it are honoured, and other core registers are plain memory.
+ *      - The UART sends whatever its PDC channel is given to the process's
+ *        standard output straight away, and raises ENDTX at once.
+ *      - The ADC converts its sequence once for each RC compare of the timer
+ *        channel which triggers it, into its PDC buffers. Channel n carries a sine
+ *        wave at 50 * (n + 1) Hz, swinging 1000 counts either side of mid-scale.
+ *      - The SPI's MOSI is wired back to its MISO: SPI_RDR and SPI_TDR are the
+ *        same register, and the status always says both are ready. A DMAC channel
+ *        which writes to a peripheral moves its bytes as soon as it is enabled,
+ *        and each byte it writes gives every enabled channel reading from a
+ *        peripheral one byte to read.
+ *      - No device on the TWI bus ever answers, so each transaction ends with
+ *        NACK as soon as the controller's interrupts are enabled for it.
+ *    So the services in lib/Services which drive these peripherals are built and
+ *    run unchanged, on top of the registers and ASF calls stood in for here.
+ */
+//*************************************************************************************
+
+#ifndef _ASF_HOST_H_
+#define _ASF_HOST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//-------------------------------------------------------------------------------------
+// compiler.h, status_codes.h, parts.h
+
+#define UNUSED(v)                   (void) (v)
+#define Min(a, b)                   (((a) < (b)) ? (a) : (b))
+#define Max(a, b)                   (((a) > (b)) ? (a) : (b))
+#ifndef __cplusplus
+#define min(a, b)                   Min(a, b)
+#define max(a, b)                   Max(a, b)
+#endif
+#define Assert(expr)                ((void) 0)
+#define COMPILER_ALIGNED(a)         __attribute__((__aligned__(a)))
+#define COMPILER_WORD_ALIGNED       __attribute__((__aligned__(4)))
+#ifndef __always_inline
+#define __always_inline             inline __attribute__((__always_inline__))
+#endif
+
+#define SAM3X                       1
+#define SAM3XA                      1
+
+typedef enum status_code
+{
+	STATUS_OK = 0,
+	ERR_IO_ERROR = -1,
+	ERR_TIMEOUT = -3,
+	ERR_INVALID_ARG = -8
+} status_code_t;
+
+//-------------------------------------------------------------------------------------
+// Peripheral IDs, which are also the interrupt numbers
+
+typedef int IRQn_Type;
+
+#define ID_UART                     8
+#define ID_PIOA                     11
+#define ID_PIOB                     12
+#define ID_PIOC                     13
+#define ID_PIOD                     14
+#define ID_USART0                   17
+#define ID_TWI0                     22
+#define ID_TWI1                     23
+#define ID_SPI0                     24
+#define ID_TC0                      27
+#define ID_TC1                      28
+#define ID_TC2                      29
+#define ID_TC3                      30
+#define ID_TC4                      31
+#define ID_TC5                      32
+#define ID_TC6                      33
+#define ID_TC7                      34
+#define ID_TC8                      35
+#define ID_ADC                      37
+#define ID_DMAC                     39
+#define ID_TRNG                     41
+
+#define UART_IRQn                   ((IRQn_Type) ID_UART)
+#define TWI0_IRQn                   ((IRQn_Type) ID_TWI0)
+#define TWI1_IRQn                   ((IRQn_Type) ID_TWI1)
+#define SPI0_IRQn                   ((IRQn_Type) ID_SPI0)
+#define PIOA_IRQn                   ((IRQn_Type) ID_PIOA)
+#define PIOB_IRQn                   ((IRQn_Type) ID_PIOB)
+#define PIOC_IRQn                   ((IRQn_Type) ID_PIOC)
+#define PIOD_IRQn                   ((IRQn_Type) ID_PIOD)
+#define TC0_IRQn                    ((IRQn_Type) ID_TC0)
+#define TC1_IRQn                    ((IRQn_Type) ID_TC1)
+#define TC2_IRQn                    ((IRQn_Type) ID_TC2)
+#define TC3_IRQn                    ((IRQn_Type) ID_TC3)
+#define TC4_IRQn                    ((IRQn_Type) ID_TC4)
+#define TC5_IRQn                    ((IRQn_Type) ID_TC5)
+#define TC6_IRQn                    ((IRQn_Type) ID_TC6)
+#define TC7_IRQn                    ((IRQn_Type) ID_TC7)
+#define TC8_IRQn                    ((IRQn_Type) ID_TC8)
+#define ADC_IRQn                    ((IRQn_Type) ID_ADC)
+#define DMAC_IRQn                   ((IRQn_Type) ID_DMAC)
+#define TRNG_IRQn                   ((IRQn_Type) ID_TRNG)
+
+//-------------------------------------------------------------------------------------
+// Core registers and intrinsics
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+	volatile uint32_t DHCSR;
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+	volatile uint32_t ICSR;
+	volatile uint32_t SCR;
+	volatile uint32_t SHCSR;
+	volatile uint32_t CFSR;
+	volatile uint32_t HFSR;
+	volatile uint32_t MMFAR;
+	volatile uint32_t BFAR;
+} SCB_Type;
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t LOAD;
+	volatile uint32_t VAL;
+} SysTick_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+#define SCB_SCR_SLEEPDEEP_Msk           (1UL << 2)
+#define SCB_ICSR_PENDSTSET_Msk          (1UL << 26)
+#define SCB_SHCSR_MEMFAULTENA_Msk       (1UL << 16)
+#define SCB_SHCSR_BUSFAULTENA_Msk       (1UL << 17)
+#define SCB_SHCSR_USGFAULTENA_Msk       (1UL << 18)
+#define SysTick_CTRL_ENABLE_Msk         (1UL << 0)
+
+/// The cycle counter, brought up to date each time it is used
+#define DWT                         (host_dwt())
+#define CoreDebug                   (&host_core_debug)
+#define SCB                         (&host_scb)
+
+/// SysTick, counting down from the last FreeRTOS tick as it would on the board
+#define SysTick                     (host_systick())
+
+extern CoreDebug_Type host_core_debug;
+extern SCB_Type host_scb;
+extern uint32_t SystemCoreClock;
+
+DWT_Type *host_dwt(void);
+SysTick_Type *host_systick(void);
+
+/** \brief Notes the time of a FreeRTOS tick, for SysTick->VAL. It is called from
+ *  the tick trace hook in lib/Host/FreeRTOSConfig.h.
+ */
+void host_tick(void);
+
+#define __DMB()                     __sync_synchronize()
+#define __DSB()                     __sync_synchronize()
+#define __ISB()                     __sync_synchronize()
+#define __NOP()                     ((void) 0)
+#define __WFI()                     ((void) 0)
+#define __WFE()                     ((void) 0)
+#define __SEV()                     ((void) 0)
+
+#define __NVIC_PRIO_BITS            4
+
+/// In an interrupt handler while one is running; masked if in cpu_irq_save()
+uint32_t __get_IPSR(void);
+uint32_t __get_PRIMASK(void);
+uint32_t __get_BASEPRI(void);
+
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_SetPendingIRQ(IRQn_Type irq);
+void NVIC_ClearPendingIRQ(IRQn_Type irq);
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority);
+
+/// Ends the program, as there is nothing to reset to
+void NVIC_SystemReset(void);
+
+#define __disable_irq()             cpu_irq_disable()
+#define __enable_irq()              cpu_irq_enable()
+
+//-------------------------------------------------------------------------------------
+// interrupt.h
+
+typedef uint32_t irqflags_t;
+
+irqflags_t cpu_irq_save(void);
+void cpu_irq_restore(irqflags_t flags);
+void cpu_irq_enable(void);
+void cpu_irq_disable(void);
+
+#define Enable_global_interrupt()   cpu_irq_enable()
+#define Disable_global_interrupt()  cpu_irq_disable()
+
+//-------------------------------------------------------------------------------------
+// sysclk.h, pmc.h, sleepmgr.h
+
+/// The Due's clocks: 84 MHz for the CPU and peripherals, 32768 Hz slow clock
+#define HOST_CPU_HZ                 84000000UL
+#define HOST_SLCK_HZ                32768UL
+
+void sysclk_init(void);
+uint32_t sysclk_get_main_hz(void);
+uint32_t sysclk_get_cpu_hz(void);
+uint32_t sysclk_get_peripheral_hz(void);
+void sysclk_enable_peripheral_clock(uint32_t id);
+void sysclk_disable_peripheral_clock(uint32_t id);
+uint32_t pmc_enable_periph_clk(uint32_t id);
+uint32_t pmc_disable_periph_clk(uint32_t id);
+
+enum sleepmgr_mode
+{
+	SLEEPMGR_ACTIVE = 0,
+	SLEEPMGR_SLEEP_WFE,
+	SLEEPMGR_SLEEP_WFI,
+	SLEEPMGR_WAIT,
+	SLEEPMGR_BACKUP,
+	SLEEPMGR_NR_OF_MODES
+};
+
+#define sleepmgr_init()             ((void) 0)
+#define sleepmgr_lock_mode(mode)    ((void) (mode))
+#define sleepmgr_unlock_mode(mode)  ((void) (mode))
+#define sleepmgr_enter_sleep()      ((void) 0)
+
+//-------------------------------------------------------------------------------------
+// pio.h, ioport.h, gpio.h, pio_handler.h
+
+typedef struct
+{
+	volatile uint32_t PIO_OSR;      ///< Pins set as outputs
+	volatile uint32_t PIO_ODSR;     ///< Levels the outputs are set to
+	volatile uint32_t PIO_PDSR;     ///< Levels the pins read back as
+	volatile uint32_t PIO_IMR;      ///< Pins with their interrupt enabled
+	volatile uint32_t PIO_ISR;      ///< Pins which have changed since last read
+} Pio;
+
+extern Pio host_pio[4];
+
+#define PIOA                        (&host_pio[0])
+#define PIOB                        (&host_pio[1])
+#define PIOC                        (&host_pio[2])
+#define PIOD                        (&host_pio[3])
+
+typedef uint32_t ioport_pin_t;
+typedef uint32_t ioport_port_mask_t;
+
+#define IOPORT_PIOA                 0
+#define IOPORT_PIOB                 1
+#define IOPORT_PIOC                 2
+#define IOPORT_PIOD                 3
+#define IOPORT_CREATE_PIN(port, pin) ((IOPORT_ ## port) * 32 + (pin))
+
+enum ioport_direction
+{
+	IOPORT_DIR_INPUT,
+	IOPORT_DIR_OUTPUT
+};
+
+enum ioport_value
+{
+	IOPORT_PIN_LEVEL_LOW,
+	IOPORT_PIN_LEVEL_HIGH
+};
+
+#define IOPORT_MODE_PULLUP          (1UL << 3)
+#define IOPORT_MODE_PULLDOWN        (1UL << 4)
+#define IOPORT_MODE_DEBOUNCE        (1UL << 6)
+
+#define PIO_TYPE_Msk                (0xFUL << 29)
+#define PIO_INPUT                   (4UL << 29)
+#define PIO_OUTPUT_0                (5UL << 29)
+#define PIO_OUTPUT_1                (6UL << 29)
+#define PIO_PERIPH_A                (1UL << 29)
+#define PIO_PERIPH_B                (2UL << 29)
+#define PIO_DEFAULT                 0UL
+#define PIO_PULLUP                  (1UL << 0)
+#define PIO_DEGLITCH                (1UL << 1)
+#define PIO_OPENDRAIN               (1UL << 2)
+#define PIO_DEBOUNCE                (1UL << 3)
+#define PIO_IT_RISE_EDGE            (1UL << 6)
+#define PIO_IT_FALL_EDGE            (1UL << 5)
+#define PIO_IT_EDGE                 (1UL << 6)
+
+void ioport_init(void);
+void ioport_set_pin_dir(ioport_pin_t pin, enum ioport_direction dir);
+void ioport_set_pin_mode(ioport_pin_t pin, ioport_port_mask_t mode);
+void ioport_set_pin_level(ioport_pin_t pin, bool level);
+void ioport_toggle_pin_level(ioport_pin_t pin);
+bool ioport_get_pin_level(ioport_pin_t pin);
+
+#define gpio_set_pin_high(pin)      ioport_set_pin_level((pin), true)
+#define gpio_set_pin_low(pin)       ioport_set_pin_level((pin), false)
+#define gpio_toggle_pin(pin)        ioport_toggle_pin_level(pin)
+#define gpio_pin_is_high(pin)       (ioport_get_pin_level(pin) ? 1 : 0)
+#define gpio_pin_is_low(pin)        (ioport_get_pin_level(pin) ? 0 : 1)
+uint32_t gpio_configure_pin(uint32_t pin, uint32_t flags);
+
+void pio_set(Pio *pio, uint32_t mask);
+void pio_clear(Pio *pio, uint32_t mask);
+uint32_t pio_get(Pio *pio, uint32_t type, uint32_t mask);
+void pio_set_output(Pio *pio, uint32_t mask, uint32_t default_level,
+		uint32_t multidrive_enable, uint32_t pull_up_enable);
+void pio_set_input(Pio *pio, uint32_t mask, uint32_t attribute);
+uint32_t pio_configure(Pio *pio, uint32_t type, uint32_t mask, uint32_t attribute);
+uint32_t pio_configure_pin(uint32_t pin, uint32_t flags);
+void pio_set_pin_high(uint32_t pin);
+void pio_set_pin_low(uint32_t pin);
+void pio_toggle_pin(uint32_t pin);
+uint32_t pio_get_pin_value(uint32_t pin);
+void pio_enable_interrupt(Pio *pio, uint32_t mask);
+void pio_disable_interrupt(Pio *pio, uint32_t mask);
+uint32_t pio_get_interrupt_status(Pio *pio);
+uint32_t pio_get_interrupt_mask(Pio *pio);
+uint32_t pio_handler_set(Pio *pio, uint32_t id, uint32_t mask, uint32_t attr,
+		void (*handler)(uint32_t, uint32_t));
+void pio_handler_set_priority(Pio *pio, IRQn_Type irq, uint32_t priority);
+
+/** \brief Drives an input pin from test code, as if something outside had changed
+ *  it. If the pin's interrupt is enabled, its PIO handler runs in the interrupt
+ *  task.
+ *  @param pin The pin, numbered as for ioport (32 per port)
+ *  @param level The level to drive it to
+ */
+void host_pin_set_input(ioport_pin_t pin, bool level);
+
+//-------------------------------------------------------------------------------------
+// board.h
+
+#define PIO_PA21_IDX                IOPORT_CREATE_PIN(PIOA, 21)
+#define PIO_PB12_IDX                IOPORT_CREATE_PIN(PIOB, 12)
+#define PIO_PB13_IDX                IOPORT_CREATE_PIN(PIOB, 13)
+#define PIO_PB27_IDX                IOPORT_CREATE_PIN(PIOB, 27)
+#define PIO_PC30_IDX                IOPORT_CREATE_PIN(PIOC, 30)
+
+/// The Due's amber "L" LED, and its TX and RX LEDs
+#define LED0_GPIO                   PIO_PB27_IDX
+#define LED1_GPIO                   PIO_PA21_IDX
+#define LED2_GPIO                   PIO_PC30_IDX
+#define LED_0_NAME                  "amber LED (L)"
+
+#define CONSOLE_UART                UART
+#define CONSOLE_UART_ID             ID_UART
+
+/// TWI1, on the Due's SDA and SCL pins
+#define TWI1_DATA_GPIO              PIO_PB12_IDX
+#define TWI1_DATA_FLAGS             (PIO_PERIPH_A | PIO_DEFAULT)
+#define TWI1_CLK_GPIO               PIO_PB13_IDX
+#define TWI1_CLK_FLAGS              (PIO_PERIPH_A | PIO_DEFAULT)
+
+void board_init(void);
+
+//-------------------------------------------------------------------------------------
+// pdc.h
+
+/** \brief A PDC channel pair. The pointer registers are as wide as a host pointer.
+ */
+typedef struct
+{
+	volatile uintptr_t PERIPH_RPR;  ///< Where the next byte or halfword received goes
+	volatile uint32_t PERIPH_RCR;   ///< How many more are to be received there
+	volatile uintptr_t PERIPH_TPR;  ///< Where the next one sent comes from
+	volatile uint32_t PERIPH_TCR;   ///< How many more are to be sent from there
+	volatile uintptr_t PERIPH_RNPR; ///< The next receive buffer
+	volatile uint32_t PERIPH_RNCR;
+	volatile uintptr_t PERIPH_TNPR; ///< The next transmit buffer
+	volatile uint32_t PERIPH_TNCR;
+	volatile uint32_t PERIPH_PTSR;  ///< Which directions are enabled
+	volatile uint32_t HOST_END;     ///< ENDRX and ENDTX, until the counters are written
+} Pdc;
+
+typedef struct
+{
+	uintptr_t ul_addr;
+	uint32_t ul_size;
+} pdc_packet_t;
+
+#define PERIPH_PTCR_RXTEN           (1UL << 0)
+#define PERIPH_PTCR_RXTDIS          (1UL << 1)
+#define PERIPH_PTCR_TXTEN           (1UL << 8)
+#define PERIPH_PTCR_TXTDIS          (1UL << 9)
+
+void pdc_rx_init(Pdc *pdc, pdc_packet_t *packet, pdc_packet_t *next_packet);
+void pdc_tx_init(Pdc *pdc, pdc_packet_t *packet, pdc_packet_t *next_packet);
+void pdc_enable_transfer(Pdc *pdc, uint32_t controls);
+void pdc_disable_transfer(Pdc *pdc, uint32_t controls);
+uint32_t pdc_read_rx_counter(Pdc *pdc);
+uint32_t pdc_read_tx_counter(Pdc *pdc);
+
+//-------------------------------------------------------------------------------------
+// stdio_serial.h, uart.h, usart.h
+
+typedef struct
+{
+	volatile uint32_t UART_IMR;     ///< Interrupts enabled
+} Uart;
+
+extern Uart host_uart;
+
+#define UART                        (&host_uart)
+
+#define UART_SR_TXRDY               (1UL << 1)
+#define UART_SR_ENDTX               (1UL << 4)
+#define UART_SR_TXEMPTY             (1UL << 9)
+#define UART_SR_TXBUFE              (1UL << 11)
+#define UART_IER_ENDTX              UART_SR_ENDTX
+#define UART_IER_TXBUFE             UART_SR_TXBUFE
+#define UART_IDR_ENDTX              UART_SR_ENDTX
+#define UART_IDR_TXBUFE             UART_SR_TXBUFE
+
+Pdc *uart_get_pdc_base(Uart *uart);
+void uart_enable_interrupt(Uart *uart, uint32_t sources);
+void uart_disable_interrupt(Uart *uart, uint32_t sources);
+uint32_t uart_get_interrupt_mask(Uart *uart);
+uint32_t uart_get_status(Uart *uart);
+
+typedef struct
+{
+	uint32_t baudrate;
+	uint32_t charlength;
+	uint32_t paritytype;
+	uint32_t stopbits;
+} usart_serial_options_t;
+
+#define US_MR_CHRL_8_BIT            (3UL << 6)
+#define US_MR_PAR_NO                (4UL << 9)
+#define US_MR_NBSTOP_1_BIT          (0UL << 12)
+#define UART_MR_PAR_NO              (4UL << 9)
+
+/// The console is standard output, which needs no setting up
+static inline void stdio_serial_init(volatile void *uart, const usart_serial_options_t *options)
+{
+	(void) uart;
+	(void) options;
+}
+
+/** \brief Writes bytes to standard output in one go, so that no other task can be
+ *  switched in part way through. printf() and puts() are renamed to
+ *  host_printf() and host_puts() by common/host.mk, and both end up here.
+ *  @param data The bytes
+ *  @param length Number of bytes
+ */
+void host_write(const char *data, size_t length);
+int host_printf(const char *format, ...);
+int host_puts(const char *text);
+
+/** \brief Reports a failed configASSERT() and aborts, so that a debugger or
+ *  sanitizer shows where it happened.
+ */
+void host_assert_failed(const char *file, int line);
+
+//-------------------------------------------------------------------------------------
+// exceptions.h: the handlers the stand-ins run, where the program has them
+
+void UART_Handler(void);
+void TWI0_Handler(void);
+void TWI1_Handler(void);
+void SPI0_Handler(void);
+void ADC_Handler(void);
+void DMAC_Handler(void);
+void TRNG_Handler(void);
+void TC0_Handler(void);
+void TC1_Handler(void);
+void TC2_Handler(void);
+void TC3_Handler(void);
+void TC4_Handler(void);
+void TC5_Handler(void);
+void TC6_Handler(void);
+void TC7_Handler(void);
+void TC8_Handler(void);
+
+//-------------------------------------------------------------------------------------
+// tc.h
+
+typedef struct
+{
+	uint32_t index;                 ///< Which of the three blocks this is
+} Tc;
+
+extern Tc host_tc[3];
+
+#define TC0                         (&host_tc[0])
+#define TC1                         (&host_tc[1])
+#define TC2                         (&host_tc[2])
+
+#define TC_CMR_TCCLKS_Msk           (0x7UL << 0)
+#define TC_CMR_TCCLKS_TIMER_CLOCK1  (0x0UL << 0)
+#define TC_CMR_TCCLKS_TIMER_CLOCK2  (0x1UL << 0)
+#define TC_CMR_TCCLKS_TIMER_CLOCK3  (0x2UL << 0)
+#define TC_CMR_TCCLKS_TIMER_CLOCK4  (0x3UL << 0)
+#define TC_CMR_TCCLKS_TIMER_CLOCK5  (0x4UL << 0)
+#define TC_CMR_CPCTRG               (0x1UL << 14)
+#define TC_CMR_WAVE                 (0x1UL << 15)
+#define TC_CMR_WAVSEL_Msk           (0x3UL << 13)
+#define TC_CMR_WAVSEL_UP            (0x0UL << 13)
+#define TC_CMR_WAVSEL_UPDOWN        (0x1UL << 13)
+#define TC_CMR_WAVSEL_UP_RC         (0x2UL << 13)
+#define TC_CMR_WAVSEL_UPDOWN_RC     (0x3UL << 13)
+#define TC_CMR_ACPA_SET             (0x1UL << 16)
+#define TC_CMR_ACPA_CLEAR           (0x2UL << 16)
+#define TC_CMR_ACPC_SET             (0x1UL << 18)
+#define TC_CMR_ACPC_CLEAR           (0x2UL << 18)
+
+#define TC_SR_COVFS                 (0x1UL << 0)
+#define TC_SR_CPAS                  (0x1UL << 2)
+#define TC_SR_CPBS                  (0x1UL << 3)
+#define TC_SR_CPCS                  (0x1UL << 4)
+#define TC_IER_COVFS                TC_SR_COVFS
+#define TC_IER_CPAS                 TC_SR_CPAS
+#define TC_IER_CPBS                 TC_SR_CPBS
+#define TC_IER_CPCS                 TC_SR_CPCS
+#define TC_IDR_COVFS                TC_SR_COVFS
+#define TC_IDR_CPAS                 TC_SR_CPAS
+#define TC_IDR_CPBS                 TC_SR_CPBS
+#define TC_IDR_CPCS                 TC_SR_CPCS
+
+void tc_init(Tc *tc, uint32_t channel, uint32_t mode);
+void tc_start(Tc *tc, uint32_t channel);
+void tc_stop(Tc *tc, uint32_t channel);
+uint32_t tc_read_cv(Tc *tc, uint32_t channel);
+uint32_t tc_read_ra(Tc *tc, uint32_t channel);
+uint32_t tc_read_rc(Tc *tc, uint32_t channel);
+void tc_write_ra(Tc *tc, uint32_t channel, uint32_t value);
+void tc_write_rc(Tc *tc, uint32_t channel, uint32_t value);
+void tc_enable_interrupt(Tc *tc, uint32_t channel, uint32_t sources);
+void tc_disable_interrupt(Tc *tc, uint32_t channel, uint32_t sources);
+uint32_t tc_get_interrupt_mask(Tc *tc, uint32_t channel);
+uint32_t tc_get_status(Tc *tc, uint32_t channel);
+uint32_t tc_find_mck_divisor(uint32_t freq, uint32_t mck, uint32_t *divisor,
+		uint32_t *tcclks, uint32_t board_mck);
+
+//-------------------------------------------------------------------------------------
+// adc.h
+
+typedef struct
+{
+	volatile uint32_t ADC_MR;       ///< Trigger selection and sequencer
+	volatile uint32_t ADC_SEQR[2];  ///< The channel in each slot of the sequence
+	volatile uint32_t ADC_CHSR;     ///< Channels (or sequence slots) enabled
+	volatile uint32_t ADC_EMR;      ///< Tagging
+	volatile uint32_t ADC_IMR;      ///< Interrupts enabled
+} Adc;
+
+extern Adc host_adc;
+
+#define ADC                         (&host_adc)
+
+#define ADC_FREQ_MAX                20000000UL
+#define ADC_MR_TRGEN                (1UL << 0)
+#define ADC_MR_TRGSEL_Msk           (0x7UL << 1)
+#define ADC_MR_USEQ                 (1UL << 31)
+#define ADC_EMR_TAG                 (1UL << 24)
+#define ADC_ISR_ENDRX               (1UL << 27)
+#define ADC_ISR_RXBUFF              (1UL << 28)
+#define ADC_IER_ENDRX               ADC_ISR_ENDRX
+#define ADC_IER_RXBUFF              ADC_ISR_RXBUFF
+#define ADC_IDR_ENDRX               ADC_ISR_ENDRX
+#define ADC_IDR_RXBUFF              ADC_ISR_RXBUFF
+
+enum adc_channel_num_t
+{
+	ADC_CHANNEL_0, ADC_CHANNEL_1, ADC_CHANNEL_2, ADC_CHANNEL_3, ADC_CHANNEL_4,
+	ADC_CHANNEL_5, ADC_CHANNEL_6, ADC_CHANNEL_7, ADC_CHANNEL_8, ADC_CHANNEL_9,
+	ADC_CHANNEL_10, ADC_CHANNEL_11, ADC_CHANNEL_12, ADC_CHANNEL_13, ADC_CHANNEL_14,
+	ADC_TEMPERATURE_SENSOR
+};
+
+enum adc_trigger_t
+{
+	ADC_TRIG_SW = 0,
+	ADC_TRIG_EXT = 1,
+	ADC_TRIG_TIO_CH_0 = 3,
+	ADC_TRIG_TIO_CH_1 = 5,
+	ADC_TRIG_TIO_CH_2 = 7,
+	ADC_TRIG_PWM_EVENT_LINE_0 = 9,
+	ADC_TRIG_PWM_EVENT_LINE_1 = 11
+};
+
+enum adc_startup_time
+{
+	ADC_STARTUP_TIME_0, ADC_STARTUP_TIME_1, ADC_STARTUP_TIME_2, ADC_STARTUP_TIME_3,
+	ADC_STARTUP_TIME_4, ADC_STARTUP_TIME_5, ADC_STARTUP_TIME_6, ADC_STARTUP_TIME_7
+};
+
+enum adc_settling_time_t
+{
+	ADC_SETTLING_TIME_0, ADC_SETTLING_TIME_1, ADC_SETTLING_TIME_2, ADC_SETTLING_TIME_3
+};
+
+uint32_t adc_init(Adc *adc, uint32_t mck, uint32_t adc_clock, enum adc_startup_time startup);
+void adc_configure_timing(Adc *adc, uint8_t tracking, enum adc_settling_time_t settling,
+		uint8_t transfer);
+void adc_configure_trigger(Adc *adc, enum adc_trigger_t trigger, uint8_t freerun);
+void adc_configure_sequence(Adc *adc, const enum adc_channel_num_t channels[],
+		uint8_t count);
+void adc_start_sequencer(Adc *adc);
+void adc_stop_sequencer(Adc *adc);
+void adc_enable_tag(Adc *adc);
+void adc_disable_tag(Adc *adc);
+void adc_enable_channel(Adc *adc, enum adc_channel_num_t channel);
+void adc_disable_channel(Adc *adc, enum adc_channel_num_t channel);
+void adc_disable_all_channel(Adc *adc);
+uint32_t adc_get_status(Adc *adc);
+void adc_enable_interrupt(Adc *adc, uint32_t sources);
+void adc_disable_interrupt(Adc *adc, uint32_t sources);
+Pdc *adc_get_pdc_base(Adc *adc);
+
+//-------------------------------------------------------------------------------------
+// spi.h
+
+/** \brief The SPI controller. SPI_RDR and SPI_TDR share their storage, which is
+ *  the wire from MOSI back to MISO.
+ */
+typedef struct
+{
+	volatile uint32_t SPI_CR;
+	volatile uint32_t SPI_MR;
+	union
+	{
+		volatile uint32_t SPI_RDR;
+		volatile uint32_t SPI_TDR;
+	};
+	volatile uint32_t SPI_SR;
+	volatile uint32_t SPI_IMR;
+	volatile uint32_t SPI_CSR[4];
+} Spi;
+
+extern Spi host_spi;
+
+#define SPI0                        (&host_spi)
+
+#define SPI_CR_SPIEN                (1UL << 0)
+#define SPI_CR_SPIDIS               (1UL << 1)
+#define SPI_CR_SWRST                (1UL << 7)
+#define SPI_CR_LASTXFER             (1UL << 24)
+#define SPI_MR_MSTR                 (1UL << 0)
+#define SPI_MR_PS                   (1UL << 1)
+#define SPI_MR_MODFDIS              (1UL << 4)
+#define SPI_MR_LLB                  (1UL << 7)
+#define SPI_MR_PCS_Pos              16
+#define SPI_MR_PCS_Msk              (0xFUL << SPI_MR_PCS_Pos)
+#define SPI_SR_RDRF                 (1UL << 0)
+#define SPI_SR_TDRE                 (1UL << 1)
+#define SPI_SR_TXEMPTY              (1UL << 9)
+#define SPI_SR_SPIENS               (1UL << 16)
+#define SPI_CSR_CPOL                (1UL << 0)
+#define SPI_CSR_NCPHA               (1UL << 1)
+#define SPI_CSR_CSNAAT              (1UL << 2)
+#define SPI_CSR_CSAAT               (1UL << 3)
+#define SPI_CSR_BITS_Pos            4
+#define SPI_CSR_BITS_Msk            (0xFUL << SPI_CSR_BITS_Pos)
+#define SPI_CSR_BITS_8_BIT          (0x0UL << SPI_CSR_BITS_Pos)
+#define SPI_CSR_SCBR_Pos            8
+#define SPI_CSR_SCBR_Msk            (0xFFUL << SPI_CSR_SCBR_Pos)
+
+#define SPI_CS_RISE_NO_TX           0
+#define SPI_CS_RISE_FORCED          SPI_CSR_CSNAAT
+#define SPI_CS_KEEP_LOW             SPI_CSR_CSAAT
+
+#define spi_get_pcs(chip_sel_id)    ((~(1u << (chip_sel_id))) & 0xF)
+
+void spi_enable(Spi *spi);
+void spi_disable(Spi *spi);
+void spi_reset(Spi *spi);
+void spi_set_lastxfer(Spi *spi);
+void spi_set_master_mode(Spi *spi);
+void spi_disable_mode_fault_detect(Spi *spi);
+void spi_disable_loopback(Spi *spi);
+void spi_set_fixed_peripheral_select(Spi *spi);
+void spi_set_peripheral_chip_select_value(Spi *spi, uint32_t value);
+void spi_set_clock_polarity(Spi *spi, uint32_t chip_select, uint32_t polarity);
+void spi_set_clock_phase(Spi *spi, uint32_t chip_select, uint32_t phase);
+void spi_configure_cs_behavior(Spi *spi, uint32_t chip_select, uint32_t behavior);
+void spi_set_bits_per_transfer(Spi *spi, uint32_t chip_select, uint32_t bits);
+int16_t spi_calc_baudrate_div(const uint32_t baudrate, uint32_t mck);
+int16_t spi_set_baudrate_div(Spi *spi, uint32_t chip_select, uint8_t divider);
+
+//-------------------------------------------------------------------------------------
+// dmac.h
+
+/// Number of DMAC channels
+#define HOST_DMAC_CHANNELS          6
+
+typedef struct
+{
+	volatile uint32_t DMAC_EN;      ///< Whether the controller is enabled
+	volatile uint32_t DMAC_EBCIMR;  ///< Interrupts enabled
+	volatile uint32_t DMAC_EBCISR;  ///< Interrupts raised, cleared when read
+	volatile uint32_t DMAC_CHSR;    ///< Channels enabled
+} Dmac;
+
+extern Dmac host_dmac;
+
+#define DMAC                        (&host_dmac)
+
+/** \brief A transfer descriptor. The address fields are as wide as a host pointer.
+ */
+typedef struct
+{
+	uintptr_t ul_source_addr;
+	uintptr_t ul_destination_addr;
+	uint32_t ul_ctrlA;
+	uint32_t ul_ctrlB;
+	uintptr_t ul_descriptor_addr;
+} dma_transfer_descriptor_t;
+
+typedef enum
+{
+	DMAC_PRIORITY_FIXED = 0,
+	DMAC_PRIORITY_ROUND_ROBIN = 1
+} dmac_priority_mode_t;
+
+#define DMAC_CTRLA_BTSIZE(value)            ((uint32_t) (value) & 0xFFFFUL)
+#define DMAC_CTRLA_SRC_WIDTH_BYTE           (0x0UL << 24)
+#define DMAC_CTRLA_DST_WIDTH_BYTE           (0x0UL << 28)
+#define DMAC_CTRLB_SRC_DSCR_FETCH_DISABLE   (0x1UL << 16)
+#define DMAC_CTRLB_DST_DSCR_FETCH_DISABLE   (0x1UL << 20)
+#define DMAC_CTRLB_FC_Msk                   (0x7UL << 21)
+#define DMAC_CTRLB_FC_MEM2MEM_DMA_FC        (0x0UL << 21)
+#define DMAC_CTRLB_FC_MEM2PER_DMA_FC        (0x1UL << 21)
+#define DMAC_CTRLB_FC_PER2MEM_DMA_FC        (0x2UL << 21)
+#define DMAC_CTRLB_SRC_INCR_Msk             (0x3UL << 24)
+#define DMAC_CTRLB_SRC_INCR_INCREMENTING    (0x0UL << 24)
+#define DMAC_CTRLB_SRC_INCR_DECREMENTING    (0x1UL << 24)
+#define DMAC_CTRLB_SRC_INCR_FIXED           (0x2UL << 24)
+#define DMAC_CTRLB_DST_INCR_Msk             (0x3UL << 28)
+#define DMAC_CTRLB_DST_INCR_INCREMENTING    (0x0UL << 28)
+#define DMAC_CTRLB_DST_INCR_DECREMENTING    (0x1UL << 28)
+#define DMAC_CTRLB_DST_INCR_FIXED           (0x2UL << 28)
+#define DMAC_CFG_SRC_PER(value)             ((uint32_t) (value) & 0xFUL)
+#define DMAC_CFG_DST_PER(value)             (((uint32_t) (value) & 0xFUL) << 4)
+#define DMAC_CFG_SRC_H2SEL                  (0x1UL << 9)
+#define DMAC_CFG_DST_H2SEL                  (0x1UL << 13)
+#define DMAC_CFG_SOD                        (0x1UL << 16)
+#define DMAC_CFG_FIFOCFG_ALAP_CFG           (0x0UL << 28)
+#define DMAC_CFG_FIFOCFG_HLF_CFG            (0x1UL << 28)
+#define DMAC_CFG_FIFOCFG_ASAP_CFG           (0x2UL << 28)
+#define DMAC_EBCIER_BTC0                    (0x1UL << 0)
+
+void dmac_init(Dmac *dmac);
+void dmac_enable(Dmac *dmac);
+void dmac_disable(Dmac *dmac);
+void dmac_set_priority_mode(Dmac *dmac, dmac_priority_mode_t mode);
+void dmac_enable_interrupt(Dmac *dmac, uint32_t sources);
+void dmac_disable_interrupt(Dmac *dmac, uint32_t sources);
+uint32_t dmac_get_status(Dmac *dmac);
+void dmac_channel_set_configuration(Dmac *dmac, uint32_t channel, uint32_t config);
+void dmac_channel_single_buf_transfer_init(Dmac *dmac, uint32_t channel,
+		dma_transfer_descriptor_t *desc);
+void dmac_channel_enable(Dmac *dmac, uint32_t channel);
+void dmac_channel_disable(Dmac *dmac, uint32_t channel);
+
+//-------------------------------------------------------------------------------------
+// twi.h
+
+typedef struct
+{
+	volatile uint32_t TWI_CR;
+	volatile uint32_t TWI_MMR;
+	volatile uint32_t TWI_IADR;
+	volatile uint32_t TWI_SR;
+	volatile uint32_t TWI_IMR;
+	volatile uint32_t TWI_RHR;
+	volatile uint32_t TWI_THR;
+} Twi;
+
+extern Twi host_twi[2];
+
+#define TWI0                        (&host_twi[0])
+#define TWI1                        (&host_twi[1])
+
+#define TWI_CR_START                (1UL << 0)
+#define TWI_CR_STOP                 (1UL << 1)
+#define TWI_MMR_IADRSZ_1_BYTE       (0x1UL << 8)
+#define TWI_MMR_MREAD               (1UL << 12)
+#define TWI_MMR_DADR(value)         (((uint32_t) (value) & 0x7FUL) << 16)
+#define TWI_SR_TXCOMP               (1UL << 0)
+#define TWI_SR_RXRDY                (1UL << 1)
+#define TWI_SR_TXRDY                (1UL << 2)
+#define TWI_SR_NACK                 (1UL << 8)
+#define TWI_SR_ARBLST               (1UL << 9)
+#define TWI_IER_TXCOMP              TWI_SR_TXCOMP
+#define TWI_IER_RXRDY               TWI_SR_RXRDY
+#define TWI_IER_TXRDY               TWI_SR_TXRDY
+#define TWI_IER_NACK                TWI_SR_NACK
+#define TWI_IER_ARBLST              TWI_SR_ARBLST
+#define TWI_IDR_TXCOMP              TWI_SR_TXCOMP
+#define TWI_IDR_RXRDY               TWI_SR_RXRDY
+#define TWI_IDR_TXRDY               TWI_SR_TXRDY
+
+#define TWI_SUCCESS                 0
+#define TWI_INVALID_ARGUMENT        1
+
+typedef struct
+{
+	uint32_t master_clk;
+	uint32_t speed;
+	uint8_t chip;
+	bool smbus;
+} twi_options_t;
+
+uint32_t twi_master_init(Twi *twi, const twi_options_t *options);
+void twi_enable_interrupt(Twi *twi, uint32_t sources);
+void twi_disable_interrupt(Twi *twi, uint32_t sources);
+uint32_t twi_get_interrupt_status(Twi *twi);
+uint32_t twi_get_interrupt_mask(Twi *twi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _ASF_HOST_H_
@@ -0,0 +1,356 @@
+//*************************************************************************************
+/** \file adc_stream.c
+ *    This file contains the streaming ADC service. Buffers pass between the
+ *    interrupt handler and the callback through two single-producer,
+ *    single-consumer rings of buffer numbers: the filled ones to the callback, and
+ *    the ones it has finished with back to the handler. Neither side ever waits
+ *    for the other, so the rings need no locking.
+ */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <compiler.h>
+#include <interrupt.h>
+#include <sysclk.h>
+#include <adc.h>
+#include <pdc.h>
+#include <tc.h>
+#include <conf_adc_stream.h>
+#include "cycle_counter.h"
+#include "adc_stream.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#endif
+
+#if ADC_STREAM_BLOCKS < 3
+#error ADC_STREAM_BLOCKS must be at least 3
+#endif
+
+/// The most samples per second the SAM3X ADC can convert
+#define ADC_STREAM_MAX_RATE    1000000UL
+
+/** \brief A ring of buffer numbers. One slot is always left empty, so each ring
+ *  can hold ADC_STREAM_BLOCKS - 1 numbers, which is more than either ever needs.
+ */
+struct adc_stream_ring
+{
+	volatile uint32_t head;            ///< Where the next number goes
+	volatile uint32_t tail;            ///< Where the next number comes from
+	uint8_t blocks[ADC_STREAM_BLOCKS];
+};
+
+static uint16_t buffers[ADC_STREAM_BLOCKS][ADC_STREAM_BLOCK_SAMPLES];
+
+/// Samples in each block, a whole number of sequences
+static uint32_t block_length;
+
+/// Filled buffers, for the callback
+static struct adc_stream_ring ready;
+
+/// Buffers the callback has finished with, for the handler
+static struct adc_stream_ring spare;
+
+/// The buffers loaded into the PDC's current and next registers
+static uint8_t dma_current;
+static uint8_t dma_next;
+
+static adc_stream_callback_t stream_callback;
+static void *stream_arg;
+
+/// The counts since the stream was started
+static volatile uint32_t count_blocks;
+static volatile uint32_t count_dropped;
+static volatile uint32_t count_overruns;
+
+/// Samples and cycles counted at the end of each block, for the rate
+static uint64_t rate_samples;
+static uint64_t rate_cycles;
+static uint32_t rate_last;
+
+#ifdef _USE_FREERTOS_
+/// Given by the interrupt handler when it queues a block for an idle callback
+static SemaphoreHandle_t ready_sem;
+#endif
+
+//------------------------------------------------------------------------------
+/** \brief Adds a buffer number to a ring. There is always room.
+ */
+static void ring_put(struct adc_stream_ring *ring, uint8_t block)
+{
+	uint32_t head = ring->head;
+
+	ring->blocks[head] = block;
+	__DMB();
+	ring->head = (head + 1 == ADC_STREAM_BLOCKS) ? 0 : head + 1;
+}
+
+/** \brief Takes the oldest buffer number from a ring.
+ *  @param block Set to the buffer number
+ *  @return false if the ring was empty
+ */
+static bool ring_get(struct adc_stream_ring *ring, uint8_t *block)
+{
+	uint32_t tail = ring->tail;
+
+	if (tail == ring->head)
+	{
+		return false;
+	}
+	__DMB();
+	*block = ring->blocks[tail];
+	ring->tail = (tail + 1 == ADC_STREAM_BLOCKS) ? 0 : tail + 1;
+	return true;
+}
+
+/** \brief Deals with the PDC finishing its current buffer, which it has already
+ *  replaced with its next one. Queues the full buffer for the callback and picks
+ *  a spare one to follow, or, if none is spare, drops the full one and reuses it.
+ *  @return Whether a buffer was queued
+ */
+static bool adc_stream_block_done(void)
+{
+	uint8_t done = dma_current;
+	uint8_t next;
+	uint32_t now = DWT->CYCCNT;
+
+	rate_cycles += (uint32_t) (now - rate_last);
+	rate_last = now;
+	rate_samples += block_length;
+	count_blocks++;
+
+	dma_current = dma_next;
+	if (ring_get(&spare, &next))
+	{
+		ring_put(&ready, done);
+		dma_next = next;
+		return true;
+	}
+	count_dropped++;
+	dma_next = done;
+	return false;
+}
+
+/** \brief Fills in a PDC packet for a buffer.
+ */
+static void adc_stream_packet(pdc_packet_t *packet, uint8_t block)
+{
+	packet->ul_addr = (uintptr_t) buffers[block];
+	packet->ul_size = block_length;
+}
+
+/** \brief ADC interrupt handler. It runs once per block, when the PDC's current
+ *  buffer is full.
+ */
+void ADC_Handler(void)
+{
+	uint32_t status = adc_get_status(ADC);
+	Pdc *pdc = adc_get_pdc_base(ADC);
+	bool queued = false;
+	pdc_packet_t current;
+	pdc_packet_t next;
+
+	if (status & ADC_ISR_RXBUFF)
+	{
+		// Both buffers filled before the handler got to the first, and the PDC has
+		// stopped. Hand both over and start again; the sequence may have slipped.
+		queued |= adc_stream_block_done();
+		queued |= adc_stream_block_done();
+		count_overruns++;
+		adc_stream_packet(&current, dma_current);
+		adc_stream_packet(&next, dma_next);
+		pdc_rx_init(pdc, &current, &next);
+	}
+	else if (status & ADC_ISR_ENDRX)
+	{
+		// Writing the next count also clears ENDRX
+		queued = adc_stream_block_done();
+		adc_stream_packet(&next, dma_next);
+		pdc_rx_init(pdc, NULL, &next);
+	}
+
+#ifdef _USE_FREERTOS_
+	if (queued && (ready_sem != NULL))
+	{
+		BaseType_t woken = pdFALSE;
+
+		xSemaphoreGiveFromISR(ready_sem, &woken);
+		portEND_SWITCHING_ISR(woken);
+	}
+#else
+	(void) queued;
+#endif
+}
+
+//------------------------------------------------------------------------------
+bool adc_stream_init(const uint8_t *channels, uint32_t count, uint32_t rate_hz,
+		adc_stream_callback_t callback, void *arg)
+{
+	enum adc_channel_num_t sequence[16];
+	uint32_t timer_hz;
+	uint32_t i;
+
+	if ((count == 0) || (count > 16) || (count > ADC_STREAM_BLOCK_SAMPLES)
+			|| (rate_hz == 0) || (rate_hz > ADC_STREAM_MAX_RATE / count))
+	{
+		return false;
+	}
+	block_length = ADC_STREAM_BLOCK_SAMPLES - ADC_STREAM_BLOCK_SAMPLES % count;
+	stream_callback = callback;
+	stream_arg = arg;
+
+	cycle_counter_enable();
+
+	// Convert the listed channels on each trigger from the timer, tagging each
+	// result with its channel. The sequencer runs through as many slots as there
+	// are channels enabled, so the first count slots are enabled.
+	sysclk_enable_peripheral_clock(ID_ADC);
+	adc_init(ADC, sysclk_get_cpu_hz(), ADC_FREQ_MAX, ADC_STARTUP_TIME_4);
+	adc_configure_timing(ADC, 0, ADC_SETTLING_TIME_3, 1);
+	adc_disable_all_channel(ADC);
+	for (i = 0; i < count; i++)
+	{
+		sequence[i] = (enum adc_channel_num_t) channels[i];
+		adc_enable_channel(ADC, (enum adc_channel_num_t) i);
+	}
+	adc_configure_sequence(ADC, sequence, (uint8_t) count);
+	adc_start_sequencer(ADC);
+	adc_enable_tag(ADC);
+	adc_configure_trigger(ADC, ADC_STREAM_TRIGGER, 0);
+
+	// The timer's TIOA output goes high at each RC compare, triggering the ADC,
+	// and low again half way through the period
+	sysclk_enable_peripheral_clock(ADC_STREAM_TC_ID);
+	timer_hz = sysclk_get_peripheral_hz() / 2;
+	tc_init(ADC_STREAM_TC, ADC_STREAM_TC_CHANNEL,
+			TC_CMR_TCCLKS_TIMER_CLOCK1 | TC_CMR_WAVE | TC_CMR_WAVSEL_UP_RC
+			| TC_CMR_ACPA_CLEAR | TC_CMR_ACPC_SET);
+	tc_write_rc(ADC_STREAM_TC, ADC_STREAM_TC_CHANNEL, timer_hz / rate_hz);
+	tc_write_ra(ADC_STREAM_TC, ADC_STREAM_TC_CHANNEL, timer_hz / rate_hz / 2);
+
+	NVIC_DisableIRQ(ADC_IRQn);
+	NVIC_ClearPendingIRQ(ADC_IRQn);
+	NVIC_SetPriority(ADC_IRQn, ADC_STREAM_IRQ_PRIORITY);
+	NVIC_EnableIRQ(ADC_IRQn);
+
+#ifdef _USE_FREERTOS_
+	if (ready_sem == NULL)
+	{
+		ready_sem = xSemaphoreCreateBinary();
+	}
+#endif
+	return true;
+}
+
+void adc_stream_start(void)
+{
+	Pdc *pdc = adc_get_pdc_base(ADC);
+	pdc_packet_t current;
+	pdc_packet_t next;
+	uint8_t i;
+
+	adc_stream_stop();
+
+	// Buffers 0 and 1 go into the PDC and the rest are spare
+	ready.head = ready.tail = 0;
+	spare.head = spare.tail = 0;
+	for (i = 2; i < ADC_STREAM_BLOCKS; i++)
+	{
+		ring_put(&spare, i);
+	}
+	dma_current = 0;
+	dma_next = 1;
+	count_blocks = 0;
+	count_dropped = 0;
+	count_overruns = 0;
+	rate_samples = 0;
+	rate_cycles = 0;
+
+	adc_stream_packet(&current, dma_current);
+	adc_stream_packet(&next, dma_next);
+	pdc_rx_init(pdc, &current, &next);
+	pdc_enable_transfer(pdc, PERIPH_PTCR_RXTEN);
+	adc_enable_interrupt(ADC, ADC_IER_ENDRX | ADC_IER_RXBUFF);
+
+	rate_last = DWT->CYCCNT;
+	tc_start(ADC_STREAM_TC, ADC_STREAM_TC_CHANNEL);
+}
+
+void adc_stream_stop(void)
+{
+	tc_stop(ADC_STREAM_TC, ADC_STREAM_TC_CHANNEL);
+	adc_disable_interrupt(ADC, ADC_IDR_ENDRX | ADC_IDR_RXBUFF);
+	pdc_disable_transfer(adc_get_pdc_base(ADC), PERIPH_PTCR_RXTDIS);
+}
+
+uint32_t adc_stream_process(void)
+{
+	uint32_t count = 0;
+	uint8_t block;
+
+	while (ring_get(&ready, &block))
+	{
+		stream_callback(buffers[block], block_length, stream_arg);
+		ring_put(&spare, block);
+		count++;
+	}
+	return count;
+}
+
+void adc_stream_get_stats(adc_stream_stats_t *stats)
+{
+	irqflags_t flags = cpu_irq_save();
+	uint64_t samples = rate_samples;
+	uint64_t cycles = rate_cycles;
+
+	stats->blocks = count_blocks;
+	stats->dropped = count_dropped;
+	stats->overruns = count_overruns;
+	cpu_irq_restore(flags);
+
+	// Work in milliseconds, so the product can't overflow in any likely run
+	cycles /= sysclk_get_cpu_hz() / 1000;
+	stats->samples_per_sec = (cycles == 0) ? 0 : (uint32_t) (samples * 1000 / cycles);
+}
+
+void adc_stream_print_stats(void)
+{
+	adc_stream_stats_t stats;
+
+	adc_stream_get_stats(&stats);
+	printf("ADC stream: %lu blocks, %lu dropped, %lu overruns, %lu samples/s\r\n",
+			(unsigned long) stats.blocks, (unsigned long) stats.dropped,
+			(unsigned long) stats.overruns, (unsigned long) stats.samples_per_sec);
+}
+
+#ifdef _USE_FREERTOS_
+/** \brief The task which gives blocks to the callback when the handler signals it.
+ *  @param params Not used
+ */
+static void adc_stream_task(void *params)
+{
+	(void) params;
+
+	for (;;)
+	{
+		xSemaphoreTake(ready_sem, portMAX_DELAY);
+		adc_stream_process();
+	}
+}
+
+long adc_stream_start_task(unsigned long priority)
+{
+	if (ready_sem == NULL)
+	{
+		ready_sem = xSemaphoreCreateBinary();
+		if (ready_sem == NULL)
+		{
+			return pdFAIL;
+		}
+	}
+	return xTaskCreate(adc_stream_task, "ADC", ADC_STREAM_TASK_STACK_SIZE, NULL,
+			(UBaseType_t) priority, NULL);
+}
+#endif
@@ -0,0 +1,115 @@
+//*************************************************************************************
+/** \file adc_stream.h
+ *    This file contains a service which samples a sequence of ADC channels
+ *    continuously and hands the samples over a block at a time.
+ *
+ *    A timer counter channel triggers the ADC at a set rate. Each trigger converts
+ *    every channel in the sequence, in order. The PDC moves each result into the
+ *    current block buffer, so sampling takes no processor time at all. The PDC
+ *    holds two buffers, the one being filled and the one after it, and moves on to
+ *    the second by itself when the first is full. The only interrupt is at the end
+ *    of each block, where the full buffer is queued for the callback and another
+ *    free one is loaded behind the one now being filled.
+ *
+ *    If the callback falls so far behind that no buffer is free, the block just
+ *    filled is dropped and filled again, so the PDC never runs dry and the
+ *    sequence never slips out of step with the blocks. Dropped blocks are counted.
+ *    Each sample is tagged with its channel number in bits 12 to 15 all the same;
+ *    use ADC_STREAM_VALUE() and ADC_STREAM_CHANNEL() to take samples apart.
+ *
+ *    The callback runs in a task under FreeRTOS (adc_stream_start_task()), or when
+ *    adc_stream_process() is called from a main loop otherwise. The SAM3X ADC
+ *    manages up to 1 million samples per second, shared between the channels.
+ *    The block size, buffer count and timer channel are set in
+ *    lib/ASF_Config/conf_adc_stream.h. To use the service, add adc_stream to
+ *    SERVICES in the project Makefile. Enabling an ADC channel takes its pin over
+ *    from the PIO, so the pins need no other setting up.
+ *    projects/ex11_frt_adc_stream_cpp streams two channels with it.
+ */
+//*************************************************************************************
+
+#ifndef _ADC_STREAM_H_
+#define _ADC_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// The 12-bit conversion result in a sample
+#define ADC_STREAM_VALUE(sample)	((sample) & 0x0FFF)
+
+/// The channel a sample was converted from
+#define ADC_STREAM_CHANNEL(sample)	((sample) >> 12)
+
+/** \brief The function which is given each block of samples.
+ *  @param samples The block, whole sequences one after another
+ *  @param count Number of samples in the block
+ *  @param arg The argument given to adc_stream_init()
+ */
+typedef void (*adc_stream_callback_t)(const uint16_t *samples, uint32_t count,
+		void *arg);
+
+/** \brief How the stream has been doing since it was started.
+ */
+typedef struct adc_stream_stats
+{
+	uint32_t blocks;           ///< Blocks filled by the PDC
+	uint32_t dropped;          ///< Blocks filled but not given to the callback
+	uint32_t overruns;         ///< Times the PDC ran out of buffers and restarted
+	uint32_t samples_per_sec;  ///< Samples converted per second, as measured
+} adc_stream_stats_t;
+
+/** \brief Sets the ADC, PDC and trigger up. Call this once, before starting.
+ *  @param channels The ADC channels to convert on each trigger, in order
+ *  @param count Number of channels, 1 to 16
+ *  @param rate_hz Triggers per second; the samples per second are this times
+ *         \p count, which must be no more than 1 million
+ *  @param callback The function to give each block to
+ *  @param arg An argument for the callback
+ *  @return false if the settings can't be used
+ */
+bool adc_stream_init(const uint8_t *channels, uint32_t count, uint32_t rate_hz,
+		adc_stream_callback_t callback, void *arg);
+
+/** \brief Starts sampling, with every buffer free and the counts reset.
+ *  \details Call this and adc_stream_stop() from the same task that runs the
+ *  callback, or while no callback is running.
+ */
+void adc_stream_start(void);
+
+/** \brief Stops sampling. Blocks not yet given to the callback are thrown away
+ *  when the stream is next started.
+ */
+void adc_stream_stop(void);
+
+/** \brief Gives each filled block to the callback, oldest first.
+ *  @return The number of blocks given
+ */
+uint32_t adc_stream_process(void);
+
+/** \brief Returns the counts since the stream was started.
+ *  @param stats Filled in with the counts
+ */
+void adc_stream_get_stats(adc_stream_stats_t *stats);
+
+/** \brief Prints the counts since the stream was started.
+ */
+void adc_stream_print_stats(void);
+
+/** \brief Creates a task which gives each block to the callback as soon as it is
+ *  filled.
+ *  \details This is only built into projects that use FreeRTOS; others should call
+ *  adc_stream_process() from their main loop instead.
+ *  @param priority The task's priority; the callback runs at this priority
+ *  @return pdPASS if the task was created
+ */
+long adc_stream_start_task(unsigned long priority);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _ADC_STREAM_H_
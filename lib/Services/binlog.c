@@ -0,0 +1,182 @@
+//*************************************************************************************
+/** \file binlog.c
+ *    This file contains the deferred binary logging service. Records are kept in a
+ *    ring of 32-bit words, each laid out as
+ *    \code
+ *    word 0    0xA5 | (argument count << 8) | (sequence number << 16)
+ *    word 1    address of the format string
+ *    word 2    DWT cycle count when the record was written, since binlog_init(),
+ *              which wraps every 51 s at 84 MHz; the decoder carries the wraps
+ *    word 3..  arguments
+ *    \endcode
+ *    and sent to the console exactly as they sit in memory, so a frame on the wire
+ *    is the same words in little-endian byte order.
+ *
+ *    Writers reserve a whole record under a short critical section, so records are
+ *    never interleaved and the ring only ever holds complete ones. The sequence
+ *    number advances for dropped records too, which is how the decoder spots them.
+ */
+//*************************************************************************************
+
+#include <compiler.h>
+#include <interrupt.h>
+#include <conf_binlog.h>
+#include "cycle_counter.h"
+#include "console.h"
+#include "binlog.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#include <task.h>
+#endif
+
+/// Mask used to turn the free-running ring indices into array indices
+#define BINLOG_MASK  (BINLOG_BUFFER_WORDS - 1)
+
+// The ring indices only wrap correctly if the buffer size is a power of two
+typedef char binlog_size_must_be_power_of_two
+	[((BINLOG_BUFFER_WORDS & BINLOG_MASK) == 0) ? 1 : -1];
+
+static uint32_t log_ring[BINLOG_BUFFER_WORDS];  ///< Records waiting to be sent
+
+/// Index one past the newest word in \c log_ring; written with interrupts masked
+static volatile uint32_t log_head = 0;
+
+/// Index of the oldest word in \c log_ring; written only by binlog_drain()
+static volatile uint32_t log_tail = 0;
+
+/// Sequence number given to the next record, 16 bits on the wire
+static uint32_t log_seq = 0;
+
+/// Number of records dropped because the ring was full
+static volatile uint32_t log_dropped = 0;
+
+/** Cycle count when binlog_init() ran, which time stamps are taken from. The
+ *  counter is shared, so it is never reset. */
+static uint32_t log_epoch = 0;
+
+void binlog_init(void)
+{
+	irqflags_t flags = cpu_irq_save();
+
+	log_head = 0;
+	log_tail = 0;
+	log_seq = 0;
+	log_dropped = 0;
+	cpu_irq_restore(flags);
+
+	cycle_counter_enable();
+	log_epoch = cycle_counter_get();
+}
+
+void binlog_write(const char *fmt, uint32_t nargs, uint32_t a0, uint32_t a1,
+		uint32_t a2, uint32_t a3)
+{
+	uint32_t words = BINLOG_HEADER_WORDS + nargs;
+	irqflags_t flags = cpu_irq_save();
+	uint32_t head = log_head;
+
+	// Stamped under the same lock as the sequence number, so the two agree on order
+	uint32_t stamp = cycle_counter_since(log_epoch);
+
+	if (BINLOG_BUFFER_WORDS - (head - log_tail) < words)
+	{
+		log_seq++;
+		log_dropped++;
+		cpu_irq_restore(flags);
+		return;
+	}
+
+	log_ring[head & BINLOG_MASK] = BINLOG_SYNC | (nargs << 8) | (log_seq++ << 16);
+	log_ring[(head + 1) & BINLOG_MASK] = (uint32_t) fmt;
+	log_ring[(head + 2) & BINLOG_MASK] = stamp;
+	switch (nargs)
+	{
+		case 4:
+			log_ring[(head + 6) & BINLOG_MASK] = a3;
+			// fall through
+		case 3:
+			log_ring[(head + 5) & BINLOG_MASK] = a2;
+			// fall through
+		case 2:
+			log_ring[(head + 4) & BINLOG_MASK] = a1;
+			// fall through
+		case 1:
+			log_ring[(head + 3) & BINLOG_MASK] = a0;
+			// fall through
+		default:
+			break;
+	}
+	log_head = head + words;
+	cpu_irq_restore(flags);
+}
+
+uint32_t binlog_drain(void)
+{
+	uint32_t head = log_head;
+	uint32_t tail = log_tail;
+	uint32_t room = console_get_free() / sizeof(uint32_t);
+	uint32_t end = tail;
+	uint32_t records = 0;
+	uint32_t start;
+	uint32_t first;
+
+	// Only whole records go out, and only as many as the console can take
+	while (end != head)
+	{
+		uint32_t words = BINLOG_HEADER_WORDS
+			+ ((log_ring[end & BINLOG_MASK] >> 8) & 0xFF);
+
+		if (words > room)
+		{
+			break;
+		}
+		room -= words;
+		end += words;
+		records++;
+	}
+	if (records == 0)
+	{
+		return 0;
+	}
+
+	// Send the words in at most two pieces, in case they wrap around the ring
+	start = tail & BINLOG_MASK;
+	first = BINLOG_BUFFER_WORDS - start;
+	if (first > end - tail)
+	{
+		first = end - tail;
+	}
+	console_write((const char*) &log_ring[start], first * sizeof(uint32_t));
+	console_write((const char*) log_ring, (end - tail - first) * sizeof(uint32_t));
+
+	log_tail = end;
+	return records;
+}
+
+uint32_t binlog_get_dropped(void)
+{
+	return log_dropped;
+}
+
+#ifdef _USE_FREERTOS_
+/** \brief The log task, which sends buffered records every BINLOG_DRAIN_PERIOD_MS.
+ *  @param params Not used
+ */
+static void binlog_task(void *params)
+{
+	(void) params;
+
+	for (;;)
+	{
+		binlog_drain();
+		vTaskDelay(configMS_TO_TICKS(BINLOG_DRAIN_PERIOD_MS));
+	}
+}
+
+long binlog_start_task(unsigned long priority)
+{
+	return xTaskCreate(binlog_task, "Log", BINLOG_TASK_STACK_SIZE, NULL,
+			(UBaseType_t) priority, NULL);
+}
+#endif
@@ -0,0 +1,100 @@
+//*************************************************************************************
+/** \file binlog.h
+ *    This file contains a deferred, binary logging service. A log call doesn't
+ *    format anything: it stores the address of its format string, a cycle-count
+ *    time stamp and up to four raw 32-bit arguments in a RAM buffer, which takes a
+ *    few dozen cycles and almost no stack. A low-priority task (or binlog_drain(),
+ *    called from a main loop) later sends the records out through the console
+ *    service, and tools/binlog_decode.py turns them back into text on the host by
+ *    looking the format strings up in the program's ELF file.
+ *
+ *    Because of that, the format string must be a string literal (or otherwise live
+ *    in flash), and so must any \c %s argument. Integer conversions (\c %d, \c %u,
+ *    \c %x, \c %c and so on) work as they do with printf(); floating point doesn't.
+ *
+ *    Records go out as binary frames that start with the byte 0xA5, which never
+ *    appears in ASCII text, so ordinary printf() output can share the UART; the
+ *    decoder passes it through unchanged. If the buffer fills up, new records are
+ *    dropped and counted, and the decoder reports the gap in sequence numbers.
+ *
+ *    The buffer size and drain period are set in lib/ASF_Config/conf_binlog.h. To
+ *    use the service, add both console and binlog to SERVICES in the project
+ *    Makefile, call console_init() and binlog_init(), and then either start the log
+ *    task or call binlog_drain() regularly.
+ */
+//*************************************************************************************
+
+#ifndef _BINLOG_H_
+#define _BINLOG_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// The first byte of every record on the wire
+#define BINLOG_SYNC            0xA5
+
+/// Words in a record before its arguments: header, format string, time stamp
+#define BINLOG_HEADER_WORDS    3
+
+/// The largest number of arguments one record can carry
+#define BINLOG_MAX_ARGS        4
+
+/** \brief Logs a message with no arguments. @param fmt A string literal */
+#define BINLOG0(fmt) \
+	binlog_write ((fmt), 0, 0, 0, 0, 0)
+
+/** \brief Logs a message with one 32-bit argument. */
+#define BINLOG1(fmt, a) \
+	binlog_write ((fmt), 1, (uint32_t) (a), 0, 0, 0)
+
+/** \brief Logs a message with two 32-bit arguments. */
+#define BINLOG2(fmt, a, b) \
+	binlog_write ((fmt), 2, (uint32_t) (a), (uint32_t) (b), 0, 0)
+
+/** \brief Logs a message with three 32-bit arguments. */
+#define BINLOG3(fmt, a, b, c) \
+	binlog_write ((fmt), 3, (uint32_t) (a), (uint32_t) (b), (uint32_t) (c), 0)
+
+/** \brief Logs a message with four 32-bit arguments. */
+#define BINLOG4(fmt, a, b, c, d) \
+	binlog_write ((fmt), 4, (uint32_t) (a), (uint32_t) (b), (uint32_t) (c), \
+		(uint32_t) (d))
+
+/** \brief Empties the log buffer and starts the cycle counter used for time stamps,
+ *  which count from here on.
+ */
+void binlog_init(void);
+
+/** \brief Stores one log record; use the BINLOGn() macros rather than calling this
+ *  directly. Safe to call from tasks and interrupt handlers.
+ *  @param fmt The printf()-style format string, which must live in flash
+ *  @param nargs How many of the arguments that follow are used (0 to 4)
+ */
+void binlog_write(const char *fmt, uint32_t nargs, uint32_t a0, uint32_t a1,
+		uint32_t a2, uint32_t a3);
+
+/** \brief Sends as many whole records to the console as it has room for.
+ *  @return The number of records sent
+ */
+uint32_t binlog_drain(void);
+
+/** \brief Returns the number of records dropped because the buffer was full.
+ */
+uint32_t binlog_get_dropped(void);
+
+/** \brief Creates a task which calls binlog_drain() every BINLOG_DRAIN_PERIOD_MS.
+ *  \details This is only built into projects that use FreeRTOS; others should call
+ *  binlog_drain() from their main loop instead.
+ *  @param priority The task's priority; usually just above the idle task
+ *  @return pdPASS if the task was created
+ */
+long binlog_start_task(unsigned long priority);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _BINLOG_H_
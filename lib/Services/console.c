@@ -0,0 +1,346 @@
+//*************************************************************************************
+/** \file console.c
+ *    This file contains the interrupt-driven console. Writers copy their bytes into
+ *    \c tx_ring under a short critical section; the oldest bytes are then copied,
+ *    up to CONSOLE_DMA_CHUNK at a time, into \c tx_stage and handed to the UART's
+ *    PDC channel. When the PDC has passed the last byte of a chunk to the UART, the
+ *    ENDTX interrupt starts the next one, or turns itself off if the ring is empty.
+ *
+ *    Sending from a separate staging buffer costs a small copy, but it means the
+ *    ring never has bytes in flight, so the overwrite policy can always throw away
+ *    the oldest queued bytes by simply moving the tail.
+ *
+ *    A blocking write that finds the ring full sleeps on \c tx_room_sem, which the
+ *    ENDTX interrupt gives when a writer is waiting, once the scheduler is running;
+ *    before then, or without FreeRTOS, it spins until the interrupt makes room.
+ */
+//*************************************************************************************
+
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <compiler.h>
+#include <interrupt.h>
+#include <pdc.h>
+#include <uart.h>
+#include <stdio_serial.h>
+#include <conf_uart_serial.h>
+#include <conf_console.h>
+#include "console.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#endif
+
+/// Mask used to turn the free-running ring indices into array indices
+#define CONSOLE_TX_MASK  (CONSOLE_TX_BUFFER_SIZE - 1)
+
+// The ring indices only wrap correctly if the buffer size is a power of two
+typedef char console_tx_size_must_be_power_of_two
+	[((CONSOLE_TX_BUFFER_SIZE & CONSOLE_TX_MASK) == 0) ? 1 : -1];
+
+int _write(int file, const char *ptr, int len);
+
+static uint8_t tx_ring[CONSOLE_TX_BUFFER_SIZE];  ///< Bytes waiting for the PDC
+static uint8_t tx_stage[CONSOLE_DMA_CHUNK];      ///< Bytes the PDC is sending now
+
+/** Index one past the newest byte in \c tx_ring. Written only by console_write(),
+ *  and only with interrupts masked; it runs freely and is masked on use. */
+static volatile uint32_t tx_head = 0;
+
+/** Index of the oldest byte in \c tx_ring. Advanced by start_chunk() and, under the
+ *  overwrite policy, by console_write(). */
+static volatile uint32_t tx_tail = 0;
+
+/// True while the PDC is sending the contents of \c tx_stage
+static volatile bool tx_busy = false;
+
+/// Number of bytes thrown away because the ring was full
+static volatile uint32_t tx_dropped = 0;
+
+/// What console_write() does when the ring is full
+static volatile enum console_full_policy tx_policy = CONSOLE_FULL_POLICY_DEFAULT;
+
+/// The console UART's PDC registers, or NULL until console_init() has run
+static Pdc *tx_pdc = NULL;
+
+#ifdef _USE_FREERTOS_
+/// Given by the ENDTX interrupt when it has made room and a writer is waiting
+static SemaphoreHandle_t tx_room_sem = NULL;
+
+/// Number of writers asleep on \c tx_room_sem; changed with interrupts masked
+static volatile uint32_t tx_waiters = 0;
+#endif
+
+/** \brief Moves the next chunk from the ring to the PDC, or goes idle if the ring is
+ *  empty. Must be called from the UART interrupt or with interrupts masked.
+ */
+static void start_chunk(void)
+{
+	pdc_packet_t packet;
+	uint32_t count = tx_head - tx_tail;
+	uint32_t first;
+	uint32_t start;
+
+	if (count == 0)
+	{
+		tx_busy = false;
+		uart_disable_interrupt(CONF_UART, UART_IDR_ENDTX);
+		return;
+	}
+	if (count > CONSOLE_DMA_CHUNK)
+	{
+		count = CONSOLE_DMA_CHUNK;
+	}
+
+	// Copy out of the ring in at most two pieces, in case the chunk wraps
+	start = tx_tail & CONSOLE_TX_MASK;
+	first = CONSOLE_TX_BUFFER_SIZE - start;
+	if (first > count)
+	{
+		first = count;
+	}
+	memcpy(tx_stage, &tx_ring[start], first);
+	memcpy(&tx_stage[first], tx_ring, count - first);
+	tx_tail += count;
+
+	packet.ul_addr = (uintptr_t) tx_stage;
+	packet.ul_size = count;
+	pdc_tx_init(tx_pdc, &packet, NULL);
+
+	tx_busy = true;
+	uart_enable_interrupt(CONF_UART, UART_IER_ENDTX);
+}
+
+/** \brief Returns true if the caller may wait for the UART interrupt to free
+ *  space in the ring: it must not be an interrupt handler, and neither PRIMASK nor
+ *  BASEPRI (which FreeRTOS critical sections use) may be masking the UART interrupt.
+ */
+static bool console_can_wait(void)
+{
+	uint32_t basepri;
+
+	if ((__get_IPSR() != 0) || (__get_PRIMASK() != 0))
+	{
+		return false;
+	}
+	basepri = __get_BASEPRI();
+	if ((basepri != 0)
+		&& (basepri <= (CONSOLE_IRQ_PRIORITY << (8 - __NVIC_PRIO_BITS))))
+	{
+		return false;
+	}
+	return true;
+}
+
+/** \brief Waits until the ENDTX interrupt has taken bytes out of a full ring. A task
+ *  sleeps, so that tasks of its priority and lower can run meanwhile; anything else
+ *  spins. Only called when console_can_wait() allows it.
+ */
+static void console_wait_for_room(void)
+{
+#ifdef _USE_FREERTOS_
+	if ((tx_room_sem != NULL) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+	{
+		irqflags_t flags = cpu_irq_save();
+		bool full = (tx_head - tx_tail == CONSOLE_TX_BUFFER_SIZE);
+
+		// Counted with interrupts masked, so a give can't slip in before it
+		if (full)
+		{
+			tx_waiters++;
+		}
+		cpu_irq_restore(flags);
+		if (full)
+		{
+			xSemaphoreTake(tx_room_sem, portMAX_DELAY);
+			flags = cpu_irq_save();
+			tx_waiters--;
+			cpu_irq_restore(flags);
+		}
+		return;
+	}
+#endif
+	while (tx_head - tx_tail == CONSOLE_TX_BUFFER_SIZE);
+}
+
+void console_init(const usart_serial_options_t *options)
+{
+	irqflags_t flags;
+
+	// Let ASF set up the UART itself and the stdio input hooks
+	stdio_serial_init(CONF_UART, options);
+
+	tx_pdc = uart_get_pdc_base(CONF_UART);
+	pdc_enable_transfer(tx_pdc, PERIPH_PTCR_TXTEN);
+
+	NVIC_DisableIRQ((IRQn_Type) CONSOLE_UART_ID);
+	NVIC_ClearPendingIRQ((IRQn_Type) CONSOLE_UART_ID);
+	NVIC_SetPriority((IRQn_Type) CONSOLE_UART_ID, CONSOLE_IRQ_PRIORITY);
+	NVIC_EnableIRQ((IRQn_Type) CONSOLE_UART_ID);
+
+#ifdef _USE_FREERTOS_
+	if (tx_room_sem == NULL)
+	{
+		tx_room_sem = xSemaphoreCreateBinary();
+	}
+#endif
+
+	// Send anything that was written before the UART was ready
+	flags = cpu_irq_save();
+	if (!tx_busy)
+	{
+		start_chunk();
+	}
+	cpu_irq_restore(flags);
+}
+
+size_t console_write(const char *data, size_t length)
+{
+	size_t queued = 0;
+	bool can_wait = (tx_policy == CONSOLE_FULL_BLOCK) && (tx_pdc != NULL)
+		&& console_can_wait();
+
+	// When overwriting, only the last buffer's worth of a long write can survive
+	if ((tx_policy == CONSOLE_FULL_OVERWRITE) && (length > CONSOLE_TX_BUFFER_SIZE))
+	{
+		size_t skip = length - CONSOLE_TX_BUFFER_SIZE;
+		irqflags_t flags = cpu_irq_save();
+		tx_dropped += skip;
+		cpu_irq_restore(flags);
+		data += skip;
+		length -= skip;
+	}
+
+	while (length > 0)
+	{
+		irqflags_t flags = cpu_irq_save();
+		uint32_t space = CONSOLE_TX_BUFFER_SIZE - (tx_head - tx_tail);
+		size_t count = length;
+		uint32_t start;
+		uint32_t first;
+
+		if (count > space)
+		{
+			if (tx_policy == CONSOLE_FULL_OVERWRITE)
+			{
+				tx_tail += count - space;
+				tx_dropped += count - space;
+			}
+			else
+			{
+				count = space;
+			}
+		}
+
+		start = tx_head & CONSOLE_TX_MASK;
+		first = CONSOLE_TX_BUFFER_SIZE - start;
+		if (first > count)
+		{
+			first = count;
+		}
+		memcpy(&tx_ring[start], data, first);
+		memcpy(tx_ring, data + first, count - first);
+		tx_head += count;
+
+		data += count;
+		length -= count;
+		queued += count;
+
+		if ((length > 0) && !can_wait)
+		{
+			tx_dropped += length;
+			length = 0;
+		}
+		if (!tx_busy && (tx_pdc != NULL))
+		{
+			start_chunk();
+		}
+		cpu_irq_restore(flags);
+
+		// Blocking: let the ENDTX interrupt free up at least one chunk's worth
+		if (length > 0)
+		{
+			console_wait_for_room();
+		}
+	}
+	return queued;
+}
+
+void console_set_policy(enum console_full_policy policy)
+{
+	tx_policy = policy;
+}
+
+uint32_t console_get_dropped(void)
+{
+	return tx_dropped;
+}
+
+size_t console_get_pending(void)
+{
+	irqflags_t flags = cpu_irq_save();
+	size_t pending = tx_head - tx_tail;
+
+	if (tx_busy)
+	{
+		pending += pdc_read_tx_counter(tx_pdc);
+	}
+	cpu_irq_restore(flags);
+	return pending;
+}
+
+size_t console_get_free(void)
+{
+	return CONSOLE_TX_BUFFER_SIZE - (tx_head - tx_tail);
+}
+
+void console_flush(void)
+{
+	while (tx_busy || (tx_head != tx_tail));
+	while (!(uart_get_status(CONF_UART) & UART_SR_TXEMPTY));
+}
+
+/** \brief Newlib's output hook, which printf(), puts() and the rest end up in. This
+ *  overrides the weak, byte-at-a-time version in ASF's stdio support.
+ *  @param file The file descriptor; only stdout and stderr go to the console
+ *  @param ptr The bytes to write
+ *  @param len The number of bytes to write
+ *  @return \c len, since bytes dropped for lack of room are counted rather than
+ *          reported as an error, or -1 with \c errno set to EBADF for any other file
+ */
+int _write(int file, const char *ptr, int len)
+{
+	if ((file != 1) && (file != 2))
+	{
+		errno = EBADF;
+		return -1;
+	}
+	console_write(ptr, (size_t) len);
+	return len;
+}
+
+/** \brief The console UART interrupt, which only has ENDTX enabled while a chunk is
+ *  being sent.
+ */
+void CONSOLE_UART_Handler(void)
+{
+	uint32_t status = uart_get_status(CONF_UART) & uart_get_interrupt_mask(CONF_UART);
+
+	if ((status & UART_SR_ENDTX) && tx_busy)
+	{
+		start_chunk();
+
+#ifdef _USE_FREERTOS_
+		if (tx_waiters > 0)
+		{
+			BaseType_t woken = pdFALSE;
+
+			xSemaphoreGiveFromISR(tx_room_sem, &woken);
+			portEND_SWITCHING_ISR(woken);
+		}
+#endif
+	}
+}
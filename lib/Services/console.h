@@ -0,0 +1,88 @@
+//*************************************************************************************
+/** \file console.h
+ *    This file contains an interrupt-driven console for the UART. Output is copied
+ *    into a RAM ring buffer and returned from immediately; the ring is drained in
+ *    the background by the UART's PDC channel, one chunk per ENDTX interrupt. Once
+ *    console_init() has run, printf(), puts() and friends go through here as well,
+ *    because this service provides the newlib _write() hook.
+ *
+ *    What happens when the ring is full is set by a policy:
+ *    \li CONSOLE_FULL_DROP discards whatever doesn't fit (the default).
+ *    \li CONSOLE_FULL_BLOCK waits for room, asleep if the caller is a task. Callers
+ *        that can't wait (interrupt handlers and code running with the UART
+ *        interrupt masked) drop instead.
+ *    \li CONSOLE_FULL_OVERWRITE discards the oldest queued bytes to make room.
+ *    Every byte thrown away by any policy is counted; see console_get_dropped().
+ *
+ *    Sizes and the default policy are set in lib/ASF_Config/conf_console.h. To use
+ *    the console in a project, add it to SERVICES in the project Makefile.
+ */
+//*************************************************************************************
+
+#ifndef _CONSOLE_H_
+#define _CONSOLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <serial.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief What console_write() does with bytes that don't fit in the TX ring.
+ */
+enum console_full_policy
+{
+	CONSOLE_FULL_DROP,                 ///< Discard the new bytes that don't fit
+	CONSOLE_FULL_BLOCK,                ///< Wait until the UART makes room
+	CONSOLE_FULL_OVERWRITE             ///< Discard the oldest queued bytes instead
+};
+
+/** \brief Sets up the console UART, its PDC channel and its interrupt.
+ *  \details This replaces stdio_serial_init(); input through scanf() and getchar()
+ *  keeps working exactly as before. The UART's peripheral clock must already be on.
+ *  @param options The baud rate and framing to use on CONF_UART
+ */
+void console_init(const usart_serial_options_t *options);
+
+/** \brief Queues bytes for transmission and returns without waiting for them.
+ *  \details This may be called from tasks and interrupt handlers alike.
+ *  @param data The bytes to send
+ *  @param length The number of bytes to send
+ *  @return The number of bytes queued, which is less than \c length only if some
+ *          were dropped under CONSOLE_FULL_DROP (or a blocking write couldn't wait)
+ */
+size_t console_write(const char *data, size_t length);
+
+/** \brief Changes what console_write() does when the TX ring is full.
+ *  @param policy The new policy
+ */
+void console_set_policy(enum console_full_policy policy);
+
+/** \brief Returns the number of bytes thrown away since console_init(), whichever
+ *  policy discarded them.
+ */
+uint32_t console_get_dropped(void);
+
+/** \brief Returns the number of bytes queued or in flight that haven't reached the
+ *  UART yet.
+ */
+size_t console_get_pending(void);
+
+/** \brief Returns the number of bytes console_write() can take right now without
+ *  hitting the full-buffer policy.
+ */
+size_t console_get_free(void);
+
+/** \brief Waits until everything queued has left the UART.
+ *  \details Use this before resetting, sleeping or reconfiguring the UART. It must
+ *  not be called with the UART interrupt masked.
+ */
+void console_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _CONSOLE_H_
@@ -0,0 +1,59 @@
+//*************************************************************************************
+/** \file cycle_counter.h
+ *    This file contains helpers for timing code with the Cortex-M3 DWT cycle counter.
+ *    The counter ticks once per CPU clock, so at the Due's 84 MHz it wraps about
+ *    every 51 seconds; differences between two readings are correct across a single
+ *    wrap as long as they are taken with unsigned 32-bit arithmetic.
+ *
+ *    The functions are static inline so that they can be used from C and C++ alike,
+ *    including from interrupt handlers.
+ */
+//*************************************************************************************
+
+#ifndef _CYCLE_COUNTER_H_
+#define _CYCLE_COUNTER_H_
+
+#include <compiler.h>
+
+/** \brief Starts the DWT cycle counter if it isn't already running.
+ *  \details The count is never reset, since the run time statistics, systime and
+ *  anything else timing with the counter may already be using it. Time things by
+ *  taking a reading when they start and subtracting it afterwards; see
+ *  cycle_counter_since(). It's harmless to call this any number of times.
+ */
+static inline void cycle_counter_enable(void)
+{
+	if (!(CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk))
+	{
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	}
+	if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+	{
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+}
+
+/** \brief Returns the current value of the DWT cycle counter.
+ */
+static inline uint32_t cycle_counter_get(void)
+{
+	return DWT->CYCCNT;
+}
+
+/** \brief Returns the number of cycles since an earlier reading.
+ *  @param start A value returned by cycle_counter_get()
+ */
+static inline uint32_t cycle_counter_since(uint32_t start)
+{
+	return (uint32_t) (DWT->CYCCNT - start);
+}
+
+/** \brief Converts a number of CPU cycles into microseconds.
+ *  @param cycles A cycle count, usually the difference between two readings
+ */
+static inline uint32_t cycles_to_us(uint32_t cycles)
+{
+	return cycles / (SystemCoreClock / 1000000UL);
+}
+
+#endif // _CYCLE_COUNTER_H_
@@ -0,0 +1,516 @@
+//*************************************************************************************
+/** \file dsp_pipeline.c
+ *    This file contains the signal processing stages and pipeline. Each stage's run
+ *    function calls CMSIS-DSP with the same buffer as source and destination.
+ *    That works for the functions used here, as each one reads its input samples
+ *    (into its state buffer, for the filters) before it writes the outputs that
+ *    take their place, and never writes an output ahead of the input it has read.
+ */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <compiler.h>
+#include <conf_dsp_pipeline.h>
+#include "cycle_counter.h"
+#include "dsp_pipeline.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#endif
+
+/// Largest block, filter lengths and decimation factor used by dsp_print_benchmark()
+#define BENCH_BLOCK_MAX        256
+#define BENCH_TAPS             32
+#define BENCH_BIQUADS          2
+#define BENCH_FACTOR           4
+
+//------------------------------------------------------------------------------
+/** \brief Clears a stage and gives it its run function and name.
+ */
+static void dsp_stage_setup(dsp_stage_t *stage, dsp_stage_run_t run, const char *name,
+		uint32_t block_max)
+{
+	memset(stage, 0, sizeof(*stage));
+	stage->run = run;
+	stage->name = name;
+	stage->block_max = block_max;
+}
+
+static uint32_t dsp_fir_q15_run(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	q15_t *block = (q15_t *) samples;
+	uint32_t done;
+
+	for (done = 0; done < count; done += stage->block_max)
+	{
+		uint32_t length = min(count - done, stage->block_max);
+
+		arm_fir_q15(&stage->dsp.fir_q15, block + done, block + done, length);
+	}
+	return count;
+}
+
+static uint32_t dsp_fir_q31_run(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	q31_t *block = (q31_t *) samples;
+	uint32_t done;
+
+	for (done = 0; done < count; done += stage->block_max)
+	{
+		uint32_t length = min(count - done, stage->block_max);
+
+		arm_fir_q31(&stage->dsp.fir_q31, block + done, block + done, length);
+	}
+	return count;
+}
+
+static uint32_t dsp_iir_q15_run(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	arm_biquad_cascade_df1_q15(&stage->dsp.iir_q15, (q15_t *) samples,
+			(q15_t *) samples, count);
+	return count;
+}
+
+static uint32_t dsp_iir_q31_run(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	arm_biquad_cascade_df1_q31(&stage->dsp.iir_q31, (q31_t *) samples,
+			(q31_t *) samples, count);
+	return count;
+}
+
+static uint32_t dsp_decimate_q15_run(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	q15_t *block = (q15_t *) samples;
+	uint32_t factor = stage->dsp.decimate_q15.M;
+	uint32_t done;
+
+	// Outputs go in front of the inputs they came from, so later chunks can't be
+	// overwritten before they are read
+	count -= count % factor;
+	for (done = 0; done < count; done += stage->block_max)
+	{
+		uint32_t length = min(count - done, stage->block_max);
+
+		arm_fir_decimate_q15(&stage->dsp.decimate_q15, block + done,
+				block + done / factor, length);
+	}
+	return count / factor;
+}
+
+static uint32_t dsp_decimate_q31_run(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	q31_t *block = (q31_t *) samples;
+	uint32_t factor = stage->dsp.decimate_q31.M;
+	uint32_t done;
+
+	count -= count % factor;
+	for (done = 0; done < count; done += stage->block_max)
+	{
+		uint32_t length = min(count - done, stage->block_max);
+
+		arm_fir_decimate_q31(&stage->dsp.decimate_q31, block + done,
+				block + done / factor, length);
+	}
+	return count / factor;
+}
+
+static uint32_t dsp_rms_q15_run(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	q15_t rms;
+
+	arm_rms_q15((q15_t *) samples, count, &rms);
+	stage->result = rms;
+	return count;
+}
+
+static uint32_t dsp_rms_q31_run(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	arm_rms_q31((q31_t *) samples, count, &stage->result);
+	return count;
+}
+
+static uint32_t dsp_fft_mag_q15_run(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	q15_t *block = (q15_t *) samples;
+	q15_t *work = (q15_t *) stage->work;
+	uint32_t length = stage->dsp.fft_q15.fftLen;
+	uint32_t i;
+
+	// Real samples in, as complex ones with no imaginary part
+	for (i = 0; i < length; i++)
+	{
+		work[2 * i] = (i < count) ? block[i] : 0;
+		work[2 * i + 1] = 0;
+	}
+	arm_cfft_radix4_q15(&stage->dsp.fft_q15, work);
+
+	length = min(count, length / 2);
+	arm_cmplx_mag_q15(work, block, length);
+	return length;
+}
+
+static uint32_t dsp_fft_mag_q31_run(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	q31_t *block = (q31_t *) samples;
+	q31_t *work = (q31_t *) stage->work;
+	uint32_t length = stage->dsp.fft_q31.fftLen;
+	uint32_t i;
+
+	for (i = 0; i < length; i++)
+	{
+		work[2 * i] = (i < count) ? block[i] : 0;
+		work[2 * i + 1] = 0;
+	}
+	arm_cfft_radix4_q31(&stage->dsp.fft_q31, work);
+
+	length = min(count, length / 2);
+	arm_cmplx_mag_q31(work, block, length);
+	return length;
+}
+
+//------------------------------------------------------------------------------
+bool dsp_fir_q15_init(dsp_stage_t *stage, const q15_t *coeffs, uint16_t taps,
+		q15_t *state, uint32_t block_max)
+{
+	dsp_stage_setup(stage, dsp_fir_q15_run, "FIR q15", block_max);
+	return arm_fir_init_q15(&stage->dsp.fir_q15, taps, (q15_t *) coeffs, state,
+			block_max) == ARM_MATH_SUCCESS;
+}
+
+bool dsp_fir_q31_init(dsp_stage_t *stage, const q31_t *coeffs, uint16_t taps,
+		q31_t *state, uint32_t block_max)
+{
+	dsp_stage_setup(stage, dsp_fir_q31_run, "FIR q31", block_max);
+	arm_fir_init_q31(&stage->dsp.fir_q31, taps, (q31_t *) coeffs, state, block_max);
+	return taps > 0;
+}
+
+bool dsp_iir_q15_init(dsp_stage_t *stage, const q15_t *coeffs, uint8_t biquads,
+		q15_t *state, int8_t post_shift)
+{
+	dsp_stage_setup(stage, dsp_iir_q15_run, "IIR q15", 0);
+	arm_biquad_cascade_df1_init_q15(&stage->dsp.iir_q15, biquads, (q15_t *) coeffs,
+			state, post_shift);
+	return biquads > 0;
+}
+
+bool dsp_iir_q31_init(dsp_stage_t *stage, const q31_t *coeffs, uint8_t biquads,
+		q31_t *state, int8_t post_shift)
+{
+	dsp_stage_setup(stage, dsp_iir_q31_run, "IIR q31", 0);
+	arm_biquad_cascade_df1_init_q31(&stage->dsp.iir_q31, biquads, (q31_t *) coeffs,
+			state, post_shift);
+	return biquads > 0;
+}
+
+bool dsp_decimate_q15_init(dsp_stage_t *stage, const q15_t *coeffs, uint16_t taps,
+		uint8_t factor, q15_t *state, uint32_t block_max)
+{
+	dsp_stage_setup(stage, dsp_decimate_q15_run, "Decimate q15", block_max);
+	return arm_fir_decimate_init_q15(&stage->dsp.decimate_q15, taps, factor,
+			(q15_t *) coeffs, state, block_max) == ARM_MATH_SUCCESS;
+}
+
+bool dsp_decimate_q31_init(dsp_stage_t *stage, const q31_t *coeffs, uint16_t taps,
+		uint8_t factor, q31_t *state, uint32_t block_max)
+{
+	dsp_stage_setup(stage, dsp_decimate_q31_run, "Decimate q31", block_max);
+	return arm_fir_decimate_init_q31(&stage->dsp.decimate_q31, taps, factor,
+			(q31_t *) coeffs, state, block_max) == ARM_MATH_SUCCESS;
+}
+
+void dsp_rms_q15_init(dsp_stage_t *stage)
+{
+	dsp_stage_setup(stage, dsp_rms_q15_run, "RMS q15", 0);
+}
+
+void dsp_rms_q31_init(dsp_stage_t *stage)
+{
+	dsp_stage_setup(stage, dsp_rms_q31_run, "RMS q31", 0);
+}
+
+q31_t dsp_rms_get(const dsp_stage_t *stage)
+{
+	return stage->result;
+}
+
+bool dsp_fft_mag_q15_init(dsp_stage_t *stage, uint16_t fft_len, q15_t *work)
+{
+	dsp_stage_setup(stage, dsp_fft_mag_q15_run, "FFT mag q15", 0);
+	stage->work = work;
+	return arm_cfft_radix4_init_q15(&stage->dsp.fft_q15, fft_len, 0, 1)
+			== ARM_MATH_SUCCESS;
+}
+
+bool dsp_fft_mag_q31_init(dsp_stage_t *stage, uint16_t fft_len, q31_t *work)
+{
+	dsp_stage_setup(stage, dsp_fft_mag_q31_run, "FFT mag q31", 0);
+	stage->work = work;
+	return arm_cfft_radix4_init_q31(&stage->dsp.fft_q31, fft_len, 0, 1)
+			== ARM_MATH_SUCCESS;
+}
+
+uint32_t dsp_adc_to_q15(const uint16_t *adc, uint32_t count, uint32_t channels,
+		uint32_t channel, q15_t *out)
+{
+	uint32_t written = 0;
+	uint32_t i;
+
+	// The 12-bit result, less mid-scale, moved up to the top of 16 bits
+	for (i = channel; i < count; i += channels)
+	{
+		out[written++] = (q15_t) (((int32_t) (adc[i] & 0x0FFF) - 2048) << 4);
+	}
+	return written;
+}
+
+uint32_t dsp_adc_to_q31(const uint16_t *adc, uint32_t count, uint32_t channels,
+		uint32_t channel, q31_t *out)
+{
+	uint32_t written = 0;
+	uint32_t i;
+
+	for (i = channel; i < count; i += channels)
+	{
+		out[written++] = ((int32_t) (adc[i] & 0x0FFF) - 2048) << 20;
+	}
+	return written;
+}
+
+//------------------------------------------------------------------------------
+void dsp_pipeline_init(dsp_pipeline_t *pipe, const char *name)
+{
+	memset(pipe, 0, sizeof(*pipe));
+	pipe->name = name;
+
+	// Each stage is timed on the cycle counter
+	cycle_counter_enable();
+}
+
+void dsp_pipeline_add(dsp_pipeline_t *pipe, dsp_stage_t *stage)
+{
+	stage->next = NULL;
+	if (pipe->last == NULL)
+	{
+		pipe->first = stage;
+	}
+	else
+	{
+		pipe->last->next = stage;
+	}
+	pipe->last = stage;
+}
+
+uint32_t dsp_pipeline_run(dsp_pipeline_t *pipe, void *samples, uint32_t count)
+{
+	dsp_stage_t *stage;
+
+	for (stage = pipe->first; (stage != NULL) && (count != 0); stage = stage->next)
+	{
+		uint32_t start = DWT->CYCCNT;
+		uint32_t taken;
+
+		stage->samples += count;
+		count = stage->run(stage, samples, count);
+		taken = DWT->CYCCNT - start;
+
+		stage->blocks++;
+		stage->cycles += taken;
+		if (taken > stage->worst_cycles)
+		{
+			stage->worst_cycles = taken;
+		}
+	}
+	return count;
+}
+
+void dsp_pipeline_print_report(const dsp_pipeline_t *pipe)
+{
+	const dsp_stage_t *stage;
+
+	printf("\r\nPipeline %s\r\nStage            Blocks   Avg cycles  Worst  Per sample\r\n",
+			pipe->name);
+	for (stage = pipe->first; stage != NULL; stage = stage->next)
+	{
+		uint32_t average = (stage->blocks == 0) ? 0
+				: (uint32_t) (stage->cycles / stage->blocks);
+		uint32_t per_sample = (stage->samples == 0) ? 0
+				: (uint32_t) (stage->cycles / stage->samples);
+
+		printf("%-14s %8lu %12lu %6lu %11lu\r\n", stage->name,
+				(unsigned long) stage->blocks, (unsigned long) average,
+				(unsigned long) stage->worst_cycles, (unsigned long) per_sample);
+	}
+}
+
+/** \brief Runs a stage on a block three times and returns the fastest time, in
+ *  cycles.
+ */
+static uint32_t dsp_bench_stage(dsp_stage_t *stage, void *samples, uint32_t count)
+{
+	uint32_t best = 0;
+	uint32_t run;
+
+	for (run = 0; run < 3; run++)
+	{
+		uint32_t start = DWT->CYCCNT;
+		uint32_t taken;
+
+		stage->run(stage, samples, count);
+		taken = DWT->CYCCNT - start;
+		if ((run == 0) || (taken < best))
+		{
+			best = taken;
+		}
+	}
+	return best;
+}
+
+void dsp_print_benchmark(void)
+{
+	static const uint32_t lengths[] = { 32, 64, 128, 256 };
+	static union
+	{
+		q15_t q15[BENCH_BLOCK_MAX];
+		q31_t q31[BENCH_BLOCK_MAX];
+	} block;
+	static union
+	{
+		q15_t q15[2 * BENCH_BLOCK_MAX];
+		q31_t q31[2 * BENCH_BLOCK_MAX];
+	} state;
+	static q31_t coeffs[BENCH_TAPS];
+	dsp_stage_t stage;
+	uint32_t kind;
+	uint32_t i;
+
+	cycle_counter_enable();
+
+	// Small coefficients, so that nothing saturates; the times don't depend on them
+	for (i = 0; i < BENCH_TAPS; i++)
+	{
+		coeffs[i] = 0x00400040;
+	}
+
+	printf("\r\nStage (cycles per block)   %6lu %6lu %6lu %6lu\r\n",
+			(unsigned long) lengths[0], (unsigned long) lengths[1],
+			(unsigned long) lengths[2], (unsigned long) lengths[3]);
+	for (kind = 0; kind < 10; kind++)
+	{
+		const char *name = NULL;
+
+		for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+		{
+			uint32_t length = lengths[i];
+			uint32_t j;
+			bool ready;
+
+			// A slow sine-ish triangle, well inside full scale
+			for (j = 0; j < length; j++)
+			{
+				int32_t wave = (int32_t) ((j * 1024) & 0x7FFF) - 0x4000;
+
+				block.q31[j] = wave << 16;
+			}
+			for (j = 0; j < length; j++)
+			{
+				block.q15[j] = (q15_t) ((int32_t) ((j * 1024) & 0x7FFF) - 0x4000);
+			}
+			memset(&state, 0, sizeof(state));
+
+			switch (kind)
+			{
+			case 0:
+				ready = dsp_fir_q15_init(&stage, (q15_t *) coeffs, BENCH_TAPS,
+						state.q15, length);
+				break;
+			case 1:
+				ready = dsp_fir_q31_init(&stage, coeffs, BENCH_TAPS, state.q31, length);
+				break;
+			case 2:
+				ready = dsp_iir_q15_init(&stage, (q15_t *) coeffs, BENCH_BIQUADS,
+						state.q15, 1);
+				break;
+			case 3:
+				ready = dsp_iir_q31_init(&stage, coeffs, BENCH_BIQUADS, state.q31, 1);
+				break;
+			case 4:
+				ready = dsp_decimate_q15_init(&stage, (q15_t *) coeffs, BENCH_TAPS,
+						BENCH_FACTOR, state.q15, length);
+				break;
+			case 5:
+				ready = dsp_decimate_q31_init(&stage, coeffs, BENCH_TAPS, BENCH_FACTOR,
+						state.q31, length);
+				break;
+			case 6:
+				dsp_rms_q15_init(&stage);
+				ready = true;
+				break;
+			case 7:
+				dsp_rms_q31_init(&stage);
+				ready = true;
+				break;
+			case 8:
+				ready = dsp_fft_mag_q15_init(&stage, (uint16_t) length, state.q15);
+				break;
+			default:
+				ready = dsp_fft_mag_q31_init(&stage, (uint16_t) length, state.q31);
+				break;
+			}
+
+			if (name == NULL)
+			{
+				name = stage.name;
+				printf("%-26s", name);
+			}
+			if (ready)
+			{
+				printf(" %6lu", (unsigned long) dsp_bench_stage(&stage,
+						(kind & 1) ? (void *) block.q31 : (void *) block.q15, length));
+			}
+			else
+			{
+				// Only 16, 64, 256 and 1024 point FFTs are built in
+				printf("      -");
+			}
+		}
+		printf("\r\n");
+	}
+	printf("FIR and decimator %u taps, decimating by %u; IIR %u biquads\r\n",
+			BENCH_TAPS, BENCH_FACTOR, BENCH_BIQUADS);
+}
+
+#ifdef _USE_FREERTOS_
+/** \brief The task which runs a pipeline on each block it is sent.
+ *  @param params The pipeline
+ */
+static void dsp_pipeline_task(void *params)
+{
+	dsp_pipeline_t *pipe = (dsp_pipeline_t *) params;
+	dsp_block_t block;
+
+	for (;;)
+	{
+		if (xQueueReceive((QueueHandle_t) pipe->input, &block, portMAX_DELAY) == pdPASS)
+		{
+			block.count = dsp_pipeline_run(pipe, block.samples, block.count);
+			if (pipe->output != NULL)
+			{
+				xQueueSend((QueueHandle_t) pipe->output, &block, portMAX_DELAY);
+			}
+		}
+	}
+}
+
+long dsp_pipeline_start_task(dsp_pipeline_t *pipe, void *input, void *output,
+		unsigned long priority)
+{
+	pipe->input = input;
+	pipe->output = output;
+	return xTaskCreate(dsp_pipeline_task, pipe->name, DSP_PIPELINE_TASK_STACK_SIZE,
+			pipe, (UBaseType_t) priority, NULL);
+}
+#endif
@@ -0,0 +1,239 @@
+//*************************************************************************************
+/** \file dsp_pipeline.h
+ *    This file contains a library of fixed-point signal processing stages, built on
+ *    the CMSIS-DSP library which the Makefiles already link, and a pipeline that
+ *    runs a chain of them over each block of samples.
+ *
+ *    Every stage works in place: it reads a block from a buffer and writes its
+ *    result back into the same buffer, and may leave fewer samples than it was
+ *    given. The stages are:
+ *      - FIR filter (arm_fir_...)
+ *      - IIR filter, as a cascade of direct form I biquads (arm_biquad_cascade_df1_...)
+ *      - FIR decimator, which keeps one sample in M (arm_fir_decimate_...)
+ *      - RMS, which leaves the block alone and keeps the RMS of it (arm_rms_...)
+ *      - FFT magnitude, which replaces the block with the magnitudes of its first
+ *        half of the spectrum (arm_cfft_radix4_... and arm_cmplx_mag_...)
+ *    each in q15 and q31. All the stages in one pipeline must use the same format.
+ *    The caller gives each stage its coefficients and state buffers, sized as the
+ *    init functions say, so nothing is allocated.
+ *
+ *    A pipeline can be run on each block from the task which produced it, with
+ *    dsp_pipeline_run(), or in a task of its own that takes blocks from one queue
+ *    and passes them on to another. Pipelines in several tasks can be chained
+ *    that way. Each stage counts the cycles it takes, and
+ *    dsp_pipeline_print_report() prints them. dsp_print_benchmark() times every
+ *    kind of stage at several block sizes, to show what fits in the CPU budget.
+ *
+ *    To use the library, add dsp_pipeline to SERVICES in the project Makefile.
+ *    projects/ex12_frt_dsp_cpp runs a pipeline on a block at a time from the ADC.
+ */
+//*************************************************************************************
+
+#ifndef _DSP_PIPELINE_H_
+#define _DSP_PIPELINE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <compiler.h>
+
+#ifndef ARM_MATH_CM3
+#define ARM_MATH_CM3
+#endif
+#include <arm_math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dsp_stage;
+
+/** \brief Runs a stage on a block in place.
+ *  @param stage The stage
+ *  @param samples The block, as q15_t or q31_t
+ *  @param count Number of samples in the block
+ *  @return Number of samples left in the block
+ */
+typedef uint32_t (*dsp_stage_run_t)(struct dsp_stage *stage, void *samples,
+		uint32_t count);
+
+/** \brief One stage of a pipeline. Set it up with one of the init functions below.
+ */
+typedef struct dsp_stage
+{
+	struct dsp_stage *next;            ///< The next stage in the pipeline
+	dsp_stage_run_t run;               ///< The function that does the work
+	const char *name;                  ///< Name shown in reports
+	uint32_t block_max;                ///< Most samples run in one go
+	void *work;                        ///< FFT work buffer
+	q31_t result;                      ///< RMS of the last block
+	uint32_t blocks;                   ///< Blocks run
+	uint32_t samples;                  ///< Samples run
+	uint64_t cycles;                   ///< Cycles taken by all the blocks
+	uint32_t worst_cycles;             ///< Cycles taken by the slowest block
+	union
+	{
+		arm_fir_instance_q15 fir_q15;
+		arm_fir_instance_q31 fir_q31;
+		arm_biquad_casd_df1_inst_q15 iir_q15;
+		arm_biquad_casd_df1_inst_q31 iir_q31;
+		arm_fir_decimate_instance_q15 decimate_q15;
+		arm_fir_decimate_instance_q31 decimate_q31;
+		arm_cfft_radix4_instance_q15 fft_q15;
+		arm_cfft_radix4_instance_q31 fft_q31;
+	} dsp;                             ///< The CMSIS-DSP instance
+} dsp_stage_t;
+
+/** \brief A chain of stages, run in order.
+ */
+typedef struct dsp_pipeline
+{
+	dsp_stage_t *first;                ///< The first stage, or NULL
+	dsp_stage_t *last;                 ///< The last stage, or NULL
+	const char *name;                  ///< Name shown in reports and given to its task
+	void *input;                       ///< Queue of blocks the pipeline's task runs
+	void *output;                      ///< Queue the task passes blocks on to, or NULL
+} dsp_pipeline_t;
+
+/** \brief A block passed between pipeline tasks. Only the pointer is copied; the
+ *  samples stay where they are.
+ */
+typedef struct dsp_block
+{
+	void *samples;                     ///< The samples, as q15_t or q31_t
+	uint32_t count;                    ///< Number of samples
+} dsp_block_t;
+
+/** \brief Sets up a FIR filter stage.
+ *  @param stage The stage
+ *  @param coeffs The coefficients, in time-reversed order
+ *  @param taps Number of coefficients; for q15 it must be even and at least 4
+ *  @param state State buffer of \p taps + \p block_max samples
+ *  @param block_max Most samples to filter in one go; longer blocks are split
+ *  @return false if the settings can't be used
+ */
+bool dsp_fir_q15_init(dsp_stage_t *stage, const q15_t *coeffs, uint16_t taps,
+		q15_t *state, uint32_t block_max);
+bool dsp_fir_q31_init(dsp_stage_t *stage, const q31_t *coeffs, uint16_t taps,
+		q31_t *state, uint32_t block_max);
+
+/** \brief Sets up an IIR filter stage, as a cascade of biquads.
+ *  @param stage The stage
+ *  @param coeffs For each biquad {b0, 0, b1, b2, a1, a2} in q15, or
+ *         {b0, b1, b2, a1, a2} in q31, scaled down by 2 ^ \p post_shift. The a
+ *         coefficients have the opposite sign to the usual convention.
+ *  @param biquads Number of biquads
+ *  @param state State buffer of 4 * \p biquads samples
+ *  @param post_shift How far the coefficients were shifted down to fit
+ *  @return false if the settings can't be used
+ */
+bool dsp_iir_q15_init(dsp_stage_t *stage, const q15_t *coeffs, uint8_t biquads,
+		q15_t *state, int8_t post_shift);
+bool dsp_iir_q31_init(dsp_stage_t *stage, const q31_t *coeffs, uint8_t biquads,
+		q31_t *state, int8_t post_shift);
+
+/** \brief Sets up a decimator stage, which filters a block with a FIR low-pass
+ *  filter and keeps one sample in \p factor. A block's length is rounded down to
+ *  a multiple of \p factor.
+ *  @param stage The stage
+ *  @param coeffs The filter's coefficients, in time-reversed order
+ *  @param taps Number of coefficients
+ *  @param factor The decimation factor
+ *  @param state State buffer of \p taps + \p block_max - 1 samples
+ *  @param block_max Most samples to decimate in one go, a multiple of \p factor
+ *  @return false if the settings can't be used
+ */
+bool dsp_decimate_q15_init(dsp_stage_t *stage, const q15_t *coeffs, uint16_t taps,
+		uint8_t factor, q15_t *state, uint32_t block_max);
+bool dsp_decimate_q31_init(dsp_stage_t *stage, const q31_t *coeffs, uint16_t taps,
+		uint8_t factor, q31_t *state, uint32_t block_max);
+
+/** \brief Sets up an RMS stage, which passes blocks on unchanged and keeps the RMS
+ *  of the last one; see dsp_rms_get().
+ *  @param stage The stage
+ */
+void dsp_rms_q15_init(dsp_stage_t *stage);
+void dsp_rms_q31_init(dsp_stage_t *stage);
+
+/** \brief Returns the RMS of the last block an RMS stage was given, in the
+ *  stage's format.
+ *  @param stage The stage
+ */
+q31_t dsp_rms_get(const dsp_stage_t *stage);
+
+/** \brief Sets up an FFT magnitude stage. It takes the first \p fft_len samples of a
+ *  block (padding with zeros if there are fewer) and replaces them with the
+ *  magnitudes of the first \p fft_len / 2 frequency bins, as far as the block
+ *  has room. The results are scaled down by \p fft_len and are in 2.14 (q15) or
+ *  2.30 (q31) format.
+ *  @param stage The stage
+ *  @param fft_len 16, 64, 256 or 1024
+ *  @param work Work buffer of 2 * \p fft_len samples
+ *  @return false if the settings can't be used
+ */
+bool dsp_fft_mag_q15_init(dsp_stage_t *stage, uint16_t fft_len, q15_t *work);
+bool dsp_fft_mag_q31_init(dsp_stage_t *stage, uint16_t fft_len, q31_t *work);
+
+/** \brief Takes one channel out of a block from the ADC stream (see adc_stream.h),
+ *  as signed samples centred on mid-scale.
+ *  @param adc The ADC block, with the channels in turn
+ *  @param count Number of samples in \p adc
+ *  @param channels Number of channels in the block
+ *  @param channel Position of the wanted channel in the sequence
+ *  @param out Buffer of \p count / \p channels samples for the result
+ *  @return Number of samples written
+ */
+uint32_t dsp_adc_to_q15(const uint16_t *adc, uint32_t count, uint32_t channels,
+		uint32_t channel, q15_t *out);
+uint32_t dsp_adc_to_q31(const uint16_t *adc, uint32_t count, uint32_t channels,
+		uint32_t channel, q31_t *out);
+
+/** \brief Sets up an empty pipeline.
+ *  @param pipe The pipeline
+ *  @param name Name for reports and for the pipeline's task
+ */
+void dsp_pipeline_init(dsp_pipeline_t *pipe, const char *name);
+
+/** \brief Adds a stage to the end of a pipeline. A stage can only be in one
+ *  pipeline.
+ *  @param pipe The pipeline
+ *  @param stage The stage
+ */
+void dsp_pipeline_add(dsp_pipeline_t *pipe, dsp_stage_t *stage);
+
+/** \brief Runs each stage of a pipeline on a block in turn, in place.
+ *  @param pipe The pipeline
+ *  @param samples The block
+ *  @param count Number of samples in the block
+ *  @return Number of samples left in the block after the last stage
+ */
+uint32_t dsp_pipeline_run(dsp_pipeline_t *pipe, void *samples, uint32_t count);
+
+/** \brief Prints each stage's block count and the cycles it has taken.
+ *  @param pipe The pipeline
+ */
+void dsp_pipeline_print_report(const dsp_pipeline_t *pipe);
+
+/** \brief Times each kind of stage, in q15 and q31, on blocks of 32 to 256 samples
+ *  and prints the cycles per block.
+ *  \details Interrupts and other tasks add to the times, so call this before the
+ *  scheduler starts.
+ */
+void dsp_print_benchmark(void);
+
+/** \brief Creates a task which takes blocks (as dsp_block_t) from a queue, runs the
+ *  pipeline on each, and passes them on to another queue.
+ *  \details This is only built into projects that use FreeRTOS.
+ *  @param pipe The pipeline
+ *  @param input Queue of dsp_block_t to take blocks from
+ *  @param output Queue of dsp_block_t to pass finished blocks to, or NULL
+ *  @param priority The task's priority
+ *  @return pdPASS if the task was created
+ */
+long dsp_pipeline_start_task(dsp_pipeline_t *pipe, void *input, void *output,
+		unsigned long priority);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _DSP_PIPELINE_H_
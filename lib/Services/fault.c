@@ -0,0 +1,398 @@
+//*************************************************************************************
+/** \file fault.c
+ *    This file contains the crash dump service. Each fault handler is a few
+ *    instructions of assembly that work out which stack the processor pushed its
+ *    exception frame onto (bit 2 of EXC_RETURN in LR) and pass it to
+ *    fault_capture(), which does the rest in C on the main stack.
+ *
+ *    The dump lives in the .noinit section. The linker script has no rule for it,
+ *    so the linker places it in RAM as an orphan section of its own, outside the
+ *    ranges the startup code copies and clears; the section flags are spelled out
+ *    so that it takes no space in the flash image. RAM holds random values after a
+ *    power cycle, so a dump is only believed if its magic number and checksum
+ *    match.
+ *
+ *    In the host build there are no fault handlers, since a fault there is a
+ *    signal that a debugger or sanitizer reports better; the software-detected
+ *    errors still fill in a record, which is printed before the program aborts.
+ */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <compiler.h>
+#include <ioport.h>
+#include <board.h>
+#include <conf_fault.h>
+#if (FAULT_SAVE_TO_FLASH == 1)
+#include <flash_efc.h>
+#endif
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#include <task.h>
+#endif
+#include "pool.h"
+#include "fault.h"
+
+/// Places a variable in RAM that is left alone at reset (the '@' starts a comment
+/// in ARM assembly, hiding the flags GCC would otherwise append)
+#ifdef _HOST_BUILD_
+#define FAULT_NOINIT
+#else
+#define FAULT_NOINIT  __attribute__((section(".noinit,\"aw\",%nobits@")))
+#endif
+
+/// Start and end of the SAM3X8E's SRAM, as mapped by the linker script: SRAM0's
+/// mirror at 0x20070000 followed by SRAM1 at 0x20080000
+#define FAULT_RAM_START        0x20070000UL
+#define FAULT_RAM_END          0x20088000UL
+
+/// SRAM0 at its own address, which stacks can also point into
+#define FAULT_SRAM0_START      0x20000000UL
+#define FAULT_SRAM0_END        0x20010000UL
+
+void fault_capture(uint32_t *frame, uint32_t exc_return, uint32_t type);
+
+/// Start and end of the program code, from the linker script
+extern uint32_t _sfixed;
+extern uint32_t _efixed;
+
+/// The dump; see the file description for why it is in .noinit
+static struct fault_record fault_ram FAULT_NOINIT;
+
+/// Names for the bits of the configurable fault status register, lowest first
+static const char *const cfsr_names[32] =
+{
+	"IACCVIOL", "DACCVIOL", NULL, "MUNSTKERR", "MSTKERR", NULL, NULL, "MMARVALID",
+	"IBUSERR", "PRECISERR", "IMPRECISERR", "UNSTKERR", "STKERR", NULL, NULL,
+	"BFARVALID", "UNDEFINSTR", "INVSTATE", "INVPC", "NOCP", NULL, NULL, NULL, NULL,
+	"UNALIGNED", "DIVBYZERO", NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+/// Names for each enum fault_type
+static const char *const type_names[] =
+{
+	"none", "hard fault", "memory management fault", "bus fault", "usage fault",
+	"stack overflow", "malloc failed"
+};
+
+/** \brief Returns true if a word can be read at an address without faulting again.
+ */
+static bool fault_is_ram(uint32_t address)
+{
+	return ((address >= FAULT_RAM_START) && (address <= FAULT_RAM_END - 4))
+		|| ((address >= FAULT_SRAM0_START) && (address <= FAULT_SRAM0_END - 4));
+}
+
+/** \brief Returns the checksum of a record, which is the sum of all its other words.
+ */
+static uint32_t fault_checksum(const struct fault_record *record)
+{
+	const uint32_t *word = (const uint32_t*) record;
+	uint32_t sum = 0;
+	uint32_t i;
+
+	for (i = 0; i < offsetof(struct fault_record, checksum) / sizeof(uint32_t); i++)
+	{
+		sum += word[i];
+	}
+	return sum;
+}
+
+/** \brief Returns true if a record holds a dump rather than leftover bits.
+ */
+static bool fault_is_valid(const struct fault_record *record)
+{
+	return (record->magic == FAULT_MAGIC)
+		&& (record->checksum == fault_checksum(record));
+}
+
+/** \brief Fills in the backtrace by scanning up the stack for odd words that point
+ *  into the program code; Thumb return addresses have bit 0 set.
+ *  @param record The dump to fill in
+ *  @param sp Where to start looking
+ */
+static void fault_scan_stack(struct fault_record *record, uint32_t sp)
+{
+	uint32_t code_start = (uint32_t) (uintptr_t) &_sfixed;
+	uint32_t code_end = (uint32_t) (uintptr_t) &_efixed;
+	uint32_t i;
+
+	record->depth = 0;
+	for (i = 0; (i < FAULT_STACK_SCAN_WORDS) && (record->depth < FAULT_BACKTRACE_DEPTH);
+		i++, sp += 4)
+	{
+		uint32_t word;
+
+		if (!fault_is_ram(sp))
+		{
+			break;
+		}
+		word = *(const uint32_t*) (uintptr_t) sp;
+		if ((word & 1) && (word - 1 >= code_start) && (word - 1 < code_end))
+		{
+			record->backtrace[record->depth++] = word - 1;
+		}
+	}
+}
+
+#ifndef _HOST_BUILD_
+/** \brief Blinks LED0 \c count times, then pauses. Only busy-waits, since nothing
+ *  else can be trusted after a fault.
+ */
+static void fault_blink(uint32_t count)
+{
+	volatile uint32_t delay;
+	uint32_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		ioport_set_pin_level(LED0_GPIO, IOPORT_PIN_LEVEL_HIGH);
+		for (delay = SystemCoreClock / 40; delay; delay--);
+		ioport_set_pin_level(LED0_GPIO, IOPORT_PIN_LEVEL_LOW);
+		for (delay = SystemCoreClock / 40; delay; delay--);
+	}
+	for (delay = SystemCoreClock / 4; delay; delay--);
+}
+#endif
+
+/** \brief Finishes a dump: names the task, seals the record, copies it to flash if
+ *  configured, and then resets or blinks for ever. On the host it says what
+ *  happened and aborts.
+ */
+static void fault_finish(struct fault_record *record, const char *task)
+{
+#ifdef _USE_FREERTOS_
+	if ((task == NULL) && (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED))
+	{
+		task = pcTaskGetTaskName(NULL);
+	}
+#endif
+	memset(record->task, 0, sizeof(record->task));
+	if (task != NULL)
+	{
+		strncpy(record->task, task, sizeof(record->task) - 1);
+	}
+	record->magic = FAULT_MAGIC;
+	record->checksum = fault_checksum(record);
+
+#if (FAULT_SAVE_TO_FLASH == 1)
+	flash_unlock(FAULT_FLASH_ADDRESS, FAULT_FLASH_ADDRESS + IFLASH1_PAGE_SIZE - 1,
+		NULL, NULL);
+	flash_write(FAULT_FLASH_ADDRESS, record, sizeof(*record), 1);
+#endif
+
+#ifdef _HOST_BUILD_
+	printf("\r\n*** Crash: %s", (record->type < sizeof(type_names) / sizeof(type_names[0]))
+		? type_names[record->type] : "unknown");
+	if (record->task[0] != '\0')
+	{
+		printf(" in task \"%s\"", record->task);
+	}
+	printf("\r\n");
+	abort();
+#else
+	for (;;)
+	{
+#if (FAULT_RESET_AFTER_DUMP == 1)
+		NVIC_SystemReset();
+#endif
+		fault_blink(record->type);
+	}
+#endif
+}
+
+/** \brief Records a fault. Called from the handlers below with interrupts still
+ *  enabled at lower priorities, so it masks them first.
+ *  @param frame The exception frame the processor stacked: r0-r3, r12, lr, pc, xpsr
+ *  @param exc_return The handler's LR
+ *  @param type An enum fault_type
+ */
+void fault_capture(uint32_t *frame, uint32_t exc_return, uint32_t type)
+{
+	struct fault_record *record = &fault_ram;
+
+	__disable_irq();
+	memset(record, 0, sizeof(*record));
+	record->type = type;
+	record->exc_return = exc_return;
+	record->cfsr = SCB->CFSR;
+	record->hfsr = SCB->HFSR;
+	record->mmfar = SCB->MMFAR;
+	record->bfar = SCB->BFAR;
+	record->sp = (uint32_t) (uintptr_t) frame;
+
+	// A stacking error leaves the frame pointer pointing who knows where
+	if (fault_is_ram((uint32_t) (uintptr_t) frame)
+		&& fault_is_ram((uint32_t) (uintptr_t) &frame[7]))
+	{
+		record->r0 = frame[0];
+		record->r1 = frame[1];
+		record->r2 = frame[2];
+		record->r3 = frame[3];
+		record->r12 = frame[4];
+		record->lr = frame[5];
+		record->pc = frame[6];
+		record->xpsr = frame[7];
+
+		// Skip the frame, and the padding word if bit 9 of xPSR says there is one
+		record->sp += 8 * sizeof(uint32_t) + ((record->xpsr & (1UL << 9)) ? 4 : 0);
+		fault_scan_stack(record, record->sp);
+	}
+	fault_finish(record, NULL);
+}
+
+/** \brief Records an error detected in software rather than by the processor.
+ */
+static void fault_capture_event(uint32_t type, const char *task)
+{
+	struct fault_record *record = &fault_ram;
+	uint32_t sp;
+
+	__disable_irq();
+	memset(record, 0, sizeof(*record));
+	record->type = type;
+#ifdef _HOST_BUILD_
+	// The host's stack isn't in the board's RAM, so there is nothing to scan
+	sp = 0;
+#else
+	__asm volatile ("mov %0, sp" : "=r" (sp));
+#endif
+	record->sp = sp;
+	record->lr = (uint32_t) (uintptr_t) __builtin_return_address(0);
+	fault_scan_stack(record, sp);
+	fault_finish(record, task);
+}
+
+//-------------------------------------------------------------------------------------
+#ifndef _HOST_BUILD_
+/// Defines a fault handler which passes the stacked frame to fault_capture()
+#define FAULT_HANDLER(name, type)                                                      \
+	__attribute__((naked)) void name(void)                                             \
+	{                                                                                  \
+		__asm volatile (                                                               \
+			"tst lr, #4        \n"                                                     \
+			"ite eq            \n"                                                     \
+			"mrseq r0, msp     \n"                                                     \
+			"mrsne r0, psp     \n"                                                     \
+			"mov r1, lr        \n"                                                     \
+			"mov r2, %0        \n"                                                     \
+			"b fault_capture   \n"                                                     \
+			: : "i" (type));                                                           \
+	}
+
+FAULT_HANDLER(HardFault_Handler, FAULT_HARD)
+FAULT_HANDLER(MemManage_Handler, FAULT_MEM_MANAGE)
+FAULT_HANDLER(BusFault_Handler, FAULT_BUS)
+FAULT_HANDLER(UsageFault_Handler, FAULT_USAGE)
+#endif
+
+#ifdef _USE_FREERTOS_
+/** \brief FreeRTOS stack overflow hook; replaces the one in FreeRTOSHooks.c.
+ *  @param pxTask The task whose stack overflowed
+ *  @param pcTaskName Its name
+ */
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName)
+{
+	(void) pxTask;
+	fault_capture_event(FAULT_STACK_OVERFLOW, pcTaskName);
+}
+
+/** \brief FreeRTOS failed malloc hook; replaces the one in FreeRTOSHooks.c.
+ */
+void vApplicationMallocFailedHook(void)
+{
+	fault_capture_event(FAULT_MALLOC_FAILED, NULL);
+}
+#endif
+
+/** \brief The C++ operator new's failure hook; replaces the one in pool.c.
+ *  @param size The size that couldn't be allocated
+ */
+void pool_alloc_failed(size_t size)
+{
+	(void) size;
+	fault_capture_event(FAULT_MALLOC_FAILED, NULL);
+}
+
+//-------------------------------------------------------------------------------------
+void fault_init(void)
+{
+	SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk
+		| SCB_SHCSR_USGFAULTENA_Msk;
+}
+
+bool fault_report(void)
+{
+	struct fault_record *record = &fault_ram;
+	uint32_t i;
+
+#if (FAULT_SAVE_TO_FLASH == 1)
+	// A dump in flash outlives a power cycle, which clears the one in RAM
+	if (!fault_is_valid(record))
+	{
+		memcpy(record, (const void*) FAULT_FLASH_ADDRESS, sizeof(*record));
+	}
+#endif
+	if (!fault_is_valid(record))
+	{
+		record->magic = 0;
+		return false;
+	}
+
+	printf("\r\n*** Crash on previous run: %s",
+		(record->type < sizeof(type_names) / sizeof(type_names[0]))
+		? type_names[record->type] : "unknown");
+	if (record->task[0] != '\0')
+	{
+		printf(" in task \"%s\"", record->task);
+	}
+	if (record->xpsr & 0x1FF)
+	{
+		printf(" in exception %lu", (unsigned long) (record->xpsr & 0x1FF));
+	}
+	printf("\r\n  PC   0x%08lx  LR   0x%08lx  SP   0x%08lx  xPSR 0x%08lx\r\n",
+		(unsigned long) record->pc, (unsigned long) record->lr,
+		(unsigned long) record->sp, (unsigned long) record->xpsr);
+	printf("  R0   0x%08lx  R1   0x%08lx  R2   0x%08lx  R3   0x%08lx  R12 0x%08lx\r\n",
+		(unsigned long) record->r0, (unsigned long) record->r1,
+		(unsigned long) record->r2, (unsigned long) record->r3,
+		(unsigned long) record->r12);
+	printf("  CFSR 0x%08lx  HFSR 0x%08lx  MMFAR 0x%08lx  BFAR 0x%08lx\r\n ",
+		(unsigned long) record->cfsr, (unsigned long) record->hfsr,
+		(unsigned long) record->mmfar, (unsigned long) record->bfar);
+	for (i = 0; i < 32; i++)
+	{
+		if ((record->cfsr & (1UL << i)) && (cfsr_names[i] != NULL))
+		{
+			printf(" %s", cfsr_names[i]);
+		}
+	}
+	if (record->hfsr & (1UL << 30))
+	{
+		printf(" FORCED");
+	}
+	if (record->hfsr & (1UL << 1))
+	{
+		printf(" VECTTBL");
+	}
+	printf("\r\n  Backtrace:");
+	for (i = 0; i < record->depth && i < FAULT_BACKTRACE_DEPTH; i++)
+	{
+		printf(" 0x%08lx", (unsigned long) record->backtrace[i]);
+	}
+	printf("\r\n");
+
+	// Report each crash once
+	record->magic = 0;
+#if (FAULT_SAVE_TO_FLASH == 1)
+	if (fault_is_valid((const struct fault_record*) FAULT_FLASH_ADDRESS))
+	{
+		flash_unlock(FAULT_FLASH_ADDRESS, FAULT_FLASH_ADDRESS + IFLASH1_PAGE_SIZE - 1,
+			NULL, NULL);
+		flash_write(FAULT_FLASH_ADDRESS, record, sizeof(*record), 1);
+	}
+#endif
+	return true;
+}
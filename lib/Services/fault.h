@@ -0,0 +1,86 @@
+//*************************************************************************************
+/** \file fault.h
+ *    This file contains a crash dump service. It takes over the hard fault, memory
+ *    management fault, bus fault and usage fault handlers and, in FreeRTOS
+ *    projects, the stack overflow and failed malloc hooks, as well as the pool
+ *    allocator's hook for a failed C++ new. When one of them fires, it records the
+ *    registers the processor stacked, the fault status and address registers, the
+ *    name of the running task and a short backtrace in a section of RAM that the
+ *    startup code neither clears nor initialises, so it survives a reset.
+ *    Optionally the dump is copied to flash as well. The board is then reset (or,
+ *    if so configured, stops and blinks LED0), and on the next boot fault_report()
+ *    prints the dump on the console.
+ *
+ *    The backtrace is found by scanning the faulting stack for words that look like
+ *    return addresses into the program, so it can include stale entries. Turn the
+ *    addresses into source lines on the host with
+ *    \code
+ *    arm-none-eabi-addr2line -f -e <project>_flash.elf <addresses>
+ *    \endcode
+ *
+ *    Settings are in lib/ASF_Config/conf_fault.h. To use the service, add fault to
+ *    SERVICES in the project Makefile and call fault_init() and fault_report() once
+ *    the console is up.
+ */
+//*************************************************************************************
+
+#ifndef _FAULT_H_
+#define _FAULT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <conf_fault.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief What caused a crash dump.
+ */
+enum fault_type
+{
+	FAULT_NONE,
+	FAULT_HARD,                        ///< Hard fault, or a fault that escalated to one
+	FAULT_MEM_MANAGE,                  ///< Memory management fault
+	FAULT_BUS,                         ///< Bus fault
+	FAULT_USAGE,                       ///< Usage fault
+	FAULT_STACK_OVERFLOW,              ///< FreeRTOS detected a task stack overflow
+	FAULT_MALLOC_FAILED                ///< pvPortMalloc() or operator new ran out of memory
+};
+
+/** \brief A crash dump, as kept in no-init RAM and, optionally, in flash.
+ */
+struct fault_record
+{
+	uint32_t magic;                    ///< FAULT_MAGIC when the record is valid
+	uint32_t type;                     ///< An enum fault_type
+	uint32_t r0, r1, r2, r3, r12;      ///< Stacked registers, zero for hook events
+	uint32_t lr, pc, xpsr;
+	uint32_t sp;                       ///< Stack pointer at the time of the fault
+	uint32_t exc_return;               ///< EXC_RETURN value of the fault handler
+	uint32_t cfsr, hfsr, mmfar, bfar;  ///< System control block fault registers
+	char task[16];                     ///< Name of the running task, if any
+	uint32_t backtrace[FAULT_BACKTRACE_DEPTH];
+	uint32_t depth;                    ///< Number of entries in backtrace
+	uint32_t checksum;                 ///< Sum of every word above
+};
+
+/// Marks a valid fault_record
+#define FAULT_MAGIC            0xDEADFA17UL
+
+/** \brief Enables the separate memory management, bus and usage fault handlers,
+ *  which would otherwise all escalate to a hard fault.
+ */
+void fault_init(void);
+
+/** \brief Prints the dump left by a crash on the previous run, if there is one, and
+ *  then discards it so that it's only reported once.
+ *  @return True if a dump was printed
+ */
+bool fault_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _FAULT_H_
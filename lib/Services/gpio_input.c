@@ -0,0 +1,351 @@
+//*************************************************************************************
+/** \file gpio_input.c
+ *    This file contains the GPIO input service. Each port in use has one PIO
+ *    handler. ASF's dispatcher reads and clears the port's interrupt status before
+ *    calling it, and passes only the mask it was registered with, so the handler
+ *    works out which pins changed by comparing the levels with the ones it last
+ *    queued. The queue has one producer (the handlers, which share a priority and
+ *    so never interrupt each other) and one consumer, so it needs no locking.
+ */
+//*************************************************************************************
+
+#include <string.h>
+#include <compiler.h>
+#include <sysclk.h>
+#include <pio.h>
+#include <pio_handler.h>
+#include <conf_gpio_input.h>
+#include "cycle_counter.h"
+#include "gpio_input.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#endif
+
+/// Number of PIO controllers on the part
+#if defined(PIOF)
+#define GPIO_INPUT_PORTS       6
+#elif defined(PIOE)
+#define GPIO_INPUT_PORTS       5
+#else
+#define GPIO_INPUT_PORTS       4
+#endif
+
+/// Marks a bit of a port which isn't in the pin table
+#define NO_PIN                 0xFF
+
+/** \brief One interrupt, as queued by the handler.
+ */
+struct gpio_input_raw
+{
+	uint32_t cycles;                   ///< Cycle counter on entry to the handler
+	uint32_t levels;                   ///< The port's pin levels
+	uint32_t changed;                  ///< Watched pins that changed; cleared as read
+	uint32_t port;                     ///< Index of the port
+};
+
+/** \brief A port with watched pins.
+ */
+struct gpio_input_port
+{
+	Pio *pio;                          ///< The controller
+	uint32_t mask;                     ///< The watched pins
+	uint32_t levels;                   ///< Levels in the last interrupt queued
+	uint8_t pin_of_bit[32];            ///< Table index of each bit's pin, or NO_PIN
+};
+
+/** \brief The debouncing state of a pin.
+ */
+struct gpio_input_state
+{
+	uint32_t window;                   ///< Debounce time, in cycles
+	uint32_t reported;                 ///< Time of the last edge reported
+	uint32_t raw_time;                 ///< Time of the last edge seen
+	uint8_t level;                     ///< Level last reported
+	uint8_t raw;                       ///< Level last seen
+	uint8_t settling;                  ///< Whether edges are being taken as bounce
+};
+
+static struct gpio_input_raw queue[GPIO_INPUT_QUEUE_SIZE];
+static volatile uint32_t queue_head;
+static volatile uint32_t queue_tail;
+static volatile uint32_t queue_dropped;
+
+static struct gpio_input_port ports[GPIO_INPUT_PORTS];
+static struct gpio_input_state pin_state[GPIO_INPUT_MAX_PINS];
+static uint32_t pin_count;
+static uint32_t cycles_per_us;
+
+#ifdef _USE_FREERTOS_
+/// Given by a handler when it queues an interrupt into an empty queue
+static SemaphoreHandle_t queue_sem;
+#endif
+
+//------------------------------------------------------------------------------
+/** \brief Handler for every port with watched pins.
+ *  @param id The port's peripheral ID
+ *  @param mask The pins it was registered with; not used
+ */
+static void gpio_input_handler(uint32_t id, uint32_t mask)
+{
+	uint32_t cycles = DWT->CYCCNT;
+	struct gpio_input_port *port = &ports[id - ID_PIOA];
+	uint32_t levels = port->pio->PIO_PDSR;
+	uint32_t changed = (levels ^ port->levels) & port->mask;
+	uint32_t head = queue_head;
+	struct gpio_input_raw *raw;
+
+	UNUSED(mask);
+
+	if (changed == 0)
+	{
+		return;
+	}
+	if (head - queue_tail >= GPIO_INPUT_QUEUE_SIZE)
+	{
+		// Leave port->levels alone, so that the next interrupt queued picks up
+		// these changes too
+		queue_dropped++;
+		return;
+	}
+
+	raw = &queue[head & (GPIO_INPUT_QUEUE_SIZE - 1)];
+	raw->cycles = cycles;
+	raw->levels = levels;
+	raw->changed = changed;
+	raw->port = id - ID_PIOA;
+	port->levels = levels;
+	__DMB();
+	queue_head = head + 1;
+
+#ifdef _USE_FREERTOS_
+	if ((head == queue_tail) && (queue_sem != NULL))
+	{
+		BaseType_t woken = pdFALSE;
+
+		xSemaphoreGiveFromISR(queue_sem, &woken);
+		portEND_SWITCHING_ISR(woken);
+	}
+#endif
+}
+
+/** \brief Ends a pin's debounce time if it is over, reporting the level it has
+ *  settled at if that differs from the level last reported.
+ *  @param state The pin
+ *  @param index Index of the pin in the table
+ *  @param now The time to check against
+ *  @param event Where to put an edge, if one is found
+ *  @return Whether an edge was put in \p event
+ */
+static bool gpio_input_settle(struct gpio_input_state *state, uint32_t index,
+		uint32_t now, gpio_input_event_t *event)
+{
+	if (!state->settling || ((int32_t) (now - state->reported) < (int32_t) state->window))
+	{
+		return false;
+	}
+	state->settling = 0;
+	if (state->raw == state->level)
+	{
+		return false;
+	}
+
+	// The pin bounced to the other level and stayed there. Report it, and give it
+	// another debounce time in case it is still moving.
+	event->cycles = state->raw_time;
+	event->pin = (uint8_t) index;
+	event->level = state->raw;
+	state->level = state->raw;
+	state->reported += state->window;
+	state->settling = 1;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void gpio_input_init(const gpio_input_pin_t *pins, uint32_t count)
+{
+	uint32_t i;
+
+	cycles_per_us = sysclk_get_cpu_hz() / 1000000UL;
+	cycle_counter_enable();
+
+	memset(ports, 0, sizeof(ports));
+	for (i = 0; i < GPIO_INPUT_PORTS; i++)
+	{
+		memset(ports[i].pin_of_bit, NO_PIN, sizeof(ports[i].pin_of_bit));
+	}
+
+	pin_count = (count > GPIO_INPUT_MAX_PINS) ? GPIO_INPUT_MAX_PINS : count;
+	for (i = 0; i < pin_count; i++)
+	{
+		uint32_t index = ((uint32_t) pins[i].pio - (uint32_t) PIOA)
+				/ ((uint32_t) PIOB - (uint32_t) PIOA);
+		struct gpio_input_port *port = &ports[index];
+
+		port->pio = pins[i].pio;
+		port->mask |= pins[i].mask;
+		port->pin_of_bit[__builtin_ctz(pins[i].mask)] = (uint8_t) i;
+
+		pmc_enable_periph_clk(ID_PIOA + index);
+		pio_set_input(pins[i].pio, pins[i].mask, pins[i].attr);
+		memset(&pin_state[i], 0, sizeof(pin_state[i]));
+		pin_state[i].window = pins[i].debounce_us * cycles_per_us;
+	}
+
+#ifdef _USE_FREERTOS_
+	queue_sem = xSemaphoreCreateBinary();
+#endif
+
+	for (i = 0; i < GPIO_INPUT_PORTS; i++)
+	{
+		struct gpio_input_port *port = &ports[i];
+		uint32_t bit;
+
+		if (port->mask == 0)
+		{
+			continue;
+		}
+
+		// Start from the levels the pins have now
+		port->levels = port->pio->PIO_PDSR;
+		for (bit = 0; bit < 32; bit++)
+		{
+			if (port->pin_of_bit[bit] != NO_PIN)
+			{
+				pin_state[port->pin_of_bit[bit]].level = (port->levels >> bit) & 1;
+				pin_state[port->pin_of_bit[bit]].raw = (port->levels >> bit) & 1;
+			}
+		}
+
+		// Attribute 0 interrupts on both edges
+		pio_handler_set(port->pio, ID_PIOA + i, port->mask, 0, gpio_input_handler);
+		pio_handler_set_priority(port->pio, (IRQn_Type) (ID_PIOA + i),
+				GPIO_INPUT_IRQ_PRIORITY);
+		pio_enable_interrupt(port->pio, port->mask);
+	}
+}
+
+uint32_t gpio_input_get_events(gpio_input_event_t *events, uint32_t max)
+{
+	uint32_t count = 0;
+	uint32_t head = queue_head;
+	uint32_t tail = queue_tail;
+	uint32_t now;
+	uint32_t i;
+
+	// Entries up to head were stamped before this reading, so none of them is
+	// later than now
+	__DMB();
+	now = DWT->CYCCNT;
+
+	while ((tail != head) && (count < max))
+	{
+		struct gpio_input_raw *raw = &queue[tail & (GPIO_INPUT_QUEUE_SIZE - 1)];
+		struct gpio_input_port *port = &ports[raw->port];
+
+		while ((raw->changed != 0) && (count < max))
+		{
+			uint32_t bit = __builtin_ctz(raw->changed);
+			uint32_t index = port->pin_of_bit[bit];
+			struct gpio_input_state *state = &pin_state[index];
+			uint8_t level = (raw->levels >> bit) & 1;
+
+			// Settle first, as the edge before this one may have ended bouncing.
+			// Each step reports at most one edge, so check for room in between.
+			if (gpio_input_settle(state, index, raw->cycles, &events[count]))
+			{
+				count++;
+				if (count == max)
+				{
+					break;
+				}
+			}
+			raw->changed &= raw->changed - 1;
+
+			state->raw = level;
+			state->raw_time = raw->cycles;
+			if (!state->settling && (level != state->level))
+			{
+				events[count].cycles = raw->cycles;
+				events[count].pin = (uint8_t) index;
+				events[count].level = level;
+				count++;
+				state->level = level;
+				state->reported = raw->cycles;
+				state->settling = 1;
+			}
+		}
+		if (raw->changed != 0)
+		{
+			break;
+		}
+		tail++;
+		queue_tail = tail;
+	}
+
+	// Pins whose debounce time has run out since their last edge
+	for (i = 0; (i < pin_count) && (count < max); i++)
+	{
+		if (gpio_input_settle(&pin_state[i], i, now, &events[count]))
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
+bool gpio_input_get_level(uint32_t pin)
+{
+	return pin_state[pin].level != 0;
+}
+
+uint32_t gpio_input_get_dropped(void)
+{
+	return queue_dropped;
+}
+
+#ifdef _USE_FREERTOS_
+uint32_t gpio_input_wait_events(gpio_input_event_t *events, uint32_t max,
+		uint32_t timeout_ms)
+{
+	TickType_t start = xTaskGetTickCount();
+	TickType_t timeout = configMS_TO_TICKS(timeout_ms);
+
+	for (;;)
+	{
+		uint32_t count = gpio_input_get_events(events, max);
+		TickType_t waited = xTaskGetTickCount() - start;
+		TickType_t wait;
+		uint32_t now;
+		uint32_t i;
+
+		if ((count != 0) || (waited >= timeout))
+		{
+			return count;
+		}
+
+		// Sleep until the queue gets something, or the first debounce time ends
+		wait = timeout - waited;
+		now = DWT->CYCCNT;
+		for (i = 0; i < pin_count; i++)
+		{
+			struct gpio_input_state *state = &pin_state[i];
+
+			if (state->settling)
+			{
+				int32_t left = (int32_t) (state->reported + state->window - now);
+				TickType_t ticks = (left <= 0) ? 1 : configMS_TO_TICKS(
+						(uint32_t) left / (cycles_per_us * 1000) + 1);
+
+				if (ticks < wait)
+				{
+					wait = ticks;
+				}
+			}
+		}
+		xSemaphoreTake(queue_sem, wait);
+	}
+}
+#endif
@@ -0,0 +1,98 @@
+//*************************************************************************************
+/** \file gpio_input.h
+ *    This file contains an input service which turns pin changes into a stream of
+ *    debounced, time-stamped events. The pins are listed in a table given to
+ *    gpio_input_init(), each with its own debounce time, and any of them on any
+ *    port can be used.
+ *
+ *    The interrupt handler does as little as it can. It reads the cycle counter and
+ *    the port's pin levels into a lock-free queue, one entry per interrupt however
+ *    many pins changed. Working out which pins changed, and debouncing them, is
+ *    left to whoever reads the events, in gpio_input_get_events(). A pin's first
+ *    edge is reported straight away, with the time it happened. Edges within the
+ *    pin's debounce time after that are taken as bounce. If the pin has ended up at
+ *    the other level once the time is over, that is reported as a further edge.
+ *
+ *    Only the levels are seen, so a pulse shorter than the time it takes to get into
+ *    the interrupt handler is lost. If the queue fills up, interrupts are dropped and
+ *    counted. Each pin still reports its level correctly when the next interrupt on
+ *    its port is read.
+ *
+ *    Times are DWT cycle counts (see cycle_counter.h), which wrap about every 51
+ *    seconds. The queue size and interrupt priority are set in
+ *    lib/ASF_Config/conf_gpio_input.h. To use the service, add gpio_input to
+ *    SERVICES in the project Makefile. It takes over the PIO interrupt of each port
+ *    it uses through pio_handler_set(), with a single handler per port.
+ */
+//*************************************************************************************
+
+#ifndef _GPIO_INPUT_H_
+#define _GPIO_INPUT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <compiler.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief One pin to watch.
+ */
+typedef struct gpio_input_pin
+{
+	Pio *pio;                  ///< The pin's PIO controller, such as PIOB
+	uint32_t mask;             ///< The pin's bit in the controller
+	uint32_t attr;             ///< pio_set_input() attributes, such as PIO_PULLUP
+	uint32_t debounce_us;      ///< How long the pin is left to settle after an edge
+} gpio_input_pin_t;
+
+/** \brief A debounced edge.
+ */
+typedef struct gpio_input_event
+{
+	uint32_t cycles;           ///< Cycle counter when the edge happened
+	uint8_t pin;               ///< Index of the pin in the table
+	uint8_t level;             ///< The pin's new level, 0 or 1
+} gpio_input_event_t;
+
+/** \brief Sets the pins up as inputs and starts watching them. Call this once.
+ *  @param pins The table of pins, which must stay valid while it is being used
+ *  @param count Number of pins in the table, up to GPIO_INPUT_MAX_PINS
+ */
+void gpio_input_init(const gpio_input_pin_t *pins, uint32_t count);
+
+/** \brief Reads the queued interrupts and returns the debounced edges found in
+ *  them, oldest first. Only one task (or main loop) may read events.
+ *  @param events Array to fill in
+ *  @param max Number of entries in \p events
+ *  @return Number of entries filled in
+ */
+uint32_t gpio_input_get_events(gpio_input_event_t *events, uint32_t max);
+
+/** \brief Returns the debounced level of a pin, as of the last event read.
+ *  @param pin Index of the pin in the table
+ */
+bool gpio_input_get_level(uint32_t pin);
+
+/** \brief Returns the number of interrupts dropped because the queue was full.
+ */
+uint32_t gpio_input_get_dropped(void);
+
+/** \brief Waits for debounced edges, then returns them as gpio_input_get_events()
+ *  does.
+ *  \details This is only built into projects that use FreeRTOS. The task sleeps
+ *  until an interrupt is queued, or until a pin's debounce time ends.
+ *  @param events Array to fill in
+ *  @param max Number of entries in \p events
+ *  @param timeout_ms The longest time to wait
+ *  @return Number of entries filled in; 0 if the wait timed out
+ */
+uint32_t gpio_input_wait_events(gpio_input_event_t *events, uint32_t max,
+		uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _GPIO_INPUT_H_
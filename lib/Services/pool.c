@@ -0,0 +1,225 @@
+//*************************************************************************************
+/** \file pool.c
+ *    This file contains the fixed-block pool allocator. Each size class listed in
+ *    POOL_CLASSES gets a static array of blocks. A free block holds a pointer to the
+ *    next free block of its class, so the free list costs no extra memory, and
+ *    allocating or freeing a block is a push or pop at the head of the list. A
+ *    block's class is found from its address, by checking which array it lies in.
+ */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <compiler.h>
+#include <interrupt.h>
+#include <conf_pool.h>
+#include "pool.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOSHooks.h>
+#endif
+
+/** \brief A free block, linked to the next free block of its class.
+ */
+struct pool_block
+{
+	struct pool_block *next;
+};
+
+/** \brief A size class: its blocks, its free list and its figures.
+ */
+struct pool_class
+{
+	uint8_t *start;                    ///< The first block
+	uint32_t block_size;               ///< Bytes in each block
+	uint32_t blocks;                   ///< Number of blocks
+	struct pool_block *free_list;      ///< Free blocks, or NULL if all are in use
+	uint32_t in_use;                   ///< Blocks allocated now
+	uint32_t high_water;               ///< Most blocks ever allocated at once
+	uint32_t failed;                   ///< Requests that found the class used up
+};
+
+// The blocks of each class; uint64_t keeps them 8-byte aligned
+#define POOL_CLASS(size, count)                                                        \
+	typedef char pool_size_##size##_must_be_multiple_of_8[((size) % 8 == 0) ? 1 : -1]; \
+	static uint64_t pool_store_##size[(size) * (count) / sizeof(uint64_t)];
+POOL_CLASSES
+#undef POOL_CLASS
+
+/// The size classes, smallest first
+#define POOL_CLASS(size, count)  { (uint8_t*) pool_store_##size, size, count, NULL, 0, 0, 0 },
+static struct pool_class pool_classes[] =
+{
+	POOL_CLASSES
+};
+#undef POOL_CLASS
+
+/// Number of entries in \c pool_classes
+#define POOL_CLASS_COUNT  (sizeof(pool_classes) / sizeof(pool_classes[0]))
+
+/// True once the free lists have been built
+static bool pool_ready = false;
+
+/** \brief Threads every block of every class onto its free list. Must be called
+ *  with interrupts masked.
+ */
+static void pool_setup(void)
+{
+	uint32_t c;
+	uint32_t i;
+
+	for (c = 0; c < POOL_CLASS_COUNT; c++)
+	{
+		struct pool_class *pc = &pool_classes[c];
+
+		pc->free_list = NULL;
+		for (i = pc->blocks; i > 0; i--)
+		{
+			struct pool_block *block =
+				(struct pool_block*) (pc->start + (i - 1) * pc->block_size);
+
+			block->next = pc->free_list;
+			pc->free_list = block;
+		}
+	}
+	pool_ready = true;
+}
+
+/** \brief Finds the class a block belongs to.
+ *  @return The class, or NULL if the pointer isn't in any pool
+ */
+static struct pool_class *pool_find_class(const void *block)
+{
+	const uint8_t *address = (const uint8_t*) block;
+	uint32_t c;
+
+	for (c = 0; c < POOL_CLASS_COUNT; c++)
+	{
+		struct pool_class *pc = &pool_classes[c];
+
+		if ((address >= pc->start) && (address < pc->start + pc->blocks * pc->block_size))
+		{
+			return pc;
+		}
+	}
+	return NULL;
+}
+
+//-------------------------------------------------------------------------------------
+void *pool_alloc(size_t size)
+{
+	struct pool_block *block = NULL;
+	irqflags_t flags = cpu_irq_save();
+	uint32_t c;
+
+	if (!pool_ready)
+	{
+		pool_setup();
+	}
+
+	// Skip the classes that are too small
+	for (c = 0; (c < POOL_CLASS_COUNT) && (size > pool_classes[c].block_size); c++);
+
+	if (c == POOL_CLASS_COUNT)
+	{
+		// Too big for every class; blame the largest
+		pool_classes[POOL_CLASS_COUNT - 1].failed++;
+	}
+	for (; c < POOL_CLASS_COUNT; c++)
+	{
+		struct pool_class *pc = &pool_classes[c];
+
+		block = pc->free_list;
+		if (block != NULL)
+		{
+			pc->free_list = block->next;
+			if (++pc->in_use > pc->high_water)
+			{
+				pc->high_water = pc->in_use;
+			}
+			break;
+		}
+		pc->failed++;
+#if (POOL_SPILL_TO_LARGER != 1)
+		break;
+#endif
+	}
+	cpu_irq_restore(flags);
+	return block;
+}
+
+void pool_free(void *block)
+{
+	struct pool_class *pc;
+	irqflags_t flags;
+
+	if (block == NULL)
+	{
+		return;
+	}
+	pc = pool_find_class(block);
+	if (pc == NULL)
+	{
+		return;
+	}
+
+	flags = cpu_irq_save();
+	((struct pool_block*) block)->next = pc->free_list;
+	pc->free_list = (struct pool_block*) block;
+	pc->in_use--;
+	cpu_irq_restore(flags);
+}
+
+bool pool_owns(const void *block)
+{
+	return pool_find_class(block) != NULL;
+}
+
+uint32_t pool_get_class_count(void)
+{
+	return POOL_CLASS_COUNT;
+}
+
+size_t pool_get_max_size(void)
+{
+	return pool_classes[POOL_CLASS_COUNT - 1].block_size;
+}
+
+bool pool_get_stats(uint32_t index, struct pool_stats *stats)
+{
+	irqflags_t flags;
+
+	if (index >= POOL_CLASS_COUNT)
+	{
+		return false;
+	}
+	flags = cpu_irq_save();
+	stats->block_size = pool_classes[index].block_size;
+	stats->blocks = pool_classes[index].blocks;
+	stats->in_use = pool_classes[index].in_use;
+	stats->high_water = pool_classes[index].high_water;
+	stats->failed = pool_classes[index].failed;
+	cpu_irq_restore(flags);
+	return true;
+}
+
+void pool_print_report(void)
+{
+	struct pool_stats stats;
+	uint32_t c;
+
+	printf("\r\n%6s %6s %6s %6s %6s\r\n", "Block", "Count", "Used", "Peak", "Failed");
+	for (c = 0; pool_get_stats(c, &stats); c++)
+	{
+		printf("%6lu %6lu %6lu %6lu %6lu\r\n", (unsigned long) stats.block_size,
+			(unsigned long) stats.blocks, (unsigned long) stats.in_use,
+			(unsigned long) stats.high_water, (unsigned long) stats.failed);
+	}
+}
+
+void __attribute__((weak)) pool_alloc_failed(size_t size)
+{
+	(void) size;
+#ifdef _USE_FREERTOS_
+	vApplicationMallocFailedHook();
+#endif
+}
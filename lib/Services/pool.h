@@ -0,0 +1,95 @@
+//*************************************************************************************
+/** \file pool.h
+ *    This file contains a fixed-block pool allocator. Memory is divided at build
+ *    time into a few size classes, each a static array of equal-sized blocks kept
+ *    on a free list, so allocating and freeing are both constant time and the pools
+ *    never fragment. All of it lives in .bss, so its size is known at link time.
+ *
+ *    Every operation runs in a critical section of a few instructions with
+ *    interrupts masked, so the pools may be used from tasks and interrupt handlers
+ *    alike, before and after the scheduler starts, and even from static
+ *    constructors. The first call sets the pools up.
+ *
+ *    For each class the allocator counts the blocks in use, the most ever in use at
+ *    once and the requests it couldn't serve. Sizes are set in
+ *    lib/ASF_Config/conf_pool.h. To use the pools, add pool to SERVICES in the
+ *    project Makefile; add pool_new as well to send every C++ new and delete here
+ *    (see pool_new.cpp).
+ */
+//*************************************************************************************
+
+#ifndef _POOL_H_
+#define _POOL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief The figures kept for one size class.
+ */
+struct pool_stats
+{
+	uint32_t block_size;               ///< Bytes in each block
+	uint32_t blocks;                   ///< Number of blocks in the class
+	uint32_t in_use;                   ///< Blocks allocated now
+	uint32_t high_water;               ///< Most blocks ever allocated at once
+	uint32_t failed;                   ///< Requests that found this class used up
+};
+
+/** \brief Allocates a block from the smallest class that \c size fits in.
+ *  @param size The number of bytes needed
+ *  @return The block, aligned to 8 bytes, or NULL if none was free (or \c size is
+ *          larger than the largest class)
+ */
+void *pool_alloc(size_t size);
+
+/** \brief Returns a block to its pool.
+ *  @param block A block from pool_alloc(), or NULL, which is ignored
+ */
+void pool_free(void *block);
+
+/** \brief Tells whether a pointer is a block from the pools.
+ *  @param block The pointer to check
+ *  @return True if \c block lies within one of the pools
+ */
+bool pool_owns(const void *block);
+
+/** \brief Returns the number of size classes.
+ */
+uint32_t pool_get_class_count(void);
+
+/** \brief Returns the block size of the largest class; pool_alloc() can't serve
+ *  anything bigger.
+ */
+size_t pool_get_max_size(void);
+
+/** \brief Copies the figures for one size class.
+ *  @param index Which class, from 0 (the smallest) to pool_get_class_count() - 1
+ *  @param stats Where to put the figures
+ *  @return False if \c index is out of range
+ */
+bool pool_get_stats(uint32_t index, struct pool_stats *stats);
+
+/** \brief Prints a table of each class's figures on stdout.
+ */
+void pool_print_report(void);
+
+/** \brief Called once by the C++ operator new when it can't serve a request, before
+ *  it fails.
+ *  \details The fault service replaces this with a version that records a crash
+ *  dump. The default calls the FreeRTOS malloc failed hook in FreeRTOS projects,
+ *  and does nothing otherwise. A program may replace it too; if it returns, the
+ *  new fails, by throwing std::bad_alloc or, without exceptions, by calling abort().
+ *  @param size The size that couldn't be allocated
+ */
+void pool_alloc_failed(size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _POOL_H_
@@ -0,0 +1,152 @@
+//*************************************************************************************
+/** \file pool_new.cpp
+ *    This file replaces the global C++ operator new and operator delete, in all
+ *    their array and nothrow forms, with the pool allocator in pool.c, so every
+ *    object a program creates with new comes out of the pools rather than newlib's
+ *    heap. Objects too big for the largest class come from the heap instead:
+ *    pvPortMalloc() in FreeRTOS projects, so they must not be created in interrupt
+ *    handlers, and malloc() otherwise.
+ *
+ *    When a plain new can't be served, it calls pool_alloc_failed() once, which
+ *    goes to the fault service if the project has it, and then fails: it throws
+ *    std::bad_alloc or, when compiled without exceptions, calls abort(), as a
+ *    plain new must never return NULL. Use the nothrow forms where running out
+ *    is to be handled.
+ *
+ *    To use it, add both pool and pool_new to SERVICES in the project Makefile.
+ */
+//*************************************************************************************
+
+#include <new>
+#include <stdlib.h>
+#include "pool.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#endif
+
+// C++98 requires the replacements to repeat the library's exception specifications
+#if (__cplusplus < 201103L)
+#define POOL_THROW_BAD_ALLOC  throw (std::bad_alloc)
+#define POOL_NO_THROW         throw ()
+#else
+#define POOL_THROW_BAD_ALLOC
+#define POOL_NO_THROW         noexcept
+#endif
+
+// pvPortMalloc() calls the malloc failed hook itself, so a request it turns down
+// has been reported already
+#if defined(_USE_FREERTOS_) && (configUSE_MALLOC_FAILED_HOOK == 1)
+#define POOL_HEAP_REPORTS     1
+#else
+#define POOL_HEAP_REPORTS     0
+#endif
+
+/** \brief Allocates from the pools, or from the heap if \c size is bigger than the
+ *  largest class.
+ *  @return The block, or NULL if there wasn't room
+ */
+static void *pool_new_alloc (std::size_t size)
+{
+	if (size > pool_get_max_size ())
+	{
+#ifdef _USE_FREERTOS_
+		return pvPortMalloc (size);
+#else
+		return malloc (size);
+#endif
+	}
+	return pool_alloc (size);
+}
+
+/** \brief Returns a block to the pool or the heap it came from.
+ */
+static void pool_new_free (void *block)
+{
+	if (pool_owns (block))
+	{
+		pool_free (block);
+	}
+	else if (block != NULL)
+	{
+#ifdef _USE_FREERTOS_
+		vPortFree (block);
+#else
+		free (block);
+#endif
+	}
+}
+
+/** \brief Allocates for the plain forms of new, reporting a request that can't be
+ *  served once and then failing it. Never returns NULL.
+ */
+static void *pool_new (std::size_t size)
+{
+	void *block = pool_new_alloc (size);
+
+	if (block == NULL)
+	{
+		if ((size <= pool_get_max_size ()) || (POOL_HEAP_REPORTS == 0))
+		{
+			pool_alloc_failed (size);
+		}
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+		throw std::bad_alloc ();
+#else
+		abort ();
+#endif
+	}
+	return block;
+}
+
+void *operator new (std::size_t size) POOL_THROW_BAD_ALLOC
+{
+	return pool_new (size);
+}
+
+void *operator new[] (std::size_t size) POOL_THROW_BAD_ALLOC
+{
+	return pool_new (size);
+}
+
+void *operator new (std::size_t size, const std::nothrow_t&) POOL_NO_THROW
+{
+	return pool_new_alloc (size);
+}
+
+void *operator new[] (std::size_t size, const std::nothrow_t&) POOL_NO_THROW
+{
+	return pool_new_alloc (size);
+}
+
+void operator delete (void *block) POOL_NO_THROW
+{
+	pool_new_free (block);
+}
+
+void operator delete[] (void *block) POOL_NO_THROW
+{
+	pool_new_free (block);
+}
+
+void operator delete (void *block, const std::nothrow_t&) POOL_NO_THROW
+{
+	pool_new_free (block);
+}
+
+void operator delete[] (void *block, const std::nothrow_t&) POOL_NO_THROW
+{
+	pool_new_free (block);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete (void *block, std::size_t) POOL_NO_THROW
+{
+	pool_new_free (block);
+}
+
+void operator delete[] (void *block, std::size_t) POOL_NO_THROW
+{
+	pool_new_free (block);
+}
+#endif
@@ -0,0 +1,458 @@
+//*************************************************************************************
+/** \file rtos_bench.cpp
+ *    This file contains the FreeRTOS micro-benchmarks. Each benchmark creates the
+ *    tasks it needs, one priority above the caller's, takes all its samples, then
+ *    deletes them again; nothing is printed until every benchmark is done, so the
+ *    console can't get in the way of the measurements. A time that an interrupt
+ *    or a tick happened to land in shows up in the maximum, not the minimum.
+ *
+ *    On the board, deleting a task only takes it off the kernel's lists; the idle
+ *    task frees its stack and control block later, so that part isn't counted in
+ *    task_delete.
+ */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <compiler.h>
+#ifdef _HOST_BUILD_
+#include <time.h>
+#endif
+#include "rtos_bench.h"
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <semphr.h>
+#include <conf_rtos_bench.h>
+#include "cycle_counter.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"
+
+/// The unit of the times, and the rate at which time stamps count
+#ifdef _HOST_BUILD_
+#define RTOS_BENCH_UNIT       "ns"
+#define RTOS_BENCH_CLOCK_HZ   1000000000UL
+#else
+#define RTOS_BENCH_UNIT       "cycles"
+#define RTOS_BENCH_CLOCK_HZ   SystemCoreClock
+#endif
+
+/// The results, in the order they are printed
+static rtos_bench_result_t timer_overhead;
+static rtos_bench_result_t context_switch;
+static rtos_bench_result_t sem_round_trip;
+static rtos_bench_result_t queue_send;
+static rtos_bench_result_t queue_receive;
+static rtos_bench_result_t task_create;
+static rtos_bench_result_t task_delete;
+static rtos_bench_result_t isr_entry;
+static rtos_bench_result_t isr_to_task;
+
+/// The semaphores the tasks hand control over with, and the one they say
+/// they're done with
+static SemaphoreHandle_t ping;
+static SemaphoreHandle_t pong;
+static SemaphoreHandle_t done;
+
+/// The time stamp taken by the last task to yield, and whether there is one yet
+static volatile uint32_t switch_stamp;
+static volatile bool switch_stamped;
+
+/// The time stamps taken as the interrupt was pended and as its handler started
+static volatile uint32_t pend_stamp;
+static volatile uint32_t isr_stamp;
+
+//------------------------------------------------------------------------------
+/** \brief Returns a time stamp: the DWT cycle count on the board, and
+ *  clock_gettime() in nanoseconds on the host. Either wraps, so only the
+ *  difference between two of them means anything.
+ */
+static inline uint32_t rtos_bench_now(void)
+{
+#ifdef _HOST_BUILD_
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t) now.tv_sec * 1000000000UL + (uint32_t) now.tv_nsec;
+#else
+	return DWT->CYCCNT;
+#endif
+}
+
+/** \brief Empties a result and names it.
+ */
+static void rtos_bench_reset(rtos_bench_result_t *result, const char *name)
+{
+	result->name = name;
+	result->samples = 0;
+	result->min = 0xFFFFFFFFUL;
+	result->max = 0;
+	result->total = 0;
+}
+
+/** \brief Adds one time to a result.
+ */
+static void rtos_bench_add(rtos_bench_result_t *result, uint32_t time)
+{
+	result->samples++;
+	result->total += time;
+	if (time < result->min)
+	{
+		result->min = time;
+	}
+	if (time > result->max)
+	{
+		result->max = time;
+	}
+}
+
+//------------------------------------------------------------------------------
+/** \brief The base of the tasks the benchmarks measure. Deleting one through a
+ *  pointer to this class runs the right destructors.
+ */
+class rtos_bench_task : public TaskClass
+{
+public:
+	rtos_bench_task(const char *name, unsigned portBASE_TYPE priority)
+		: TaskClass(name, priority, RTOS_BENCH_TASK_STACK_SIZE)
+	{
+	}
+
+	virtual ~rtos_bench_task()
+	{
+	}
+
+	/** \brief Whether FreeRTOS could create the task.
+	 */
+	bool created(void)
+	{
+		return handle != 0;
+	}
+
+	/** \brief Deletes a task, unless it couldn't be created. Deleting one of those
+	 *  would delete the calling task instead, as its handle is empty, so it is
+	 *  left alone.
+	 */
+	static void end(rtos_bench_task *task)
+	{
+		if (task->created())
+		{
+			delete task;
+		}
+	}
+
+protected:
+	/** \brief Blocks for good, so that a task whose work is done is only ever
+	 *  ended by deleting it.
+	 */
+	static void park(void)
+	{
+		for (;;)
+		{
+			vTaskDelay(portMAX_DELAY);
+		}
+	}
+};
+
+/** \brief One of a pair of tasks at the same priority which yield to each other,
+ *  each timing the switch from the other.
+ */
+class rtos_bench_yielder : public rtos_bench_task
+{
+public:
+	rtos_bench_yielder(const char *name, unsigned portBASE_TYPE priority)
+		: rtos_bench_task(name, priority)
+	{
+	}
+
+	void run(void)
+	{
+		for (;;)
+		{
+			uint32_t now = rtos_bench_now();
+
+			if (switch_stamped)
+			{
+				if (context_switch.samples == RTOS_BENCH_SAMPLES)
+				{
+					break;
+				}
+				rtos_bench_add(&context_switch, now - switch_stamp);
+			}
+			switch_stamped = true;
+			switch_stamp = rtos_bench_now();
+			taskYIELD();
+		}
+		xSemaphoreGive(done);
+		park();
+	}
+};
+
+/** \brief Answers each ping with a pong, as task_blink1 answers task_blink2.
+ */
+class rtos_bench_responder : public rtos_bench_task
+{
+public:
+	rtos_bench_responder(const char *name, unsigned portBASE_TYPE priority)
+		: rtos_bench_task(name, priority)
+	{
+	}
+
+	void run(void)
+	{
+		for (;;)
+		{
+			xSemaphoreTake(ping, portMAX_DELAY);
+			xSemaphoreGive(pong);
+		}
+	}
+};
+
+/** \brief Waits for the interrupt handler's ping, and times how long it took to
+ *  get there from the interrupt being pended.
+ */
+class rtos_bench_isr_waiter : public rtos_bench_task
+{
+public:
+	rtos_bench_isr_waiter(const char *name, unsigned portBASE_TYPE priority)
+		: rtos_bench_task(name, priority)
+	{
+	}
+
+	void run(void)
+	{
+		for (;;)
+		{
+			xSemaphoreTake(ping, portMAX_DELAY);
+
+			uint32_t now = rtos_bench_now();
+			rtos_bench_add(&isr_entry, isr_stamp - pend_stamp);
+			rtos_bench_add(&isr_to_task, now - pend_stamp);
+			xSemaphoreGive(pong);
+		}
+	}
+};
+
+/** \brief Does nothing. It is created and deleted before it ever runs.
+ */
+class rtos_bench_sleeper : public rtos_bench_task
+{
+public:
+	rtos_bench_sleeper(const char *name, unsigned portBASE_TYPE priority)
+		: rtos_bench_task(name, priority)
+	{
+	}
+
+	void run(void)
+	{
+		park();
+	}
+};
+
+//------------------------------------------------------------------------------
+/** \brief The benchmark's interrupt handler, which only wakes the waiting task.
+ */
+extern "C" void RTOS_BENCH_Handler(void)
+{
+	BaseType_t woken = pdFALSE;
+
+	isr_stamp = rtos_bench_now();
+	xSemaphoreGiveFromISR(ping, &woken);
+	portEND_SWITCHING_ISR(woken);
+}
+
+//------------------------------------------------------------------------------
+/** \brief Times two time stamps taken one after the other.
+ */
+static void rtos_bench_timer(void)
+{
+	for (uint32_t i = 0; i < RTOS_BENCH_SAMPLES; i++)
+	{
+		uint32_t start = rtos_bench_now();
+		rtos_bench_add(&timer_overhead, rtos_bench_now() - start);
+	}
+}
+
+/** \brief Times switches between two tasks which yield to each other. They are
+ *  both created before either can run, so that neither yields to itself.
+ */
+static void rtos_bench_context_switch(unsigned portBASE_TYPE priority)
+{
+	switch_stamped = false;
+
+	vTaskSuspendAll();
+	rtos_bench_yielder *first = new rtos_bench_yielder("BnchY1", priority);
+	rtos_bench_yielder *second = new rtos_bench_yielder("BnchY2", priority);
+	xTaskResumeAll();
+
+	if (first->created() && second->created())
+	{
+		xSemaphoreTake(done, portMAX_DELAY);
+		xSemaphoreTake(done, portMAX_DELAY);
+	}
+	else
+	{
+		// A task on its own only yielded to itself, which isn't a switch
+		rtos_bench_reset(&context_switch, "context_switch");
+		xSemaphoreTake(done, 0);
+	}
+	rtos_bench_task::end(first);
+	rtos_bench_task::end(second);
+}
+
+/** \brief Times giving a semaphore to a task and taking the one it gives back.
+ */
+static void rtos_bench_semaphore(unsigned portBASE_TYPE priority)
+{
+	rtos_bench_responder *responder = new rtos_bench_responder("BnchS", priority);
+
+	if (responder->created())
+	{
+		for (uint32_t i = 0; i < RTOS_BENCH_SAMPLES; i++)
+		{
+			uint32_t start = rtos_bench_now();
+
+			xSemaphoreGive(ping);
+			xSemaphoreTake(pong, portMAX_DELAY);
+			rtos_bench_add(&sem_round_trip, rtos_bench_now() - start);
+		}
+	}
+	rtos_bench_task::end(responder);
+}
+
+/** \brief Times sending a word to a queue nobody is waiting on, and receiving it
+ *  back.
+ */
+static void rtos_bench_queue(void)
+{
+	QueueHandle_t queue = xQueueCreate(1, sizeof(uint32_t));
+	uint32_t value = 0;
+
+	if (queue == NULL)
+	{
+		return;
+	}
+	for (uint32_t i = 0; i < RTOS_BENCH_SAMPLES; i++)
+	{
+		uint32_t start = rtos_bench_now();
+		xQueueSend(queue, &value, 0);
+		uint32_t sent = rtos_bench_now();
+		xQueueReceive(queue, &value, 0);
+		uint32_t received = rtos_bench_now();
+
+		rtos_bench_add(&queue_send, sent - start);
+		rtos_bench_add(&queue_receive, received - sent);
+	}
+	vQueueDelete(queue);
+}
+
+/** \brief Times creating a TaskClass task, with new, and deleting it. Each task
+ *  is at the idle priority, so it never gets to run, and the caller waits a tick
+ *  after deleting each one for the idle task to free it.
+ */
+static void rtos_bench_task_life(void)
+{
+	for (uint32_t i = 0; i < RTOS_BENCH_SAMPLES; i++)
+	{
+		uint32_t start = rtos_bench_now();
+		rtos_bench_sleeper *task = new rtos_bench_sleeper("BnchT", tskIDLE_PRIORITY);
+		uint32_t created = rtos_bench_now();
+
+		if (!task->created())
+		{
+			return;
+		}
+		delete task;
+		uint32_t deleted = rtos_bench_now();
+
+		rtos_bench_add(&task_create, created - start);
+		rtos_bench_add(&task_delete, deleted - created);
+		vTaskDelay(1);
+	}
+}
+
+/** \brief Times the interrupt handler starting, and the task it wakes running,
+ *  after the interrupt is pended.
+ */
+static void rtos_bench_isr(unsigned portBASE_TYPE priority)
+{
+	rtos_bench_isr_waiter *waiter = new rtos_bench_isr_waiter("BnchI", priority);
+
+	if (waiter->created())
+	{
+		NVIC_DisableIRQ(RTOS_BENCH_IRQn);
+		NVIC_ClearPendingIRQ(RTOS_BENCH_IRQn);
+		NVIC_SetPriority(RTOS_BENCH_IRQn, RTOS_BENCH_IRQ_PRIORITY);
+		NVIC_EnableIRQ(RTOS_BENCH_IRQn);
+
+		for (uint32_t i = 0; i < RTOS_BENCH_SAMPLES; i++)
+		{
+			pend_stamp = rtos_bench_now();
+			NVIC_SetPendingIRQ(RTOS_BENCH_IRQn);
+			xSemaphoreTake(pong, portMAX_DELAY);
+		}
+		NVIC_DisableIRQ(RTOS_BENCH_IRQn);
+	}
+	rtos_bench_task::end(waiter);
+}
+
+//------------------------------------------------------------------------------
+void rtos_bench_run(void)
+{
+	unsigned portBASE_TYPE priority = uxTaskPriorityGet(NULL) + 1;
+
+	rtos_bench_reset(&timer_overhead, "timer_overhead");
+	rtos_bench_reset(&context_switch, "context_switch");
+	rtos_bench_reset(&sem_round_trip, "sem_round_trip");
+	rtos_bench_reset(&queue_send, "queue_send");
+	rtos_bench_reset(&queue_receive, "queue_receive");
+	rtos_bench_reset(&task_create, "task_create");
+	rtos_bench_reset(&task_delete, "task_delete");
+	rtos_bench_reset(&isr_entry, "isr_entry");
+	rtos_bench_reset(&isr_to_task, "isr_to_task");
+
+#ifndef _HOST_BUILD_
+	cycle_counter_enable();
+#endif
+
+	if (ping == NULL)
+	{
+		ping = xSemaphoreCreateBinary();
+		pong = xSemaphoreCreateBinary();
+		done = xSemaphoreCreateCounting(2, 0);
+	}
+	if ((ping != NULL) && (pong != NULL) && (done != NULL))
+	{
+		rtos_bench_timer();
+		rtos_bench_context_switch(priority);
+		rtos_bench_semaphore(priority);
+		rtos_bench_queue();
+		rtos_bench_task_life();
+		rtos_bench_isr(priority);
+	}
+
+	printf("bench,begin,kernel=%s,unit=%s,clock_hz=%lu,tick_hz=%lu,heap=%d\r\n",
+			tskKERNEL_VERSION_NUMBER, RTOS_BENCH_UNIT,
+			(unsigned long) RTOS_BENCH_CLOCK_HZ, (unsigned long) configTICK_RATE_HZ,
+			(int) configHEAP_NUMBER);
+	rtos_bench_print(&timer_overhead);
+	rtos_bench_print(&context_switch);
+	rtos_bench_print(&sem_round_trip);
+	rtos_bench_print(&queue_send);
+	rtos_bench_print(&queue_receive);
+	rtos_bench_print(&task_create);
+	rtos_bench_print(&task_delete);
+	rtos_bench_print(&isr_entry);
+	rtos_bench_print(&isr_to_task);
+	printf("bench,end\r\n");
+}
+
+void rtos_bench_print(const rtos_bench_result_t *result)
+{
+	uint32_t mean = (result->samples == 0) ? 0
+			: (uint32_t) (result->total / result->samples);
+
+	printf("bench,%s,%s,%lu,%lu,%lu,%lu\r\n", result->name, RTOS_BENCH_UNIT,
+			(unsigned long) result->samples,
+			(unsigned long) ((result->samples == 0) ? 0 : result->min),
+			(unsigned long) mean, (unsigned long) result->max);
+}
@@ -0,0 +1,68 @@
+//*************************************************************************************
+/** \file rtos_bench.h
+ *    This file contains micro-benchmarks of what the FreeRTOS layer costs: a
+ *    context switch, a semaphore round trip between two tasks as the blink tasks
+ *    in ex04 use them, sending to and receiving from a queue, creating and deleting
+ *    a TaskClass task, and the time from an interrupt to the task it wakes.
+ *
+ *    Times are DWT cycle counts on the board and nanoseconds from clock_gettime()
+ *    in the host build (see common/host.mk). Each operation is done
+ *    RTOS_BENCH_SAMPLES times, and the results are printed one line each, as comma
+ *    separated values which a script can pick out of the rest of the console
+ *    output and compare between kernel versions and configurations:
+ *
+ *        bench,begin,kernel=V8.0.1,unit=cycles,clock_hz=84000000,tick_hz=1000,heap=5
+ *        bench,<name>,<unit>,<samples>,<min>,<mean>,<max>
+ *        ...
+ *        bench,end
+ *
+ *    The first result, timer_overhead, is the cost of taking a time stamp, which
+ *    is included once in each of the others. The tasks the benchmarks need are
+ *    created and deleted as they go.
+ *
+ *    The interrupt, its priority and the number of samples are set in
+ *    lib/ASF_Config/conf_rtos_bench.h. To use the service, add rtos_bench to
+ *    SERVICES in the project Makefile; projects/ex08_frt_bench_cpp runs it. It
+ *    takes over the handler of the interrupt it uses.
+ */
+//*************************************************************************************
+
+#ifndef _RTOS_BENCH_H_
+#define _RTOS_BENCH_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief The times taken by one operation.
+ */
+typedef struct
+{
+	const char *name;                  ///< Short name, without spaces or commas
+	uint32_t samples;                  ///< Times the operation was measured
+	uint32_t min;                      ///< Quickest time
+	uint32_t max;                      ///< Slowest time
+	uint64_t total;                    ///< All the times added up
+} rtos_bench_result_t;
+
+/** \brief Runs every benchmark and prints the results.
+ *  \details This must be called from a task, with the scheduler running, and
+ *  takes a few seconds, most of them spent creating and deleting tasks. The
+ *  tasks it measures run at one priority above the caller's, so the caller's
+ *  priority must be below configMAX_PRIORITIES - 2, and no other task should be
+ *  ready at the caller's priority or above while it runs.
+ */
+void rtos_bench_run(void);
+
+/** \brief Prints one result as a line of comma separated values.
+ *  @param result The result
+ */
+void rtos_bench_print(const rtos_bench_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _RTOS_BENCH_H_
@@ -0,0 +1,401 @@
+//*************************************************************************************
+/** \file spi_async.c
+ *    This file contains the DMA-driven SPI master. The queue is a singly linked
+ *    list of transfers, changed only with interrupts off. The transfer at its head
+ *    is the one on the bus; the DMAC interrupt handler takes it off when it is done
+ *    and starts the one behind it before doing anything else.
+ *
+ *    The DMAC moves at most 4095 bytes per block, so longer transfers are done in
+ *    chunks, each started by the handler when the one before it ends. Chip select
+ *    stays on between chunks, as the SPI only lets it go after a transfer marked
+ *    as the last.
+ */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <compiler.h>
+#include <interrupt.h>
+#include <sysclk.h>
+#include <ioport.h>
+#include <gpio.h>
+#include <spi.h>
+#include <dmac.h>
+#include <conf_spi_async.h>
+#include "cycle_counter.h"
+#include "spi_async.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#endif
+
+/// The most bytes the DMAC moves in one block
+#define SPI_ASYNC_CHUNK        0x0FFFUL
+
+/// The DMAC's BTC interrupt bit for a channel
+#define SPI_ASYNC_BTC(channel) (DMAC_EBCIER_BTC0 << (channel))
+
+/// Transfers queued, the one on the bus first
+static spi_async_xfer_t *queue_head;
+static spi_async_xfer_t *queue_tail;
+
+/// Sent when a transfer has no transmit buffer, and where unwanted bytes are read to
+static const uint8_t dummy_tx = 0xFF;
+static uint8_t dummy_rx;
+
+//------------------------------------------------------------------------------
+/** \brief Loads the next chunk of the transfer at the head of the queue into both
+ *  DMAC channels and starts them. The receiver's channel is started first, so it
+ *  is ready for the first byte.
+ */
+static void spi_async_start_chunk(void)
+{
+	spi_async_xfer_t *xfer = queue_head;
+	dma_transfer_descriptor_t desc;
+	uint32_t length = min(xfer->length - xfer->done_bytes, SPI_ASYNC_CHUNK);
+	Spi *spi = SPI_ASYNC_SPI;
+
+	desc.ul_source_addr = (uintptr_t) &spi->SPI_RDR;
+	desc.ul_destination_addr = (uintptr_t) ((xfer->rx != NULL)
+			? xfer->rx + xfer->done_bytes : &dummy_rx);
+	desc.ul_ctrlA = DMAC_CTRLA_BTSIZE(length) | DMAC_CTRLA_SRC_WIDTH_BYTE
+			| DMAC_CTRLA_DST_WIDTH_BYTE;
+	desc.ul_ctrlB = DMAC_CTRLB_SRC_DSCR_FETCH_DISABLE | DMAC_CTRLB_DST_DSCR_FETCH_DISABLE
+			| DMAC_CTRLB_FC_PER2MEM_DMA_FC | DMAC_CTRLB_SRC_INCR_FIXED
+			| ((xfer->rx != NULL) ? DMAC_CTRLB_DST_INCR_INCREMENTING
+			: DMAC_CTRLB_DST_INCR_FIXED);
+	desc.ul_descriptor_addr = 0;
+	dmac_channel_single_buf_transfer_init(DMAC, SPI_ASYNC_RX_CHANNEL, &desc);
+	dmac_channel_enable(DMAC, SPI_ASYNC_RX_CHANNEL);
+
+	desc.ul_source_addr = (uintptr_t) ((xfer->tx != NULL)
+			? xfer->tx + xfer->done_bytes : &dummy_tx);
+	desc.ul_destination_addr = (uintptr_t) &spi->SPI_TDR;
+	desc.ul_ctrlB = DMAC_CTRLB_SRC_DSCR_FETCH_DISABLE | DMAC_CTRLB_DST_DSCR_FETCH_DISABLE
+			| DMAC_CTRLB_FC_MEM2PER_DMA_FC | DMAC_CTRLB_DST_INCR_FIXED
+			| ((xfer->tx != NULL) ? DMAC_CTRLB_SRC_INCR_INCREMENTING
+			: DMAC_CTRLB_SRC_INCR_FIXED);
+	dmac_channel_single_buf_transfer_init(DMAC, SPI_ASYNC_TX_CHANNEL, &desc);
+	dmac_channel_enable(DMAC, SPI_ASYNC_TX_CHANNEL);
+
+	xfer->done_bytes += length;
+}
+
+/** \brief Sets the SPI up for the transfer at the head of the queue and starts
+ *  its first chunk.
+ */
+static void spi_async_start(void)
+{
+	spi_async_xfer_t *xfer = queue_head;
+	Spi *spi = SPI_ASYNC_SPI;
+	int16_t div = spi_calc_baudrate_div(xfer->clock_hz, sysclk_get_cpu_hz());
+
+	// The divider for the fastest rate at or below the one asked for
+	if ((div > 0) && (sysclk_get_cpu_hz() / (uint32_t) div > xfer->clock_hz)
+			&& (div < 255))
+	{
+		div++;
+	}
+	spi_set_baudrate_div(spi, xfer->cs, (uint8_t) ((div > 0) ? div : 255));
+	spi_set_bits_per_transfer(spi, xfer->cs, SPI_CSR_BITS_8_BIT);
+	spi_set_clock_polarity(spi, xfer->cs, xfer->mode >> 1);
+	spi_set_clock_phase(spi, xfer->cs, (xfer->mode & 0x01) ^ 0x01);
+	spi_configure_cs_behavior(spi, xfer->cs, SPI_CS_KEEP_LOW);
+	spi_set_peripheral_chip_select_value(spi, spi_get_pcs(xfer->cs));
+
+	// Throw away anything left over in the receiver
+	(void) spi->SPI_RDR;
+
+	xfer->done_bytes = 0;
+	spi_async_start_chunk();
+}
+
+/** \brief DMAC interrupt handler. It runs at the end of each chunk, when the last
+ *  byte has been read.
+ */
+void DMAC_Handler(void)
+{
+	uint32_t status = dmac_get_status(DMAC);
+	spi_async_xfer_t *xfer = queue_head;
+#ifdef _USE_FREERTOS_
+	BaseType_t woken = pdFALSE;
+#endif
+
+	if (!(status & SPI_ASYNC_BTC(SPI_ASYNC_RX_CHANNEL)) || (xfer == NULL))
+	{
+		return;
+	}
+	if (xfer->done_bytes < xfer->length)
+	{
+		spi_async_start_chunk();
+		return;
+	}
+
+	// Let chip select go, unless the next transfer is to carry on from this one
+	if (!xfer->hold_cs)
+	{
+		spi_set_lastxfer(SPI_ASYNC_SPI);
+	}
+
+	// Start the next transfer before telling anyone about this one, so the bus
+	// sits idle for as short a time as possible
+	queue_head = xfer->next;
+	if (queue_head == NULL)
+	{
+		queue_tail = NULL;
+	}
+	else
+	{
+		spi_async_start();
+	}
+
+	xfer->next = NULL;
+	xfer->busy = false;
+	if (xfer->callback != NULL)
+	{
+		xfer->callback(xfer);
+	}
+#ifdef _USE_FREERTOS_
+	if (xfer->waiter != NULL)
+	{
+		xSemaphoreGiveFromISR((SemaphoreHandle_t) xfer->waiter, &woken);
+	}
+	portEND_SWITCHING_ISR(woken);
+#endif
+}
+
+//------------------------------------------------------------------------------
+void spi_async_init(void)
+{
+	Spi *spi = SPI_ASYNC_SPI;
+
+#ifdef SPI0_MISO_GPIO
+	gpio_configure_pin(SPI0_MISO_GPIO, SPI0_MISO_FLAGS);
+	gpio_configure_pin(SPI0_MOSI_GPIO, SPI0_MOSI_FLAGS);
+	gpio_configure_pin(SPI0_SPCK_GPIO, SPI0_SPCK_FLAGS);
+	gpio_configure_pin(SPI0_NPCS0_GPIO, SPI0_NPCS0_FLAGS);
+#endif
+
+	sysclk_enable_peripheral_clock(SPI_ASYNC_ID);
+	spi_disable(spi);
+	spi_reset(spi);
+	spi_set_master_mode(spi);
+	spi_disable_mode_fault_detect(spi);
+	spi_disable_loopback(spi);
+	spi_set_fixed_peripheral_select(spi);
+	spi_enable(spi);
+
+	// The channels are handshaken by the SPI, and each starts on a fresh
+	// descriptor for every chunk
+	sysclk_enable_peripheral_clock(ID_DMAC);
+	dmac_init(DMAC);
+	dmac_set_priority_mode(DMAC, DMAC_PRIORITY_ROUND_ROBIN);
+	dmac_enable(DMAC);
+	dmac_channel_set_configuration(DMAC, SPI_ASYNC_TX_CHANNEL,
+			DMAC_CFG_DST_PER(SPI_ASYNC_TX_INTERFACE) | DMAC_CFG_DST_H2SEL
+			| DMAC_CFG_SOD | DMAC_CFG_FIFOCFG_ALAP_CFG);
+	dmac_channel_set_configuration(DMAC, SPI_ASYNC_RX_CHANNEL,
+			DMAC_CFG_SRC_PER(SPI_ASYNC_RX_INTERFACE) | DMAC_CFG_SRC_H2SEL
+			| DMAC_CFG_SOD | DMAC_CFG_FIFOCFG_ASAP_CFG);
+	dmac_enable_interrupt(DMAC, SPI_ASYNC_BTC(SPI_ASYNC_RX_CHANNEL));
+
+	NVIC_DisableIRQ(DMAC_IRQn);
+	NVIC_ClearPendingIRQ(DMAC_IRQn);
+	NVIC_SetPriority(DMAC_IRQn, SPI_ASYNC_IRQ_PRIORITY);
+	NVIC_EnableIRQ(DMAC_IRQn);
+
+	cycle_counter_enable();
+}
+
+bool spi_async_submit(spi_async_xfer_t *xfer)
+{
+	irqflags_t flags;
+
+	if (xfer->busy || (xfer->length == 0) || (xfer->clock_hz == 0)
+			|| (xfer->cs > 3) || (xfer->mode > 3))
+	{
+		return false;
+	}
+	xfer->next = NULL;
+	xfer->busy = true;
+
+	flags = cpu_irq_save();
+	if (queue_tail == NULL)
+	{
+		queue_head = queue_tail = xfer;
+		spi_async_start();
+	}
+	else
+	{
+		queue_tail->next = xfer;
+		queue_tail = xfer;
+	}
+	cpu_irq_restore(flags);
+	return true;
+}
+
+bool spi_async_transfer(spi_async_xfer_t *xfer)
+{
+#ifdef _USE_FREERTOS_
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+	{
+		if (xfer->waiter == NULL)
+		{
+			xfer->waiter = xSemaphoreCreateBinary();
+		}
+		if (xfer->waiter != NULL)
+		{
+			if (!spi_async_submit(xfer))
+			{
+				return false;
+			}
+			xSemaphoreTake((SemaphoreHandle_t) xfer->waiter, portMAX_DELAY);
+			return true;
+		}
+	}
+#endif
+	if (!spi_async_submit(xfer))
+	{
+		return false;
+	}
+	while (xfer->busy);
+	return true;
+}
+
+bool spi_async_is_idle(void)
+{
+	return queue_head == NULL;
+}
+
+//------------------------------------------------------------------------------
+/// Rates tried by the benchmark; the SPI runs at MCK divided by 1 to 255
+static const uint32_t bench_rates[] = { 1000000, 4000000, 10500000, 21000000, 42000000 };
+
+#define BENCH_RATES            (sizeof (bench_rates) / sizeof (bench_rates[0]))
+#define BENCH_XFERS            8
+#define BENCH_LENGTH           256
+
+/** \brief Counts how often an empty loop gets round in a number of cycles, with
+ *  nothing else running. The loop is the same as the one in spi_async_bench_dma().
+ */
+static uint32_t spi_async_bench_spins(uint32_t cycles)
+{
+	volatile uint32_t spins = 0;
+	uint32_t start = DWT->CYCCNT;
+
+	while ((uint32_t) (DWT->CYCCNT - start) < cycles)
+	{
+		spins++;
+	}
+	return spins;
+}
+
+/** \brief Sends a batch of queued transfers and waits for the last, counting how
+ *  often the loop gets round while it waits.
+ *  @param cycles Set to the cycles the batch took
+ *  @return How often the loop got round
+ */
+static uint32_t spi_async_bench_dma(spi_async_xfer_t *xfers, uint32_t *cycles)
+{
+	volatile uint32_t spins = 0;
+	uint32_t start = DWT->CYCCNT;
+	uint32_t i;
+
+	for (i = 0; i < BENCH_XFERS; i++)
+	{
+		spi_async_submit(&xfers[i]);
+	}
+	while (xfers[BENCH_XFERS - 1].busy)
+	{
+		spins++;
+	}
+	*cycles = DWT->CYCCNT - start;
+	return spins;
+}
+
+/** \brief Sends the same bytes as spi_async_bench_dma() one at a time, waiting
+ *  for each to come back, with the SPI set up by a queued transfer beforehand.
+ *  @return The cycles it took
+ */
+static uint32_t spi_async_bench_polled(const uint8_t *tx, uint8_t *rx)
+{
+	Spi *spi = SPI_ASYNC_SPI;
+	uint32_t start = DWT->CYCCNT;
+	uint32_t i;
+	uint32_t j;
+
+	for (i = 0; i < BENCH_XFERS; i++)
+	{
+		for (j = 0; j < BENCH_LENGTH; j++)
+		{
+			while (!(spi->SPI_SR & SPI_SR_TDRE));
+			spi->SPI_TDR = tx[j];
+			while (!(spi->SPI_SR & SPI_SR_RDRF));
+			rx[j] = (uint8_t) spi->SPI_RDR;
+		}
+		spi_set_lastxfer(spi);
+	}
+	return DWT->CYCCNT - start;
+}
+
+void spi_async_print_benchmark(uint8_t cs)
+{
+	static uint8_t tx[BENCH_LENGTH];
+	static uint8_t rx[BENCH_XFERS][BENCH_LENGTH];
+	spi_async_xfer_t xfers[BENCH_XFERS];
+	uint32_t dma_cycles[BENCH_RATES];
+	uint32_t dma_load[BENCH_RATES];
+	uint32_t poll_cycles[BENCH_RATES];
+	uint32_t bytes = BENCH_XFERS * BENCH_LENGTH;
+	uint32_t hz = sysclk_get_cpu_hz();
+	uint32_t idle;
+	uint32_t spins;
+	uint32_t r;
+	uint32_t i;
+
+	for (i = 0; i < BENCH_LENGTH; i++)
+	{
+		tx[i] = (uint8_t) i;
+	}
+
+	// Take all the measurements first, so printing can't get in their way
+	for (r = 0; r < BENCH_RATES; r++)
+	{
+		for (i = 0; i < BENCH_XFERS; i++)
+		{
+			xfers[i].tx = tx;
+			xfers[i].rx = rx[i];
+			xfers[i].length = BENCH_LENGTH;
+			xfers[i].clock_hz = bench_rates[r];
+			xfers[i].cs = cs;
+			xfers[i].mode = 0;
+			xfers[i].hold_cs = false;
+			xfers[i].callback = NULL;
+			xfers[i].arg = NULL;
+			xfers[i].busy = false;
+			xfers[i].waiter = NULL;
+		}
+
+		spins = spi_async_bench_dma(xfers, &dma_cycles[r]);
+		idle = spi_async_bench_spins(dma_cycles[r]);
+		dma_load[r] = (idle == 0 || spins >= idle) ? 0 : 100 - spins * 100 / idle;
+
+		// A one-byte transfer sets the SPI up at this rate for the polled loop
+		xfers[0].length = 1;
+		spi_async_transfer(&xfers[0]);
+		poll_cycles[r] = spi_async_bench_polled(tx, rx[0]);
+	}
+
+	printf("SPI benchmark, %lu transfers of %u bytes:\r\n", (unsigned long) BENCH_XFERS,
+			BENCH_LENGTH);
+	printf("  clock Hz      DMA bytes/s  CPU %%   polled bytes/s  CPU %%\r\n");
+	for (r = 0; r < BENCH_RATES; r++)
+	{
+		printf("  %-12lu  %-11lu  %-5lu  %-14lu  100\r\n",
+				(unsigned long) bench_rates[r],
+				(unsigned long) ((uint64_t) bytes * hz / dma_cycles[r]),
+				(unsigned long) dma_load[r],
+				(unsigned long) ((uint64_t) bytes * hz / poll_cycles[r]));
+	}
+}
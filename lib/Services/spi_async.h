@@ -0,0 +1,104 @@
+//*************************************************************************************
+/** \file spi_async.h
+ *    This file contains an SPI master which moves its data by DMA, so that the
+ *    processor is free while a transfer runs.
+ *
+ *    Each transfer is described by a spi_async_xfer_t, giving the chip select, SPI
+ *    mode, clock rate and buffers. Transfers from any number of tasks and interrupt
+ *    handlers go into one queue and are done in order. Two DMAC channels carry a
+ *    transfer's bytes, one filling the transmitter and one emptying the receiver,
+ *    and the receiver's channel interrupts when the last byte is in. The interrupt
+ *    handler then ends the transfer and starts the next one in the queue straight
+ *    away, so a run of queued transfers goes out back to back, without waiting for
+ *    any task to be scheduled in between.
+ *
+ *    When a transfer is done, its callback (if any) is run from the interrupt
+ *    handler. spi_async_transfer() queues a transfer and waits for it; under
+ *    FreeRTOS the waiting task is blocked rather than spinning. A transfer must
+ *    not be changed or queued again until it is done.
+ *
+ *    The SAM3X's SPI has no PDC channel, which is why the DMAC is used. The
+ *    controller, DMAC channels and interrupt priority are set in
+ *    lib/ASF_Config/conf_spi_async.h. To use the service, add spi_async to
+ *    SERVICES in the project Makefile. It takes over DMAC_Handler.
+ *    projects/ex13_frt_spi_async_cpp benchmarks it and runs a loopback test.
+ */
+//*************************************************************************************
+
+#ifndef _SPI_ASYNC_H_
+#define _SPI_ASYNC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct spi_async_xfer;
+
+/** \brief The function run from the interrupt handler when a transfer is done.
+ *  @param xfer The transfer
+ */
+typedef void (*spi_async_callback_t)(struct spi_async_xfer *xfer);
+
+/** \brief One SPI transfer. Set up the fields above \c next; the rest belong to
+ *  the service.
+ */
+typedef struct spi_async_xfer
+{
+	const uint8_t *tx;                 ///< Bytes to send, or NULL to send 0xFF
+	uint8_t *rx;                       ///< Where to put the bytes read, or NULL
+	uint32_t length;                   ///< Number of bytes each way
+	uint32_t clock_hz;                 ///< SPI clock; the nearest rate at or below
+	uint8_t cs;                        ///< Chip select, NPCS0 to NPCS3
+	uint8_t mode;                      ///< SPI mode, 0 to 3
+	bool hold_cs;                      ///< Leave chip select on, for the next transfer
+	spi_async_callback_t callback;     ///< Run when done, or NULL
+	void *arg;                         ///< For the callback's use
+
+	struct spi_async_xfer *next;       ///< The next transfer in the queue
+	uint32_t done_bytes;               ///< Bytes moved so far
+	volatile bool busy;                ///< Set while the transfer is queued or running
+	void *waiter;                      ///< Semaphore spi_async_transfer() waits on
+} spi_async_xfer_t;
+
+/** \brief Sets up the SPI controller as a master, its pins, and the DMAC. Call
+ *  this once.
+ */
+void spi_async_init(void);
+
+/** \brief Queues a transfer. It starts at once if the bus is idle. Safe to call
+ *  from tasks and interrupt handlers.
+ *  @param xfer The transfer
+ *  @return false if the transfer is already queued, or its settings can't be used
+ */
+bool spi_async_submit(spi_async_xfer_t *xfer);
+
+/** \brief Queues a transfer and waits for it to be done. Under FreeRTOS, once the
+ *  scheduler is running, the calling task is blocked while it waits; the first
+ *  call for a transfer creates the semaphore it waits on.
+ *  @param xfer The transfer
+ *  @return false if the transfer couldn't be queued
+ */
+bool spi_async_transfer(spi_async_xfer_t *xfer);
+
+/** \brief Returns true if no transfer is queued or running.
+ */
+bool spi_async_is_idle(void);
+
+/** \brief Measures throughput and CPU load at several SPI clock rates, both with
+ *  queued DMA transfers and with a polled loop for comparison, and prints them.
+ *  \details Nothing needs to be connected, as the bytes read are thrown away;
+ *  but whatever is on the chip select will see the traffic. Call this before the
+ *  scheduler starts, as the CPU load is measured by counting how often a loop
+ *  gets round while the transfers run.
+ *  @param cs The chip select to use
+ */
+void spi_async_print_benchmark(uint8_t cs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SPI_ASYNC_H_
@@ -0,0 +1,326 @@
+//*************************************************************************************
+/** \file systime.c
+ *    This file contains the clock and delay service. The clock is read with
+ *    interrupts off, so that the tick count and the SysTick value belong together:
+ *    if SysTick has reloaded but its interrupt hasn't run yet, the tick it owes is
+ *    added by hand. Every reading also folds the DWT cycle counter into a 64-bit
+ *    count, which is what the clock follows before any tick is running.
+ */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <compiler.h>
+#include <interrupt.h>
+#include <sysclk.h>
+#include <conf_systime.h>
+#include "cycle_counter.h"
+#include "systime.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#include <task.h>
+
+/// SysTick periods per second
+#define SYSTIME_HZ             configTICK_RATE_HZ
+#else
+#define SYSTIME_HZ             SYSTIME_TICK_HZ
+#endif
+
+/// Where the clock came from when it was last read
+#define SOURCE_NONE            0
+#define SOURCE_CYCLES          1
+#define SOURCE_TICKS           2
+
+/// The longest stretch spun on one reading of the cycle counter
+#define SPIN_CHUNK             0x40000000UL
+
+static uint32_t cycles_per_us;
+static uint32_t cycles_per_tick;
+static uint32_t us_per_tick;
+
+/// Cycles a short delay spends outside its spin loop, measured by systime_init()
+static uint32_t spin_overhead;
+
+/// Ticks counted by systime_tick(), and whether it has been called yet
+static uint64_t bare_ticks;
+static bool bare_ticking;
+
+#ifdef _USE_FREERTOS_
+/// The kernel's tick count when last read, and how often it has wrapped
+static uint32_t rtos_last_tick;
+static uint32_t rtos_tick_wraps;
+#endif
+
+/// The cycle counter when last read, and the cycles counted up to then
+static uint32_t dwt_last;
+static uint64_t dwt_cycles;
+
+/// The clock's source and value when last read, and what is added to the source
+/// so that the clock carries on from where it was when the source changes
+static uint8_t clock_source = SOURCE_NONE;
+static uint64_t clock_last;
+static uint64_t clock_offset;
+
+//------------------------------------------------------------------------------
+/** \brief Reads the count of SysTick periods, if one is running.
+ *  @param ticks Set to the count
+ *  @return Whether ticks are being counted
+ */
+static bool systime_read_ticks(uint64_t *ticks)
+{
+#ifdef _USE_FREERTOS_
+	if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+	{
+		uint32_t now = (uint32_t) xTaskGetTickCountFromISR();
+
+		if (now < rtos_last_tick)
+		{
+			rtos_tick_wraps++;
+		}
+		rtos_last_tick = now;
+		*ticks = ((uint64_t) rtos_tick_wraps << 32) | now;
+		return true;
+	}
+#endif
+	*ticks = bare_ticks;
+	return bare_ticking;
+}
+
+/** \brief Reads the clock.
+ *  @param into Set to the microseconds since the last tick; 0 if no tick is running
+ *  @return The time in microseconds
+ */
+static uint64_t systime_read(uint32_t *into)
+{
+	irqflags_t flags = cpu_irq_save();
+	uint32_t cycles = DWT->CYCCNT;
+	uint64_t ticks;
+	uint64_t now;
+	uint8_t source;
+
+	dwt_cycles += (uint32_t) (cycles - dwt_last);
+	dwt_last = cycles;
+	*into = 0;
+
+	if (systime_read_ticks(&ticks))
+	{
+		uint32_t val = SysTick->VAL;
+
+		if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+		{
+			ticks++;
+			val = SysTick->VAL;
+		}
+
+		// SysTick counts down to 0 once per tick. While tickless idle has it
+		// loaded for a longer sleep, the position in the tick isn't known.
+		if (val < cycles_per_tick)
+		{
+			*into = (cycles_per_tick - 1 - val) / cycles_per_us;
+		}
+		now = ticks * us_per_tick + *into;
+		source = SOURCE_TICKS;
+	}
+	else
+	{
+		now = dwt_cycles / cycles_per_us;
+		source = SOURCE_CYCLES;
+	}
+
+	if (source != clock_source)
+	{
+		clock_offset = (now < clock_last) ? clock_last - now : 0;
+		clock_source = source;
+	}
+	now += clock_offset;
+	if (now < clock_last)
+	{
+		now = clock_last;
+	}
+	clock_last = now;
+
+	cpu_irq_restore(flags);
+	return now;
+}
+
+/** \brief Spins until the cycle counter has moved on by a number of cycles.
+ *  @param start The cycle counter at the start
+ *  @param cycles The number of cycles
+ */
+static void systime_spin(uint32_t start, uint64_t cycles)
+{
+	while (cycles > SPIN_CHUNK)
+	{
+		while ((uint32_t) (DWT->CYCCNT - start) < SPIN_CHUNK);
+		start += SPIN_CHUNK;
+		cycles -= SPIN_CHUNK;
+	}
+	while ((uint32_t) (DWT->CYCCNT - start) < (uint32_t) cycles);
+}
+
+#ifdef _USE_FREERTOS_
+/** \brief Returns true if the caller may block: the scheduler is running, and it's
+ *  a task outside any critical section.
+ */
+static bool systime_can_sleep(void)
+{
+	return (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+			&& (__get_IPSR() == 0) && (__get_PRIMASK() == 0)
+			&& (__get_BASEPRI() == 0);
+}
+
+/** \brief Blocks for as many whole ticks as fit before a time, less the wake margin.
+ *  @param until The time to wake up before
+ */
+static void systime_sleep(uint64_t until)
+{
+	for (;;)
+	{
+		uint32_t into;
+		uint64_t now = systime_read(&into);
+		uint64_t ticks;
+
+		if (now + SYSTIME_WAKE_MARGIN_US >= until)
+		{
+			return;
+		}
+
+		// vTaskDelay(n) wakes up on the n-th tick from the last one
+		ticks = (until - SYSTIME_WAKE_MARGIN_US - now + into) / us_per_tick;
+		if (ticks == 0)
+		{
+			return;
+		}
+		vTaskDelay((TickType_t) ((ticks > portMAX_DELAY - 1) ? portMAX_DELAY - 1 : ticks));
+	}
+}
+#endif
+
+//------------------------------------------------------------------------------
+void systime_init(void)
+{
+	uint32_t into;
+	uint32_t i;
+
+	cycles_per_us = sysclk_get_cpu_hz() / 1000000UL;
+	cycles_per_tick = sysclk_get_cpu_hz() / SYSTIME_HZ;
+	us_per_tick = 1000000UL / SYSTIME_HZ;
+
+	cycle_counter_enable();
+	dwt_last = DWT->CYCCNT;
+	systime_read(&into);
+
+	// Time the shortest delay with no correction; whatever it takes beyond its
+	// microsecond is overhead
+	spin_overhead = 0;
+	for (i = 0; i < 8; i++)
+	{
+		uint32_t start = DWT->CYCCNT;
+		uint32_t taken;
+
+		systime_delay_us(1);
+		taken = DWT->CYCCNT - start - cycles_per_us;
+		if ((i == 0) || (taken < spin_overhead))
+		{
+			spin_overhead = taken;
+		}
+	}
+}
+
+void systime_tick(void)
+{
+	bare_ticks++;
+	bare_ticking = true;
+}
+
+uint64_t systime_now_us(void)
+{
+	uint32_t into;
+
+	return systime_read(&into);
+}
+
+uint64_t systime_now_ms(void)
+{
+	return systime_now_us() / 1000;
+}
+
+void systime_delay_until_us(uint64_t until)
+{
+	uint32_t start;
+	uint32_t into;
+	uint64_t now;
+
+#ifdef _USE_FREERTOS_
+	if (systime_can_sleep())
+	{
+		systime_sleep(until);
+	}
+#endif
+
+	start = DWT->CYCCNT;
+	now = systime_read(&into);
+	if (now < until)
+	{
+		systime_spin(start, (until - now) * cycles_per_us);
+	}
+}
+
+void systime_delay_us(uint32_t us)
+{
+	uint32_t start = DWT->CYCCNT;
+	uint64_t cycles = (uint64_t) us * cycles_per_us;
+
+#ifdef _USE_FREERTOS_
+	if ((us > us_per_tick + SYSTIME_WAKE_MARGIN_US) && systime_can_sleep())
+	{
+		systime_delay_until_us(systime_now_us() + us);
+		return;
+	}
+#endif
+
+	// Short delays are counted in cycles from the call, rather than on the
+	// microsecond clock, so they're accurate to a few cycles
+	systime_spin(start, (cycles > spin_overhead) ? cycles - spin_overhead : 0);
+}
+
+void systime_delay_ms(uint32_t ms)
+{
+	systime_delay_until_us(systime_now_us() + (uint64_t) ms * 1000);
+}
+
+void systime_print_accuracy(void)
+{
+	static const uint32_t lengths[] = { 1, 2, 5, 10, 50, 100, 1000, 10000, 100000 };
+	uint32_t i;
+	uint32_t run;
+
+	printf("\r\nDelay (us)  Error min  max (ns), overhead %lu cycles\r\n",
+			(unsigned long) spin_overhead);
+	for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+	{
+		int32_t lowest = 0;
+		int32_t highest = 0;
+
+		for (run = 0; run < 5; run++)
+		{
+			uint32_t start = DWT->CYCCNT;
+			int32_t error;
+
+			systime_delay_us(lengths[i]);
+			error = (int32_t) (DWT->CYCCNT - start - lengths[i] * cycles_per_us);
+			if ((run == 0) || (error < lowest))
+			{
+				lowest = error;
+			}
+			if ((run == 0) || (error > highest))
+			{
+				highest = error;
+			}
+		}
+		printf("%10lu %10ld %5ld\r\n", (unsigned long) lengths[i],
+				(long) lowest * 1000 / (long) cycles_per_us,
+				(long) highest * 1000 / (long) cycles_per_us);
+	}
+}
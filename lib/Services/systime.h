@@ -0,0 +1,82 @@
+//*************************************************************************************
+/** \file systime.h
+ *    This file contains a monotonic microsecond clock and delay functions which work
+ *    the same with and without FreeRTOS.
+ *
+ *    The clock counts SysTick periods and adds how far SysTick has got into the
+ *    current one. Under FreeRTOS the periods are the kernel's ticks, which tickless
+ *    idle keeps correct across sleep. Without FreeRTOS they are counted by
+ *    systime_tick(), which the project's SysTick_Handler has to call. Until either
+ *    kind of tick is running the clock follows the DWT cycle counter instead, which
+ *    must then be read at least every 51 seconds to notice it wrapping. The clock
+ *    never goes backwards. It does stand still while the FreeRTOS scheduler is
+ *    suspended, as the kernel holds back its ticks then.
+ *
+ *    A delay longer than a tick gives up the processor with vTaskDelay() up to the
+ *    last tick before it is due, when that's allowed: the scheduler must be running,
+ *    and the caller must be a task outside a critical section. The rest of the
+ *    delay, and all of it where giving up the processor isn't allowed, is spun out
+ *    on the DWT cycle counter. The time taken to call the function and set up the
+ *    spin is measured by systime_init() and taken off.
+ *
+ *    To use the service, add systime to SERVICES in the project Makefile and call
+ *    systime_init() once the clock is set up. Projects without FreeRTOS also need
+ *    to call systime_tick() from SysTick_Handler.
+ */
+//*************************************************************************************
+
+#ifndef _SYSTIME_H_
+#define _SYSTIME_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Starts the DWT cycle counter (without clearing it) and measures the
+ *  overhead of a delay call.
+ */
+void systime_init(void);
+
+/** \brief Counts a SysTick period. Projects without FreeRTOS call this from
+ *  SysTick_Handler; under FreeRTOS it isn't used.
+ */
+void systime_tick(void);
+
+/** \brief Returns the microseconds since the clock started. Safe to call from
+ *  tasks and interrupt handlers.
+ */
+uint64_t systime_now_us(void);
+
+/** \brief Returns the milliseconds since the clock started.
+ */
+uint64_t systime_now_ms(void);
+
+/** \brief Waits until the clock reaches a time.
+ *  @param until The time to wait for, from systime_now_us()
+ */
+void systime_delay_until_us(uint64_t until);
+
+/** \brief Waits for a number of microseconds.
+ *  @param us The time to wait
+ */
+void systime_delay_us(uint32_t us);
+
+/** \brief Waits for a number of milliseconds.
+ *  @param ms The time to wait
+ */
+void systime_delay_ms(uint32_t ms);
+
+/** \brief Times delays from 1 us to 100 ms against the cycle counter and prints
+ *  the smallest and largest error for each length.
+ *  \details The cycle counter stops while the processor sleeps, so call this
+ *  before the scheduler starts (or without FreeRTOS), when every delay is spun.
+ */
+void systime_print_accuracy(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SYSTIME_H_
@@ -0,0 +1,524 @@
+//*************************************************************************************
+/** \file timer_wheel.c
+ *    This file contains the timer wheel. The channel counts at MCK/2 (42 MHz on the
+ *    Due) from 0 to 0xFFFFFFFF and round again, and the RC compare interrupt is
+ *    moved to each event in turn. The wheel's own time, \c wheel_now, only moves
+ *    forward in the interrupt handler. It jumps from one event to the next, where
+ *    an event is either an occupied first-level slot coming due or an occupied
+ *    higher-level slot whose timers must move down. Nothing happens between two
+ *    events, so the wheel never has to step through the empty slots in between.
+ *
+ *    All the lists are changed with interrupts off, as timers may be started and
+ *    stopped from tasks, other interrupts and the callbacks themselves.
+ */
+//*************************************************************************************
+
+#include <compiler.h>
+#include <interrupt.h>
+#include <sysclk.h>
+#include <tc.h>
+#include <conf_timer_wheel.h>
+#include "timer_wheel.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#endif
+
+/// Number of levels in the wheel
+#define WHEEL_LEVELS           4
+
+/// Slots in the first level, which are a microsecond each
+#define WHEEL_SLOTS_0          256
+
+/// Slots in each higher level
+#define WHEEL_SLOTS_N          64
+
+/// Slots in the whole wheel
+#define WHEEL_SLOTS            (WHEEL_SLOTS_0 + (WHEEL_LEVELS - 1) * WHEEL_SLOTS_N)
+
+/// How far to shift a time right to get each level's slot number
+static const uint8_t level_shift[WHEEL_LEVELS] = { 0, 8, 14, 20 };
+
+/// Slot numbers in each level are masked with this
+static const uint16_t level_mask[WHEEL_LEVELS] = { 255, 63, 63, 63 };
+
+/// Index of each level's first slot in \c wheel_slots
+static const uint16_t level_first[WHEEL_LEVELS] = { 0, 256, 320, 384 };
+
+/// The timers in each slot
+static timer_wheel_timer_t *wheel_slots[WHEEL_SLOTS];
+
+/// One bit per slot, set when the slot holds a timer
+static uint32_t wheel_map[WHEEL_SLOTS / 32];
+
+/// The time up to which the wheel has been run, in microseconds
+static uint32_t wheel_now;
+
+/// The counter value matching \c count_us
+static uint32_t count_base;
+
+/// The time in microseconds when the counter read \c count_base
+static uint32_t count_us;
+
+/// Counter ticks per microsecond
+static uint32_t counts_per_us;
+
+/// Deferred timers which have expired, oldest first
+static timer_wheel_timer_t *deferred_head;
+static timer_wheel_timer_t *deferred_tail;
+
+#ifdef _USE_FREERTOS_
+/// Given by the interrupt handler when a deferred timer expires
+static SemaphoreHandle_t deferred_sem;
+#endif
+
+//------------------------------------------------------------------------------
+/** \brief Reads the counter and brings \c count_us up to date. Interrupts must be
+ *  off.
+ *  @return The time now, in microseconds
+ */
+static uint32_t wheel_read_time(void)
+{
+	uint32_t elapsed = (tc_read_cv(TIMER_WHEEL_TC, TIMER_WHEEL_CHANNEL) - count_base)
+			/ counts_per_us;
+
+	count_base += elapsed * counts_per_us;
+	count_us += elapsed;
+	return count_us;
+}
+
+/** \brief Puts a timer into the slot for its expiry time, as seen from
+ *  \c wheel_now. A timer that is already due goes into the current first-level
+ *  slot.
+ */
+static void wheel_insert(timer_wheel_timer_t *timer)
+{
+	uint32_t delta = timer->expires - wheel_now;
+	uint32_t level;
+	uint32_t index;
+
+	if ((int32_t) delta <= 0)
+	{
+		index = wheel_now & level_mask[0];
+	}
+	else if (delta < WHEEL_SLOTS_0)
+	{
+		index = timer->expires & level_mask[0];
+	}
+	else
+	{
+		// The lowest level whose slot for the expiry is less than a turn away
+		for (level = 1; level < WHEEL_LEVELS; level++)
+		{
+			uint32_t shift = level_shift[level];
+			uint32_t slots = (timer->expires >> shift) - (wheel_now >> shift);
+
+			if ((slots & (0xFFFFFFFFUL >> shift)) < WHEEL_SLOTS_N)
+			{
+				break;
+			}
+		}
+		if (level == WHEEL_LEVELS)
+		{
+			// Too far off for the wheel: wait in the top level's last slot and
+			// be put back in from there
+			level = WHEEL_LEVELS - 1;
+			index = (wheel_now >> level_shift[level]) + WHEEL_SLOTS_N - 1;
+		}
+		else
+		{
+			index = timer->expires >> level_shift[level];
+		}
+		index = level_first[level] + (index & level_mask[level]);
+	}
+
+	timer->slot = (uint16_t) index;
+	timer->next = wheel_slots[index];
+	if (timer->next != NULL)
+	{
+		timer->next->pprev = &timer->next;
+	}
+	timer->pprev = &wheel_slots[index];
+	wheel_slots[index] = timer;
+	wheel_map[index >> 5] |= 1UL << (index & 31);
+}
+
+/** \brief Takes a timer out of its slot. It must be in one.
+ */
+static void wheel_remove(timer_wheel_timer_t *timer)
+{
+	*timer->pprev = timer->next;
+	if (timer->next != NULL)
+	{
+		timer->next->pprev = timer->pprev;
+	}
+	if (wheel_slots[timer->slot] == NULL)
+	{
+		wheel_map[timer->slot >> 5] &= ~(1UL << (timer->slot & 31));
+	}
+	timer->pprev = NULL;
+}
+
+/** \brief Finds how many slots after the current one the next occupied slot in a
+ *  level is.
+ *  @param level The level to search
+ *  @param current The current slot number in that level
+ *  @return The number of slots to it, 0 if the current slot is occupied, or -1 if
+ *          the level is empty
+ */
+static int32_t wheel_next_in_level(uint32_t level, uint32_t current)
+{
+	const uint32_t *map = &wheel_map[level_first[level] >> 5];
+	uint32_t words = (level_mask[level] + 1) >> 5;
+	uint32_t word = current >> 5;
+	uint32_t bits = map[word] & (0xFFFFFFFFUL << (current & 31));
+	uint32_t i;
+
+	// Going one word past a full turn rereads the current word whole, which
+	// picks up the slots before the current one
+	for (i = 0; i <= words; i++)
+	{
+		if (bits != 0)
+		{
+			return (int32_t) ((((word << 5) + __builtin_ctz(bits)) - current)
+					& level_mask[level]);
+		}
+		word = (word + 1) & (words - 1);
+		bits = map[word];
+	}
+	return -1;
+}
+
+/** \brief Finds the next event: a first-level slot coming due, or a higher-level
+ *  slot whose timers have to move down. On a tie the higher level comes first, so
+ *  that timers moving down are run in the same pass.
+ *  @param level Set to the level of the event
+ *  @param when Set to the time of the event
+ *  @return Whether there is an event at all
+ */
+static bool wheel_next_event(uint32_t *level, uint32_t *when)
+{
+	bool found = false;
+	uint32_t soonest = 0;
+	int32_t lev;
+
+	for (lev = WHEEL_LEVELS - 1; lev >= 0; lev--)
+	{
+		uint32_t shift = level_shift[lev];
+		int32_t slots = wheel_next_in_level(lev, (wheel_now >> shift) & level_mask[lev]);
+		uint32_t at;
+
+		if (slots < 0)
+		{
+			continue;
+		}
+		if (slots == 0)
+		{
+			at = wheel_now;
+		}
+		else
+		{
+			at = ((wheel_now >> shift) + slots) << shift;
+		}
+		if (!found || (at - wheel_now) < soonest)
+		{
+			found = true;
+			soonest = at - wheel_now;
+			*level = lev;
+		}
+	}
+	*when = wheel_now + soonest;
+	return found;
+}
+
+/** \brief Hands an expired timer to its callback, or to the deferred list, and
+ *  puts a periodic timer back in the wheel.
+ */
+static void wheel_expire(timer_wheel_timer_t *timer)
+{
+	if (timer->period != 0)
+	{
+		timer->expires += timer->period;
+		if ((int32_t) (timer->expires - wheel_now) <= 0)
+		{
+			// Skip the expiries that were missed rather than running them late
+			uint32_t missed = (wheel_now - timer->expires) / timer->period + 1;
+
+			timer->expires += missed * timer->period;
+			timer->overruns += missed;
+		}
+		wheel_insert(timer);
+	}
+
+	if (timer->mode == TIMER_WHEEL_IN_ISR)
+	{
+		timer->callback(timer->arg);
+	}
+	else
+	{
+		if (timer->fired++ != 0)
+		{
+			timer->overruns++;
+		}
+		if (!timer->queued)
+		{
+			timer->queued = 1;
+			timer->deferred_next = NULL;
+			if (deferred_tail != NULL)
+			{
+				deferred_tail->deferred_next = timer;
+			}
+			else
+			{
+				deferred_head = timer;
+			}
+			deferred_tail = timer;
+		}
+	}
+}
+
+/** \brief Runs every event up to a time, then sets \c wheel_now to it.
+ *  @param until The time to run to
+ */
+static void wheel_run_until(uint32_t until)
+{
+	uint32_t level;
+	uint32_t when;
+
+	while (wheel_next_event(&level, &when) && (int32_t) (when - until) <= 0)
+	{
+		uint32_t index;
+
+		wheel_now = when;
+		index = level_first[level]
+				+ ((when >> level_shift[level]) & level_mask[level]);
+		while (wheel_slots[index] != NULL)
+		{
+			timer_wheel_timer_t *timer = wheel_slots[index];
+
+			wheel_remove(timer);
+			if (level == 0)
+			{
+				wheel_expire(timer);
+			}
+			else
+			{
+				wheel_insert(timer);
+			}
+		}
+	}
+	wheel_now = until;
+}
+
+/** \brief Sets the compare register for the next event. Interrupts must be off.
+ *  @return False if the event is already due, in which case the caller must run
+ *          the wheel again (or have the interrupt handler do it)
+ */
+static bool wheel_program(void)
+{
+	uint32_t level;
+	uint32_t when;
+	uint32_t ahead;
+	uint32_t compare;
+
+	if (!wheel_next_event(&level, &when)
+			|| (when - wheel_now) > TIMER_WHEEL_MAX_SLEEP_US)
+	{
+		when = wheel_now + TIMER_WHEEL_MAX_SLEEP_US;
+	}
+
+	ahead = when - wheel_read_time();
+	if ((int32_t) ahead <= 0)
+	{
+		return false;
+	}
+	compare = count_base + ahead * counts_per_us;
+	tc_write_rc(TIMER_WHEEL_TC, TIMER_WHEEL_CHANNEL, compare);
+
+	// The compare only matches on equality, so make sure the counter hadn't got
+	// there while the register was being written
+	return (int32_t) (compare - tc_read_cv(TIMER_WHEEL_TC, TIMER_WHEEL_CHANNEL)) > 0;
+}
+
+/** \brief Interrupt handler for the timer wheel's channel.
+ */
+void TIMER_WHEEL_Handler(void)
+{
+	timer_wheel_timer_t *deferred = deferred_head;
+
+	tc_get_status(TIMER_WHEEL_TC, TIMER_WHEEL_CHANNEL);
+	do
+	{
+		wheel_run_until(wheel_read_time());
+	} while (!wheel_program());
+
+#ifdef _USE_FREERTOS_
+	if ((deferred_head != deferred) && (deferred_sem != NULL))
+	{
+		BaseType_t woken = pdFALSE;
+
+		xSemaphoreGiveFromISR(deferred_sem, &woken);
+		portEND_SWITCHING_ISR(woken);
+	}
+#else
+	(void) deferred;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void timer_wheel_init(void)
+{
+	irqflags_t flags;
+
+	sysclk_enable_peripheral_clock(TIMER_WHEEL_ID);
+	counts_per_us = sysclk_get_peripheral_hz() / 2 / 1000000UL;
+
+	// Free running from 0 to 0xFFFFFFFF, with the RC compare only raising an
+	// interrupt
+	tc_init(TIMER_WHEEL_TC, TIMER_WHEEL_CHANNEL,
+			TC_CMR_TCCLKS_TIMER_CLOCK1 | TC_CMR_WAVE | TC_CMR_WAVSEL_UP);
+
+	flags = cpu_irq_save();
+	tc_start(TIMER_WHEEL_TC, TIMER_WHEEL_CHANNEL);
+	wheel_now = 0;
+	count_us = 0;
+	count_base = tc_read_cv(TIMER_WHEEL_TC, TIMER_WHEEL_CHANNEL);
+	tc_write_rc(TIMER_WHEEL_TC, TIMER_WHEEL_CHANNEL,
+			count_base + TIMER_WHEEL_MAX_SLEEP_US * counts_per_us);
+	cpu_irq_restore(flags);
+
+	NVIC_DisableIRQ((IRQn_Type) TIMER_WHEEL_ID);
+	NVIC_ClearPendingIRQ((IRQn_Type) TIMER_WHEEL_ID);
+	NVIC_SetPriority((IRQn_Type) TIMER_WHEEL_ID, TIMER_WHEEL_IRQ_PRIORITY);
+	NVIC_EnableIRQ((IRQn_Type) TIMER_WHEEL_ID);
+	tc_enable_interrupt(TIMER_WHEEL_TC, TIMER_WHEEL_CHANNEL, TC_IER_CPCS);
+}
+
+void timer_wheel_setup(timer_wheel_timer_t *timer, timer_wheel_callback_t callback,
+		void *arg, uint8_t mode)
+{
+	timer->next = NULL;
+	timer->pprev = NULL;
+	timer->expires = 0;
+	timer->period = 0;
+	timer->callback = callback;
+	timer->arg = arg;
+	timer->deferred_next = NULL;
+	timer->slot = 0;
+	timer->mode = mode;
+	timer->queued = 0;
+	timer->fired = 0;
+	timer->overruns = 0;
+}
+
+void timer_wheel_start(timer_wheel_timer_t *timer, uint32_t delay_us,
+		uint32_t period_us)
+{
+	irqflags_t flags = cpu_irq_save();
+
+	if (timer->pprev != NULL)
+	{
+		wheel_remove(timer);
+	}
+	timer->expires = wheel_read_time() + delay_us;
+	timer->period = period_us;
+	timer->fired = 0;
+	wheel_insert(timer);
+
+	// The handler reprograms the compare itself when it's done with the callbacks
+	if (!wheel_program())
+	{
+		NVIC_SetPendingIRQ((IRQn_Type) TIMER_WHEEL_ID);
+	}
+	cpu_irq_restore(flags);
+}
+
+void timer_wheel_stop(timer_wheel_timer_t *timer)
+{
+	irqflags_t flags = cpu_irq_save();
+
+	if (timer->pprev != NULL)
+	{
+		wheel_remove(timer);
+	}
+	timer->fired = 0;
+	cpu_irq_restore(flags);
+}
+
+bool timer_wheel_is_running(const timer_wheel_timer_t *timer)
+{
+	return timer->pprev != NULL;
+}
+
+uint32_t timer_wheel_now_us(void)
+{
+	irqflags_t flags = cpu_irq_save();
+	uint32_t now = wheel_read_time();
+
+	cpu_irq_restore(flags);
+	return now;
+}
+
+uint32_t timer_wheel_run_deferred(void)
+{
+	uint32_t runs = 0;
+
+	for (;;)
+	{
+		irqflags_t flags = cpu_irq_save();
+		timer_wheel_timer_t *timer = deferred_head;
+		uint32_t fired;
+
+		if (timer == NULL)
+		{
+			cpu_irq_restore(flags);
+			break;
+		}
+		deferred_head = timer->deferred_next;
+		if (deferred_head == NULL)
+		{
+			deferred_tail = NULL;
+		}
+		timer->queued = 0;
+		fired = timer->fired;
+		timer->fired = 0;
+		cpu_irq_restore(flags);
+
+		// A timer stopped after it expired has had its count cleared
+		if (fired != 0)
+		{
+			timer->callback(timer->arg);
+			runs++;
+		}
+	}
+	return runs;
+}
+
+#ifdef _USE_FREERTOS_
+/** \brief The task which runs deferred callbacks when the handler signals it.
+ *  @param params Not used
+ */
+static void timer_wheel_task(void *params)
+{
+	(void) params;
+
+	for (;;)
+	{
+		xSemaphoreTake(deferred_sem, portMAX_DELAY);
+		timer_wheel_run_deferred();
+	}
+}
+
+long timer_wheel_start_task(unsigned long priority)
+{
+	deferred_sem = xSemaphoreCreateBinary();
+	if (deferred_sem == NULL)
+	{
+		return pdFAIL;
+	}
+	return xTaskCreate(timer_wheel_task, "Wheel", TIMER_WHEEL_TASK_STACK_SIZE, NULL,
+			(UBaseType_t) priority, NULL);
+}
+#endif
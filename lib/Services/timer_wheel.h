@@ -0,0 +1,131 @@
+//*************************************************************************************
+/** \file timer_wheel.h
+ *    This file contains a timer service with microsecond resolution for periodic
+ *    and one-shot jobs too fast or too precise for the 1 ms RTOS tick. One
+ *    free-running 32-bit timer counter channel keeps time. Its compare interrupt is
+ *    set for the next thing the wheel has to do, so it fires once per expiry rather
+ *    than once per tick, however many timers are running.
+ *
+ *    Timers are kept in a hierarchical wheel. The first level has 256 slots, one per
+ *    microsecond. The three levels above it have 64 slots each, 256 us, 16 ms and
+ *    1 s wide. A timer goes straight into the slot of its expiry time, so starting
+ *    and stopping one takes constant time. When the first level gets to the start of
+ *    a slot in a higher level, the timers there move down a level. A bitmap of
+ *    occupied slots finds the next expiry in a few word reads. Timers more than
+ *    about a minute off wait in the top level and are moved again as needed, so
+ *    delays up to 2^31 us (35 minutes) work.
+ *
+ *    Each timer's callback runs either in the timer interrupt, for jitter of a few
+ *    microseconds, or later in task context. Deferred callbacks are run by a task
+ *    under FreeRTOS (timer_wheel_start_task()), or by calling
+ *    timer_wheel_run_deferred() from a main loop otherwise. If a deferred timer
+ *    expires again before its callback has run, the callback runs once and the
+ *    missed run is counted in \c overruns.
+ *
+ *    The timer objects belong to the caller; the service allocates nothing, so any
+ *    number can run at once. The channel and interrupt priority are set in
+ *    lib/ASF_Config/conf_timer_wheel.h. To use the service, add timer_wheel to
+ *    SERVICES in the project Makefile and call timer_wheel_init().
+ *    projects/ex10_frt_timer_wheel_cpp runs a job every 500 us with it.
+ */
+//*************************************************************************************
+
+#ifndef _TIMER_WHEEL_H_
+#define _TIMER_WHEEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Run the callback in the timer interrupt
+#define TIMER_WHEEL_IN_ISR     0
+
+/// Run the callback later, in task context
+#define TIMER_WHEEL_DEFERRED   1
+
+/** \brief The function a timer calls when it expires.
+ *  @param arg The argument given to timer_wheel_setup()
+ */
+typedef void (*timer_wheel_callback_t)(void *arg);
+
+/** \brief A timer. Set it up with timer_wheel_setup(); the fields other than
+ *  \c overruns belong to the service.
+ */
+typedef struct timer_wheel_timer
+{
+	struct timer_wheel_timer *next;    ///< Next timer in the same slot
+	struct timer_wheel_timer **pprev;  ///< The pointer to this timer, or NULL
+	uint32_t expires;                  ///< Time of the next expiry, in microseconds
+	uint32_t period;                   ///< Microseconds between expiries; 0 if one-shot
+	timer_wheel_callback_t callback;   ///< The function to call
+	void *arg;                         ///< Its argument
+	struct timer_wheel_timer *deferred_next; ///< Next timer waiting for the task
+	uint16_t slot;                     ///< The slot the timer is in
+	uint8_t mode;                      ///< TIMER_WHEEL_IN_ISR or TIMER_WHEEL_DEFERRED
+	uint8_t queued;                    ///< Whether the timer is waiting for the task
+	uint32_t fired;                    ///< Expiries the task hasn't handled yet
+	uint32_t overruns;                 ///< Expiries that were missed or merged
+} timer_wheel_timer_t;
+
+/** \brief Starts the timer counter channel and enables its interrupt. Call this
+ *  once, before starting any timers.
+ */
+void timer_wheel_init(void);
+
+/** \brief Prepares a timer. It must not be running.
+ *  @param timer The timer
+ *  @param callback The function to call when the timer expires
+ *  @param arg The argument to pass to \p callback
+ *  @param mode TIMER_WHEEL_IN_ISR or TIMER_WHEEL_DEFERRED
+ */
+void timer_wheel_setup(timer_wheel_timer_t *timer, timer_wheel_callback_t callback,
+		void *arg, uint8_t mode);
+
+/** \brief Starts a timer, restarting it if it is already running. A deferred
+ *  callback from an earlier expiry that hasn't run yet is cancelled. Safe to call
+ *  from tasks, from interrupt handlers and from callbacks, including the timer's own.
+ *  @param timer The timer
+ *  @param delay_us Microseconds from now to the first expiry, less than 2^31
+ *  @param period_us Microseconds between later expiries, or 0 for a one-shot timer
+ */
+void timer_wheel_start(timer_wheel_timer_t *timer, uint32_t delay_us,
+		uint32_t period_us);
+
+/** \brief Stops a timer, and cancels a deferred callback that hasn't run yet.
+ *  Stopping a timer that isn't running does nothing.
+ *  @param timer The timer
+ */
+void timer_wheel_stop(timer_wheel_timer_t *timer);
+
+/** \brief Returns whether a timer is waiting to expire.
+ *  @param timer The timer
+ */
+bool timer_wheel_is_running(const timer_wheel_timer_t *timer);
+
+/** \brief Returns the time in microseconds since timer_wheel_init(). It wraps
+ *  every 71 minutes, so compare times by their unsigned difference.
+ */
+uint32_t timer_wheel_now_us(void);
+
+/** \brief Runs the callbacks of deferred timers that have expired.
+ *  @return The number of callbacks run
+ */
+uint32_t timer_wheel_run_deferred(void);
+
+/** \brief Creates a task which runs deferred callbacks as soon as their timers
+ *  expire.
+ *  \details This is only built into projects that use FreeRTOS; others should call
+ *  timer_wheel_run_deferred() from their main loop instead.
+ *  @param priority The task's priority; deferred callbacks run at this priority
+ *  @return pdPASS if the task was created
+ */
+long timer_wheel_start_task(unsigned long priority);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TIMER_WHEEL_H_
@@ -0,0 +1,343 @@
+//*************************************************************************************
+/** \file twi_async.c
+ *    This file contains the interrupt-driven I2C manager. The queue is a singly
+ *    linked list of requests, changed only with interrupts off. The requests at
+ *    its head which share the bus transaction in progress are its batch. The
+ *    interrupt handler moves one byte per interrupt, filling each request of a
+ *    batched read in turn, and when the transaction ends it takes the whole batch
+ *    off the queue and starts the next one before doing anything else.
+ */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <compiler.h>
+#include <interrupt.h>
+#include <sysclk.h>
+#include <ioport.h>
+#include <gpio.h>
+#include <twi.h>
+#include <conf_twi_async.h>
+#include "twi_async.h"
+
+#ifdef _USE_FREERTOS_
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#endif
+
+/// The interrupts which end a transaction early
+#define TWI_ASYNC_ERRORS       (TWI_SR_NACK | TWI_SR_ARBLST)
+
+/// Requests queued, the ones on the bus first
+static twi_async_req_t *queue_head;
+static twi_async_req_t *queue_tail;
+
+/// The last request in the batch at the head of the queue
+static twi_async_req_t *batch_last;
+
+/// Bytes in the batch's transaction
+static uint32_t batch_length;
+
+/// Times the batch has been tried again
+static uint8_t batch_retries;
+
+/// The request the next byte goes to or comes from, and where in it
+static twi_async_req_t *xfer_req;
+static uint32_t xfer_index;
+
+/// Bytes still to come in the transaction
+static uint32_t xfer_left;
+
+/// The counts since the manager was started
+static twi_async_stats_t stats;
+
+//------------------------------------------------------------------------------
+/** \brief Starts the transaction for the batch at the head of the queue, from
+ *  its first byte.
+ */
+static void twi_async_start_transaction(void)
+{
+	Twi *twi = TWI_ASYNC_TWI;
+	twi_async_req_t *req = queue_head;
+
+	xfer_req = req;
+	xfer_index = 0;
+	xfer_left = batch_length;
+	stats.transactions++;
+
+	twi->TWI_MMR = 0;
+	twi->TWI_MMR = TWI_MMR_DADR(req->device) | TWI_MMR_IADRSZ_1_BYTE
+			| (req->write ? 0 : TWI_MMR_MREAD);
+	twi->TWI_IADR = req->reg;
+
+	if (req->write)
+	{
+		// Writing the first byte starts the transaction
+		twi->TWI_THR = req->data[xfer_index++];
+		xfer_left--;
+		twi_enable_interrupt(twi, TWI_IER_TXRDY | TWI_ASYNC_ERRORS);
+	}
+	else
+	{
+		// The stop has to be asked for while the last byte is coming in, so for
+		// a single byte that's straight away
+		twi->TWI_CR = (xfer_left == 1) ? (TWI_CR_START | TWI_CR_STOP) : TWI_CR_START;
+		twi_enable_interrupt(twi, TWI_IER_RXRDY | TWI_ASYNC_ERRORS);
+	}
+}
+
+/** \brief Makes a batch of the request at the head of the queue and any reads
+ *  behind it which carry on from it in the same device, and starts it.
+ */
+static void twi_async_begin(void)
+{
+	twi_async_req_t *req = queue_head;
+	twi_async_req_t *next;
+
+	batch_last = req;
+	batch_length = req->length;
+	batch_retries = 0;
+	if (!req->write)
+	{
+		for (next = req->next; next != NULL; next = next->next)
+		{
+			if (next->write || (next->device != req->device)
+					|| ((uint32_t) next->reg != batch_last->reg + batch_last->length)
+					|| (batch_length + next->length > TWI_ASYNC_BATCH_MAX))
+			{
+				break;
+			}
+			batch_last = next;
+			batch_length += next->length;
+			stats.batched++;
+		}
+	}
+	twi_async_start_transaction();
+}
+
+/** \brief Takes the batch off the queue, starts the next one, and then tells each
+ *  request in the batch how it went.
+ *  @param status How the batch went
+ */
+static void twi_async_finish(twi_async_status_t status)
+{
+	twi_async_req_t *req = queue_head;
+	twi_async_req_t *last = batch_last;
+	twi_async_req_t *next;
+#ifdef _USE_FREERTOS_
+	BaseType_t woken = pdFALSE;
+#endif
+
+	queue_head = last->next;
+	if (queue_head == NULL)
+	{
+		queue_tail = NULL;
+	}
+	else
+	{
+		twi_async_begin();
+	}
+
+	for (;;)
+	{
+		next = req->next;
+		req->next = NULL;
+		req->status = status;
+		stats.requests++;
+		if (status != TWI_ASYNC_DONE)
+		{
+			stats.failed++;
+		}
+		if (req->callback != NULL)
+		{
+			req->callback(req);
+		}
+#ifdef _USE_FREERTOS_
+		if (req->waiter != NULL)
+		{
+			xSemaphoreGiveFromISR((SemaphoreHandle_t) req->waiter, &woken);
+		}
+#endif
+		if (req == last)
+		{
+			break;
+		}
+		req = next;
+	}
+#ifdef _USE_FREERTOS_
+	portEND_SWITCHING_ISR(woken);
+#endif
+}
+
+/** \brief TWI interrupt handler. It runs once per byte, and once more when the
+ *  transaction has ended.
+ */
+void TWI_ASYNC_Handler(void)
+{
+	Twi *twi = TWI_ASYNC_TWI;
+	uint32_t status = twi_get_interrupt_status(twi) & twi_get_interrupt_mask(twi);
+
+	if (status & TWI_ASYNC_ERRORS)
+	{
+		// The controller has already let the bus go
+		twi_disable_interrupt(twi, 0xFFFFFFFF);
+		if (status & TWI_SR_NACK)
+		{
+			stats.nacks++;
+		}
+		else
+		{
+			stats.arb_lost++;
+		}
+		if (batch_retries < TWI_ASYNC_RETRIES)
+		{
+			batch_retries++;
+			stats.retries++;
+			twi_async_start_transaction();
+		}
+		else
+		{
+			twi_async_finish((status & TWI_SR_NACK) ? TWI_ASYNC_NACK : TWI_ASYNC_ARB_LOST);
+		}
+	}
+	else if (status & TWI_SR_RXRDY)
+	{
+		xfer_req->data[xfer_index++] = (uint8_t) twi->TWI_RHR;
+		if ((xfer_index == xfer_req->length) && (xfer_req != batch_last))
+		{
+			xfer_req = xfer_req->next;
+			xfer_index = 0;
+		}
+		xfer_left--;
+		if (xfer_left == 1)
+		{
+			twi->TWI_CR = TWI_CR_STOP;
+		}
+		else if (xfer_left == 0)
+		{
+			twi_disable_interrupt(twi, TWI_IDR_RXRDY);
+			twi_enable_interrupt(twi, TWI_IER_TXCOMP);
+		}
+	}
+	else if (status & TWI_SR_TXRDY)
+	{
+		if (xfer_left > 0)
+		{
+			twi->TWI_THR = xfer_req->data[xfer_index++];
+			xfer_left--;
+		}
+		else
+		{
+			twi->TWI_CR = TWI_CR_STOP;
+			twi_disable_interrupt(twi, TWI_IDR_TXRDY);
+			twi_enable_interrupt(twi, TWI_IER_TXCOMP);
+		}
+	}
+	else if (status & TWI_SR_TXCOMP)
+	{
+		twi_disable_interrupt(twi, 0xFFFFFFFF);
+		twi_async_finish(TWI_ASYNC_DONE);
+	}
+}
+
+//------------------------------------------------------------------------------
+bool twi_async_init(void)
+{
+	twi_options_t options;
+
+	gpio_configure_pin(TWI_ASYNC_DATA_GPIO, TWI_ASYNC_DATA_FLAGS);
+	gpio_configure_pin(TWI_ASYNC_CLK_GPIO, TWI_ASYNC_CLK_FLAGS);
+
+	sysclk_enable_peripheral_clock(TWI_ASYNC_ID);
+	options.master_clk = sysclk_get_peripheral_hz();
+	options.speed = TWI_ASYNC_CLOCK_HZ;
+	options.chip = 0;
+	options.smbus = 0;
+	if (twi_master_init(TWI_ASYNC_TWI, &options) != TWI_SUCCESS)
+	{
+		return false;
+	}
+	twi_disable_interrupt(TWI_ASYNC_TWI, 0xFFFFFFFF);
+
+	NVIC_DisableIRQ(TWI_ASYNC_IRQn);
+	NVIC_ClearPendingIRQ(TWI_ASYNC_IRQn);
+	NVIC_SetPriority(TWI_ASYNC_IRQn, TWI_ASYNC_IRQ_PRIORITY);
+	NVIC_EnableIRQ(TWI_ASYNC_IRQn);
+	return true;
+}
+
+bool twi_async_submit(twi_async_req_t *req)
+{
+	irqflags_t flags;
+
+	if ((req->status == TWI_ASYNC_QUEUED) || (req->length == 0) || (req->data == NULL)
+			|| (req->device > 0x7F))
+	{
+		return false;
+	}
+	req->next = NULL;
+	req->status = TWI_ASYNC_QUEUED;
+
+	flags = cpu_irq_save();
+	if (queue_tail == NULL)
+	{
+		queue_head = queue_tail = req;
+		twi_async_begin();
+	}
+	else
+	{
+		queue_tail->next = req;
+		queue_tail = req;
+	}
+	cpu_irq_restore(flags);
+	return true;
+}
+
+twi_async_status_t twi_async_transfer(twi_async_req_t *req)
+{
+#ifdef _USE_FREERTOS_
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+	{
+		if (req->waiter == NULL)
+		{
+			req->waiter = xSemaphoreCreateBinary();
+		}
+		if (req->waiter != NULL)
+		{
+			if (!twi_async_submit(req))
+			{
+				return TWI_ASYNC_QUEUED;
+			}
+			xSemaphoreTake((SemaphoreHandle_t) req->waiter, portMAX_DELAY);
+			return req->status;
+		}
+	}
+#endif
+	if (!twi_async_submit(req))
+	{
+		return TWI_ASYNC_QUEUED;
+	}
+	while (req->status == TWI_ASYNC_QUEUED);
+	return req->status;
+}
+
+void twi_async_get_stats(twi_async_stats_t *copy)
+{
+	irqflags_t flags = cpu_irq_save();
+
+	*copy = stats;
+	cpu_irq_restore(flags);
+}
+
+void twi_async_print_stats(void)
+{
+	twi_async_stats_t copy;
+
+	twi_async_get_stats(&copy);
+	printf("I2C: %lu requests (%lu batched) in %lu transactions; %lu NACKs, "
+			"%lu arbitration lost, %lu retries, %lu failed\r\n",
+			(unsigned long) copy.requests, (unsigned long) copy.batched,
+			(unsigned long) copy.transactions, (unsigned long) copy.nacks,
+			(unsigned long) copy.arb_lost, (unsigned long) copy.retries,
+			(unsigned long) copy.failed);
+}
@@ -0,0 +1,125 @@
+//*************************************************************************************
+/** \file twi_async.h
+ *    This file contains an I2C bus manager which several tasks can share. Register
+ *    reads and writes are queued and carried out by the TWI interrupt handler, so
+ *    no task polls the bus.
+ *
+ *    Each request reads or writes a run of registers in one device, starting at a
+ *    given register address. Requests are done in the order they were queued.
+ *    When a read reaches the head of the queue, any reads queued behind it from
+ *    the same device which carry on where it leaves off are taken along in the
+ *    same bus transaction. Most devices step their register address after each
+ *    byte, so one transaction then fills all the buffers, with one address phase
+ *    instead of one each. For example, reads of a device's accelerometer,
+ *    temperature and gyro registers in turn cost one transaction if they are
+ *    queued together.
+ *
+ *    If the device doesn't acknowledge, or another master wins the bus, the whole
+ *    transaction is tried again, up to TWI_ASYNC_RETRIES times, before the
+ *    requests in it fail. The counts of errors, retries and failures are kept.
+ *
+ *    When a request is done, its callback (if any) is run from the interrupt
+ *    handler. twi_async_transfer() queues a request and waits for it; under
+ *    FreeRTOS the waiting task is blocked rather than spinning. A request must not
+ *    be changed or queued again until it is done.
+ *
+ *    The controller, bus clock and retry count are set in
+ *    lib/ASF_Config/conf_twi_async.h. To use the service, add twi_async to
+ *    SERVICES in the project Makefile. It takes over the controller's interrupt
+ *    handler. projects/ex14_frt_twi_async_cpp polls an MPU-6050 with it.
+ */
+//*************************************************************************************
+
+#ifndef _TWI_ASYNC_H_
+#define _TWI_ASYNC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief How a request turned out.
+ */
+typedef enum twi_async_status
+{
+	TWI_ASYNC_DONE,                    ///< Done
+	TWI_ASYNC_QUEUED,                  ///< Queued or on the bus
+	TWI_ASYNC_NACK,                    ///< The device didn't acknowledge, every try
+	TWI_ASYNC_ARB_LOST                 ///< Another master kept winning the bus
+} twi_async_status_t;
+
+struct twi_async_req;
+
+/** \brief The function run from the interrupt handler when a request is done.
+ *  @param req The request; its status says how it went
+ */
+typedef void (*twi_async_callback_t)(struct twi_async_req *req);
+
+/** \brief One register read or write. Set up the fields above \c next; the rest
+ *  belong to the manager.
+ */
+typedef struct twi_async_req
+{
+	uint8_t device;                    ///< The device's 7-bit address
+	uint8_t reg;                       ///< The first register's address
+	bool write;                        ///< Write the registers rather than read them
+	uint8_t *data;                     ///< The bytes to write, or the buffer to read into
+	uint32_t length;                   ///< Number of bytes, at least 1
+	twi_async_callback_t callback;     ///< Run when done, or NULL
+	void *arg;                         ///< For the callback's use
+
+	struct twi_async_req *next;        ///< The next request in the queue
+	volatile twi_async_status_t status;    ///< How the request turned out
+	void *waiter;                      ///< Semaphore twi_async_transfer() waits on
+} twi_async_req_t;
+
+/** \brief The counts since the manager was started.
+ */
+typedef struct twi_async_stats
+{
+	uint32_t requests;                 ///< Requests done, whether they worked or not
+	uint32_t transactions;             ///< Bus transactions begun, retries included
+	uint32_t batched;                  ///< Requests which shared another's transaction
+	uint32_t nacks;                    ///< Transactions the device didn't acknowledge
+	uint32_t arb_lost;                 ///< Transactions in which arbitration was lost
+	uint32_t retries;                  ///< Transactions tried again
+	uint32_t failed;                   ///< Requests which failed after every retry
+} twi_async_stats_t;
+
+/** \brief Sets up the TWI controller as a master and its pins. Call this once.
+ *  @return false if the bus clock can't be set
+ */
+bool twi_async_init(void);
+
+/** \brief Queues a request. It starts at once if the bus is idle. Safe to call
+ *  from tasks and interrupt handlers.
+ *  @param req The request
+ *  @return false if the request is already queued, or its settings can't be used
+ */
+bool twi_async_submit(twi_async_req_t *req);
+
+/** \brief Queues a request and waits for it to be done. Under FreeRTOS, once the
+ *  scheduler is running, the calling task is blocked while it waits; the first
+ *  call for a request creates the semaphore it waits on.
+ *  @param req The request
+ *  @return How the request turned out, or TWI_ASYNC_QUEUED if it couldn't be
+ *          queued
+ */
+twi_async_status_t twi_async_transfer(twi_async_req_t *req);
+
+/** \brief Returns the counts since the manager was started.
+ *  @param stats Filled in with the counts
+ */
+void twi_async_get_stats(twi_async_stats_t *stats);
+
+/** \brief Prints the counts since the manager was started.
+ */
+void twi_async_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TWI_ASYNC_H_
@@ -9,10 +9,7 @@
 
 // Includes for convenience
 #include "shares.h"
-
-/** \brief IRQ priority for PIO (The lower the value, the greater the priority) 
- */
-#define IRQ_PRIOR_PIO    0
+#include "lib/Services/gpio_input.h"
 
 // Rather than skulking around, trying to cast these methods to void*, it's a lot
 // easier to just keep them global
@@ -57,58 +54,29 @@ inline void ProcessButtonEvt(uint8_t uc_button)
 	#endif
 }
 
-/** \brief Handler for Button 1 rising edge interrupt.
- *  Handle process led1 status change.
+/** \brief The pushbuttons, as watched by the GPIO input service. The pins are
+ *  debounced in software, for 10 ms after each edge.
  */
-static inline void Button1_Handler(uint32_t id, uint32_t mask)
+static const gpio_input_pin_t button_pins[] =
 {
-	if (PIN_PUSHBUTTON_1_ID == id && PIN_PUSHBUTTON_1_MASK == mask) 
-	{
-		ProcessButtonEvt(0);
-	}
-}
+	{ PIN_PUSHBUTTON_1_PIO, PIN_PUSHBUTTON_1_MASK, PIN_PUSHBUTTON_1_ATTR, 10000 },
+	#ifndef BOARD_NO_PUSHBUTTON_2
+	{ PIN_PUSHBUTTON_2_PIO, PIN_PUSHBUTTON_2_MASK, PIN_PUSHBUTTON_2_ATTR, 10000 },
+	#endif
+};
 
-#ifndef BOARD_NO_PUSHBUTTON_2
-/** \brief Handler for Button 2 falling edge interrupt.
- *  Handle process led2 status change.
+/** \brief The level each button acts on: button 1 on its rising edge, button 2 on
+ *  its falling edge.
  */
-static inline void Button2_Handler(uint32_t id, uint32_t mask)
-{
-	if (PIN_PUSHBUTTON_2_ID == id && PIN_PUSHBUTTON_2_MASK == mask) 
-	{
-		ProcessButtonEvt(1);
-	}
-}
-#endif
+static const uint8_t button_press_levels[] = { 1, 0 };
 
 /** \brief Configure the Pushbuttons
- *  Configure the PIO as inputs and generate corresponding interrupt when
- *  pressed or released.
+ *  Hand the buttons to the GPIO input service, which queues their edges from the
+ *  PIO interrupts; see lib/Services/gpio_input.h.
  */
 void inline configure_buttons(void)
 {
-	/* Configure Pushbutton 1 */
-	pmc_enable_periph_clk(PIN_PUSHBUTTON_1_ID);
-	pio_set_debounce_filter(PIN_PUSHBUTTON_1_PIO, PIN_PUSHBUTTON_1_MASK, 10);
-	/* Interrupt on rising edge  */
-	pio_handler_set(PIN_PUSHBUTTON_1_PIO, PIN_PUSHBUTTON_1_ID,
-			PIN_PUSHBUTTON_1_MASK, PIN_PUSHBUTTON_1_ATTR, Button1_Handler);
-	NVIC_EnableIRQ((IRQn_Type) PIN_PUSHBUTTON_1_ID);
-	pio_handler_set_priority(PIN_PUSHBUTTON_1_PIO,
-			(IRQn_Type) PIN_PUSHBUTTON_1_ID, IRQ_PRIOR_PIO);
-	pio_enable_interrupt(PIN_PUSHBUTTON_1_PIO, PIN_PUSHBUTTON_1_MASK);
-	#ifndef BOARD_NO_PUSHBUTTON_2
-		/* Configure Pushbutton 2 */
-		pmc_enable_periph_clk(PIN_PUSHBUTTON_2_ID);
-		pio_set_debounce_filter(PIN_PUSHBUTTON_2_PIO, PIN_PUSHBUTTON_2_MASK, 10);
-		/* Interrupt on falling edge */
-		pio_handler_set(PIN_PUSHBUTTON_2_PIO, PIN_PUSHBUTTON_2_ID,
-				PIN_PUSHBUTTON_2_MASK, PIN_PUSHBUTTON_2_ATTR, Button2_Handler);
-		NVIC_EnableIRQ((IRQn_Type) PIN_PUSHBUTTON_2_ID);
-		pio_handler_set_priority(PIN_PUSHBUTTON_2_PIO,
-				(IRQn_Type) PIN_PUSHBUTTON_2_ID, IRQ_PRIOR_PIO);
-		pio_enable_interrupt(PIN_PUSHBUTTON_2_PIO, PIN_PUSHBUTTON_2_MASK);
-	#endif
+	gpio_input_init(button_pins, sizeof(button_pins) / sizeof(button_pins[0]));
 }
 
 #endif/* _EX_CPP_BUTTONS_H_ */
\ No newline at end of file
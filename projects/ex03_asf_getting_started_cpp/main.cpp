@@ -38,6 +38,8 @@
 
 #include "shares.h"
 #include "system_functions.h"
+#include "lib/Services/fault.h"
+#include "lib/Services/systime.h"
 
 /** \brief LED0 blink time, LED1 blink half this time, in ms 
  */
@@ -66,6 +68,10 @@ volatile bool g_b_led1_active;
 /** \brief Global g_ul_ms_ticks in milliseconds since start of application 
 */
 volatile uint32_t g_ul_ms_ticks;
+
+/** \brief Timer ticks queued by the TC0 interrupt handler for the main loop
+ */
+SpscRing<uint32_t, 8> g_tc_events;
 		
 system_functions* sys_function;
 
@@ -83,6 +89,10 @@ int main(void)
 	// Initialize the console UART
 	sys_function->config_console();
 
+	// Report any crash from the previous run, and catch the next one
+	fault_init();
+	fault_report();
+
 	// Output example information
 	puts(STRING_HEADER);
 
@@ -97,6 +107,9 @@ int main(void)
 		}
 	#endif
 
+	// Show how closely delays keep to time, now that the tick is running
+	systime_print_accuracy();
+
 	puts("Configure TC.\r");
 	sys_function->config_tc();
 
@@ -112,8 +125,8 @@ int main(void)
 	#endif
 
 	while (1) {
-		/* Wait for LED to be active */
-		while (!g_b_led0_active);
+		/* Handle button presses and timer ticks queued since the last pass */
+		sys_function->process_events();
 
 		/* Toggle LED state if active */
 		if (g_b_led0_active) {
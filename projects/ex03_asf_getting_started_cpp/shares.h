@@ -13,10 +13,7 @@
 #include "lib/ASF_Config/conf_clock.h"
 #include "lib/ASF_Config/conf_uart_serial.h"
 #include <stdio_serial.h>
-
-/** \brief IRQ priority for PIO (The lower the value, the greater the priority) 
- */
-#define IRQ_PRIOR_PIO    0
+#include "lib/FreeRTOS_CPP/spsc_ring.h"
 
 /** \brief LED0 blinking control. 
 */
@@ -32,5 +29,10 @@ extern volatile bool g_b_led1_active;
 */
 extern volatile uint32_t g_ul_ms_ticks;
 
+/** \brief Timer ticks queued by the TC0 interrupt handler, stamped with
+ *  g_ul_ms_ticks.
+ */
+extern SpscRing<uint32_t, 8> g_tc_events;
+
 
 #endif/* _EX_CPP_SHARES_H_ */
\ No newline at end of file
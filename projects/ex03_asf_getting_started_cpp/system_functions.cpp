@@ -5,12 +5,14 @@
 
 // Include the header
 #include "system_functions.h"
+#include "lib/Services/console.h"
+#include "lib/Services/systime.h"
 
 // We need to define the system tick handler separately from the class, otherwise
 // the linker can't see it.
 /** \brief Handler for System Tick interrupt.
  *  Process System Tick Event
- *  Increments the g_ul_ms_ticks counter.
+ *  Increments the g_ul_ms_ticks counter and the system time service's tick count.
  *  If we have FreeRTOS enabled, this'll cause issues with the SysTick_Handler provided
  *  in FreeRTOS/Source/portable/GCC/ARM_CM3/port.c, so this needs to be surrounded by
  *  an #ifndef #endif
@@ -19,13 +21,15 @@
 void SysTick_Handler(void)
 {
 	g_ul_ms_ticks++;
+	systime_tick();
 }
 #endif
 
 // Additionally, keep the TC0 interrupt handler out of the class because it's externed
 // elsewhere and hooked up as the actual ISR function.
 /** \brief Interrupt handler for TC0 interrupt. 
- *  Toggles the state of LED\#2.
+ *  Toggles the state of LED\#2 and queues the tick for the main loop to report,
+ *  rather than printing from interrupt context.
  */
 void TC0_Handler(void)
 {
@@ -42,7 +46,7 @@ void TC0_Handler(void)
 		ioport_toggle_pin_level(LED1_GPIO);
 	#endif
 
-	printf("2 ");
+	g_tc_events.push((uint32_t) g_ul_ms_ticks);
 }
 
 // Defines for the system class
@@ -59,11 +63,13 @@ system_functions::system_functions(void)
 	g_b_led1_active = true;
 }
 
-/** \brief Initialize the system clock with default ASF parameters
+/** \brief Initialize the system clock with default ASF parameters, then start the
+ *  system time service which mdelay() uses
  */
 void system_functions::init_clock(void)
 {
 	sysclk_init();
+	systime_init();
 }
 
 /** \brief Initialize the board with default ASF parameters.
@@ -115,7 +121,9 @@ void system_functions::config_tc(void)
 }
 
 /** \brief Configure UART console
- *  Uses options specified in include/configure_console.h
+ *  Uses options specified in include/configure_console.h. Output goes through the
+ *  interrupt-driven console service, so printf() only waits for the bytes to be
+ *  copied into RAM; see lib/Services/console.h.
  */
 void system_functions::config_console(void)
 {
@@ -129,18 +137,42 @@ void system_functions::config_console(void)
 
 	/* Configure console UART. */
 	sysclk_enable_peripheral_clock(CONSOLE_UART_ID);
-	stdio_serial_init(CONF_UART, &uart_serial_options);
+	console_init(&uart_serial_options);
 }
 
-/** \brief Wait for the given number of milliseconds (using the g_ul_ms_ticks
- *  generated by the SAM's microcontrollers's system tick).
+/** \brief Handle the events queued up by the interrupt handlers
+ *  Button edges and timer ticks are pushed into lock-free queues by their
+ *  interrupt handlers, which keeps the handlers short; the slow part, printing to
+ *  the console, happens here in the main loop instead.
+ */
+void system_functions::process_events(void)
+{
+	gpio_input_event_t edges[8];
+	uint32_t ticks[8];
+	uint32_t count;
+	
+	count = gpio_input_get_events(edges, 8);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (edges[i].level == button_press_levels[edges[i].pin])
+		{
+			ProcessButtonEvt(edges[i].pin);
+		}
+	}
+	
+	count = g_tc_events.pop_batch(ticks, 8);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		printf("2 ");
+	}
+}
+
+/** \brief Wait for the given number of milliseconds. Under FreeRTOS, a task calling
+ *  this gives up the processor while it waits; see lib/Services/systime.h.
  *
  *  \param ul_dly_ticks  Delay to wait for, in milliseconds.
  */
 void system_functions::mdelay(uint32_t ul_dly_ticks)
 {
-	uint32_t ul_cur_ticks;
-
-	ul_cur_ticks = g_ul_ms_ticks;
-	while ((g_ul_ms_ticks - ul_cur_ticks) < ul_dly_ticks);
+	systime_delay_ms(ul_dly_ticks);
 }
\ No newline at end of file
@@ -50,6 +50,9 @@ class system_functions
 		// Configure UART console.
 		static void config_console(void);
 		
+		// Handle the events queued up by the interrupt handlers
+		static void process_events(void);
+		
 		// Wait for the given number of milliseconds
 		void mdelay(uint32_t ul_dly_ticks);
 }; // end class system_functions
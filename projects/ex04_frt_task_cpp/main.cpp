@@ -22,7 +22,12 @@
 
 #include "shares.h"
 #include "system_functions.h"
+#include "lib/Services/fault.h"
+#include "lib/Services/pool.h"
 #include "lib/FreeRTOS_CPP/task_wrap.h"
+#include "lib/FreeRTOS_Config/FreeRTOSStats.h"
+#include "lib/FreeRTOS_Config/FreeRTOSHeap.h"
+#include "lib/FreeRTOS_Config/FreeRTOSStack.h"
 #include "task_blink1.h"
 #include "task_blink2.h"
 
@@ -63,6 +68,10 @@ int main(void)
 
 	// Initialize the console UART
 	sys_function->config_console();
+
+	// Report any crash from the previous run, and catch the next one
+	fault_init();
+	fault_report();
 	
 	// Initialize fifoData semaphore to no data available
 	sem = xSemaphoreCreateCounting(1, 0);
@@ -72,8 +81,24 @@ int main(void)
 	new task_blink1 ("Blnk1", 2, configMINIMAL_STACK_SIZE + 50);
 	new task_blink2 ("Blnk2", 2, configMINIMAL_STACK_SIZE + 50);
 
+	// Print each task's share of the CPU every ten seconds
+	xStatsStartReportTask(1, configMS_TO_TICKS(10000));
+
+	// Check the tasks' stacks every second, and print recommended sizes every minute
+	xStackMonitorStartTask(1, configMS_TO_TICKS(1000), 60);
+
+#ifdef _USE_BINLOG_
+	// Log records are sent from a task which only runs when nothing else needs to
+	binlog_init();
+	binlog_start_task(1);
+#endif
+
 	// Output example information
 	puts(STRING_HEADER);
+
+	// Show how much of the pools and the heap the objects created so far take up
+	pool_print_report();
+	vHeapPrintReport();
 		
 	// Start the FreeRTOS Task Scheduler
 	vTaskStartScheduler();
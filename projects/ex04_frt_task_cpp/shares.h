@@ -17,6 +17,10 @@
 #include <semphr.h>
 #include <stdio_serial.h>
 
+#ifdef _USE_BINLOG_
+#include "lib/Services/binlog.h"
+#endif
+
 /** \brief IRQ priority for PIO (The lower the value, the greater the priority) 
  */
 #define IRQ_PRIOR_PIO    0
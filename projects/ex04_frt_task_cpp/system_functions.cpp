@@ -5,6 +5,8 @@
 
 // Include the header
 #include "system_functions.h"
+#include "lib/Services/console.h"
+#include "lib/Services/systime.h"
 
 // Defines for the system class
 /** \brief This constructor really doesn't do much but give access to the class methods.
@@ -17,11 +19,13 @@ system_functions::system_functions(void)
 	g_b_led1_active = true;
 }
 
-/** \brief Initialize the system clock with default ASF parameters
+/** \brief Initialize the system clock with default ASF parameters, then start the
+ *  system time service which mdelay() uses
  */
 void system_functions::init_clock(void)
 {
 	sysclk_init();
+	systime_init();
 }
 
 /** \brief Initialize the board with default ASF parameters.
@@ -32,7 +36,9 @@ void system_functions::init_board(void)
 }
 
 /** \brief Configure UART console
- *  Uses options specified in include/configure_console.h
+ *  Uses options specified in include/configure_console.h. Output goes through the
+ *  interrupt-driven console service, so printf() only waits for the bytes to be
+ *  copied into RAM; see lib/Services/console.h.
  */
 void system_functions::config_console(void)
 {
@@ -46,18 +52,15 @@ void system_functions::config_console(void)
 
 	/* Configure console UART. */
 	sysclk_enable_peripheral_clock(CONSOLE_UART_ID);
-	stdio_serial_init(CONF_UART, &uart_serial_options);
+	console_init(&uart_serial_options);
 }
 
-/** \brief Wait for the given number of milliseconds (using the g_ul_ms_ticks
- *  generated by the SAM's microcontrollers's system tick).
+/** \brief Wait for the given number of milliseconds. Under FreeRTOS, a task calling
+ *  this gives up the processor while it waits; see lib/Services/systime.h.
  *
  *  \param ul_dly_ticks  Delay to wait for, in milliseconds.
  */
 void system_functions::mdelay(uint32_t ul_dly_ticks)
 {
-	uint32_t ul_cur_ticks;
-
-	ul_cur_ticks = g_ul_ms_ticks;
-	while ((g_ul_ms_ticks - ul_cur_ticks) < ul_dly_ticks);
+	systime_delay_ms(ul_dly_ticks);
 }
\ No newline at end of file
@@ -28,14 +28,18 @@
  *  label cutter.
  *  @param aName A character string which will be the name of this task
  *  @param aPriority The priority at which this task will initially run (default: 0)
- *  @param aStackSize The size of this task's stack in bytes 
+ *  @param aStackSize The size of this task's stack in words 
  *                    (default: configMINIMAL_STACK_SIZE)
  */
 
 task_blink1::task_blink1 (const char* aName, 
 						unsigned portBASE_TYPE aPriority, 
 						size_t aStackSize)
+#ifdef _USE_CRTP_TASKS_
+						: Task<task_blink1> (aName, aPriority, aStackSize)
+#else
 						: TaskClass (aName, aPriority, aStackSize)
+#endif
 {
 }
 
@@ -55,6 +59,10 @@ void task_blink1::run (void)
 		ioport_set_pin_level(LED1_GPIO, IOPORT_PIN_LEVEL_LOW);
 		
 		// Print off message
+#ifdef _USE_BINLOG_
+		BINLOG0("LED Off");
+#else
 		printf("LED Off... ");
+#endif
 	}
 }
\ No newline at end of file
@@ -28,14 +28,18 @@
  *  label cutter.
  *  @param aName A character string which will be the name of this task
  *  @param aPriority The priority at which this task will initially run (default: 0)
- *  @param aStackSize The size of this task's stack in bytes 
+ *  @param aStackSize The size of this task's stack in words 
  *                    (default: configMINIMAL_STACK_SIZE)
  */
 
 task_blink2::task_blink2 (const char* aName, 
 						unsigned portBASE_TYPE aPriority, 
 						size_t aStackSize)
+#ifdef _USE_CRTP_TASKS_
+						: Task<task_blink2> (aName, aPriority, aStackSize)
+#else
 						: TaskClass (aName, aPriority, aStackSize)
+#endif
 {
 }
 
@@ -50,7 +54,11 @@ void task_blink2::run (void)
 	{
 		// Turn LED on, display message
 		ioport_set_pin_level(LED1_GPIO, IOPORT_PIN_LEVEL_HIGH);
+#ifdef _USE_BINLOG_
+		BINLOG0("LED On");
+#else
 		printf("LED On... ");
+#endif
 
 		// Sleep for 200 milliseconds.
 		delayms(200);
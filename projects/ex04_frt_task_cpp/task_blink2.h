@@ -32,7 +32,13 @@
 /** \brief   This task controls the half of the blinking behavior.
  */
 
+// Building with _USE_CRTP_TASKS_ swaps the virtual TaskClass for the CRTP Task<>
+// template so that the two can be compared for size
+#ifdef _USE_CRTP_TASKS_
+class task_blink2 : public Task<task_blink2>
+#else
 class task_blink2 : public TaskClass
+#endif
 {
 private:
 	
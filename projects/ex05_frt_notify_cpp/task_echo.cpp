@@ -0,0 +1,64 @@
+//**************************************************************************************
+/** \file task_echo.cpp
+ *    This file contains the code for a task class which answers the ping task.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "task_echo.h"              // Header for this task
+
+//-------------------------------------------------------------------------------------
+/** \brief This constructor creates a task that answers the ping task.
+ *  @param aName A character string which will be the name of this task
+ *  @param aPriority The priority at which this task will initially run
+ *  @param aStackSize The size of this task's stack in words
+ *  @param aReplyTo The task to notify in reply to each notification this task gets.
+ *                  If this is null, or the kernel has no task notifications (see
+ *                  \c FRT_TASK_NOTIFICATIONS), the task waits on \c sem_ping and
+ *                  replies by giving \c sem_pong instead.
+ */
+
+task_echo::task_echo (const char* aName, 
+					  unsigned portBASE_TYPE aPriority, 
+					  size_t aStackSize,
+					  TaskClass* aReplyTo)
+					  : TaskClass (aName, aPriority, aStackSize)
+{
+	p_reply_to = aReplyTo;
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This is the run method for the echo task.
+ */
+
+void task_echo::run (void)
+{
+	for (;;) 
+	{
+		#if (FRT_TASK_NOTIFICATIONS == 1)
+		if (p_reply_to != NULL)
+		{
+			// Notification path: no kernel objects at all
+			wait_notify();
+			p_reply_to->notify();
+			continue;
+		}
+		#endif
+		
+		// Semaphore path: two queue-based kernel objects per round trip
+		xSemaphoreTake(sem_ping, portMAX_DELAY);
+		xSemaphoreGive(sem_pong);
+	}
+}
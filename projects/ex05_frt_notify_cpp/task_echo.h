@@ -0,0 +1,50 @@
+//**************************************************************************************
+/** \file task_echo.h
+ *    This file contains the header for a task class that answers every signal it gets
+ *    from the ping task, either with a semaphore or with a task notification.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_ECHO_H_
+#define _TASK_ECHO_H_
+
+#include <FreeRTOS.h>                         // Header for FreeRTOS
+#include "shares.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"       // Header for FRT C++ wrapper
+
+//-------------------------------------------------------------------------------------
+/** \brief   This task sends back every signal it receives from the ping task.
+ */
+
+class task_echo : public TaskClass
+{
+private:
+	// The task that is notified in reply, or null to reply with sem_pong
+	TaskClass* p_reply_to;
+	
+protected:
+	
+public:
+	// This constructor creates an echo task which replies by semaphore, or by
+	// notification if given a task to reply to
+	task_echo (const char*, unsigned portBASE_TYPE, size_t, TaskClass* = NULL);
+	
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+};
+
+#endif // _TASK_ECHO_H_
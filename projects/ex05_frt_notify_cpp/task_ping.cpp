@@ -0,0 +1,119 @@
+//**************************************************************************************
+/** \file task_ping.cpp
+ *    This file contains the code for a task class which times round trips to the
+ *    echo tasks.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "task_ping.h"              // Header for this task
+#include "lib/Services/cycle_counter.h"
+
+//-------------------------------------------------------------------------------------
+/** \brief This constructor creates the ping task.
+ *  @param aName A character string which will be the name of this task
+ *  @param aPriority The priority at which this task will initially run. This should
+ *                   be lower than that of the echo tasks, so each signal is answered
+ *                   before this task runs again.
+ *  @param aStackSize The size of this task's stack in words
+ */
+
+task_ping::task_ping (const char* aName, 
+					  unsigned portBASE_TYPE aPriority, 
+					  size_t aStackSize)
+					  : TaskClass (aName, aPriority, aStackSize)
+{
+	p_echo = NULL;
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief Sets the echo task which is signalled by notification.
+ *  \details This has to be done after construction, as that task in turn needs a
+ *  pointer to this one to reply to. Without task notifications (see
+ *  \c FRT_TASK_NOTIFICATIONS) there is no such task, and this isn't called.
+ *  @param aEcho The echo task to notify
+ */
+
+void task_ping::set_echo (TaskClass* aEcho)
+{
+	p_echo = aEcho;
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This is the run method for the ping task.
+ */
+
+void task_ping::run (void)
+{
+	uint32_t start;
+	uint32_t elapsed;
+	uint32_t sem_total, sem_worst;
+	#if (FRT_TASK_NOTIFICATIONS == 1)
+	uint32_t ntf_total, ntf_worst;
+	#endif
+	
+	cycle_counter_enable();
+	
+	for (;;) 
+	{
+		delayms(1000);
+		
+		// Round trips through the two counting semaphores
+		sem_total = 0;
+		sem_worst = 0;
+		for (uint16_t i = 0; i < PING_ROUNDS; i++)
+		{
+			start = cycle_counter_get();
+			xSemaphoreGive(sem_ping);
+			xSemaphoreTake(sem_pong, portMAX_DELAY);
+			elapsed = cycle_counter_since(start);
+			
+			sem_total += elapsed;
+			if (elapsed > sem_worst)
+			{
+				sem_worst = elapsed;
+			}
+		}
+		
+		#if (FRT_TASK_NOTIFICATIONS == 1)
+		// Round trips through direct-to-task notifications
+		ntf_total = 0;
+		ntf_worst = 0;
+		for (uint16_t i = 0; i < PING_ROUNDS; i++)
+		{
+			start = cycle_counter_get();
+			p_echo->notify();
+			wait_notify();
+			elapsed = cycle_counter_since(start);
+			
+			ntf_total += elapsed;
+			if (elapsed > ntf_worst)
+			{
+				ntf_worst = elapsed;
+			}
+		}
+		
+		printf("Round trip, cycles (avg/worst): semaphore %lu/%lu, "
+			   "notification %lu/%lu\r\n",
+			   (unsigned long)(sem_total / PING_ROUNDS), (unsigned long)sem_worst,
+			   (unsigned long)(ntf_total / PING_ROUNDS), (unsigned long)ntf_worst);
+		#else
+		// This kernel has no task notifications, so only the semaphores are timed
+		printf("Round trip, cycles (avg/worst): semaphore %lu/%lu, "
+			   "notification n/a\r\n",
+			   (unsigned long)(sem_total / PING_ROUNDS), (unsigned long)sem_worst);
+		#endif
+	}
+}
@@ -0,0 +1,61 @@
+//**************************************************************************************
+/** \file task_ping.h
+ *    This file contains the header for a task class that times round trips to the
+ *    echo tasks.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_PING_H_
+#define _TASK_PING_H_
+
+#include <FreeRTOS.h>                         // Header for FreeRTOS
+#include "shares.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"       // Header for FRT C++ wrapper
+
+/** \brief The number of round trips timed for each signalling method per report
+ */
+#define PING_ROUNDS      1000
+
+//-------------------------------------------------------------------------------------
+/** \brief   This task measures the wake-up latency of semaphores and notifications.
+ *  \details Once a second, it times \c PING_ROUNDS round trips to the echo task that
+ *  uses \c sem_ping and \c sem_pong, then the same number to the echo task that
+ *  uses task notifications, and prints the average and worst-case cycle counts.
+ *  Kernels older than FreeRTOS V8.2.0, such as the V8.0.1 in lib/FreeRTOS, have no
+ *  task notifications, so there only the semaphore round trips are timed.
+ */
+
+class task_ping : public TaskClass
+{
+private:
+	// The echo task that answers by notification
+	TaskClass* p_echo;
+	
+protected:
+	
+public:
+	// This constructor creates a generic task of which many copies can be made
+	task_ping (const char*, unsigned portBASE_TYPE, size_t);
+	
+	// Tells this task which echo task to notify
+	void set_echo (TaskClass*);
+	
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+};
+
+#endif // _TASK_PING_H_
@@ -0,0 +1,64 @@
+/** \file shares.h
+ *  This file contains the header info for shared variables for the channel
+ *  throughput benchmark.
+ */
+
+// Prevent this header from being included multiple times in the same file
+#ifndef _EX_CPP_SHARES_H
+#define _EX_CPP_SHARES_H
+
+// Includes for convenience
+#include "lib/ASF_Config/asf.h"
+#include "lib/ASF_Config/conf_board.h"
+#include "lib/ASF_Config/conf_clock.h"
+#include "lib/ASF_Config/conf_uart_serial.h"
+
+#include <FreeRTOS.h>
+#include <stdio_serial.h>
+#include "lib/FreeRTOS_CPP/channel.h"
+
+/** \brief The number of items pushed through each channel per measurement. This 
+ *  times one million must fit in 32 bits.
+ */
+#define CHANNEL_ITEMS    4000
+
+/** \brief The most items the sink task takes per wake-up.
+ */
+#define CHANNEL_BATCH    8
+
+/** \brief A large message, as a stand-in for a block of samples.
+ */
+struct bench_block
+{
+	uint32_t words[16];
+};
+
+/** \brief LED0 blinking control. 
+*/
+extern volatile bool g_b_led0_active;
+
+/** \brief LED1 blinking control. 
+*/
+#ifdef LED1_GPIO
+extern volatile bool g_b_led1_active;
+#endif
+
+/** \brief Global g_ul_ms_ticks in milliseconds since start of application 
+*/
+extern volatile uint32_t g_ul_ms_ticks;
+
+/** \brief Channel of small items, one word each.
+ */
+extern Channel<uint32_t, 32> small_chan;
+
+/** \brief Channel of large items.
+ */
+extern Channel<bench_block, 8> big_chan;
+
+/** \brief The number of times the sink task woke up to receive during the last
+ *  measurement.
+ */
+extern volatile uint32_t g_ul_sink_wakeups;
+
+
+#endif/* _EX_CPP_SHARES_H_ */
@@ -0,0 +1,78 @@
+//**************************************************************************************
+/** \file task_sink.cpp
+ *    This file contains the code for a task class which drains the benchmark
+ *    channels.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "task_sink.h"              // Header for this task
+
+//-------------------------------------------------------------------------------------
+/** \brief Receives \c CHANNEL_ITEMS items from a channel, in batches.
+ *  @param chan The channel to drain
+ *  @return The number of wake-ups it took
+ */
+
+template <typename T, UBaseType_t N>
+static uint32_t drain (Channel<T, N>& chan)
+{
+	T batch[CHANNEL_BATCH];
+	uint32_t received = 0;
+	uint32_t wakeups = 0;
+	
+	while (received < CHANNEL_ITEMS)
+	{
+		received += chan.receive_batch(batch, CHANNEL_BATCH);
+		wakeups++;
+	}
+	return wakeups;
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This constructor creates the sink task.
+ *  @param aName A character string which will be the name of this task
+ *  @param aPriority The priority at which this task will initially run. Giving it
+ *                   the same priority as the source task lets items pile up so they
+ *                   can be received in batches.
+ *  @param aStackSize The size of this task's stack in words; it has to hold a batch
+ *                    of \c bench_block items
+ *  @param aSource The task to notify after each measurement
+ */
+
+task_sink::task_sink (const char* aName, 
+					  unsigned portBASE_TYPE aPriority, 
+					  size_t aStackSize,
+					  TaskClass* aSource)
+					  : TaskClass (aName, aPriority, aStackSize)
+{
+	p_source = aSource;
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This is the run method for the sink task.
+ */
+
+void task_sink::run (void)
+{
+	for (;;) 
+	{
+		g_ul_sink_wakeups = drain(small_chan);
+		p_source->notify();
+		
+		g_ul_sink_wakeups = drain(big_chan);
+		p_source->notify();
+	}
+}
@@ -0,0 +1,49 @@
+//**************************************************************************************
+/** \file task_sink.h
+ *    This file contains the header for a task class that drains the benchmark
+ *    channels.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_SINK_H_
+#define _TASK_SINK_H_
+
+#include <FreeRTOS.h>                         // Header for FreeRTOS
+#include "shares.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"       // Header for FRT C++ wrapper
+
+//-------------------------------------------------------------------------------------
+/** \brief   This task receives everything the source task sends, in batches.
+ */
+
+class task_sink : public TaskClass
+{
+private:
+	// The task to notify when all of a measurement's items have arrived
+	TaskClass* p_source;
+	
+protected:
+	
+public:
+	// This constructor creates a sink which reports back to the given task
+	task_sink (const char*, unsigned portBASE_TYPE, size_t, TaskClass*);
+	
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+};
+
+#endif // _TASK_SINK_H_
@@ -0,0 +1,86 @@
+//**************************************************************************************
+/** \file task_source.cpp
+ *    This file contains the code for a task class which measures channel
+ *    throughput.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "task_source.h"            // Header for this task
+#include "lib/Services/cycle_counter.h"
+#include <string.h>
+
+//-------------------------------------------------------------------------------------
+/** \brief Sends \c CHANNEL_ITEMS items through a channel and prints the throughput.
+ *  \details The clock stops once the sink task has said it has received every item,
+ *  so the figure covers both ends of the channel.
+ *  @param pTask The calling task, which the sink task notifies
+ *  @param chan The channel to send through
+ *  @param label The name to print for this measurement
+ */
+
+template <typename T, UBaseType_t N>
+static void measure (TaskClass* pTask, Channel<T, N>& chan, const char* label)
+{
+	T item;
+	uint32_t start;
+	uint32_t us;
+	
+	memset(&item, 0, sizeof(item));
+	
+	start = cycle_counter_get();
+	for (uint32_t i = 0; i < CHANNEL_ITEMS; i++)
+	{
+		chan.send(item);
+	}
+	pTask->wait_notify();
+	us = cycles_to_us(cycle_counter_since(start));
+	
+	printf("%s (%u bytes): %lu items/s, %lu items per wake-up\r\n", label,
+		   (unsigned int)sizeof(T),
+		   (unsigned long)((CHANNEL_ITEMS * 1000000UL) / (us ? us : 1)),
+		   (unsigned long)(CHANNEL_ITEMS / (g_ul_sink_wakeups ? g_ul_sink_wakeups : 1)));
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This constructor creates the source task.
+ *  @param aName A character string which will be the name of this task
+ *  @param aPriority The priority at which this task will initially run
+ *  @param aStackSize The size of this task's stack in words
+ */
+
+task_source::task_source (const char* aName, 
+						  unsigned portBASE_TYPE aPriority, 
+						  size_t aStackSize)
+						  : TaskClass (aName, aPriority, aStackSize)
+{
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This is the run method for the source task.
+ */
+
+void task_source::run (void)
+{
+	cycle_counter_enable();
+	
+	for (;;) 
+	{
+		delayms(1000);
+		
+		measure(this, small_chan, "Small");
+		measure(this, big_chan, "Large");
+	}
+}
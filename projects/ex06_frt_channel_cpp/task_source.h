@@ -0,0 +1,50 @@
+//**************************************************************************************
+/** \file task_source.h
+ *    This file contains the header for a task class that pushes items through the
+ *    benchmark channels and times them.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_SOURCE_H_
+#define _TASK_SOURCE_H_
+
+#include <FreeRTOS.h>                         // Header for FreeRTOS
+#include "shares.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"       // Header for FRT C++ wrapper
+
+//-------------------------------------------------------------------------------------
+/** \brief   This task measures channel throughput.
+ *  \details Once a second, it sends \c CHANNEL_ITEMS items through \c small_chan and
+ *  then through \c big_chan, waiting each time for the sink task to say it has
+ *  received them all, and prints the items per second and items per sink wake-up.
+ */
+
+class task_source : public TaskClass
+{
+private:
+	
+protected:
+	
+public:
+	// This constructor creates a generic task of which many copies can be made
+	task_source (const char*, unsigned portBASE_TYPE, size_t);
+	
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+};
+
+#endif // _TASK_SOURCE_H_
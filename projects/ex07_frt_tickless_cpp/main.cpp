@@ -0,0 +1,85 @@
+//**************************************************************************************
+/** \file main.cpp
+ *  Tickless idle example: measures wake-ups per second while the system is idle
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "shares.h"
+#include "system_functions.h"
+#include "lib/Services/fault.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"
+#include "task_sleep_report.h"
+
+/** \brief Define the header string, shown to the user on startup
+ */
+#define STRING_HEADER "-- FreeRTOS C++ Tickless Idle Example --\r\n"
+	
+/** \brief LED0 blinking control. 
+*/
+volatile bool g_b_led0_active;
+
+/** \brief LED1 blinking control. 
+*/
+#ifdef LED1_GPIO
+volatile bool g_b_led1_active;
+#endif
+
+/** \brief Global g_ul_ms_ticks in milliseconds since start of application 
+*/
+volatile uint32_t g_ul_ms_ticks;
+		
+system_functions* sys_function;
+
+/** \brief Tickless idle example entry point.
+ */
+int main(void)
+{
+	// Create a pointer to a system_function object so we can use the system methods
+	sys_function = new system_functions();
+	
+	// Initialize the SAM system
+	sys_function->init_clock();
+	sys_function->init_board();
+
+	// Initialize the console UART
+	sys_function->config_console();
+
+	// Report any crash from the previous run, and catch the next one
+	fault_init();
+	fault_report();
+	
+	// The sleep manager decides whether the idle task may sleep; drivers that need
+	// the processor awake take a SLEEPMGR_ACTIVE lock
+	sleepmgr_init();
+
+	// The report task is the only one, so the system is idle the rest of the time
+	new task_sleep_report ("Sleep", 1, configMINIMAL_STACK_SIZE + 100);
+
+	// Output example information
+	puts(STRING_HEADER);
+		
+	// Start the FreeRTOS Task Scheduler
+	vTaskStartScheduler();
+	
+	// Let the user know if FreeRTOS crashes.
+	printf("Something terrible has happened and FreeRTOS exited!");
+
+	// Loop until a reset
+	while (1) {
+		// Wait for 500ms
+		sys_function->mdelay(500);
+	}
+}
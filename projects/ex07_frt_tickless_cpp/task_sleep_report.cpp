@@ -0,0 +1,63 @@
+//**************************************************************************************
+/** \file task_sleep_report.cpp
+ *    This file contains the source for a task class that reports how often the idle
+ *    task wakes up and how much of the time the processor spends asleep.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "task_sleep_report.h"      // Header for this task
+
+//-------------------------------------------------------------------------------------
+/** \brief This constructor creates the sleep report task.
+ *  @param aName A character string which will be the name of this task
+ *  @param aPriority The priority at which this task will initially run
+ *  @param aStackSize The size of this task's stack in words
+ */
+
+task_sleep_report::task_sleep_report (const char* aName, 
+									  unsigned portBASE_TYPE aPriority, 
+									  size_t aStackSize)
+									  : TaskClass (aName, aPriority, aStackSize)
+{
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This is the run method for the sleep report task.
+ */
+
+void task_sleep_report::run (void)
+{
+	portTickType last_wake = xTaskGetTickCount ();
+	uint32_t last_count = ulSleepGetCount ();
+	uint64_t last_cycles = ullSleepGetCycles ();
+	uint64_t period_cycles = (uint64_t) SystemCoreClock * SLEEP_REPORT_PERIOD / 1000;
+
+	for (;;)
+	{
+		delay_from_for (last_wake, SLEEP_REPORT_PERIOD);
+
+		uint32_t count = ulSleepGetCount ();
+		uint64_t cycles = ullSleepGetCycles ();
+		uint32_t permille = (uint32_t) ((cycles - last_cycles) * 1000 / period_cycles);
+
+		printf ("Wake-ups/s: %lu, asleep: %lu.%lu%%\r\n",
+				(unsigned long) ((count - last_count) * 1000UL / SLEEP_REPORT_PERIOD),
+				(unsigned long) (permille / 10), (unsigned long) (permille % 10));
+
+		last_count = count;
+		last_cycles = cycles;
+	}
+}
@@ -0,0 +1,57 @@
+//**************************************************************************************
+/** \file task_sleep_report.h
+ *    This file contains the header for a task class that reports how often the idle
+ *    task wakes up and how much of the time the processor spends asleep.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_SLEEP_REPORT_H_
+#define _TASK_SLEEP_REPORT_H_
+
+#include <FreeRTOS.h>                         // Header for FreeRTOS
+#include "shares.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"       // Header for FRT C++ wrapper
+
+/** \brief The time between reports, in milliseconds
+ */
+#define SLEEP_REPORT_PERIOD      1000
+
+//-------------------------------------------------------------------------------------
+/** \brief   This task measures wake-ups per second while the system is idle.
+ *  \details Once every \c SLEEP_REPORT_PERIOD milliseconds it prints how many times
+ *  the idle task went to sleep, and so was woken, since the last report, and what
+ *  share of that time the processor spent asleep. With nothing else to do, the only
+ *  wake-ups are this task's own, the console's transmit interrupts and the SysTick
+ *  reloads forced by its 24-bit limit; without tickless idle there would be one per
+ *  tick, i.e. \c configTICK_RATE_HZ a second.
+ */
+
+class task_sleep_report : public TaskClass
+{
+private:
+	
+protected:
+	
+public:
+	// This constructor creates a generic task of which many copies can be made
+	task_sleep_report (const char*, unsigned portBASE_TYPE, size_t);
+	
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+};
+
+#endif // _TASK_SLEEP_REPORT_H_
@@ -0,0 +1,58 @@
+//**************************************************************************************
+/** \file task_bench.cpp
+ *    This file contains the source for a task class that runs the kernel
+ *    benchmarks once and prints their results.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include <stdlib.h>
+#include "task_bench.h"             // Header for this task
+#include "lib/Services/rtos_bench.h"
+
+//-------------------------------------------------------------------------------------
+/** \brief This constructor creates the benchmark task.
+ *  @param aName A character string which will be the name of this task
+ *  @param aPriority The priority at which this task will initially run
+ *  @param aStackSize The size of this task's stack in words
+ */
+
+task_bench::task_bench (const char* aName, 
+						unsigned portBASE_TYPE aPriority, 
+						size_t aStackSize)
+						: TaskClass (aName, aPriority, aStackSize)
+{
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This is the run method for the benchmark task.
+ */
+
+void task_bench::run (void)
+{
+	// Let the start-up messages go out first
+	delayms (1000);
+
+	rtos_bench_run ();
+
+#ifdef _HOST_BUILD_
+	exit (0);
+#endif
+
+	for (;;)
+	{
+		vTaskDelay (portMAX_DELAY);
+	}
+}
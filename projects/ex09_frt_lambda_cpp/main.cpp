@@ -0,0 +1,121 @@
+//**************************************************************************************
+/** \file main.cpp
+ *  Tasks written as lambdas, with their settings checked at compile time
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "shares.h"
+#include "system_functions.h"
+#include "lib/Services/fault.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"
+
+/** \brief Define the header string, shown to the user on startup
+ */
+#define STRING_HEADER "-- FreeRTOS C++17 Lambda Task Example --\r\n"
+	
+/** \brief LED0 blinking control. 
+*/
+volatile bool g_b_led0_active;
+
+/** \brief LED1 blinking control. 
+*/
+#ifdef LED1_GPIO
+volatile bool g_b_led1_active;
+#endif
+
+/** \brief Global g_ul_ms_ticks in milliseconds since start of application 
+*/
+volatile uint32_t g_ul_ms_ticks;
+		
+system_functions* sys_function;
+
+/** \brief Counts sent by the counting task to the reporting task. As a global, its
+ *  storage is allocated by the linker when static allocation is available.
+ */
+Channel<uint32_t, 8> counts;
+
+/** \brief Lambda task example entry point.
+ */
+int main(void)
+{
+	// Create a pointer to a system_function object so we can use the system methods
+	sys_function = new system_functions();
+	
+	// Initialize the SAM system
+	sys_function->init_clock();
+	sys_function->init_board();
+
+	// Initialize the console UART
+	sys_function->config_console();
+
+	// Report any crash from the previous run, and catch the next one
+	fault_init();
+	fault_report();
+	
+	// The counting task blinks LED0 and sends a count at each blink. The period is
+	// captured by value, so the task keeps its own copy once main() has moved on.
+	// The priority and stack depth are template parameters: a priority of
+	// configMAX_PRIORITIES or a stack below configMINIMAL_STACK_SIZE won't compile.
+	uint16_t period = 500;
+	create_task<2, configMINIMAL_STACK_SIZE + 100>("Count", [period](TaskWrap& task)
+	{
+		uint32_t count = 0;
+		
+		for (;;)
+		{
+			ioport_toggle_pin_level(LED0_GPIO);
+			counts.send(count++);
+			task.delayms(period);
+		}
+	});
+	
+	// The reporting task prints each count it's sent. It has no use for its task
+	// object, so its lambda takes no arguments.
+	create_task<1, configMINIMAL_STACK_SIZE + 200>("Report", []
+	{
+		uint32_t count;
+		
+		for (;;)
+		{
+			if (counts.receive(count))
+			{
+				printf("Count %lu\r\n", (unsigned long)count);
+			}
+		}
+	});
+	
+	// A task can also be made with new; its lambda's type is worked out by the
+	// compiler. This one says hello once and returns, so it is deleted again.
+	new FunctionTask("Hello", TaskConfig<1>(), []
+	{
+		puts("Hello from a lambda\r");
+	});
+
+	// Output example information
+	puts(STRING_HEADER);
+		
+	// Start the FreeRTOS Task Scheduler
+	vTaskStartScheduler();
+	
+	// Let the user know if FreeRTOS crashes.
+	printf("Something terrible has happened and FreeRTOS exited!");
+
+	// Loop until a reset
+	while (1) {
+		// Wait for 500ms
+		sys_function->mdelay(500);
+	}
+}
@@ -0,0 +1,127 @@
+//**************************************************************************************
+/** \file main.cpp
+ *  Timer wheel example: runs a fast job in the interrupt and reports on it
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "shares.h"
+#include "system_functions.h"
+#include "lib/Services/fault.h"
+#include "lib/Services/timer_wheel.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"
+
+/** \brief Define the header string, shown to the user on startup
+ */
+#define STRING_HEADER "-- FreeRTOS C++ Timer Wheel Example --\r\n"
+	
+/** \brief LED0 blinking control. 
+*/
+volatile bool g_b_led0_active;
+
+/** \brief LED1 blinking control. 
+*/
+#ifdef LED1_GPIO
+volatile bool g_b_led1_active;
+#endif
+
+/** \brief Global g_ul_ms_ticks in milliseconds since start of application 
+*/
+volatile uint32_t g_ul_ms_ticks;
+		
+system_functions* sys_function;
+
+/** \brief Period of the fast timer wheel job, in microseconds. */
+#define FAST_PERIOD_US 500
+
+/** \brief Timer wheel jobs: a fast one run in the interrupt, and a report of its
+ *  timing run once a second by the timer wheel task.
+ */
+static timer_wheel_timer_t fast_timer;
+static timer_wheel_timer_t report_timer;
+
+/** \brief Runs of the fast job, and the most it has run late, in microseconds. */
+static volatile uint32_t fast_runs;
+static volatile uint32_t fast_worst_late;
+
+/** \brief The fast job, which only measures how late it runs.
+ */
+static void fast_job(void*)
+{
+	static uint32_t expected;
+	uint32_t now = timer_wheel_now_us();
+
+	if (fast_runs++ == 0)
+	{
+		expected = now;
+	}
+	if (now - expected > fast_worst_late)
+	{
+		fast_worst_late = now - expected;
+	}
+	expected += FAST_PERIOD_US;
+}
+
+/** \brief Prints how the fast job has been doing.
+ */
+static void report_job(void*)
+{
+	printf("Timer wheel: %lu runs, worst %lu us late, %lu overruns\r\n",
+		   (unsigned long) fast_runs, (unsigned long) fast_worst_late,
+		   (unsigned long) fast_timer.overruns);
+}
+
+/** \brief Timer wheel example entry point.
+ */
+int main(void)
+{
+	// Create a pointer to a system_function object so we can use the system methods
+	sys_function = new system_functions();
+	
+	// Initialize the SAM system
+	sys_function->init_clock();
+	sys_function->init_board();
+
+	// Initialize the console UART
+	sys_function->config_console();
+
+	// Report any crash from the previous run, and catch the next one
+	fault_init();
+	fault_report();
+	
+	// Output example information
+	puts(STRING_HEADER);
+
+	// Run a job every 500 us from the timer wheel's interrupt, and report on it
+	// every second from the timer wheel's task
+	timer_wheel_init();
+	timer_wheel_start_task(3);
+	timer_wheel_setup(&fast_timer, fast_job, NULL, TIMER_WHEEL_IN_ISR);
+	timer_wheel_setup(&report_timer, report_job, NULL, TIMER_WHEEL_DEFERRED);
+	timer_wheel_start(&fast_timer, FAST_PERIOD_US, FAST_PERIOD_US);
+	timer_wheel_start(&report_timer, 1000000UL, 1000000UL);
+		
+	// Start the FreeRTOS Task Scheduler
+	vTaskStartScheduler();
+	
+	// Let the user know if FreeRTOS crashes.
+	printf("Something terrible has happened and FreeRTOS exited!");
+
+	// Loop until a reset
+	while (1) {
+		// Wait for 500ms
+		sys_function->mdelay(500);
+	}
+}
\ No newline at end of file
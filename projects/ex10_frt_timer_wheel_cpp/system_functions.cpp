@@ -0,0 +1,66 @@
+/** \file system_functions.cpp
+ *  This file contains the class for system functions for the CPP version of the 
+ *  FreeRTOS example.
+ */
+
+// Include the header
+#include "system_functions.h"
+#include "lib/Services/console.h"
+#include "lib/Services/systime.h"
+
+// Defines for the system class
+/** \brief This constructor really doesn't do much but give access to the class methods.
+ */
+system_functions::system_functions(void)
+{
+	// Initialize the object variables and pointers
+	g_ul_ms_ticks = 0;
+	g_b_led0_active = true;
+	g_b_led1_active = true;
+}
+
+/** \brief Initialize the system clock with default ASF parameters, then start the
+ *  system time service which mdelay() uses
+ */
+void system_functions::init_clock(void)
+{
+	sysclk_init();
+	systime_init();
+}
+
+/** \brief Initialize the board with default ASF parameters.
+ */
+void system_functions::init_board(void)
+{
+	board_init();
+}
+
+/** \brief Configure UART console
+ *  Uses options specified in include/configure_console.h. Output goes through the
+ *  interrupt-driven console service, so printf() only waits for the bytes to be
+ *  copied into RAM; see lib/Services/console.h.
+ */
+void system_functions::config_console(void)
+{
+	usart_serial_options_t uart_serial_options =
+	{
+		.baudrate   = CONF_UART_BAUDRATE,
+		.charlength = CONF_UART_CHAR_LENGTH,
+		.paritytype = CONF_UART_PARITY,
+		.stopbits   = CONF_UART_STOP_BIT
+	};
+
+	/* Configure console UART. */
+	sysclk_enable_peripheral_clock(CONSOLE_UART_ID);
+	console_init(&uart_serial_options);
+}
+
+/** \brief Wait for the given number of milliseconds. Under FreeRTOS, a task calling
+ *  this gives up the processor while it waits; see lib/Services/systime.h.
+ *
+ *  \param ul_dly_ticks  Delay to wait for, in milliseconds.
+ */
+void system_functions::mdelay(uint32_t ul_dly_ticks)
+{
+	systime_delay_ms(ul_dly_ticks);
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+//**************************************************************************************
+/** \file task_adc.cpp
+ *    This file contains the source for a task class that reports on a stream of
+ *    samples from two ADC channels.
+ *
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "task_adc.h"               // Header for this task
+#include "lib/Services/adc_stream.h"
+
+/** \brief The mean of each ADC channel over the last block
+ */
+static volatile uint16_t adc_means[ADC_CHANNELS];
+
+//-------------------------------------------------------------------------------------
+/** \brief This constructor creates the report task.
+ *  @param aName A character string which will be the name of this task
+ *  @param aPriority The priority at which this task will initially run
+ *  @param aStackSize The size of this task's stack in words
+ */
+
+task_adc::task_adc (const char* aName, 
+					unsigned portBASE_TYPE aPriority, 
+					size_t aStackSize)
+					: TaskClass (aName, aPriority, aStackSize)
+{
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief Takes the mean of each channel in a block of ADC samples.
+ *  @param samples The block, with the channels in turn
+ *  @param count Number of samples in the block
+ *  @param arg Not used
+ */
+
+void task_adc::adc_block (const uint16_t* samples, uint32_t count, void* arg)
+{
+	(void) arg;
+
+	uint32_t sums[ADC_CHANNELS] = { 0 };
+
+	for (uint32_t i = 0; i < count; i += ADC_CHANNELS)
+	{
+		for (uint32_t ch = 0; ch < ADC_CHANNELS; ch++)
+		{
+			sums[ch] += ADC_STREAM_VALUE (samples[i + ch]);
+		}
+	}
+	for (uint32_t ch = 0; ch < ADC_CHANNELS; ch++)
+	{
+		adc_means[ch] = sums[ch] / (count / ADC_CHANNELS);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This is the run method for the report task.
+ */
+
+void task_adc::run (void)
+{
+	portTickType last_wake = xTaskGetTickCount ();
+
+	for (;;)
+	{
+		delay_from_for (last_wake, ADC_REPORT_PERIOD);
+
+		adc_stream_print_stats ();
+		printf ("ADC means: %u %u\r\n", (unsigned) adc_means[0], (unsigned) adc_means[1]);
+	}
+}
@@ -0,0 +1,65 @@
+//**************************************************************************************
+/** \file task_adc.h
+ *    This file contains the header for a task class that reports on a stream of
+ *    samples from two ADC channels.
+ *
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_ADC_H_
+#define _TASK_ADC_H_
+
+#include <FreeRTOS.h>                         // Header for FreeRTOS
+#include "shares.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"       // Header for FRT C++ wrapper
+
+/** \brief The number of ADC channels streamed, and the sequences of them converted
+ *  per second
+ */
+#define ADC_CHANNELS             2
+#define ADC_RATE_HZ              100000UL
+
+/** \brief The time between reports, in milliseconds
+ */
+#define ADC_REPORT_PERIOD        1000
+
+//-------------------------------------------------------------------------------------
+/** \brief   This task reports on the blocks which \c adc_block() takes in.
+ *  \details \c adc_block() is the ADC stream's callback, and runs in the ADC
+ *  stream's task, once per block. It takes the mean of each channel over the
+ *  block. Once every \c ADC_REPORT_PERIOD milliseconds this task prints the
+ *  stream's counts and the latest means.
+ */
+
+class task_adc : public TaskClass
+{
+private:
+	
+protected:
+	
+public:
+	// This constructor creates a generic task of which many copies can be made
+	task_adc (const char*, unsigned portBASE_TYPE, size_t);
+	
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+
+	// Takes the means of the channels in a block from the ADC stream
+	static void adc_block (const uint16_t* samples, uint32_t count, void* arg);
+};
+
+#endif // _TASK_ADC_H_
@@ -0,0 +1,134 @@
+//**************************************************************************************
+/** \file task_dsp.cpp
+ *    This file contains the source for a task class that runs a signal processing
+ *    pipeline on an ADC stream and reports what it finds.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "task_dsp.h"               // Header for this task
+#include "lib/Services/adc_stream.h"
+#include "lib/ASF_Config/conf_adc_stream.h"
+#include "lib/Services/dsp_pipeline.h"
+
+/** \brief The length of the spectrum; the decimated block is padded out to it
+ */
+#define DSP_FFT_LEN              256
+
+/** \brief The block, worked on in place by the pipeline
+ */
+static q15_t dsp_samples[ADC_STREAM_BLOCK_SAMPLES];
+
+/** \brief DC blocking filter, y[n] = x[n] - x[n-1] + 0.995 y[n-1], as one biquad
+ *  with its coefficients halved (post shift 1).
+ */
+static const q15_t dc_block_coeffs[] = { 16384, 0, -16384, 0, 16302, 0 };
+
+/** \brief 16 tap low-pass filter, cut off at a tenth of the sample rate, for
+ *  decimating by 4. Hamming windowed sinc.
+ */
+static const q15_t low_pass_coeffs[] =
+{
+	-114, -159, -139, 291, 1450, 3284, 5246, 6524,
+	6524, 5246, 3284, 1450, 291, -139, -159, -114
+};
+
+/** \brief The pipeline and its stages
+ */
+static dsp_pipeline_t dsp_pipe;
+static dsp_stage_t dc_block_stage;
+static dsp_stage_t decimate_stage;
+static dsp_stage_t rms_stage;
+static dsp_stage_t fft_stage;
+static q15_t dc_block_state[4];
+static q15_t decimate_state[16 + ADC_STREAM_BLOCK_SAMPLES - 1];
+static q15_t fft_work[2 * DSP_FFT_LEN];
+
+/** \brief The strongest frequency bin in the last spectrum, leaving out DC
+ */
+static volatile uint32_t dsp_peak_bin;
+
+//-------------------------------------------------------------------------------------
+/** \brief This constructor creates the report task and sets up the pipeline.
+ *  @param aName A character string which will be the name of this task
+ *  @param aPriority The priority at which this task will initially run
+ *  @param aStackSize The size of this task's stack in words
+ */
+
+task_dsp::task_dsp (const char* aName, 
+					unsigned portBASE_TYPE aPriority, 
+					size_t aStackSize)
+					: TaskClass (aName, aPriority, aStackSize)
+{
+	dsp_pipeline_init (&dsp_pipe, "ADC");
+	dsp_iir_q15_init (&dc_block_stage, dc_block_coeffs, 1, dc_block_state, 1);
+	dsp_decimate_q15_init (&decimate_stage, low_pass_coeffs, 16, 4, decimate_state,
+			ADC_STREAM_BLOCK_SAMPLES);
+	dsp_rms_q15_init (&rms_stage);
+	dsp_fft_mag_q15_init (&fft_stage, DSP_FFT_LEN, fft_work);
+	dsp_pipeline_add (&dsp_pipe, &dc_block_stage);
+	dsp_pipeline_add (&dsp_pipe, &decimate_stage);
+	dsp_pipeline_add (&dsp_pipe, &rms_stage);
+	dsp_pipeline_add (&dsp_pipe, &fft_stage);
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief Runs a block from the ADC stream through the pipeline and finds the
+ *  strongest frequency in it.
+ *  @param samples The block
+ *  @param count Number of samples in the block
+ *  @param arg Not used
+ */
+
+void task_dsp::adc_block (const uint16_t* samples, uint32_t count, void* arg)
+{
+	(void) arg;
+
+	uint32_t bins = dsp_pipeline_run (&dsp_pipe, dsp_samples,
+			dsp_adc_to_q15 (samples, count, 1, 0, dsp_samples));
+	uint32_t peak = 1;
+	for (uint32_t bin = 2; bin < bins; bin++)
+	{
+		if (dsp_samples[bin] > dsp_samples[peak])
+		{
+			peak = bin;
+		}
+	}
+	dsp_peak_bin = peak;
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This is the run method for the report task.
+ */
+
+void task_dsp::run (void)
+{
+	portTickType last_wake = xTaskGetTickCount ();
+	uint32_t reports = 0;
+
+	for (;;)
+	{
+		delay_from_for (last_wake, DSP_REPORT_PERIOD);
+
+		adc_stream_print_stats ();
+		printf ("RMS %ld, peak at %lu Hz\r\n", (long) dsp_rms_get (&rms_stage),
+				(unsigned long) (dsp_peak_bin * (DSP_ADC_RATE_HZ / 4) / DSP_FFT_LEN));
+
+		if (++reports % DSP_COST_REPORTS == 0)
+		{
+			dsp_pipeline_print_report (&dsp_pipe);
+		}
+	}
+}
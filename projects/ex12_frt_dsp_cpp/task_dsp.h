@@ -0,0 +1,67 @@
+//**************************************************************************************
+/** \file task_dsp.h
+ *    This file contains the header for a task class that runs a signal processing
+ *    pipeline on an ADC stream and reports what it finds.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_DSP_H_
+#define _TASK_DSP_H_
+
+#include <FreeRTOS.h>                         // Header for FreeRTOS
+#include "shares.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"       // Header for FRT C++ wrapper
+
+/** \brief The ADC channel streamed, AD7 (pin A0 on the Due), and its sample rate
+ */
+#define DSP_ADC_CHANNEL          7
+#define DSP_ADC_RATE_HZ          100000UL
+
+/** \brief The time between reports, in milliseconds, and the reports between
+ *  printouts of what each stage costs
+ */
+#define DSP_REPORT_PERIOD        1000
+#define DSP_COST_REPORTS         10
+
+//-------------------------------------------------------------------------------------
+/** \brief   This task reports on the pipeline which \c adc_block() runs.
+ *  \details The pipeline takes out DC with a one-biquad IIR filter, decimates by 4
+ *  to 25 kHz through a 16 tap low-pass FIR filter, measures the RMS, then takes the
+ *  spectrum. \c adc_block() is the ADC stream's callback, and runs in the ADC
+ *  stream's task, once per block. Once every \c DSP_REPORT_PERIOD milliseconds this
+ *  task prints the RMS, the strongest frequency and the stream's counts, and every
+ *  \c DSP_COST_REPORTS reports the cycles each stage has taken.
+ */
+
+class task_dsp : public TaskClass
+{
+private:
+	
+protected:
+	
+public:
+	// This constructor creates a generic task of which many copies can be made
+	task_dsp (const char*, unsigned portBASE_TYPE, size_t);
+	
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+
+	// Runs the pipeline on a block from the ADC stream
+	static void adc_block (const uint16_t* samples, uint32_t count, void* arg);
+};
+
+#endif // _TASK_DSP_H_
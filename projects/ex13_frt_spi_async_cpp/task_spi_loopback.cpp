@@ -0,0 +1,86 @@
+//**************************************************************************************
+/** \file task_spi_loopback.cpp
+ *    This file contains the source for a task class that sends blocks over SPI by
+ *    DMA and checks what comes back.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "task_spi_loopback.h"      // Header for this task
+#include "lib/Services/spi_async.h"
+#include "lib/Services/systime.h"
+
+/** \brief The bytes sent and the bytes read back
+ */
+static uint8_t loopback_tx[SPI_LOOPBACK_BYTES];
+static uint8_t loopback_rx[SPI_LOOPBACK_BYTES];
+
+//-------------------------------------------------------------------------------------
+/** \brief This constructor creates the loopback task.
+ *  @param aName A character string which will be the name of this task
+ *  @param aPriority The priority at which this task will initially run
+ *  @param aStackSize The size of this task's stack in words
+ */
+
+task_spi_loopback::task_spi_loopback (const char* aName, 
+									  unsigned portBASE_TYPE aPriority, 
+									  size_t aStackSize)
+									  : TaskClass (aName, aPriority, aStackSize)
+{
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This is the run method for the loopback task.
+ */
+
+void task_spi_loopback::run (void)
+{
+	spi_async_xfer_t xfer = { loopback_tx, loopback_rx, SPI_LOOPBACK_BYTES,
+			SPI_LOOPBACK_CLOCK_HZ, SPI_LOOPBACK_CS, 0, false, NULL, NULL };
+	portTickType last_wake = xTaskGetTickCount ();
+	uint32_t blocks = 0;
+	uint32_t matched = 0;
+
+	for (;;)
+	{
+		delay_from_for (last_wake, SPI_LOOPBACK_PERIOD);
+
+		// A different pattern each time, so a stale buffer can't pass
+		for (uint32_t i = 0; i < SPI_LOOPBACK_BYTES; i++)
+		{
+			loopback_tx[i] = (uint8_t) (i + blocks);
+			loopback_rx[i] = (uint8_t) ~loopback_tx[i];
+		}
+
+		uint32_t start = systime_now_us ();
+		if (!spi_async_transfer (&xfer))
+		{
+			printf ("SPI: transfer refused\r\n");
+			continue;
+		}
+		uint32_t taken = (uint32_t) (systime_now_us () - start);
+
+		blocks++;
+		uint32_t same = 0;
+		for (uint32_t i = 0; i < SPI_LOOPBACK_BYTES; i++)
+		{
+			same += (loopback_rx[i] == loopback_tx[i]) ? 1 : 0;
+		}
+		matched += (same == SPI_LOOPBACK_BYTES) ? 1 : 0;
+		printf ("SPI: %lu bytes in %lu us, %lu matched; %lu of %lu blocks came back whole\r\n",
+				(unsigned long) SPI_LOOPBACK_BYTES, (unsigned long) taken,
+				(unsigned long) same, (unsigned long) matched, (unsigned long) blocks);
+	}
+}
@@ -0,0 +1,61 @@
+//**************************************************************************************
+/** \file task_spi_loopback.h
+ *    This file contains the header for a task class that sends blocks over SPI by
+ *    DMA and checks what comes back.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_SPI_LOOPBACK_H_
+#define _TASK_SPI_LOOPBACK_H_
+
+#include <FreeRTOS.h>                         // Header for FreeRTOS
+#include "shares.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"       // Header for FRT C++ wrapper
+
+/** \brief The bytes in each block, the SPI clock, and the chip select used
+ */
+#define SPI_LOOPBACK_BYTES       256
+#define SPI_LOOPBACK_CLOCK_HZ    4000000UL
+#define SPI_LOOPBACK_CS          0
+
+/** \brief The time between blocks, in milliseconds
+ */
+#define SPI_LOOPBACK_PERIOD      1000
+
+//-------------------------------------------------------------------------------------
+/** \brief   This task sends a block over SPI once a period and checks the echo.
+ *  \details Each block is sent with \c spi_async_transfer(), which blocks the task
+ *  while the DMAC moves the bytes, so the processor is free for other tasks in the
+ *  meantime. With the Due's MOSI pin wired to MISO, every byte comes back as it was
+ *  sent; with nothing connected, the task still runs and reports the mismatches.
+ */
+
+class task_spi_loopback : public TaskClass
+{
+private:
+	
+protected:
+	
+public:
+	// This constructor creates a generic task of which many copies can be made
+	task_spi_loopback (const char*, unsigned portBASE_TYPE, size_t);
+	
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+};
+
+#endif // _TASK_SPI_LOOPBACK_H_
@@ -0,0 +1,103 @@
+//**************************************************************************************
+/** \file task_imu.cpp
+ *    This file contains the source for a task class that polls an MPU-6050 motion
+ *    sensor over I2C and reports its readings.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "task_imu.h"               // Header for this task
+#include "lib/Services/twi_async.h"
+
+/** \brief The sensor's readings: accelerometer, temperature and gyro registers
+ */
+static uint8_t imu_accel[6];
+static uint8_t imu_temp[2];
+static uint8_t imu_gyro[6];
+
+/** \brief Readings taken, counted when the last of the three reads is done
+ */
+static volatile uint32_t imu_readings;
+
+/** \brief Counts each complete reading; run from the TWI interrupt.
+ */
+static void imu_done (twi_async_req_t* req)
+{
+	if (req->status == TWI_ASYNC_DONE)
+	{
+		imu_readings++;
+	}
+}
+
+/** \brief The register write which wakes the sensor up, and the reads of its data
+ */
+static uint8_t imu_wake_data[] = { 0x00 };
+static twi_async_req_t imu_wake = { IMU_ADDRESS, 0x6B, true, imu_wake_data, 1, NULL, NULL };
+static twi_async_req_t imu_reads[] =
+{
+	{ IMU_ADDRESS, 0x3B, false, imu_accel, sizeof(imu_accel), NULL, NULL },
+	{ IMU_ADDRESS, 0x41, false, imu_temp, sizeof(imu_temp), NULL, NULL },
+	{ IMU_ADDRESS, 0x43, false, imu_gyro, sizeof(imu_gyro), imu_done, NULL },
+};
+
+//-------------------------------------------------------------------------------------
+/** \brief This constructor creates the sensor task.
+ *  @param aName A character string which will be the name of this task
+ *  @param aPriority The priority at which this task will initially run
+ *  @param aStackSize The size of this task's stack in words
+ */
+
+task_imu::task_imu (const char* aName, 
+					unsigned portBASE_TYPE aPriority, 
+					size_t aStackSize)
+					: TaskClass (aName, aPriority, aStackSize)
+{
+}
+
+//-------------------------------------------------------------------------------------
+/** \brief This is the run method for the sensor task.
+ */
+
+void task_imu::run (void)
+{
+	portTickType last_wake;
+	uint32_t polls = 0;
+
+	if (twi_async_transfer (&imu_wake) != TWI_ASYNC_DONE)
+	{
+		printf ("IMU: no answer at address 0x%02x\r\n", IMU_ADDRESS);
+	}
+
+	last_wake = xTaskGetTickCount ();
+	for (;;)
+	{
+		delay_from_for (last_wake, IMU_POLL_PERIOD);
+
+		for (uint32_t i = 0; i < sizeof(imu_reads) / sizeof(imu_reads[0]); i++)
+		{
+			twi_async_submit (&imu_reads[i]);
+		}
+
+		if (++polls % (IMU_REPORT_PERIOD / IMU_POLL_PERIOD) == 0)
+		{
+			printf ("IMU: %lu readings, accel X %d, temp %d, gyro X %d\r\n",
+					(unsigned long) imu_readings,
+					(int) (int16_t) ((imu_accel[0] << 8) | imu_accel[1]),
+					(int) (int16_t) ((imu_temp[0] << 8) | imu_temp[1]),
+					(int) (int16_t) ((imu_gyro[0] << 8) | imu_gyro[1]));
+			twi_async_print_stats ();
+		}
+	}
+}
@@ -0,0 +1,63 @@
+//**************************************************************************************
+/** \file task_imu.h
+ *    This file contains the header for a task class that polls an MPU-6050 motion
+ *    sensor over I2C and reports its readings.
+ *
+ *  License:
+ *    This file is copyright 2026 by the Altrino Due contributors. It is currently
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_IMU_H_
+#define _TASK_IMU_H_
+
+#include <FreeRTOS.h>                         // Header for FreeRTOS
+#include "shares.h"
+#include "lib/FreeRTOS_CPP/task_wrap.h"       // Header for FRT C++ wrapper
+
+/** \brief The sensor's I2C address, with its AD0 pin low
+ */
+#define IMU_ADDRESS              0x68
+
+/** \brief The time between readings, and between reports, in milliseconds
+ */
+#define IMU_POLL_PERIOD          10
+#define IMU_REPORT_PERIOD        1000
+
+//-------------------------------------------------------------------------------------
+/** \brief   This task reads an MPU-6050 on the Due's SDA and SCL pins.
+ *  \details It wakes the sensor with a blocking write, then every
+ *  \c IMU_POLL_PERIOD milliseconds queues reads of the accelerometer, temperature
+ *  and gyro registers and goes straight back to sleep; the TWI interrupt carries
+ *  them out. As the three blocks of registers follow one another, the manager
+ *  batches the reads into one bus transaction. Once every \c IMU_REPORT_PERIOD
+ *  milliseconds the task prints how many readings were completed and the manager's
+ *  counts. With no sensor connected, every transaction is NACKed and counted.
+ */
+
+class task_imu : public TaskClass
+{
+private:
+	
+protected:
+	
+public:
+	// This constructor creates a generic task of which many copies can be made
+	task_imu (const char*, unsigned portBASE_TYPE, size_t);
+	
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+};
+
+#endif // _TASK_IMU_H_
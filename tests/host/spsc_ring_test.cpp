@@ -0,0 +1,152 @@
+//*************************************************************************************
+/** \file spsc_ring_test.cpp
+ *    This file stresses SpscRing from lib/FreeRTOS_CPP/spsc_ring.h with a producer
+ *    and a consumer in two threads, with 'make host-test' (see common/host.mk).
+ *
+ *    The ring is small, so its indices wrap around its slots hundreds of
+ *    thousands of times. Every item carries its sequence number and words made
+ *    from it, and the consumer, which takes items one at a time and in batches of
+ *    varying size, checks that each arrives once, in order and whole. The
+ *    producer retries while the ring is full, and those refusals must match
+ *    overruns(). Either side yields when it has to wait, so that the test still
+ *    gets through on a host with one processor.
+ */
+//*************************************************************************************
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "lib/FreeRTOS_CPP/spsc_ring.h"
+
+/// Items passed through the ring
+#define ITEMS                  4000000UL
+
+/// Slots in the ring
+#define SLOTS                  16
+
+/// Most items the consumer takes in one batch
+#define MAX_BATCH              7
+
+/** \brief An item, bigger than one store, so that a torn copy shows.
+ */
+struct item_t {
+	uint32_t seq;
+	uint32_t inverse;
+	uint32_t scrambled;
+	uint32_t again;
+};
+
+static SpscRing<item_t, SLOTS> ring;
+
+/// Pushes the producer had refused because the ring was full
+static uint32_t refused;
+
+/** \brief Pushes every item in order, retrying each until there is room.
+ *  @param arg Not used
+ */
+static void* producer(void* arg)
+{
+	(void) arg;
+
+	for (uint32_t seq = 0; seq < ITEMS; seq++)
+	{
+		item_t item = { seq, ~seq, (uint32_t) (seq * 2654435761UL), seq };
+
+		while (!ring.push(item))
+		{
+			refused++;
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+/** \brief Checks one item against the sequence number it should have.
+ *  @return True if it is the expected item and is whole
+ */
+static bool check_item(const item_t& item, uint32_t expected)
+{
+	if ((item.seq == expected) && (item.inverse == ~expected)
+			&& (item.scrambled == (uint32_t) (expected * 2654435761UL))
+			&& (item.again == expected))
+	{
+		return true;
+	}
+	printf("Item %lu arrived as %lu %08lx %08lx %lu\r\n", (unsigned long) expected,
+			(unsigned long) item.seq, (unsigned long) item.inverse,
+			(unsigned long) item.scrambled, (unsigned long) item.again);
+	return false;
+}
+
+int main(void)
+{
+	pthread_t thread;
+	item_t batch[MAX_BATCH];
+	uint32_t expected = 0;
+	uint32_t turn = 0;
+	bool passed = true;
+
+	if (pthread_create(&thread, NULL, producer, NULL) != 0)
+	{
+		printf("spsc_ring_test: no producer thread\r\n");
+		return EXIT_FAILURE;
+	}
+
+	// Take single items and batches of 1 to MAX_BATCH in turn, so that batches
+	// start and end all over the ring
+	while (passed && (expected < ITEMS))
+	{
+		uint32_t want = turn % (MAX_BATCH + 1);
+		uint32_t got;
+
+		turn++;
+		if (want == 0)
+		{
+			got = ring.pop(batch[0]) ? 1 : 0;
+		}
+		else
+		{
+			got = ring.pop_batch(batch, want);
+			if (got > want)
+			{
+				printf("pop_batch() gave %lu items for %lu\r\n", (unsigned long) got,
+						(unsigned long) want);
+				passed = false;
+				break;
+			}
+		}
+		for (uint32_t i = 0; passed && (i < got); i++)
+		{
+			passed = check_item(batch[i], expected++);
+		}
+
+		// Give the producer the processor if it's waiting for it
+		if (got == 0)
+		{
+			sched_yield();
+		}
+	}
+
+	// After a failure the producer may be stuck on a full ring, so it isn't waited for
+	if (passed)
+	{
+		pthread_join(thread, NULL);
+	}
+	if (passed && !ring.empty())
+	{
+		printf("%lu items left over\r\n", (unsigned long) ring.size());
+		passed = false;
+	}
+	if (passed && (ring.overruns() != refused))
+	{
+		printf("overruns() is %lu, but %lu pushes were refused\r\n",
+				(unsigned long) ring.overruns(), (unsigned long) refused);
+		passed = false;
+	}
+
+	printf("%lu items through %d slots, %lu pushes refused\r\n",
+			(unsigned long) expected, SLOTS, (unsigned long) refused);
+	printf("spsc_ring_test: %s\r\n", passed ? "passed" : "FAILED");
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
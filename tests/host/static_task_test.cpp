@@ -0,0 +1,124 @@
+//*************************************************************************************
+/** \file static_task_test.cpp
+ *    This file checks that creating a StaticTaskClass task takes nothing from the
+ *    FreeRTOS heap, with 'make host-test' (see common/host.mk). Static allocation
+ *    needs FreeRTOS V9.0.0 or later, so this can only run on the host kernel; the
+ *    V8.0.1 kernel the board builds with leaves StaticTaskClass out.
+ *
+ *    A dozen static tasks are created and the heap's free bytes must not change;
+ *    one TaskClass task, whose stack and TCB do come from the heap, shows the count
+ *    would have moved. Then the scheduler is started to see every task run.
+ */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include "lib/FreeRTOS_CPP/task_wrap.h"
+
+#if (FRT_STATIC_ALLOCATION == 1)
+
+/// The number of static tasks, which fits the stack monitor with room to spare
+#define STATIC_TASKS           12
+
+/// Set by each static task when it runs
+static volatile bool static_ran[STATIC_TASKS];
+
+/** \brief A static task which notes that it ran, then sleeps for good.
+ */
+class static_task : public StaticTaskClass<configMINIMAL_STACK_SIZE> {
+private:
+	int index;
+
+public:
+	static_task(const char* name, int anIndex)
+		: StaticTaskClass<configMINIMAL_STACK_SIZE>(name, tskIDLE_PRIORITY + 1),
+		  index(anIndex) {}
+
+	void run(void)
+	{
+		static_ran[index] = true;
+		for (;;)
+		{
+			vTaskDelay(portMAX_DELAY);
+		}
+	}
+};
+
+/** \brief Creates the static tasks, Index of them, each in a variable of its own
+ *  so that it's constructed here rather than before main().
+ */
+template <int Index>
+static void create_static_tasks(void)
+{
+	static static_task task("Static", Index - 1);
+
+	create_static_tasks<Index - 1>();
+}
+
+template <>
+void create_static_tasks<0>(void)
+{
+}
+
+/** \brief Waits for the static tasks to run, then ends the test.
+ */
+class check_task : public TaskClass {
+public:
+	check_task(const char* name)
+		: TaskClass(name, tskIDLE_PRIORITY + 1, configMINIMAL_STACK_SIZE) {}
+
+	void run(void)
+	{
+		int ran = 0;
+		int i;
+
+		vTaskDelay(configMS_TO_TICKS(100));
+		for (i = 0; i < STATIC_TASKS; i++)
+		{
+			ran += static_ran[i] ? 1 : 0;
+		}
+		printf("%d of %d static tasks ran\r\n", ran, STATIC_TASKS);
+		printf("static_task_test: %s\r\n", (ran == STATIC_TASKS) ? "passed" : "FAILED");
+		exit((ran == STATIC_TASKS) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+};
+
+int main(void)
+{
+	size_t before;
+	size_t after_static;
+	size_t after_dynamic;
+
+	// heap_4 counts nothing as free until its first allocation sets it up
+	vPortFree(pvPortMalloc(1));
+
+	before = xPortGetFreeHeapSize();
+	create_static_tasks<STATIC_TASKS>();
+	after_static = xPortGetFreeHeapSize();
+	new check_task("Check");
+	after_dynamic = xPortGetFreeHeapSize();
+
+	printf("Free heap: %lu bytes, %lu after %d static tasks, %lu after a dynamic one\r\n",
+			(unsigned long) before, (unsigned long) after_static, STATIC_TASKS,
+			(unsigned long) after_dynamic);
+	if ((after_static != before) || (after_dynamic >= after_static))
+	{
+		printf("static_task_test: FAILED\r\n");
+		return EXIT_FAILURE;
+	}
+
+	vTaskStartScheduler();
+	return EXIT_FAILURE;
+}
+
+#else
+
+int main(void)
+{
+	printf("static_task_test: skipped, the kernel has no static allocation\r\n");
+	return EXIT_SUCCESS;
+}
+
+#endif // FRT_STATIC_ALLOCATION
@@ -0,0 +1,127 @@
+//*************************************************************************************
+/** \file systime_test.c
+ *    This file checks the delays in lib/Services/systime.c against the host's own
+ *    clock, with 'make host-test' (see common/host.mk).
+ *
+ *    No delay may end early. How late one ends depends on when the host gets back
+ *    to the thread, so only the best of several runs is held to a bound: a few
+ *    tens of microseconds for delays spun on the cycle counter, before the
+ *    scheduler starts, and half a tick for those which sleep on the kernel's
+ *    ticks first, which would catch one sleeping a tick too long.
+ */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sysclk.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include "lib/Services/systime.h"
+
+/// Runs of each delay, of which the best is held to the bound
+#define RUNS                   5
+
+/// How early a delay may seem to end, for the clocks' rounding
+#define EARLY_NS               2000
+
+/// How late the best run of a spun delay, and of a sleeping one, may end
+#define SPIN_LATE_NS           50000
+#define SLEEP_LATE_NS          (500000000 / configTICK_RATE_HZ)
+
+/// Checks which have failed
+static int failures;
+
+/** \brief Returns the host's monotonic clock in nanoseconds.
+ */
+static int64_t now_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64_t) now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/** \brief Times a delay several times and checks how far each run was out.
+ *  @param name What is being delayed, for the report
+ *  @param length The length of the delay, in microseconds
+ *  @param in_ms Whether to call systime_delay_ms() rather than systime_delay_us()
+ *  @param late_ns How late the best run may end
+ */
+static void check_delay(const char *name, uint32_t length, int in_ms, int64_t late_ns)
+{
+	int64_t wanted = (int64_t) length * 1000;
+	int64_t lowest = 0;
+	int64_t highest = 0;
+	int run;
+
+	for (run = 0; run < RUNS; run++)
+	{
+		int64_t start = now_ns();
+		int64_t error;
+
+		if (in_ms)
+		{
+			systime_delay_ms(length / 1000);
+		}
+		else
+		{
+			systime_delay_us(length);
+		}
+		error = now_ns() - start - wanted;
+		if ((run == 0) || (error < lowest))
+		{
+			lowest = error;
+		}
+		if ((run == 0) || (error > highest))
+		{
+			highest = error;
+		}
+	}
+
+	if ((lowest < -EARLY_NS) || (lowest > late_ns))
+	{
+		failures++;
+	}
+	printf("%-16s %8lu us: error %7lld to %7lld ns%s\r\n", name, (unsigned long) length,
+			(long long) lowest, (long long) highest,
+			((lowest < -EARLY_NS) || (lowest > late_ns)) ? "  FAILED" : "");
+}
+
+/** \brief Checks the delays which sleep, then ends the test.
+ *  @param params Not used
+ */
+static void test_task(void *params)
+{
+	(void) params;
+
+	check_delay("systime_delay_us", 1500, 0, SLEEP_LATE_NS);
+	check_delay("systime_delay_us", 5000, 0, SLEEP_LATE_NS);
+	check_delay("systime_delay_us", 20000, 0, SLEEP_LATE_NS);
+	check_delay("systime_delay_ms", 1000, 1, SLEEP_LATE_NS);
+	check_delay("systime_delay_ms", 2000, 1, SLEEP_LATE_NS);
+	check_delay("systime_delay_ms", 10000, 1, SLEEP_LATE_NS);
+
+	printf("systime_test: %s\r\n", (failures == 0) ? "passed" : "FAILED");
+	exit((failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+int main(void)
+{
+	static const uint32_t spun[] = { 1, 10, 100, 1000, 10000 };
+	uint32_t i;
+
+	sysclk_init();
+	systime_init();
+
+	// Before the scheduler starts, every delay is spun on the cycle counter
+	for (i = 0; i < sizeof(spun) / sizeof(spun[0]); i++)
+	{
+		check_delay("systime_delay_us", spun[i], 0, SPIN_LATE_NS);
+	}
+
+	xTaskCreate(test_task, "Test", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1,
+			NULL);
+	vTaskStartScheduler();
+	return EXIT_FAILURE;
+}
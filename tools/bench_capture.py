@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""Collector for the results printed by lib/Services/rtos_bench.cpp.
+
+Reads the console output of a program that runs the kernel benchmarks, passes
+it through to the screen, and saves the benchmark lines (those starting with
+"bench,") to a file, stopping at the "bench,end" line. For example:
+
+    python3 tools/bench_capture.py --port /dev/ttyACM0 -o ex08_frt_bench_cpp_bench.csv
+    ./ex08_frt_bench_cpp_host | python3 tools/bench_capture.py -o host_bench.csv
+
+Given an earlier file with --compare, it then prints how the mean of each
+result has changed since, and exits with status 1 if any got slower by more
+than --threshold percent. Results are only compared if their units match, so
+board and host runs can't be mixed up.
+"""
+
+import argparse
+import sys
+
+PREFIX = "bench,"
+END = "bench,end"
+
+
+def read_results(lines):
+    """Returns the header fields and a dictionary of (unit, samples, min, mean,
+    max) by name, from benchmark lines."""
+    header = {}
+    results = {}
+    for line in lines:
+        fields = line.strip().split(",")
+        if len(fields) < 2 or fields[0] != "bench":
+            continue
+        if fields[1] == "begin":
+            header = dict(field.split("=", 1) for field in fields[2:] if "=" in field)
+        elif len(fields) == 7:
+            results[fields[1]] = (fields[2],) + tuple(int(value) for value in fields[3:])
+    return header, results
+
+
+def compare(old_path, new_lines, threshold):
+    """Prints the change in each mean; returns True if none got much slower."""
+    with open(old_path) as old_file:
+        old_header, old = read_results(old_file)
+    new_header, new = read_results(new_lines)
+    if old_header.get("kernel") != new_header.get("kernel"):
+        print("kernel: %s -> %s" % (old_header.get("kernel"), new_header.get("kernel")))
+
+    passed = True
+    for name, (unit, samples, _, mean, _) in sorted(new.items()):
+        if name not in old or old[name][0] != unit or old[name][1] == 0 or samples == 0:
+            print("%-16s %10d %-6s (nothing to compare with)" % (name, mean, unit))
+            continue
+        old_mean = old[name][3]
+        change = (mean - old_mean) * 100.0 / old_mean if old_mean else 0.0
+        flag = ""
+        if change > threshold:
+            flag = "  SLOWER"
+            passed = False
+        print("%-16s %10d %-6s was %10d  %+6.1f%%%s" % (name, mean, unit, old_mean,
+                                                       change, flag))
+    return passed
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Save the kernel benchmark results from an Altrino Due console.")
+    parser.add_argument("input", nargs="?",
+                        help="captured console output (default: standard input)")
+    parser.add_argument("--port", help="read from this serial port instead")
+    parser.add_argument("--baud", type=int, default=115200,
+                        help="serial port baud rate (default: 115200)")
+    parser.add_argument("-o", "--output", help="save the benchmark lines to this file")
+    parser.add_argument("--compare", help="an earlier file to compare the results with")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="percentage slowdown counted as a regression (default: 10)")
+    options = parser.parse_args()
+
+    if options.port:
+        import serial
+        stream = serial.Serial(options.port, options.baud, timeout=0.1)
+    elif options.input:
+        stream = open(options.input, "rb")
+    else:
+        stream = sys.stdin.buffer
+
+    lines = []
+    pending = b""
+    finished = False
+    try:
+        while not finished:
+            data = stream.read(256) if options.port else stream.readline()
+            if not data:
+                if options.port:
+                    continue
+                break
+            pending += data
+            while b"\n" in pending and not finished:
+                raw, pending = pending.split(b"\n", 1)
+                line = raw.decode("latin-1").rstrip("\r")
+                sys.stdout.write(line + "\n")
+                if line.startswith(PREFIX):
+                    lines.append(line)
+                    finished = line == END
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+    if not finished:
+        sys.stderr.write("bench_capture: no %s line, so the results are incomplete\n" % END)
+    if options.output:
+        with open(options.output, "w") as out:
+            out.write("\n".join(lines) + "\n")
+    if options.compare and not compare(options.compare, lines, options.threshold):
+        sys.exit(1)
+    if not finished:
+        sys.exit(2)
+
+
+if __name__ == "__main__":
+    main()
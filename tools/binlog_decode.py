@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""Decoder for the binary log records sent by lib/Services/binlog.c.
+
+Reads the console output of a program built with the binlog service, passes
+ordinary text through unchanged, and turns each binary record back into text by
+looking its format string up in the program's ELF file. For example:
+
+    python3 tools/binlog_decode.py build/ex04_frt_task_cpp/ex04_frt_task_cpp_flash.elf --port /dev/ttyACM0
+    python3 tools/binlog_decode.py build/ex04_frt_task_cpp/ex04_frt_task_cpp_flash.elf capture.bin
+
+Each record is printed on a line of its own, prefixed with its time stamp in
+microseconds, which assumes the CPU clock given by --clock (84 MHz on the Due).
+The target's 32-bit stamps wrap every 51 s at 84 MHz; a stamp lower than the one
+before it is taken to have wrapped, so times keep counting up as long as records
+arrive at least that often.
+Gaps in the record sequence numbers, i.e. records dropped on the target because
+the log buffer was full, are reported as they are found.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+HEADER_WORDS = 3
+MAX_ARGS = 4
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+# One printf() conversion: flags, width, precision, length modifier, conversion
+CONVERSION = re.compile(r"%([-+ #0]*)(\d*)(\.\d+)?(hh|h|ll|l|z|j|t|L)?([diouxXcsp%])")
+
+
+class ElfImage(object):
+    """The loadable contents of a 32-bit little-endian ELF file, by address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as elf:
+            data = elf.read()
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise ValueError("%s is not a 32-bit little-endian ELF file" % path)
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+        self.sections = []
+        for index in range(shnum):
+            (_, sh_type, flags, addr, offset, size) = struct.unpack_from(
+                "<IIIIII", data, shoff + index * shentsize)
+            if (flags & SHF_ALLOC) and sh_type != SHT_NOBITS and size > 0:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def string_at(self, address):
+        """Returns the NUL-terminated string at an address, or None."""
+        for base, contents in self.sections:
+            if base <= address < base + len(contents):
+                end = contents.find(b"\0", address - base)
+                if end < 0:
+                    end = len(contents)
+                return contents[address - base:end].decode("latin-1")
+        return None
+
+
+def format_record(image, fmt, args):
+    """Expands a printf()-style format with raw 32-bit arguments."""
+    args = list(args)
+
+    def expand(match):
+        flags, width, precision, _, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        value = args.pop(0) if args else 0
+        if conversion in "di":
+            value = value - (1 << 32) if value & 0x80000000 else value
+            conversion = "d"
+        elif conversion == "u":
+            conversion = "d"
+        elif conversion == "c":
+            value = chr(value & 0xFF)
+        elif conversion == "s":
+            text = image.string_at(value)
+            value = text if text is not None else "<0x%08x>" % value
+        elif conversion == "p":
+            return "0x%08x" % value
+        spec = "%" + flags + width + (precision or "") + conversion
+        return spec % value
+
+    return CONVERSION.sub(expand, fmt)
+
+
+class Decoder(object):
+    """Splits a console byte stream into plain text and binary log records."""
+
+    def __init__(self, image, clock, out):
+        self.image = image
+        self.clock = float(clock)
+        self.out = out
+        self.pending = bytearray()
+        self.next_seq = None
+        self.last_stamp = None
+        self.wraps = 0
+
+    def feed(self, data):
+        self.pending.extend(data)
+        while self.pending:
+            sync = self.pending.find(bytes([SYNC]))
+            if sync != 0:
+                # Everything up to the next record is plain text
+                text = self.pending if sync < 0 else self.pending[:sync]
+                self.out.write(text.decode("latin-1"))
+                del self.pending[:len(text)]
+                continue
+            if len(self.pending) < 4:
+                return
+            nargs = self.pending[1]
+            if nargs > MAX_ARGS:
+                self._skip_byte()
+                continue
+            length = 4 * (HEADER_WORDS + nargs)
+            if len(self.pending) < length:
+                return
+            words = struct.unpack_from("<%dI" % (HEADER_WORDS + nargs),
+                                       self.pending)
+            fmt = self.image.string_at(words[1])
+            if fmt is None:
+                # Not a real record, just a stray 0xA5 or a damaged frame
+                self._skip_byte()
+                continue
+            del self.pending[:length]
+            self._emit(words[0] >> 16, words[2], fmt, words[HEADER_WORDS:])
+
+    def _skip_byte(self):
+        self.out.write(self.pending[:1].decode("latin-1"))
+        del self.pending[:1]
+
+    def _emit(self, seq, stamp, fmt, args):
+        if self.next_seq is not None and seq != self.next_seq:
+            lost = (seq - self.next_seq) & 0xFFFF
+            self.out.write("[binlog: %d record(s) lost]\n" % lost)
+        self.next_seq = (seq + 1) & 0xFFFF
+        if self.last_stamp is not None and stamp < self.last_stamp:
+            self.wraps += 1
+        self.last_stamp = stamp
+        stamp += self.wraps << 32
+        text = format_record(self.image, fmt, args).rstrip("\r\n")
+        self.out.write("[%12.1f] %s\n" % (stamp * 1e6 / self.clock, text))
+        self.out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode binary log records from an Altrino Due console.")
+    parser.add_argument("elf", help="the ELF file of the program on the board")
+    parser.add_argument("input", nargs="?",
+                        help="a captured byte stream (default: standard input)")
+    parser.add_argument("--port", help="read from this serial port instead")
+    parser.add_argument("--baud", type=int, default=115200,
+                        help="serial port baud rate (default: 115200)")
+    parser.add_argument("--clock", type=float, default=84e6,
+                        help="CPU clock in Hz, for time stamps (default: 84e6)")
+    options = parser.parse_args()
+
+    decoder = Decoder(ElfImage(options.elf), options.clock, sys.stdout)
+    if options.port:
+        import serial
+        stream = serial.Serial(options.port, options.baud, timeout=0.1)
+    elif options.input:
+        stream = open(options.input, "rb")
+    else:
+        stream = sys.stdin.buffer
+
+    try:
+        while True:
+            data = stream.read(256)
+            if not data:
+                if options.port:
+                    continue
+                break
+            decoder.feed(data)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,166 @@
+/**
+ * \file
+ * \brief Host-side churn benchmark for the FreeRTOS heaps
+ *
+ * Builds one FreeRTOS heap implementation into a PC program, through the small
+ * stand-ins for FreeRTOS.h and task.h in host/. Then it runs a fixed,
+ * pseudo-random mix of allocations and frees against the heap, shaped like a
+ * program that keeps creating and deleting tasks and queues. The program prints:
+ *  - how many allocations failed, and the step at which the first one failed
+ *  - the free bytes left at the end
+ *  - the largest block that could still be allocated
+ *  - the resulting fragmentation
+ *  - the time per operation
+ *
+ * Every heap gets the same configTOTAL_HEAP_SIZE bytes. Heap 5 gets them as two
+ * regions, like the two SRAM banks, so its largest block can never be more than
+ * half the heap, and its fragmentation figure counts the split between the
+ * regions. Heap 3 is left out, because on a PC it is the
+ * C library's malloc() and has no fixed size. Build and run every heap with
+ *
+ *     tools/heap_churn/run.sh [path to FreeRTOS]
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#if ( HEAP_NUMBER == 5 )
+#include "FreeRTOSHeap.h"
+#endif
+
+/** Number of steps in a run */
+#define CHURN_STEPS			200000L
+
+/** Number of objects that can be alive at once */
+#define CHURN_SLOTS			32
+
+static void *pvSlots[ CHURN_SLOTS ];
+
+/** State of the xorshift generator; fixed so that every heap sees the same run */
+static uint32_t ulRandom = 2463534242UL;
+
+static uint32_t prvRandom( void )
+{
+	ulRandom ^= ulRandom << 13;
+	ulRandom ^= ulRandom >> 17;
+	ulRandom ^= ulRandom << 5;
+	return ulRandom;
+}
+
+/** Picks the size of the next object: task stacks, task control blocks, queues of
+ *  various lengths and small buffers */
+static size_t prvObjectSize( void )
+{
+	uint32_t ulKind = prvRandom() % 10;
+
+	if( ulKind < 3 )
+	{
+		return ( 130 + prvRandom() % 270 ) * sizeof( uint32_t );
+	}
+	else if( ulKind < 5 )
+	{
+		return 96;
+	}
+	else if( ulKind < 7 )
+	{
+		return 76 + ( 1 + prvRandom() % 32 ) * sizeof( uint32_t );
+	}
+	return 8 + prvRandom() % 57;
+}
+
+/** Finds the largest block the heap can still hand out. Heap 1 never gets it back,
+ *  so this is only done at the end of a run. */
+static size_t prvLargestAllocatable( void )
+{
+	size_t xLow = 0, xHigh = configTOTAL_HEAP_SIZE;
+	void *pv;
+
+	while( xLow < xHigh )
+	{
+		size_t xMid = xLow + ( xHigh - xLow + 1 ) / 2;
+
+		pv = pvPortMalloc( xMid );
+		if( pv != NULL )
+		{
+			vPortFree( pv );
+			xLow = xMid;
+		}
+		else
+		{
+			xHigh = xMid - 1;
+		}
+	}
+	return xLow;
+}
+
+int main( void )
+{
+	unsigned long ulAllocs = 0, ulFrees = 0, ulFailed = 0;
+	long lFirstFailure = -1;
+	struct timespec xStart, xEnd;
+	double dNanoseconds;
+	size_t xFree, xLargest;
+	long lStep;
+
+#if ( HEAP_NUMBER == 5 )
+	static uint64_t ullBank0[ configTOTAL_HEAP_SIZE / 2 / sizeof( uint64_t ) ];
+	static uint64_t ullBank1[ configTOTAL_HEAP_SIZE / 2 / sizeof( uint64_t ) ];
+	uint8_t *pucLow = ( uint8_t * ) ( ( &ullBank0[ 0 ] < &ullBank1[ 0 ] ) ? ullBank0 : ullBank1 );
+	uint8_t *pucHigh = ( uint8_t * ) ( ( &ullBank0[ 0 ] < &ullBank1[ 0 ] ) ? ullBank1 : ullBank0 );
+	HeapRegion_t xRegions[] =
+	{
+		{ pucLow, sizeof( ullBank0 ) },
+		{ pucHigh, sizeof( ullBank1 ) },
+		{ NULL, 0 }
+	};
+
+	vPortDefineHeapRegions( xRegions );
+#endif
+
+	clock_gettime( CLOCK_MONOTONIC, &xStart );
+	for( lStep = 0; lStep < CHURN_STEPS; lStep++ )
+	{
+		uint32_t ulSlot = prvRandom() % CHURN_SLOTS;
+
+		if( pvSlots[ ulSlot ] != NULL )
+		{
+			vPortFree( pvSlots[ ulSlot ] );
+			pvSlots[ ulSlot ] = NULL;
+			ulFrees++;
+		}
+		else
+		{
+			pvSlots[ ulSlot ] = pvPortMalloc( prvObjectSize() );
+			if( pvSlots[ ulSlot ] != NULL )
+			{
+				ulAllocs++;
+			}
+			else
+			{
+				ulFailed++;
+				if( lFirstFailure < 0 )
+				{
+					lFirstFailure = lStep;
+				}
+			}
+		}
+	}
+	clock_gettime( CLOCK_MONOTONIC, &xEnd );
+	dNanoseconds = ( xEnd.tv_sec - xStart.tv_sec ) * 1e9 + ( xEnd.tv_nsec - xStart.tv_nsec );
+
+	xFree = xPortGetFreeHeapSize();
+	xLargest = prvLargestAllocatable();
+
+	printf( "heap_%d: %lu allocs, %lu frees, %lu failed", HEAP_NUMBER, ulAllocs, ulFrees,
+			ulFailed );
+	if( lFirstFailure >= 0 )
+	{
+		printf( " (first at step %ld)", lFirstFailure );
+	}
+	printf( "\n        %lu bytes free, largest allocatable %lu, fragmentation %.1f%%,"
+			" %.0f ns/op\n", ( unsigned long ) xFree, ( unsigned long ) xLargest,
+			( xFree != 0 ) ? 100.0 * ( 1.0 - ( double ) xLargest / xFree ) : 0.0,
+			dNanoseconds / CHURN_STEPS );
+	return 0;
+}
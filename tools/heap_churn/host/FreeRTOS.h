@@ -0,0 +1,40 @@
+/**
+ * \file
+ * \brief Just enough of FreeRTOS.h to build the heap implementations on a PC
+ *
+ * Used only by the heap churn benchmark; see heap_churn.c. There is one thread and
+ * no scheduler, so suspending the scheduler does nothing.
+ */
+#ifndef _HOST_FREERTOS_H
+#define _HOST_FREERTOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define tskKERNEL_VERSION_MAJOR			8
+#define tskKERNEL_VERSION_MINOR			0
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdTRUE							1
+#define pdFALSE							0
+
+#define portBYTE_ALIGNMENT				8
+#define portBYTE_ALIGNMENT_MASK			( 0x0007 )
+#define portPOINTER_SIZE_TYPE			size_t
+
+#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 40960 ) )
+#define configUSE_MALLOC_FAILED_HOOK	0
+#define configNEWLIB_HEAP_SIZE			( ( size_t ) ( 4096 ) )
+#define configASSERT( x )
+#define mtCOVERAGE_TEST_MARKER()
+#define traceMALLOC( pvAddress, uiSize )
+#define traceFREE( pvAddress, uiSize )
+
+void *pvPortMalloc( size_t xSize );
+void vPortFree( void *pv );
+size_t xPortGetFreeHeapSize( void );
+void vPortInitialiseBlocks( void );
+
+#endif  // _HOST_FREERTOS_H
@@ -0,0 +1,19 @@
+/**
+ * \file
+ * \brief Just enough of task.h to build the heap implementations on a PC
+ */
+#ifndef _HOST_TASK_H
+#define _HOST_TASK_H
+
+#include "FreeRTOS.h"
+
+static inline void vTaskSuspendAll( void )
+{
+}
+
+static inline BaseType_t xTaskResumeAll( void )
+{
+	return pdFALSE;
+}
+
+#endif  // _HOST_TASK_H
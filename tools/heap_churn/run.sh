@@ -0,0 +1,27 @@
+#!/bin/sh
+# Builds the heap churn benchmark (heap_churn.c) once for each FreeRTOS heap and
+# runs it. Run from the top of the repository:
+#
+#     tools/heap_churn/run.sh [path to FreeRTOS, default lib/FreeRTOS]
+#
+# Heaps 1, 2 and 4 come from the kernel, heap 5 from lib/FreeRTOS_Heap. Heaps
+# that aren't there are skipped.
+
+FRT_PATH=${1:-lib/FreeRTOS}
+CC=${CC:-cc}
+OUT=${TMPDIR:-/tmp}/heap_churn.$$
+
+for HEAP in 1 2 4 5; do
+	if [ "$HEAP" = 5 ]; then
+		SRC=lib/FreeRTOS_Heap/heap_5.c
+	else
+		SRC=$FRT_PATH/Source/portable/MemMang/heap_$HEAP.c
+	fi
+	if [ ! -f "$SRC" ]; then
+		echo "heap_$HEAP: $SRC not found, skipped"
+		continue
+	fi
+	$CC -O2 -DHEAP_NUMBER=$HEAP -Itools/heap_churn/host -Ilib/FreeRTOS_Config \
+		tools/heap_churn/heap_churn.c "$SRC" -o "$OUT" && "$OUT"
+done
+rm -f "$OUT"
@@ -0,0 +1,304 @@
+#!/usr/bin/env python3
+"""Flash and RAM usage of a linked program, by module.
+
+Reads the program's ELF file and the map file the linker wrote beside it, and
+adds up the sections each module's objects put into flash and RAM. common.mk
+runs it after every link, naming the objects of each module (the application,
+the services, FreeRTOS, the syscalls and ASF); for example:
+
+    python3 tools/size_report.py build/ex04_frt_task_cpp/ex04_frt_task_cpp_flash.elf \\
+        --library build/ex04_frt_task_cpp/syslib.a \\
+        --module app build/ex04_frt_task_cpp/main.o ... \\
+        --module freertos build/ex04_frt_task_cpp/lib/FreeRTOS/Source/tasks.o ... \\
+        --budget flash=256K --budget freertos.ram=40K
+
+Code and constants count as flash, zeroed data as RAM, and initialized data as
+both, as it is copied from flash at startup. Objects from the toolchain (newlib,
+libgcc and the C++ runtime) are counted as "toolchain", and the linker's padding,
+and space it reserves such as the main stack, as "other".
+
+With link-time optimization, the code is all in the linker's temporary objects,
+so each of their sections is put down to the module which defines the function
+or variable it is named after. That needs the modules' objects to have their
+own code in them too (-ffat-lto-objects); what can't be placed, such as merged
+string constants, is counted as "lto".
+
+Each --budget is a limit on the flash or ram used by the whole program or by
+one module, in bytes, which may end in K or M. The report is printed, and saved
+with -o if every budget is met; otherwise the exit status is 1.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+SHN_UNDEF = 0
+SHN_LORESERVE = 0xFF00
+SHN_COMMON = 0xFFF2
+STT_OBJECT = 1
+STT_FUNC = 2
+
+TOOLCHAIN = "toolchain"
+LTO = "lto"
+OTHER = "other"
+MEMORIES = ("flash", "ram")
+
+# The sections GCC names after a function or variable, and the prefixes it
+# puts in front of the name for some functions
+NAMED_SECTIONS = (".text.", ".rodata.", ".data.", ".bss.")
+SUBSECTIONS = ("startup", "unlikely", "hot", "exit")
+
+HEX = re.compile(r"0x[0-9a-fA-F]+$")
+MEMBER = re.compile(r"^(.*)\(([^()]*)\)$")
+
+
+class ElfFile(object):
+    """The section headers and symbols of an ELF file, 32 or 64 bit, little-endian."""
+
+    def __init__(self, path):
+        with open(path, "rb") as elf:
+            self.data = data = elf.read()
+        if data[:4] != b"\x7fELF" or data[5] != 1:
+            raise ValueError("%s is not a little-endian ELF file" % path)
+        self.wide = data[4] == 2
+        if self.wide:
+            shoff, = struct.unpack_from("<Q", data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+            header = "<IIQQQQII"
+        else:
+            shoff, = struct.unpack_from("<I", data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+            header = "<IIIIIIII"
+        self.sections = []
+        for index in range(shnum):
+            (name, sh_type, flags, _, offset, size, link, _) = struct.unpack_from(
+                header, data, shoff + index * shentsize)
+            self.sections.append([name, sh_type, flags, offset, size, link])
+        names = self.sections[shstrndx] if shstrndx < shnum else None
+        for section in self.sections:
+            section[0] = self.string(names, section[0]) if names else ""
+
+    def string(self, table, offset):
+        """Returns the NUL-terminated string at an offset into a string table."""
+        start = table[3] + offset
+        return self.data[start:self.data.index(b"\0", start)].decode("latin-1")
+
+    def memories(self):
+        """Returns, by name, the memories (flash, ram or both) each section of the
+        program takes up."""
+        result = {}
+        for name, sh_type, flags, _, size, _ in self.sections:
+            if not flags & SHF_ALLOC or size == 0:
+                continue
+            used = []
+            if sh_type != SHT_NOBITS:
+                used.append("flash")
+            if flags & SHF_WRITE:
+                used.append("ram")
+            result[name] = (used, size)
+        return result
+
+    def defined_symbols(self):
+        """Returns the names of the functions and variables defined here."""
+        names = []
+        for _, sh_type, _, offset, size, link in self.sections:
+            if sh_type != SHT_SYMTAB:
+                continue
+            strings = self.sections[link]
+            entry, layout = (24, "<IBBHQQ") if self.wide else (16, "<IIIBBH")
+            for start in range(offset + entry, offset + size, entry):
+                fields = struct.unpack_from(layout, self.data, start)
+                if self.wide:
+                    name, info, shndx = fields[0], fields[1], fields[3]
+                else:
+                    name, info, shndx = fields[0], fields[3], fields[5]
+                if info & 0xF not in (STT_OBJECT, STT_FUNC):
+                    continue
+                if shndx == SHN_UNDEF or (shndx >= SHN_LORESERVE and shndx != SHN_COMMON):
+                    continue
+                names.append(self.string(strings, name))
+        return names
+
+
+def read_map(path):
+    """Returns the output sections in a GNU ld map file, as a list of (name,
+    [(input section, size, file)]). Padding has no file."""
+    sections = []
+    inputs = None
+    started = False
+    pending = None
+    with open(path) as map_file:
+        for line in map_file:
+            line = line.rstrip("\n")
+            if not started:
+                started = line.startswith("Linker script and memory map")
+                continue
+            if line.startswith("OUTPUT(") or line.startswith("Cross Reference Table"):
+                break
+            tokens = line.split()
+            indent = len(line) - len(line.lstrip(" "))
+            if pending:
+                # A long section name goes on a line of its own
+                indent, tokens = pending[0], [pending[1]] + tokens
+                pending = None
+            if not tokens:
+                continue
+            if len(tokens) == 1 and indent <= 1 and not tokens[0].startswith("*("):
+                pending = (indent, tokens[0])
+                continue
+            if len(tokens) < 3 or not HEX.match(tokens[1]) or not HEX.match(tokens[2]):
+                continue
+            if indent == 0:
+                inputs = []
+                sections.append((tokens[0], inputs))
+            elif indent == 1 and inputs is not None and not tokens[0].startswith("*("):
+                source = " ".join(tokens[3:]) if tokens[0] != "*fill*" else ""
+                inputs.append((tokens[0], int(tokens[2], 16), source))
+    return sections
+
+
+class Modules(object):
+    """Finds the module an input section in the map file came from."""
+
+    def __init__(self, modules, library):
+        self.names = []
+        self.paths = {}
+        self.members = {}
+        self.objects = []
+        self.symbols = None
+        self.library = os.path.normpath(library) if library else None
+        for name, objects in modules:
+            if name not in self.names:
+                self.names.append(name)
+            for obj in objects:
+                path = os.path.normpath(obj)
+                self.paths.setdefault(path, name)
+                self.members.setdefault(os.path.basename(path), name)
+                self.objects.append((name, path))
+
+    def module_of(self, section, source):
+        """Returns the module an input section from a file belongs to."""
+        if not source:
+            return OTHER
+        if "ltrans" in os.path.basename(source):
+            return self.module_of_symbol(section)
+        member = MEMBER.match(source)
+        if member:
+            if os.path.normpath(member.group(1)) == self.library:
+                return self.members.get(os.path.basename(member.group(2)), TOOLCHAIN)
+            return TOOLCHAIN
+        return self.paths.get(os.path.normpath(source), TOOLCHAIN)
+
+    def module_of_symbol(self, section):
+        """Returns the module that defines what an LTO section is named after."""
+        if self.symbols is None:
+            self.symbols = {}
+            for name, path in self.objects:
+                try:
+                    for symbol in ElfFile(path).defined_symbols():
+                        self.symbols.setdefault(symbol, name)
+                except (IOError, ValueError):
+                    pass
+        for prefix in NAMED_SECTIONS:
+            if section.startswith(prefix):
+                parts = section[len(prefix):].split(".")
+                if len(parts) > 1 and parts[0] in SUBSECTIONS:
+                    parts = parts[1:]
+                # Clones and local copies have suffixes, as in foo.constprop.0
+                return self.symbols.get(parts[0], LTO)
+        return LTO
+
+
+def parse_size(text):
+    """Returns a number of bytes given as e.g. 4096, 0x1000, 4K or 1M."""
+    scale = {"K": 1024, "M": 1024 * 1024}.get(text[-1:].upper(), 1)
+    if scale > 1:
+        text = text[:-1]
+    return int(text, 0) * scale
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Show the flash and RAM a program uses, by module.")
+    parser.add_argument("elf", help="the linked program")
+    parser.add_argument("--map", help="the linker's map file (default: the ELF file's "
+                        "name ending in .map)")
+    parser.add_argument("--module", nargs="+", action="append", default=[],
+                        metavar=("NAME", "OBJECT"),
+                        help="a module and the objects it's built from")
+    parser.add_argument("--library", help="the archive the modules' objects are linked "
+                        "from, if they aren't linked directly")
+    parser.add_argument("--budget", action="append", default=[],
+                        metavar="[MODULE.]MEMORY=BYTES",
+                        help="a limit on the flash or ram used, e.g. ram=64K")
+    parser.add_argument("-o", "--output", help="save the report to this file")
+    options = parser.parse_args()
+
+    map_path = options.map or os.path.splitext(options.elf)[0] + ".map"
+    memories = ElfFile(options.elf).memories()
+    modules = Modules([(names[0], names[1:]) for names in options.module],
+                      options.library)
+
+    usage = {}
+    for name, inputs in read_map(map_path):
+        if name not in memories:
+            continue
+        used, size = memories[name]
+        counted = {}
+        for section, length, source in inputs:
+            module = modules.module_of(section, source)
+            counted[module] = counted.get(module, 0) + length
+        counted[OTHER] = counted.get(OTHER, 0) + size - sum(counted.values())
+        for module, length in counted.items():
+            for memory in used:
+                usage[(module, memory)] = usage.get((module, memory), 0) + length
+
+    order = modules.names + [TOOLCHAIN, LTO, OTHER]
+    order += sorted(set(module for module, _ in usage) - set(order))
+    totals = dict((memory, sum(length for (_, used), length in usage.items()
+                               if used == memory)) for memory in MEMORIES)
+
+    budgets = {}
+    for budget in options.budget:
+        what, _, limit = budget.partition("=")
+        key = tuple(what.rsplit(".", 1)) if "." in what else (None, what)
+        if key[1] not in MEMORIES or not limit:
+            parser.error("a budget is [module.]flash=bytes or [module.]ram=bytes, "
+                         "not %s" % budget)
+        budgets[key] = parse_size(limit)
+
+    lines = ["%-12s %10s %10s" % ("module", "flash", "ram")]
+    for module in order:
+        row = [usage.get((module, memory), 0) for memory in MEMORIES]
+        if any(row) or module in modules.names:
+            lines.append("%-12s %10d %10d" % ((module,) + tuple(row)))
+    lines.append("%-12s %10d %10d" % ("total", totals["flash"], totals["ram"]))
+    if (None, "flash") in budgets or (None, "ram") in budgets:
+        lines.append("%-12s %10s %10s" % (("budget",) + tuple(
+            budgets.get((None, memory), "-") for memory in MEMORIES)))
+    report = "\n".join(lines) + "\n"
+    sys.stdout.write(report)
+
+    over = []
+    for (module, memory), limit in sorted(budgets.items(), key=str):
+        used = totals[memory] if module is None else usage.get((module, memory), 0)
+        if used > limit:
+            over.append("%s%s is %d bytes, over its budget of %d by %d" % (
+                module + " " if module else "", memory, used, limit, used - limit))
+    for message in over:
+        sys.stderr.write("size_report: %s\n" % message)
+    if over:
+        sys.exit(1)
+    if options.output:
+        with open(options.output, "w") as out:
+            out.write(report)
+
+
+if __name__ == "__main__":
+    main()